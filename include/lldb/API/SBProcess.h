@@ -124,6 +124,9 @@ public:
     lldb::SBThread
     GetSelectedThread () const;
 
+    bool
+    FetchThreadStackFrames (uint32_t max_frames, uint32_t num_workers);
+
     //------------------------------------------------------------------
     // Function for lazily creating a thread using the current OS
     // plug-in. This function will be removed in the future when there
@@ -204,6 +204,9 @@ protected:
     bp_collection::const_iterator
     GetBreakpointIDConstIterator(lldb::break_id_t breakID) const;
 
+    void
+    UpdateBreakpointsForLoadedModules (ModuleList &module_list);
+
     Mutex &
     GetMutex () const
     {
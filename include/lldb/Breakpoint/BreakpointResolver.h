@@ -99,6 +99,30 @@ public:
     ResolveBreakpointInModules (SearchFilter &filter,
                                 ModuleList &modules);
 
+    //------------------------------------------------------------------
+    /// A (name, FunctionNameType mask) pair the resolver looks up.
+    //------------------------------------------------------------------
+    typedef std::pair<ConstString, uint32_t> NameLookup;
+
+    //------------------------------------------------------------------
+    /// Get the function names this resolver looks up, for resolvers that
+    /// can only ever find locations in a module by looking up one of a
+    /// fixed set of names.  BreakpointList uses this to skip resolvers
+    /// for newly loaded modules that define none of their names.
+    ///
+    /// @param[out] names
+    ///   Filled in with the names and name type masks looked up.
+    ///
+    /// @return
+    ///   \b true if \a names covers every location the resolver can
+    ///   find, \b false if it has to search each module itself.
+    //------------------------------------------------------------------
+    virtual bool
+    GetLookupNames (std::vector<NameLookup> &names) const
+    {
+        return false;
+    }
+
     //------------------------------------------------------------------
     /// Prints a canonical description for the breakpoint to the stream \a s.
     ///
@@ -79,6 +79,9 @@ public:
     void
     Dump (Stream *s) const override;
 
+    bool
+    GetLookupNames (std::vector<NameLookup> &names) const override;
+
     /// Methods for support type inquiry through isa, cast, and dyn_cast:
     static inline bool classof(const BreakpointResolverName *) { return true; }
     static inline bool classof(const BreakpointResolver *V) {
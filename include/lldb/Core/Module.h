@@ -12,6 +12,7 @@
 
 #include "lldb/lldb-forward.h"
 #include "lldb/Core/ArchSpec.h"
+#include "lldb/Core/UniqueCStringMap.h"
 #include "lldb/Core/UUID.h"
 #include "lldb/Host/FileSpec.h"
 #include "lldb/Host/Mutex.h"
@@ -663,6 +664,30 @@ public:
     lldb::CompUnitSP
     GetCompileUnitAtIndex (size_t idx);
 
+    //------------------------------------------------------------------
+    /// Find the compile units that might have line entries for
+    /// \a file_spec.
+    ///
+    /// Matches on basename only: every compile unit whose primary file
+    /// or one of whose support files has the basename of \a file_spec is
+    /// returned, and callers still have to compare the full paths.  The
+    /// basename index is built from the support file lists the first time
+    /// it is needed and kept for the life of the symbol vendor.
+    ///
+    /// @param[in] file_spec
+    ///     The file to look for.
+    ///
+    /// @param[out] cu_indexes
+    ///     Sorted, unique compile unit indexes (as used by
+    ///     GetCompileUnitAtIndex) are appended here.
+    ///
+    /// @return
+    ///     The number of compile unit indexes appended.
+    //------------------------------------------------------------------
+    size_t
+    FindCompileUnitIndexesForFile (const FileSpec &file_spec,
+                                   std::vector<uint32_t> &cu_indexes);
+
     const ConstString &
     GetObjectName() const;
 
@@ -1111,9 +1136,11 @@ protected:
     lldb::ClangASTContextUP     m_ast;          ///< The AST context for this module.
     PathMappingList             m_source_mappings; ///< Module specific source remappings for when you have debug info for a module that doesn't match where the sources currently are
     lldb::SectionListUP         m_sections_ap; ///< Unified section list for module that is used by the ObjectFile and and ObjectFile instances for the debug info
+    UniqueCStringMap<uint32_t>  m_file_basename_to_cu_index; ///< Compile unit indexes keyed by the basenames of their primary and support files
 
     bool                        m_did_load_objfile:1,
                                 m_did_load_symbol_vendor:1,
+                                m_did_index_compile_unit_files:1,
                                 m_did_parse_uuid:1,
                                 m_did_init_ast:1;
     mutable bool                m_file_has_changed:1,
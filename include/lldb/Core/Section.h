@@ -277,6 +277,23 @@ public:
         m_thread_specific = b;
     }
     
+    //------------------------------------------------------------------
+    /// Get the memory permissions this section is mapped with at runtime,
+    /// as a mask of lldb::Permissions bits. Zero means the object file
+    /// didn't say, and callers must assume the section is writable.
+    //------------------------------------------------------------------
+    uint32_t
+    GetPermissions () const
+    {
+        return m_permissions;
+    }
+
+    void
+    SetPermissions (uint32_t permissions)
+    {
+        m_permissions = permissions;
+    }
+
     ObjectFile *
     GetObjectFile ()
     {
@@ -318,6 +335,7 @@ protected:
     lldb::offset_t  m_file_offset;      // Object file offset (if any)
     lldb::offset_t  m_file_size;        // Object file size (can be smaller than m_byte_size for zero filled sections...)
     uint32_t        m_log2align;        // log_2(align) of the section (i.e. section has to be aligned to 2^m_log2align)
+    uint32_t        m_permissions;      // lldb::Permissions the section is mapped with, or zero if unknown
     SectionList     m_children;         // Child sections
     bool            m_fake:1,           // If true, then this section only can contain the address if one of its
                                         // children contains an address. This allows for gaps between the children
@@ -12,6 +12,7 @@
 
 // C Includes
 // C++ Includes
+#include <algorithm>
 #include <map>
 #include <vector>
 
@@ -1000,9 +1001,18 @@ protected:
     class ChildrenManager
     {
     public:
+        enum
+        {
+            // Children are kept in pages of up to this many consecutive
+            // indexes, so finding one is a single map lookup per page and
+            // making thousands of them doesn't allocate a map node for each.
+            // A page only grows as far as the children it has to hold.
+            kPageSize = 256
+        };
+
         ChildrenManager() :
             m_mutex(Mutex::eMutexTypeRecursive),
-            m_children(),
+            m_pages(),
             m_children_count(0)
         {}
         
@@ -1010,29 +1020,53 @@ protected:
         HasChildAtIndex (size_t idx)
         {
             Mutex::Locker locker(m_mutex);
-            ChildrenIterator iter = m_children.find(idx);
-            ChildrenIterator end = m_children.end();
-            return (iter != end);
+            const ChildrenPage *page = FindPage(idx);
+            const size_t page_idx = idx % kPageSize;
+            return page != NULL && page_idx < page->m_created.size() && page->m_created[page_idx];
+        }
+        
+        // Returns true if a child in the same page as idx has been made.
+        bool
+        HasChildrenInPage (size_t idx)
+        {
+            Mutex::Locker locker(m_mutex);
+            return FindPage(idx) != NULL;
         }
         
         ValueObject*
         GetChildAtIndex (size_t idx)
         {
             Mutex::Locker locker(m_mutex);
-            ChildrenIterator iter = m_children.find(idx);
-            ChildrenIterator end = m_children.end();
-            if (iter == end)
+            const ChildrenPage *page = FindPage(idx);
+            const size_t page_idx = idx % kPageSize;
+            if (page == NULL || page_idx >= page->m_children.size())
                 return NULL;
             else
-                return iter->second;
+                return page->m_children[page_idx];
         }
         
         void
         SetChildAtIndex (size_t idx, ValueObject* valobj)
         {
-            ChildrenPair pair(idx,valobj); // we do not need to be mutex-protected to make a pair
+            const size_t page_idx = idx % kPageSize;
             Mutex::Locker locker(m_mutex);
-            m_children.insert(pair);
+            ChildrenPage &page = m_pages[idx / kPageSize];
+            if (page_idx >= page.m_children.size())
+            {
+                // Make room for the rest of the page's children up front,
+                // which for a small value is all of them, but don't go
+                // further than the children count unless we have to.
+                const size_t page_start = idx - page_idx;
+                size_t page_size = page_idx + 1;
+                if (m_children_count > page_start)
+                    page_size = std::max<size_t>(page_size, std::min<size_t>(kPageSize, m_children_count - page_start));
+                page.m_children.resize(page_size, NULL);
+                page.m_created.resize(page_size, false);
+            }
+            else if (page.m_created[page_idx])
+                return;
+            page.m_children[page_idx] = valobj;
+            page.m_created[page_idx] = true;
         }
         
         void
@@ -1052,15 +1086,33 @@ protected:
         {
             Mutex::Locker locker(m_mutex);
             m_children_count = new_count;
-            m_children.clear();
+            m_pages.clear();
         }
         
     private:
-        typedef std::map<size_t, ValueObject*> ChildrenMap;
-        typedef ChildrenMap::iterator ChildrenIterator;
-        typedef ChildrenMap::value_type ChildrenPair;
+        struct ChildrenPage
+        {
+            ChildrenPage () :
+                m_children(),
+                m_created()
+            {}
+
+            std::vector<ValueObject*> m_children;
+            std::vector<bool> m_created;    // A failed attempt leaves a NULL child, but still counts as made
+        };
+        typedef std::map<size_t, ChildrenPage> PageMap;
+        
+        ChildrenPage *
+        FindPage (size_t idx)
+        {
+            PageMap::iterator pos = m_pages.find(idx / kPageSize);
+            if (pos == m_pages.end())
+                return NULL;
+            return &pos->second;
+        }
+        
         Mutex m_mutex;
-        ChildrenMap m_children;
+        PageMap m_pages;
         size_t m_children_count;
     };
 
@@ -1185,6 +1237,14 @@ protected:
     virtual ValueObject *
     CreateChildAtIndex (size_t idx, bool synthetic_array_member, int32_t synthetic_index);
 
+    // Makes element idx of a constant sized array straight from the element
+    // type instead of asking the type for each child by index.  The memory
+    // behind idx's page of elements is read in one go when the first child
+    // in that page is made, so the elements read their values from the
+    // memory cache.  Returns NULL if this isn't such an array.
+    ValueObject *
+    CreateArrayElementAtIndex (size_t idx);
+
     // Should only be called by ValueObject::GetNumChildren()
     virtual size_t
     CalculateNumChildren() = 0;
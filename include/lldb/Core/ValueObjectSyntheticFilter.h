@@ -161,17 +161,26 @@ protected:
     virtual void
     CreateSynthFilter ();
 
+    // Fetch the page of children that contains idx from the front-end in one go, returning
+    // child idx if the front-end supports that.
+    lldb::ValueObjectSP
+    FetchChildPage (size_t idx);
+
     // we need to hold on to the SyntheticChildren because someone might delete the type binding while we are alive
     lldb::SyntheticChildrenSP m_synth_sp;
     std::unique_ptr<SyntheticChildrenFrontEnd> m_synth_filter_ap;
     
     typedef ThreadSafeSTLMap<uint32_t, ValueObject*> ByIndexMap;
+    typedef ThreadSafeSTLMap<uint32_t, lldb::ValueObjectSP> PagedChildrenMap;
+    typedef ThreadSafeSTLMap<uint32_t, bool> FetchedPagesMap;
     typedef ThreadSafeSTLMap<const char*, uint32_t> NameToIndexMap;
     
     typedef ByIndexMap::iterator ByIndexIterator;
     typedef NameToIndexMap::iterator NameToIndexIterator;
 
     ByIndexMap      m_children_byindex;
+    PagedChildrenMap m_paged_children;  // keeps the children fetched by FetchChildPage() alive; nobody else holds on to them
+    FetchedPagesMap m_fetched_pages;    // the first index of every page FetchChildPage() already asked the front-end for
     NameToIndexMap  m_name_toindex;
     uint32_t        m_synthetic_children_count; // FIXME use the ValueObject's ChildrenManager instead of a special purpose solution
     
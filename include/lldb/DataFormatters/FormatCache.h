@@ -12,13 +12,16 @@
 
 // C Includes
 // C++ Includes
-#include <map>
+#include <atomic>
+#include <unordered_map>
 
 // Other libraries and framework includes
+#include "llvm/ADT/Hashing.h"
+#include "llvm/Support/RWMutex.h"
+
 // Project includes
 #include "lldb/lldb-public.h"
 #include "lldb/Core/ConstString.h"
-#include "lldb/Host/Mutex.h"
 #include "lldb/DataFormatters/FormatClasses.h"
 
 namespace lldb_private {
@@ -81,16 +84,50 @@ private:
         void
         SetValidator (lldb::TypeValidatorImplSP);
     };
-    typedef std::map<ConstString,Entry> CacheMap;
-    CacheMap m_map;
-    Mutex m_mutex;
-    
-    uint64_t m_cache_hits;
-    uint64_t m_cache_misses;
-    
-    Entry&
-    GetEntry (const ConstString& type);
-    
+
+    // ConstStrings are uniqued, so the string pointer is all there is to hash.
+    struct ConstStringHasher
+    {
+        size_t
+        operator() (const ConstString& type) const
+        {
+            return llvm::hash_value (type.GetCString());
+        }
+    };
+    typedef std::unordered_map<ConstString,Entry,ConstStringHasher> CacheMap;
+
+    //------------------------------------------------------------------
+    // The cache is hit from every thread that formats a value, and almost
+    // every access is a lookup that finds its entry.  Split it into shards
+    // that each have their own reader/writer lock so that lookups proceed
+    // in parallel and a thread filling in a missing entry only holds off
+    // readers of the same shard.
+    //------------------------------------------------------------------
+    enum
+    {
+        kNumShards = 16
+    };
+
+    struct Shard
+    {
+        llvm::sys::RWMutex m_mutex;
+        CacheMap m_map;
+    };
+    Shard m_shards[kNumShards];
+
+    std::atomic<uint64_t> m_cache_hits;
+    std::atomic<uint64_t> m_cache_misses;
+
+    Shard&
+    GetShard (const ConstString& type);
+
+    // Copies the entry for "type" into "entry" under a shared lock.
+    bool
+    LookupEntry (const ConstString& type, Entry& entry);
+
+    void
+    CountLookup (bool hit);
+
 public:
     FormatCache ();
     
@@ -12,8 +12,12 @@
 
 // C Includes
 // C++ Includes
+#include <memory>
+#include <vector>
 
 // Other libraries and framework includes
+#include "llvm/Support/RWMutex.h"
+
 // Project includes
 #include "lldb/lldb-public.h"
 #include "lldb/lldb-enumerations.h"
@@ -30,6 +34,8 @@ namespace lldb_private {
         typedef ValueType::SharedPointer ValueSP;
         typedef std::list<lldb::TypeCategoryImplSP> ActiveCategoriesList;
         typedef ActiveCategoriesList::iterator ActiveCategoriesIterator;
+        typedef std::vector<lldb::TypeCategoryImplSP> ActiveCategoriesSnapshot;
+        typedef std::shared_ptr<const ActiveCategoriesSnapshot> ActiveCategoriesSnapshotSP;
         
     public:
         typedef std::map<KeyType, ValueSP> MapType;
@@ -133,12 +139,32 @@ namespace lldb_private {
             }
         };
         
+        //------------------------------------------------------------------
+        /// Publish the current contents of m_active_categories to the
+        /// formatter lookups.  Must be called with m_map_mutex held after
+        /// every change to the active list.
+        //------------------------------------------------------------------
+        void
+        UpdateActiveCategoriesSnapshot ();
+        
+        //------------------------------------------------------------------
+        /// The enabled categories in lookup order.  The snapshot is never
+        /// modified once published, so the formatter lookups walk it
+        /// without holding m_map_mutex and never wait on each other or on
+        /// a category being enabled or disabled.
+        //------------------------------------------------------------------
+        ActiveCategoriesSnapshotSP
+        GetActiveCategoriesSnapshot ();
+        
         Mutex m_map_mutex;
         IFormatChangeListener* listener;
         
         MapType m_map;
         ActiveCategoriesList m_active_categories;
         
+        llvm::sys::RWMutex m_snapshot_mutex;
+        ActiveCategoriesSnapshotSP m_active_snapshot;
+        
         MapType& map ()
         {
             return m_map;
@@ -62,6 +62,16 @@ namespace lldb_private {
         virtual lldb::ValueObjectSP
         GetChildAtIndex (size_t idx) = 0;
         
+        // fetch up to count children starting at idx into children, returning how many were fetched
+        // front-ends that can produce a batch of children much more cheaply than one at a time (e.g. because
+        // each call crosses into a script interpreter) should override this; returning 0 makes the caller
+        // fall back to GetChildAtIndex()
+        virtual size_t
+        GetChildrenInRange (size_t idx, size_t count, std::vector<lldb::ValueObjectSP> &children)
+        {
+            return 0;
+        }
+        
         virtual size_t
         GetIndexOfChildWithName (const ConstString &name) = 0;
         
@@ -554,6 +564,7 @@ namespace lldb_private {
             std::string m_python_class;
             StructuredData::ObjectSP m_wrapper_sp;
             ScriptInterpreter *m_interpreter;
+            bool m_can_get_children_in_range; // false once we know the provider doesn't implement get_children_in_range
         public:
             
             FrontEnd (std::string pclass,
@@ -571,6 +582,9 @@ namespace lldb_private {
             virtual lldb::ValueObjectSP
             GetChildAtIndex (size_t idx);
             
+            virtual size_t
+            GetChildrenInRange (size_t idx, size_t count, std::vector<lldb::ValueObjectSP> &children);
+            
             virtual bool
             Update ();
             
@@ -356,6 +356,10 @@ protected:
     uint32_t
     GetMaxNumChildrenToPrint (bool& print_dotdotdot);
     
+    void
+    PrefetchChildStrings (ValueObject* synth_valobj,
+                          size_t num_children);
+    
     void
     PrintChildren (uint32_t curr_ptr_depth);
     
@@ -0,0 +1,84 @@
+//===-- ClangPredefinesCache.h ----------------------------------*- C++ -*-===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+
+#ifndef liblldb_ClangPredefinesCache_h_
+#define liblldb_ClangPredefinesCache_h_
+
+// C Includes
+// C++ Includes
+#include <map>
+#include <string>
+
+// Other libraries and framework includes
+// Project includes
+#include "lldb/lldb-private.h"
+#include "lldb/Core/ClangForward.h"
+#include "lldb/Host/Mutex.h"
+
+namespace lldb_private
+{
+
+//----------------------------------------------------------------------
+/// @class ClangPredefinesCache ClangPredefinesCache.h "lldb/Expression/ClangPredefinesCache.h"
+/// @brief Predefined macro buffers of expression parsers, one per
+///        compiler configuration.
+///
+/// Every expression used to rebuild the <built-in> buffer of predefined
+/// macros (__GNUC__, __x86_64__, __SIZEOF_LONG__, ...) even though that
+/// text only depends on the target and language options.  The cache
+/// keeps the buffer for each distinct configuration and hands out
+/// copies, so nothing clang owns is shared between compiler instances.
+//----------------------------------------------------------------------
+class ClangPredefinesCache
+{
+public:
+    ClangPredefinesCache ();
+
+    ~ClangPredefinesCache ();
+
+    //------------------------------------------------------------------
+    /// Get the cache shared by all expression parsers.
+    //------------------------------------------------------------------
+    static ClangPredefinesCache &
+    GetSharedCache ();
+
+    //------------------------------------------------------------------
+    /// Make the key for a configuration.  It covers every target option
+    /// and every language option, so a buffer is never reused once any
+    /// of them changes.
+    //------------------------------------------------------------------
+    static std::string
+    GetKey (const clang::TargetOptions &target_opts,
+            const clang::LangOptions &lang_opts);
+
+    //------------------------------------------------------------------
+    /// Look up the buffer for \a key.
+    ///
+    /// @return
+    ///     True, with a copy of the buffer in \a predefines, if one was
+    ///     stored for \a key.
+    //------------------------------------------------------------------
+    bool
+    GetPredefines (const std::string &key, std::string &predefines);
+
+    void
+    SetPredefines (const std::string &key, const std::string &predefines);
+
+private:
+    typedef std::map<std::string, std::string> PredefinesMap;
+
+    Mutex m_mutex;
+    PredefinesMap m_predefines;
+
+    DISALLOW_COPY_AND_ASSIGN (ClangPredefinesCache);
+};
+
+} // namespace lldb_private
+
+#endif // liblldb_ClangPredefinesCache_h_
@@ -42,6 +42,14 @@ namespace lldb_private
         Error
         GetBreakpoint (lldb::addr_t addr, NativeBreakpointSP &breakpoint_sp);
 
+        //------------------------------------------------------------------
+        /// Replace the trap opcodes of every enabled software breakpoint
+        /// that overlaps [addr, addr + size) in @a buf, which holds memory
+        /// read from @a addr, with the original bytes they cover.
+        //------------------------------------------------------------------
+        void
+        RemoveTrapsFromBuffer (lldb::addr_t addr, void *buf, size_t size);
+
     private:
         typedef std::map<lldb::addr_t, NativeBreakpointSP> BreakpointMap;
 
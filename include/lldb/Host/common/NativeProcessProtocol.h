@@ -10,6 +10,7 @@
 #ifndef liblldb_NativeProcessProtocol_h_
 #define liblldb_NativeProcessProtocol_h_
 
+#include <unordered_map>
 #include <vector>
 
 #include "lldb/lldb-private-forward.h"
@@ -228,6 +229,37 @@ namespace lldb_private
         uint32_t
         GetStopID () const;
 
+        //----------------------------------------------------------------------
+        // Non-stop mode
+        //----------------------------------------------------------------------
+
+        //------------------------------------------------------------------
+        /// Switch between all-stop and non-stop mode.
+        ///
+        /// In all-stop mode, the default, every thread is halted before a
+        /// stop is reported through NativeDelegate::ProcessStateChanged.
+        /// In non-stop mode only the thread that stopped is halted; its
+        /// stop is reported through NativeDelegate::ThreadStopped while
+        /// the other threads keep running, and each thread is resumed or
+        /// interrupted on its own through Resume().
+        ///
+        /// @param[in] enabled
+        ///     \b true to enter non-stop mode, \b false to return to
+        ///     all-stop mode.
+        ///
+        /// @return
+        ///     An error if the process plugin doesn't support non-stop
+        ///     mode or can't switch modes right now.
+        //------------------------------------------------------------------
+        virtual Error
+        SetNonStopMode (bool enabled);
+
+        bool
+        GetNonStopMode () const
+        {
+            return m_non_stop_mode;
+        }
+
         // ---------------------------------------------------------------------
         // Callbacks for low-level process state changes
         // ---------------------------------------------------------------------
@@ -245,6 +277,11 @@ namespace lldb_private
 
             virtual void
             DidExec (NativeProcessProtocol *process) = 0;
+
+            // Only called in non-stop mode, once for each thread that stops
+            // while the rest of the process may still be running.
+            virtual void
+            ThreadStopped (NativeProcessProtocol *process, lldb::tid_t tid) = 0;
         };
 
         //------------------------------------------------------------------
@@ -291,6 +328,9 @@ namespace lldb_private
         lldb::pid_t m_pid;
 
         std::vector<NativeThreadProtocolSP> m_threads;
+        // Index of m_threads by thread id.  Subclasses adding or removing
+        // threads must keep both in sync.
+        std::unordered_map<lldb::tid_t, NativeThreadProtocolSP> m_threads_by_id;
         lldb::tid_t m_current_thread_id;
         mutable Mutex m_threads_mutex;
 
@@ -306,6 +346,7 @@ namespace lldb_private
         NativeWatchpointList m_watchpoint_list;
         int m_terminal_fd;
         uint32_t m_stop_id;
+        bool m_non_stop_mode;
 
         // -----------------------------------------------------------
         // Internal interface for state handling
@@ -340,6 +381,13 @@ namespace lldb_private
         void
         NotifyDidExec ();
 
+        // -----------------------------------------------------------
+        /// Notify the delegates that a single thread stopped while in
+        /// non-stop mode.
+        // -----------------------------------------------------------
+        void
+        NotifyThreadStopped (lldb::tid_t tid);
+
         NativeThreadProtocolSP
         GetThreadByIDUnlocked (lldb::tid_t tid);
 
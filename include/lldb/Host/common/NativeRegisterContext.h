@@ -36,11 +36,19 @@ public:
     // void
     // InvalidateIfNeeded (bool force);
 
+    //------------------------------------------------------------------
+    /// Discard any register values cached since the thread last stopped.
+    ///
+    /// Called whenever the owning thread is about to be resumed or
+    /// stepped. Subclasses that cache register sets must override this;
+    /// the default implementation caches nothing.
+    //------------------------------------------------------------------
+    virtual void
+    InvalidateAllRegisters ();
+
     //------------------------------------------------------------------
     // Subclasses must override these functions
     //------------------------------------------------------------------
-    // virtual void
-    // InvalidateAllRegisters () = 0;
 
     virtual uint32_t
     GetRegisterCount () const = 0;
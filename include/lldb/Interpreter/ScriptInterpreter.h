@@ -80,6 +80,11 @@ public:
     
     typedef size_t          (*SWIGPythonCalculateNumChildren)                   (void *implementor);
     typedef void*           (*SWIGPythonGetChildAtIndex)                        (void *implementor, uint32_t idx);
+    typedef size_t          (*SWIGPythonGetChildrenInRange)                     (void *implementor,
+                                                                                 const lldb::ValueObjectSP& parent_sp,
+                                                                                 uint32_t start_idx,
+                                                                                 uint32_t count,
+                                                                                 std::vector<lldb::ValueObjectSP> &children);
     typedef int             (*SWIGPythonGetIndexOfChildWithName)                (void *implementor, const char* child_name);
     typedef void*           (*SWIGPythonCastPyObjectToSBValue)                  (void* data);
     typedef lldb::ValueObjectSP  (*SWIGPythonGetValueObjectSPFromSBValue)       (void* data);
@@ -452,6 +457,27 @@ public:
         return lldb::ValueObjectSP();
     }
 
+    //------------------------------------------------------------------
+    /// Fetch up to @a count children, starting at @a start_idx, from a
+    /// scripted synthetic children provider in one call.
+    ///
+    /// @return
+    ///     The number of children appended to @a children, which can
+    ///     be fewer than @a count (or zero) if the provider didn't hand
+    ///     all of them over this time.  UINT32_MAX if the provider
+    ///     doesn't support fetching children in bulk at all, and they
+    ///     always have to be requested one at a time.
+    //------------------------------------------------------------------
+    virtual size_t
+    GetChildrenInRange(const StructuredData::ObjectSP &implementor,
+                       const lldb::ValueObjectSP &parent_sp,
+                       uint32_t start_idx,
+                       uint32_t count,
+                       std::vector<lldb::ValueObjectSP> &children)
+    {
+        return UINT32_MAX;
+    }
+
     virtual int
     GetIndexOfChildWithName(const StructuredData::ObjectSP &implementor, const char *child_name)
     {
@@ -615,6 +641,7 @@ public:
                            SWIGPythonCreateCommandObject swig_create_cmd,
                            SWIGPythonCalculateNumChildren swig_calc_children,
                            SWIGPythonGetChildAtIndex swig_get_child_index,
+                           SWIGPythonGetChildrenInRange swig_get_children_in_range,
                            SWIGPythonGetIndexOfChildWithName swig_get_index_child,
                            SWIGPythonCastPyObjectToSBValue swig_cast_to_sbvalue ,
                            SWIGPythonGetValueObjectSPFromSBValue swig_get_valobj_sp_from_sbvalue,
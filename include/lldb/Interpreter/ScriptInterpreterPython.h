@@ -110,6 +110,9 @@ public:
 
     lldb::ValueObjectSP GetChildAtIndex(const StructuredData::ObjectSP &implementor, uint32_t idx) override;
 
+    size_t GetChildrenInRange(const StructuredData::ObjectSP &implementor, const lldb::ValueObjectSP &parent_sp,
+                              uint32_t start_idx, uint32_t count, std::vector<lldb::ValueObjectSP> &children) override;
+
     int GetIndexOfChildWithName(const StructuredData::ObjectSP &implementor, const char *child_name) override;
 
     bool UpdateSynthProviderInstance(const StructuredData::ObjectSP &implementor) override;
@@ -271,6 +274,7 @@ public:
                            SWIGPythonCreateCommandObject swig_create_cmd,
                            SWIGPythonCalculateNumChildren swig_calc_children,
                            SWIGPythonGetChildAtIndex swig_get_child_index,
+                           SWIGPythonGetChildrenInRange swig_get_children_in_range,
                            SWIGPythonGetIndexOfChildWithName swig_get_index_child,
                            SWIGPythonCastPyObjectToSBValue swig_cast_to_sbvalue ,
                            SWIGPythonGetValueObjectSPFromSBValue swig_get_valobj_sp_from_sbvalue,
@@ -329,6 +333,12 @@ protected:
     
     void
     LeaveSession ();
+
+    void
+    SetDebuggerGlobals ();
+
+    void
+    SetSelectionGlobals ();
     
     void
     SaveTerminalState (int fd);
@@ -358,7 +368,8 @@ public:
             AcquireLock         = 0x0001,
             InitSession         = 0x0002,
             InitGlobals         = 0x0004,
-            NoSTDIN             = 0x0008
+            NoSTDIN             = 0x0008,
+            InitDebugger        = 0x0010     // without InitSession: only make lldb.debugger ours, leave sys.std* alone
         };
         
         enum OnLeave
@@ -435,6 +446,9 @@ protected:
     PythonDictionary &
     GetSysModuleDictionary ();
 
+    PythonObject &
+    GetLLDBModule ();
+
     bool
     GetEmbeddedInterpreterModuleObjects ();
     
@@ -445,6 +459,18 @@ protected:
     PythonObject m_lldb_module;
     PythonDictionary m_session_dict;
     PythonDictionary m_sys_module_dict;
+    // The objects we last stored in lldb.debugger, lldb.target, ... and the selection they were made
+    // from, so sessions only have to update the globals when the selection actually changed.
+    PythonObject m_py_debugger;
+    PythonObject m_py_target;
+    PythonObject m_py_process;
+    PythonObject m_py_thread;
+    PythonObject m_py_frame;
+    Target *m_globals_target;
+    Process *m_globals_process;
+    uint32_t m_globals_stop_id;
+    lldb::tid_t m_globals_tid;
+    uint32_t m_globals_frame_idx;
     PythonObject m_run_one_line_function;
     PythonObject m_run_one_line_str_global;
     std::string m_dictionary_name;
@@ -245,6 +245,21 @@ public:
     LineTable*
     GetLineTable ();
 
+    //------------------------------------------------------------------
+    /// Check if the line table has been parsed, without parsing it.
+    ///
+    /// SymbolFile plug-ins can use this to answer a single address
+    /// lookup from part of the line table instead of parsing all of it.
+    ///
+    /// @return
+    ///     \b true if GetLineTable() won't need to parse anything.
+    //------------------------------------------------------------------
+    bool
+    HasParsedLineTable () const
+    {
+        return m_flags.Test(flagsParsedLineTable);
+    }
+
     //------------------------------------------------------------------
     /// Get the compile unit's support file list.
     ///
@@ -10,6 +10,7 @@
 #ifndef liblldb_DWARFCallFrameInfo_h_
 #define liblldb_DWARFCallFrameInfo_h_
 
+#include <atomic>
 #include <map>
 
 #include "lldb/Core/AddressRange.h"
@@ -122,6 +123,25 @@ private:
     void
     GetFDEIndex ();
 
+    // Read the function range of the FDE at fde_offset in the CFI data.
+    bool
+    GetFDEEntryAtOffset (dw_offset_t fde_offset, FDEEntryMap::Entry& fde_entry);
+
+    // Locate the .eh_frame_hdr section that the linker emits next to
+    // .eh_frame (the one PT_GNU_EH_FRAME points to) and check that its
+    // binary search table is usable.  Returns true if it is.
+    bool
+    HasEHFrameHeader ();
+
+    // Fill in the m_hdr_* fields, called once with m_fde_index_mutex held.
+    bool
+    ParseEHFrameHeader ();
+
+    // Binary search the .eh_frame_hdr table for the FDE covering file_addr,
+    // without building m_fde_index.
+    bool
+    GetFDEEntryFromEHFrameHeader (lldb::addr_t file_addr, FDEEntryMap::Entry& fde_entry);
+
     bool
     FDEToUnwindPlan (uint32_t offset, Address startaddr, UnwindPlan& unwind_plan);
 
@@ -142,7 +162,15 @@ private:
 
     FDEEntryMap                 m_fde_index;
     bool                        m_fde_index_initialized;  // only scan the section for FDEs once
-    Mutex                       m_fde_index_mutex;        // and isolate the thread that does it
+    Mutex                       m_fde_index_mutex;        // and isolate the thread that does it; also guards m_cie_map
+
+    DataExtractor               m_hdr_data;               // contents of .eh_frame_hdr
+    lldb::addr_t                m_hdr_addr;               // file address of .eh_frame_hdr
+    lldb::offset_t              m_hdr_table_offset;       // offset of the search table in m_hdr_data
+    uint32_t                    m_hdr_fde_count;          // number of (initial location, FDE address) pairs
+    uint8_t                     m_hdr_table_encoding;     // DW_EH_PE encoding of both fields of a pair
+    uint8_t                     m_hdr_field_size;         // size in bytes of each field of a pair
+    std::atomic<bool>           m_hdr_initialized;        // only look for .eh_frame_hdr once
 
     bool                        m_is_eh_frame;
 
@@ -116,6 +116,9 @@ private:
     UnwindTable& m_unwind_table;
     AddressRange m_range;
 
+    // Guards everything below, including the m_tried bitfields.  The
+    // UnwindTable hands the same FuncUnwinders to every thread that is
+    // being unwound, possibly in parallel.
     Mutex m_mutex;
 
     lldb::UnwindPlanSP              m_unwind_plan_assembly_sp;
@@ -103,7 +103,8 @@ public:
                                bool is_epilogue_begin,
                                bool is_terminal_entry);
 
-    // Insert a sequence of entries into this line table.
+    // Insert a sequence of entries into this line table.  The entries
+    // are moved out of the sequence, which is left empty.
     void
     InsertSequence (LineSequence* sequence);
 
@@ -384,11 +385,116 @@ protected:
     //------------------------------------------------------------------
     typedef std::vector<lldb_private::Section*> section_collection; ///< The collection type for the sections.
     typedef std::vector<Entry>                  entry_collection;   ///< The collection type for the line entries.
+
+    //------------------------------------------------------------------
+    // Line entries are stored encoded, in blocks of kEntriesPerBlock
+    // consecutive entries.  Within a block each entry is an SLEB128
+    // address delta from the previous entry, an SLEB128 line delta, a
+    // ULEB128 column and a ULEB128 file index; the first entry of a block
+    // is relative to the block's file address and to line zero.  The
+    // five flags of each entry are packed separately into
+    // m_entry_flags.  Entries are found by a binary search of the block
+    // index followed by a scan of at most one block.
+    //------------------------------------------------------------------
+    enum
+    {
+        kEntriesPerBlock = 64,
+        kBitsPerEntryFlags = 5
+    };
+
+    struct EntryBlock
+    {
+        lldb::addr_t file_addr;     ///< The file address of the first entry in this block.
+        uint32_t data_offset;       ///< The offset of the first entry in this block within m_entry_data.
+
+        static bool
+        FileAddressLessThan (const EntryBlock &block, lldb::addr_t file_addr)
+        {
+            return block.file_addr < file_addr;
+        }
+    };
+    typedef std::vector<EntryBlock> entry_block_collection;
+
+    //------------------------------------------------------------------
+    // Decodes entries one at a time, starting at any index.  Moving to
+    // the next entry is constant time; positioning the reader scans at
+    // most one block.
+    //------------------------------------------------------------------
+    class EntryReader
+    {
+    public:
+        EntryReader (const LineTable &line_table, uint32_t idx = 0);
+
+        bool
+        IsValid () const
+        {
+            return m_idx < m_line_table.m_num_entries;
+        }
+
+        uint32_t
+        GetIndex () const
+        {
+            return m_idx;
+        }
+
+        const Entry &
+        GetEntry () const
+        {
+            return m_entry;
+        }
+
+        void
+        Next ();
+
+    private:
+        void
+        DecodeEntry ();
+
+        const LineTable &m_line_table;
+        uint32_t m_idx;
+        size_t m_data_offset;
+        Entry m_entry;
+    };
+
     //------------------------------------------------------------------
     // Member variables.
     //------------------------------------------------------------------
     CompileUnit* m_comp_unit;   ///< The compile unit that this line table belongs to.
-    entry_collection m_entries; ///< The collection of line entries in this line table.
+    entry_block_collection m_entry_blocks;  ///< The file address and data offset of every kEntriesPerBlock'th entry.
+    std::vector<uint8_t> m_entry_data;      ///< The encoded addresses, lines, columns and file indexes of all entries.
+    std::vector<uint8_t> m_entry_flags;     ///< The flags of all entries, kBitsPerEntryFlags bits each.
+    uint32_t m_num_entries;                 ///< The number of encoded entries.
+
+    //------------------------------------------------------------------
+    // Sequences and entries inserted since the entries were last encoded.
+    // They are merged into the encoded entries in one pass the next time
+    // the table is searched, so inserting sequences out of address order
+    // doesn't move the rest of the table each time.
+    //------------------------------------------------------------------
+    std::vector<entry_collection> m_pending_sequences;
+    uint32_t m_num_pending_entries;
+
+    //------------------------------------------------------------------
+    // Index for looking up entries by file and line.  For each file
+    // index, the non-terminal entries of that file sorted by line and
+    // then by entry index.  Built by the first lookup and dropped when
+    // entries are added.
+    //------------------------------------------------------------------
+    struct LineIndexEntry
+    {
+        uint32_t line;
+        uint32_t entry_idx;
+
+        static bool
+        LessThan (const LineIndexEntry &lhs, const LineIndexEntry &rhs)
+        {
+            if (lhs.line != rhs.line)
+                return lhs.line < rhs.line;
+            return lhs.entry_idx < rhs.entry_idx;
+        }
+    };
+    typedef std::vector<std::vector<LineIndexEntry> > file_line_index_collection;
+    file_line_index_collection m_file_line_index;
 
     //------------------------------------------------------------------
     // Helper class
@@ -413,6 +519,28 @@ protected:
     bool
     ConvertEntryAtIndexToLineEntry (uint32_t idx, LineEntry &line_entry);
 
+    bool
+    ConvertEntryToLineEntry (const Entry &entry, const Entry *next_entry, LineEntry &line_entry);
+
+    void
+    EncodeEntries (const entry_collection &entries);
+
+    void
+    FinalizeEntries ();
+
+    uint32_t
+    FindFirstEntryIndexAtOrAfter (lldb::addr_t file_addr);
+
+    void
+    BuildFileLineIndex ();
+
+    bool
+    FindInFileLineIndex (uint32_t start_idx,
+                         uint32_t file_idx,
+                         uint32_t line,
+                         bool exact,
+                         LineIndexEntry &match);
+
 private:
     DISALLOW_COPY_AND_ASSIGN (LineTable);
 };
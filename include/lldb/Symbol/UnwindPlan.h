@@ -6,7 +6,10 @@
 #include "lldb/Core/Stream.h"
 #include "lldb/Core/ConstString.h"
 
+#include "llvm/ADT/SmallVector.h"
+
 #include <map>
+#include <utility>
 #include <vector>
 
 namespace lldb_private {
@@ -480,7 +483,20 @@ public:
         Dump (Stream& s, const UnwindPlan* unwind_plan, Thread* thread, lldb::addr_t base_addr) const;
 
     protected:
-        typedef std::map<uint32_t, RegisterLocation> collection;
+        // Register locations sorted by register number.  Rows are copied a
+        // lot (each CFI or assembly profiler row starts out as a copy of the
+        // previous one) and searched on every frame, so they are kept in a
+        // flat array with room for a typical function's callee saved
+        // registers before it has to go to the heap.
+        typedef std::pair<uint32_t, RegisterLocation> RegisterLocationEntry;
+        typedef llvm::SmallVector<RegisterLocationEntry, 8> collection;
+
+        RegisterLocation *
+        FindRegisterLocation (uint32_t reg_num);
+
+        const RegisterLocation *
+        FindRegisterLocation (uint32_t reg_num) const;
+
         lldb::addr_t m_offset;      // Offset into the function for this row
 
         CFAValue m_cfa_value;
@@ -13,6 +13,7 @@
 // C Includes
 // C++ Includes
 #include <map>
+#include <memory>
 #include <vector>
 
 // Other libraries and framework includes
@@ -26,10 +27,46 @@ namespace lldb_private {
     //----------------------------------------------------------------------
     // A class to track memory that was read from a live process between 
     // runs. 
+    //
+    // Lines live in two tiers. A small direct mapped L1 table remembers
+    // the most recently used lines so that the typical run of small reads
+    // from the same few lines skips the map lookup, and the L2 maps hold
+    // every line read since the process last stopped. Lines inside loaded
+    // sections that aren't writable go in their own map that is kept
+    // across resumes; everything else is dropped by ClearVolatile () when
+    // the process stops again. Line storage comes from fixed size slabs
+    // instead of a heap buffer per line.
+    //
+    // Misses on consecutive lines are taken as a sequential scan and each
+    // one reads twice as many lines ahead as the previous one, up to
+    // k_max_prefetch_lines, so walking a large block costs a handful of
+    // reads instead of one per line.
     //----------------------------------------------------------------------
     class MemoryCache
     {
     public:
+        struct Stats
+        {
+            Stats () :
+                l1_hits (0),
+                l2_hits (0),
+                misses (0),
+                uncached_reads (0),
+                inferior_reads (0),
+                prefetched_lines (0),
+                bytes_transferred (0)
+            {
+            }
+
+            uint64_t l1_hits;           // Lines found in the L1 table
+            uint64_t l2_hits;           // Lines found in the line maps
+            uint64_t misses;            // Lines that had to be read from the inferior
+            uint64_t uncached_reads;    // Reads larger than a line that bypass the cache
+            uint64_t inferior_reads;    // Calls to Process::ReadMemoryFromInferior
+            uint64_t prefetched_lines;  // Lines read ahead of being asked for
+            uint64_t bytes_transferred; // Bytes read from the inferior
+        };
+
         //------------------------------------------------------------------
         // Constructors and Destructors
         //------------------------------------------------------------------
@@ -37,9 +74,26 @@ namespace lldb_private {
         
         ~MemoryCache ();
         
+        //------------------------------------------------------------------
+        /// Drop every cached line, including the read-only ones.
+        //------------------------------------------------------------------
         void
         Clear(bool clear_invalid_ranges = false);
         
+        //------------------------------------------------------------------
+        /// Drop the lines that may have changed while the process ran,
+        /// keeping the lines from read-only sections.
+        //------------------------------------------------------------------
+        void
+        ClearVolatile ();
+
+        //------------------------------------------------------------------
+        /// Drop only the lines from read-only sections, e.g. because the
+        /// modules they belong to were unloaded.
+        //------------------------------------------------------------------
+        void
+        ClearReadOnly ();
+
         void
         Flush (lldb::addr_t addr, size_t size);
         
@@ -48,6 +102,24 @@ namespace lldb_private {
               void *dst, 
               size_t dst_len,
               Error &error);
+
+        //------------------------------------------------------------------
+        /// Fill the cache lines that cover [addr, addr + size) using as few
+        /// reads from the inferior as possible.  Lines that are already
+        /// cached or that start in an invalid range are left alone.
+        //------------------------------------------------------------------
+        void
+        Prefetch (lldb::addr_t addr, size_t size);
+
+        //------------------------------------------------------------------
+        /// Batched form of Prefetch() for many small objects, e.g. the
+        /// strings behind an array of char pointers.  Fills the lines that
+        /// hold the first @a size bytes at each address in @a addrs, never
+        /// past the end of the page the address lives in.  Missing lines
+        /// that are contiguous or share a page are fetched with one read.
+        //------------------------------------------------------------------
+        void
+        Prefetch (const std::vector<lldb::addr_t> &addrs, size_t size);
         
         uint32_t
         GetMemoryCacheLineSize() const
@@ -61,18 +133,88 @@ namespace lldb_private {
         bool
         RemoveInvalidRange (lldb::addr_t base_addr, lldb::addr_t byte_size);
 
+        Stats
+        GetStats () const;
+
+        void
+        ResetStats ();
+
+        void
+        DumpStats (Stream &s) const;
+
     protected:
-        typedef std::map<lldb::addr_t, lldb::DataBufferSP> BlockMap;
+        struct CacheLine
+        {
+            uint8_t *bytes;
+            uint32_t byte_size;  // Less than the line size if the read came up short
+        };
+
+        struct L1Entry
+        {
+            lldb::addr_t line_addr;
+            const CacheLine *line;
+        };
+
+        enum
+        {
+            k_num_l1_entries = 16,      // Must be a power of two
+            k_lines_per_slab = 64,
+            k_max_prefetch_lines = 32
+        };
+
+        typedef std::map<lldb::addr_t, CacheLine> BlockMap;
         typedef RangeArray<lldb::addr_t, lldb::addr_t, 4> InvalidRanges;
         //------------------------------------------------------------------
         // Classes that inherit from MemoryCache can see and modify these
         //------------------------------------------------------------------
         Process &m_process;
         uint32_t m_cache_line_byte_size;
-        Mutex m_mutex;
-        BlockMap m_cache;
+        mutable Mutex m_mutex;
+        BlockMap m_cache;               // Lines dropped when the process stops
+        BlockMap m_read_only_cache;     // Lines from read-only sections, kept across resumes
+        L1Entry m_l1[k_num_l1_entries];
         InvalidRanges m_invalid_ranges;
+        std::vector<std::unique_ptr<uint8_t[]>> m_slabs;
+        size_t m_slab_bytes_used;       // Bytes handed out from m_slabs.back()
+        std::vector<uint8_t *> m_free_lines;
+        lldb::addr_t m_next_sequential_line_addr;
+        uint32_t m_prefetch_lines;
+        Stats m_stats;
+
     private:
+        const CacheLine *
+        FindLine (lldb::addr_t line_addr);
+
+        const CacheLine *
+        InsertLine (lldb::addr_t line_addr, const uint8_t *bytes, uint32_t byte_size);
+
+        const CacheLine *
+        ReadLines (lldb::addr_t line_addr, Error &error);
+
+        size_t
+        ReadFromInferior (lldb::addr_t addr, void *dst, size_t dst_len, Error &error);
+
+        uint8_t *
+        AllocateLine ();
+
+        void
+        ReleaseLines (BlockMap &lines);
+
+        void
+        InvalidateL1 (lldb::addr_t line_addr);
+
+        void
+        InvalidateL1 ();
+
+        bool
+        IsReadOnlyLine (lldb::addr_t line_addr);
+
+        bool
+        LineIsCached (lldb::addr_t line_addr) const;
+
+        void
+        FillLines (const std::vector<lldb::addr_t> &line_addrs);
+
         DISALLOW_COPY_AND_ASSIGN (MemoryCache);
     };
 
@@ -18,6 +18,7 @@
 // C++ Includes
 #include <list>
 #include <iosfwd>
+#include <map>
 #include <vector>
 
 // Other libraries and framework includes
@@ -66,6 +67,9 @@ public:
     uint64_t
     GetMemoryCacheLineSize () const;
 
+    bool
+    GetForceLiveMemoryReads () const;
+
     Args
     GetExtraStartupCommands () const;
 
@@ -1857,6 +1861,13 @@ public:
     void
     ModulesDidLoad (ModuleList &module_list);
 
+    //------------------------------------------------------------------
+    /// Forget the memory cached for the sections of modules that are
+    /// going away, since their address ranges can be reused.
+    //------------------------------------------------------------------
+    void
+    ModulesDidUnload (ModuleList &module_list);
+
 protected:
     
     void
@@ -2096,7 +2107,8 @@ public:
     /// Read a NULL terminated C string from memory
     ///
     /// This function will read a cache page at a time until the NULL
-    /// C string terminator is found. It will stop reading if the NULL
+    /// C string terminator is found. Once a string runs past its first
+    /// cache page the rest of the memory page is fetched in one read. It will stop reading if the NULL
     /// termination byte isn't found before reading \a cstr_max_len
     /// bytes, and the results are always guaranteed to be NULL 
     /// terminated (at most cstr_max_len - 1 bytes will be read).
@@ -2117,6 +2129,38 @@ public:
                             void *buf, 
                             size_t size,
                             Error &error);
+
+    //------------------------------------------------------------------
+    /// Warm the memory cache with the first \a byte_size bytes at each
+    /// address in \a addrs, batching the reads so that objects packed
+    /// close together in memory share a single request to the inferior.
+    ///
+    /// Summary formatters call this before summarizing many strings at
+    /// once so the per-string reads that follow are served from the
+    /// cache. Does nothing when the memory cache is disabled.
+    //------------------------------------------------------------------
+    void
+    PrefetchMemory (const std::vector<lldb::addr_t> &addrs,
+                    size_t byte_size);
+
+    //------------------------------------------------------------------
+    /// Warm the memory cache with the \a byte_size bytes at \a addr,
+    /// e.g. the elements of an array that are about to be read one at a
+    /// time. Does nothing when the memory cache is disabled.
+    //------------------------------------------------------------------
+    void
+    PrefetchMemory (lldb::addr_t addr,
+                    size_t byte_size);
+
+    //------------------------------------------------------------------
+    /// The cache that ReadMemory serves reads from while the memory
+    /// cache is enabled.
+    //------------------------------------------------------------------
+    MemoryCache &
+    GetMemoryCache ()
+    {
+        return m_memory_cache;
+    }
     
     //------------------------------------------------------------------
     /// Reads an unsigned integer of the specified byte size from 
@@ -2594,6 +2638,20 @@ public:
     virtual Error
     DisableSoftwareBreakpoint (BreakpointSite *bp_site);
 
+    //------------------------------------------------------------------
+    /// Ask whether resuming a thread that sits on \a bp_site moves it
+    /// past the breakpoint without any help.
+    ///
+    /// Processes whose debug server steps threads over its own breakpoints
+    /// (without removing them from memory) return \b true, and the thread
+    /// then doesn't push a ThreadPlanStepOverBreakpoint.
+    //------------------------------------------------------------------
+    virtual bool
+    StepsOverBreakpointSiteOnResume (BreakpointSite *bp_site)
+    {
+        return false;
+    }
+
     BreakpointSiteList &
     GetBreakpointSiteList();
 
@@ -3138,6 +3196,8 @@ protected:
     Predicate<bool>             m_iohandler_sync;
     MemoryCache                 m_memory_cache;
     AllocatedMemoryCache        m_allocated_memory_cache;
+    Mutex                       m_file_sections_mutex;
+    std::map<const Section *, bool> m_file_sections_match_memory; // Whether a read-only section can be read from its object file; false once written to
     bool                        m_should_detach;   /// Should we detach if the process object goes away with an explicit call to Kill or Detach?
     LanguageRuntimeCollection   m_language_runtimes;
     InstrumentationRuntimeCollection m_instrumentation_runtimes;
@@ -3165,6 +3225,14 @@ protected:
     size_t
     RemoveBreakpointOpcodesFromBuffer (lldb::addr_t addr, size_t size, uint8_t *buf) const;
 
+    //------------------------------------------------------------------
+    /// Drop any cached memory covering a breakpoint site.  Call it
+    /// whenever a trap is written to or removed from memory, including
+    /// by a remote stub, since those writes bypass WriteMemory.
+    //------------------------------------------------------------------
+    void
+    FlushBreakpointSiteMemory (lldb::addr_t addr, size_t size);
+
     void
     SynchronouslyNotifyStateChanged (lldb::StateType state);
 
@@ -3214,6 +3282,24 @@ protected:
 
     size_t
     WriteMemoryPrivate (lldb::addr_t addr, const void *buf, size_t size, Error &error);
+
+    void
+    PrefetchStringTail (lldb::addr_t addr, size_t max_bytes);
+
+    size_t
+    ReadMemoryFromObjectFile (lldb::addr_t addr, void *buf, size_t size);
+
+    bool
+    FileSectionMatchesMemory (const lldb::SectionSP &section_sp, lldb::addr_t load_addr);
+
+    bool
+    FileSectionBytesMatchMemory (const lldb::SectionSP &section_sp, lldb::addr_t offset, lldb::addr_t load_addr, size_t size, bool &matches);
+
+    void
+    FileSectionsWritten (lldb::addr_t addr, size_t size);
+
+    void
+    ClearFileSections ();
     
     void
     AppendSTDOUT (const char *s, size_t len);
@@ -13,6 +13,7 @@
 // C Includes
 // C++ Includes
 #include <map>
+#include <vector>
 
 // Other libraries and framework includes
 #include "llvm/ADT/DenseMap.h"
@@ -60,6 +61,11 @@ public:
     bool
     ResolveLoadAddress (lldb::addr_t load_addr, Address &so_addr) const;
 
+    // Append the top level sections that overlap [addr, addr + size) to
+    // "sections" and return how many were found.
+    size_t
+    FindSectionsInRange (lldb::addr_t addr, lldb::addr_t size, std::vector<lldb::SectionSP> &sections) const;
+
     bool
     SetSectionLoadAddress (const lldb::SectionSP &section_sp, lldb::addr_t load_addr, bool warn_multiple = false);
 
@@ -122,6 +122,39 @@ public:
     void
     DiscardThreadPlans();
 
+    //------------------------------------------------------------------
+    /// Unwind and symbolicate the stacks of several threads at once.
+    ///
+    /// Each worker repeatedly takes the next thread in @a threads and
+    /// computes its frames [0, @a end_frame_idx), resolving the full
+    /// symbol context of every frame.  The results are cached in each
+    /// thread's StackFrameList, so displaying the threads afterwards, in
+    /// whatever order, doesn't unwind or look up symbols again.
+    ///
+    /// The process must be stopped for the whole call.
+    ///
+    /// @param[in] threads
+    ///     The threads to unwind.
+    ///
+    /// @param[in] end_frame_idx
+    ///     One past the last frame index to compute, or UINT32_MAX for
+    ///     the complete stacks.
+    ///
+    /// @param[in] num_workers
+    ///     The number of host threads to use, including the calling one.
+    ///     Zero means one per CPU.
+    //------------------------------------------------------------------
+    static void
+    FetchStackFrames (const collection &threads,
+                      uint32_t end_frame_idx,
+                      uint32_t num_workers);
+
+    //------------------------------------------------------------------
+    /// Same as above, for every thread in the list.
+    //------------------------------------------------------------------
+    void
+    FetchStackFrames (uint32_t end_frame_idx, uint32_t num_workers);
+
     uint32_t
     GetStopID () const;
 
@@ -164,6 +164,15 @@ public:
     lldb::SBThread
     GetSelectedThread () const;
 
+    %feature("autodoc", "
+    Unwinds and symbolicates up to MAX_FRAMES frames of every thread using
+    NUM_WORKERS host threads (0 for one per CPU), so that walking the frames
+    of the threads afterwards is cheap.  Returns False if the process isn't
+    stopped.
+    ") FetchThreadStackFrames;
+    bool
+    FetchThreadStackFrames (uint32_t max_frames, uint32_t num_workers);
+
     %feature("autodoc", "
     Lazily create a thread on demand through the current OperatingSystem plug-in, if the current OperatingSystem plug-in supports it.
     ") CreateOSPluginThread;
@@ -631,6 +631,13 @@ LLDBSwigPython_CalculateNumChildren (void *implementor);
 extern "C" void *
 LLDBSwigPython_GetChildAtIndex (void *implementor, uint32_t idx);
 
+extern "C" size_t
+LLDBSwigPython_GetChildrenInRange (void *implementor,
+                                   const lldb::ValueObjectSP& parent_sp,
+                                   uint32_t start_idx,
+                                   uint32_t count,
+                                   std::vector<lldb::ValueObjectSP> &children);
+
 extern "C" int
 LLDBSwigPython_GetIndexOfChildWithName (void *implementor, const char* child_name);
 
@@ -728,6 +735,7 @@ SBCommandInterpreter::InitializeSWIG ()
                                                   LLDBSwigPythonCreateCommandObject,
                                                   LLDBSwigPython_CalculateNumChildren,
                                                   LLDBSwigPython_GetChildAtIndex,
+                                                  LLDBSwigPython_GetChildrenInRange,
                                                   LLDBSwigPython_GetIndexOfChildWithName,
                                                   LLDBSWIGPython_CastPyObjectToSBValue,
                                                   LLDBSWIGPython_GetValueObjectSPFromSBValue,
@@ -958,6 +958,30 @@ SBProcess::GetThreadByIndexID (uint32_t index_id)
     return sb_thread;
 }
 
+bool
+SBProcess::FetchThreadStackFrames (uint32_t max_frames, uint32_t num_workers)
+{
+    bool success = false;
+    ProcessSP process_sp(GetSP());
+    if (process_sp)
+    {
+        Process::StopLocker stop_locker;
+        if (stop_locker.TryLock(&process_sp->GetRunLock()))
+        {
+            Mutex::Locker api_locker (process_sp->GetTarget().GetAPIMutex());
+            process_sp->GetThreadList().FetchStackFrames (max_frames, num_workers);
+            success = true;
+        }
+    }
+
+    Log *log(lldb_private::GetLogIfAllCategoriesSet (LIBLLDB_LOG_API));
+    if (log)
+        log->Printf ("SBProcess(%p)::FetchThreadStackFrames (max_frames=%u, num_workers=%u) => %i",
+                     static_cast<void*>(process_sp.get()), max_frames, num_workers, success);
+
+    return success;
+}
+
 StateType
 SBProcess::GetStateFromEvent (const SBEvent &event)
 {
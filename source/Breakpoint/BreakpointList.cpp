@@ -11,8 +11,16 @@
 
 // C Includes
 // C++ Includes
+#include <map>
+
 // Other libraries and framework includes
 // Project includes
+#include "lldb/Breakpoint/BreakpointLocation.h"
+#include "lldb/Breakpoint/BreakpointResolver.h"
+#include "lldb/Core/Log.h"
+#include "lldb/Core/Module.h"
+#include "lldb/Core/Section.h"
+#include "lldb/Symbol/SymbolContext.h"
 #include "lldb/Target/Target.h"
 
 using namespace lldb;
@@ -213,11 +221,122 @@ void
 BreakpointList::UpdateBreakpoints (ModuleList& module_list, bool added, bool delete_locations)
 {
     Mutex::Locker locker(m_mutex);
+    if (added)
+    {
+        UpdateBreakpointsForLoadedModules (module_list);
+        return;
+    }
+
     for (const auto &bp_sp : m_breakpoints)
         bp_sp->ModulesChanged (module_list, added, delete_locations);
 
 }
 
+static bool
+BreakpointHasLocationInModule (Breakpoint &bp, const ModuleSP &module_sp)
+{
+    const size_t num_locations = bp.GetNumLocations ();
+    for (size_t i = 0; i < num_locations; ++i)
+    {
+        SectionSP section_sp (bp.GetLocationAtIndex (i)->GetAddress ().GetSection ());
+        if (!section_sp || section_sp->GetModule () == module_sp)
+            return true;
+    }
+    return false;
+}
+
+void
+BreakpointList::UpdateBreakpointsForLoadedModules (ModuleList &module_list)
+{
+    // Breakpoints whose resolvers can only find locations by looking up a
+    // fixed set of names (the common case for pending "break set -n"
+    // breakpoints) don't need to search a module that defines none of
+    // those names.  Look each distinct name up once per module and hand
+    // every such breakpoint only the modules where one of its names hit;
+    // everything else searches all the modules as before.
+    typedef std::map<BreakpointResolver::NameLookup, size_t> NameIndexMap;
+    NameIndexMap name_indexes;
+    std::vector<BreakpointResolver::NameLookup> names;
+    std::vector<std::vector<size_t>> bp_name_indexes;
+    std::vector<BreakpointSP> indexed_bps;
+
+    for (const auto &bp_sp : m_breakpoints)
+    {
+        std::vector<BreakpointResolver::NameLookup> bp_names;
+        BreakpointResolverSP resolver_sp (bp_sp->GetResolver ());
+        if (!resolver_sp || !resolver_sp->GetLookupNames (bp_names))
+        {
+            bp_sp->ModulesChanged (module_list, true, false);
+            continue;
+        }
+
+        std::vector<size_t> indexes;
+        for (const auto &name : bp_names)
+        {
+            auto insert_result = name_indexes.insert (NameIndexMap::value_type (name, names.size ()));
+            if (insert_result.second)
+                names.push_back (name);
+            indexes.push_back (insert_result.first->second);
+        }
+        indexed_bps.push_back (bp_sp);
+        bp_name_indexes.push_back (std::move (indexes));
+    }
+
+    if (indexed_bps.empty ())
+        return;
+
+    std::vector<ModuleList> bp_modules (indexed_bps.size ());
+    {
+        Mutex::Locker modules_locker (module_list.GetMutex ());
+        std::vector<bool> name_found (names.size ());
+        SymbolContextList sc_list;
+        for (ModuleSP module_sp : module_list.ModulesNoLocking ())
+        {
+            for (size_t i = 0; i < names.size (); ++i)
+            {
+                const bool include_symbols = true;
+                const bool include_inlines = true;
+                const bool append = false;
+                name_found[i] = module_sp->FindFunctions (names[i].first,
+                                                          NULL,
+                                                          names[i].second,
+                                                          include_symbols,
+                                                          include_inlines,
+                                                          append,
+                                                          sc_list) > 0;
+            }
+
+            for (size_t bp_idx = 0; bp_idx < indexed_bps.size (); ++bp_idx)
+            {
+                bool found = false;
+                for (size_t name_idx : bp_name_indexes[bp_idx])
+                {
+                    if (name_found[name_idx])
+                    {
+                        found = true;
+                        break;
+                    }
+                }
+
+                // Existing locations in the module still need their sites set.
+                if (found || BreakpointHasLocationInModule (*indexed_bps[bp_idx], module_sp))
+                    bp_modules[bp_idx].Append (module_sp);
+            }
+        }
+    }
+
+    Log *log (GetLogIfAllCategoriesSet (LIBLLDB_LOG_BREAKPOINTS));
+    if (log)
+        log->Printf ("BreakpointList::%s looked up %zu names for %zu breakpoints in %zu modules",
+                     __FUNCTION__, names.size (), indexed_bps.size (), module_list.GetSize ());
+
+    for (size_t bp_idx = 0; bp_idx < indexed_bps.size (); ++bp_idx)
+    {
+        if (bp_modules[bp_idx].GetSize () > 0)
+            indexed_bps[bp_idx]->ModulesChanged (bp_modules[bp_idx], true, false);
+    }
+}
+
 void
 BreakpointList::UpdateBreakpointsWhenModuleIsReplaced (ModuleSP old_module_sp, ModuleSP new_module_sp)
 {
@@ -71,10 +71,12 @@ BreakpointResolverFileLine::SearchCallback
     // So we go through the match list and pull out the sets that have the same file spec in their line_entry
     // and treat each set separately.
     
-    const size_t num_comp_units = context.module_sp->GetNumCompileUnits();
-    for (size_t i = 0; i < num_comp_units; i++)
+    // Only visit the compile units that use a file with our basename.
+    std::vector<uint32_t> cu_indexes;
+    context.module_sp->FindCompileUnitIndexesForFile (m_file_spec, cu_indexes);
+    for (uint32_t cu_idx : cu_indexes)
     {
-        CompUnitSP cu_sp (context.module_sp->GetCompileUnitAtIndex (i));
+        CompUnitSP cu_sp (context.module_sp->GetCompileUnitAtIndex (cu_idx));
         if (cu_sp)
         {
             if (filter.CompUnitPasses(*cu_sp))
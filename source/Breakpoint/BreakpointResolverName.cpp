@@ -348,6 +348,19 @@ BreakpointResolverName::SearchCallback
     return Searcher::eCallbackReturnContinue;
 }
 
+bool
+BreakpointResolverName::GetLookupNames (std::vector<NameLookup> &names) const
+{
+    // Regular expressions can match anything, and class/method lookups
+    // aren't done by name yet.
+    if (m_match_type != Breakpoint::Exact || m_class_name)
+        return false;
+
+    for (const LookupInfo &lookup : m_lookups)
+        names.push_back (NameLookup (lookup.lookup_name, lookup.name_type_mask));
+    return true;
+}
+
 Searcher::Depth
 BreakpointResolverName::GetDepth()
 {
@@ -1772,6 +1772,116 @@ protected:
     
 };
 
+//----------------------------------------------------------------------
+// Print statistics for the process memory cache
+//----------------------------------------------------------------------
+class CommandObjectMemoryCacheStats : public CommandObjectParsed
+{
+public:
+    class CommandOptions : public Options
+    {
+    public:
+
+        CommandOptions (CommandInterpreter &interpreter) :
+            Options (interpreter)
+        {
+            OptionParsingStarting ();
+        }
+
+        ~CommandOptions ()
+        {
+        }
+
+        Error
+        SetOptionValue (uint32_t option_idx, const char *option_arg)
+        {
+            Error error;
+            const int short_option = m_getopt_table[option_idx].val;
+
+            switch (short_option)
+            {
+                case 'r':
+                    m_reset = true;
+                    break;
+                default:
+                    error.SetErrorStringWithFormat("invalid short option character '%c'", short_option);
+                    break;
+            }
+            return error;
+        }
+
+        void
+        OptionParsingStarting ()
+        {
+            m_reset = false;
+        }
+
+        const OptionDefinition*
+        GetDefinitions ()
+        {
+            return g_option_table;
+        }
+
+        // Options table: Required for subclasses of Options.
+
+        static OptionDefinition g_option_table[];
+
+        // Instance variables to hold the values for command options.
+        bool m_reset;
+    };
+
+    CommandObjectMemoryCacheStats (CommandInterpreter &interpreter) :
+        CommandObjectParsed (interpreter,
+                             "memory cache-stats",
+                             "Show hit, miss and transfer statistics for the process memory cache.",
+                             "memory cache-stats [--reset]",
+                             eFlagRequiresProcess | eFlagProcessMustBeLaunched),
+        m_options (interpreter)
+    {
+    }
+
+    ~CommandObjectMemoryCacheStats ()
+    {
+    }
+
+    Options *
+    GetOptions ()
+    {
+        return &m_options;
+    }
+
+protected:
+    bool
+    DoExecute (Args& command, CommandReturnObject &result)
+    {
+        if (command.GetArgumentCount() > 0)
+        {
+            result.AppendErrorWithFormat ("%s takes no arguments", m_cmd_name.c_str());
+            result.SetStatus(eReturnStatusFailed);
+            return false;
+        }
+
+        Process *process = m_exe_ctx.GetProcessPtr();
+        MemoryCache &memory_cache = process->GetMemoryCache();
+        if (process->GetDisableMemoryCache())
+            result.AppendMessage ("The memory cache is disabled (target.process.disable-memory-cache).");
+        memory_cache.DumpStats (result.GetOutputStream());
+        if (m_options.m_reset)
+            memory_cache.ResetStats ();
+        result.SetStatus (eReturnStatusSuccessFinishResult);
+        return true;
+    }
+
+    CommandOptions m_options;
+};
+
+OptionDefinition
+CommandObjectMemoryCacheStats::CommandOptions::g_option_table[] =
+{
+{ LLDB_OPT_SET_1, false, "reset", 'r', OptionParser::eNoArgument, NULL, NULL, 0, eArgTypeNone, "Reset the statistics after showing them." },
+{ 0, false, NULL, 0, 0, NULL, NULL, 0, eArgTypeNone, NULL }
+};
+
 
 //-------------------------------------------------------------------------
 // CommandObjectMemory
@@ -1787,6 +1897,7 @@ CommandObjectMemory::CommandObjectMemory (CommandInterpreter &interpreter) :
     LoadSubCommand ("read",  CommandObjectSP (new CommandObjectMemoryRead (interpreter)));
     LoadSubCommand ("write", CommandObjectSP (new CommandObjectMemoryWrite (interpreter)));
     LoadSubCommand ("history", CommandObjectSP (new CommandObjectMemoryHistory (interpreter)));
+    LoadSubCommand ("cache-stats", CommandObjectSP (new CommandObjectMemoryCacheStats (interpreter)));
 }
 
 CommandObjectMemory::~CommandObjectMemory ()
@@ -75,6 +75,11 @@ public:
         else if (command.GetArgumentCount() == 1 && ::strcmp (command.GetArgumentAtIndex(0), "all") == 0)
         {
             Process *process = m_exe_ctx.GetProcessPtr();
+            std::vector<ThreadSP> thread_sps;
+            for (ThreadSP thread_sp : process->Threads())
+                thread_sps.push_back (thread_sp);
+            WillHandleThreads (thread_sps);
+
             uint32_t idx = 0;
             for (ThreadSP thread_sp : process->Threads())
             {
@@ -115,6 +120,12 @@ public:
                 }
                 
             }
+
+            // Don't hold the thread list's mutex while the threads are
+            // prepared, it may be needed on other host threads.
+            locker.Unlock();
+            WillHandleThreads (thread_sps);
+            locker.Lock (process->GetThreadList().GetMutex());
             
             for (uint32_t i = 0; i < num_args; i++)
             {
@@ -140,6 +151,14 @@ protected:
     virtual bool
     HandleOneThread (Thread &thread, CommandReturnObject &result) = 0;
 
+    // Called with all the threads that are about to be handled, before the
+    // first HandleOneThread, when they are given by index or as "all".  The
+    // thread list's mutex is not held during the call.
+    virtual void
+    WillHandleThreads (const std::vector<lldb::ThreadSP> &thread_sps)
+    {
+    }
+
     ReturnStatus m_success_return = eReturnStatusSuccessFinishResult;
     bool m_add_return = true;
 
@@ -196,6 +215,7 @@ public:
                     if (!success)
                         error.SetErrorStringWithFormat("invalid integer value for option '%c'", short_option);
                 }
+                break;
                 case 'e':
                 {
                     bool success;
@@ -204,6 +224,14 @@ public:
                         error.SetErrorStringWithFormat("invalid boolean value for option '%c'", short_option);
                 }
                 break;
+                case 'p':
+                {
+                    bool success;
+                    m_num_workers =  StringConvert::ToUInt32 (option_arg, 0, 0, &success);
+                    if (!success)
+                        error.SetErrorStringWithFormat("invalid integer value for option '%c'", short_option);
+                }
+                break;
                 default:
                     error.SetErrorStringWithFormat("invalid short option character '%c'", short_option);
                     break;
@@ -218,6 +246,7 @@ public:
             m_count = UINT32_MAX;
             m_start = 0;
             m_extended_backtrace = false;
+            m_num_workers = 1;
         }
 
         const OptionDefinition*
@@ -234,6 +263,7 @@ public:
         uint32_t m_count;
         uint32_t m_start;
         bool     m_extended_backtrace;
+        uint32_t m_num_workers;
     };
 
     CommandObjectThreadBacktrace (CommandInterpreter &interpreter) :
@@ -287,6 +317,21 @@ protected:
         }
     }
 
+    virtual void
+    WillHandleThreads (const std::vector<ThreadSP> &thread_sps)
+    {
+        if (m_options.m_num_workers == 1 || thread_sps.size() < 2)
+            return;
+
+        // Unwind everything we are about to print up front, in parallel.
+        // The threads are still displayed one at a time, in order, from
+        // the frames cached in their stack frame lists.
+        uint32_t end_frame_idx = UINT32_MAX;
+        if (m_options.m_count < UINT32_MAX - m_options.m_start)
+            end_frame_idx = m_options.m_start + m_options.m_count;
+        ThreadList::FetchStackFrames (thread_sps, end_frame_idx, m_options.m_num_workers);
+    }
+
     virtual bool
     HandleOneThread (Thread &thread, CommandReturnObject &result)
     {
@@ -321,6 +366,7 @@ CommandObjectThreadBacktrace::CommandOptions::g_option_table[] =
 { LLDB_OPT_SET_1, false, "count", 'c', OptionParser::eRequiredArgument, NULL, NULL, 0, eArgTypeCount, "How many frames to display (-1 for all)"},
 { LLDB_OPT_SET_1, false, "start", 's', OptionParser::eRequiredArgument, NULL, NULL, 0, eArgTypeFrameIndex, "Frame in which to start the backtrace"},
 { LLDB_OPT_SET_1, false, "extended", 'e', OptionParser::eRequiredArgument, NULL, NULL, 0, eArgTypeBoolean, "Show the extended backtrace, if available"},
+{ LLDB_OPT_SET_1, false, "parallel", 'p', OptionParser::eRequiredArgument, NULL, NULL, 0, eArgTypeCount, "Unwind the threads on this many host threads before displaying them (0 for one per CPU)"},
 { 0, false, NULL, 0, 0, NULL, NULL, 0, eArgTypeNone, NULL }
 };
 
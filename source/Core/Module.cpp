@@ -151,8 +151,10 @@ Module::Module (const ModuleSpec &module_spec) :
     m_ast (new ClangASTContext),
     m_source_mappings (),
     m_sections_ap(),
+    m_file_basename_to_cu_index (),
     m_did_load_objfile (false),
     m_did_load_symbol_vendor (false),
+    m_did_index_compile_unit_files (false),
     m_did_parse_uuid (false),
     m_did_init_ast (false),
     m_file_has_changed (false),
@@ -255,8 +257,10 @@ Module::Module(const FileSpec& file_spec,
     m_ast (new ClangASTContext),
     m_source_mappings (),
     m_sections_ap(),
+    m_file_basename_to_cu_index (),
     m_did_load_objfile (false),
     m_did_load_symbol_vendor (false),
+    m_did_index_compile_unit_files (false),
     m_did_parse_uuid (false),
     m_did_init_ast (false),
     m_file_has_changed (false),
@@ -301,8 +305,10 @@ Module::Module () :
     m_ast (new ClangASTContext),
     m_source_mappings (),
     m_sections_ap(),
+    m_file_basename_to_cu_index (),
     m_did_load_objfile (false),
     m_did_load_symbol_vendor (false),
+    m_did_index_compile_unit_files (false),
     m_did_parse_uuid (false),
     m_did_init_ast (false),
     m_file_has_changed (false),
@@ -534,6 +540,55 @@ Module::GetCompileUnitAtIndex (size_t index)
     return cu_sp;
 }
 
+size_t
+Module::FindCompileUnitIndexesForFile (const FileSpec &file_spec, std::vector<uint32_t> &cu_indexes)
+{
+    Mutex::Locker locker (m_mutex);
+    Timer scoped_timer(__PRETTY_FUNCTION__, "Module::FindCompileUnitIndexesForFile (file = %s)", file_spec.GetFilename().AsCString("<NULL>"));
+
+    if (!m_did_index_compile_unit_files)
+    {
+        m_did_index_compile_unit_files = true;
+
+        // Only the support file lists (the line table prologues for DWARF)
+        // are needed here, not the line tables themselves.
+        const size_t num_comp_units = GetNumCompileUnits ();
+        for (size_t cu_idx = 0; cu_idx < num_comp_units; ++cu_idx)
+        {
+            CompUnitSP cu_sp (GetCompileUnitAtIndex (cu_idx));
+            if (!cu_sp)
+                continue;
+
+            const ConstString &cu_basename = cu_sp->GetFilename();
+            if (cu_basename)
+                m_file_basename_to_cu_index.Append (cu_basename.GetCString(), cu_idx);
+
+            const FileSpecList &support_files = cu_sp->GetSupportFiles();
+            const size_t num_files = support_files.GetSize();
+            for (size_t file_idx = 0; file_idx < num_files; ++file_idx)
+            {
+                const ConstString &basename = support_files.GetFileSpecAtIndex (file_idx).GetFilename();
+                if (basename && basename != cu_basename)
+                    m_file_basename_to_cu_index.Append (basename.GetCString(), cu_idx);
+            }
+        }
+        m_file_basename_to_cu_index.Sort();
+    }
+
+    const ConstString &basename = file_spec.GetFilename();
+    if (!basename)
+        return 0;
+
+    // A compile unit shows up once for each of its files with this basename.
+    std::vector<uint32_t> matches;
+    m_file_basename_to_cu_index.GetValues (basename.GetCString(), matches);
+    std::sort (matches.begin(), matches.end());
+    matches.erase (std::unique (matches.begin(), matches.end()), matches.end());
+
+    cu_indexes.insert (cu_indexes.end(), matches.begin(), matches.end());
+    return matches.size();
+}
+
 bool
 Module::ResolveFileAddress (lldb::addr_t vm_addr, Address& so_addr)
 {
@@ -1497,6 +1552,8 @@ Module::SetSymbolFileFileSpec (const FileSpec &file)
     m_symfile_spec = file;
     m_symfile_ap.reset();
     m_did_load_symbol_vendor = false;
+    m_file_basename_to_cu_index.Clear();
+    m_did_index_compile_unit_files = false;
 }
 
 bool
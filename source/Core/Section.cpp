@@ -43,6 +43,7 @@ Section::Section (const ModuleSP &module_sp,
     m_file_offset   (file_offset),
     m_file_size     (file_size),
     m_log2align     (log2align),
+    m_permissions   (0),
     m_children      (),
     m_fake          (false),
     m_encrypted     (false),
@@ -78,6 +79,7 @@ Section::Section (const lldb::SectionSP &parent_section_sp,
     m_file_offset   (file_offset),
     m_file_size     (file_size),
     m_log2align     (log2align),
+    m_permissions   (0),
     m_children      (),
     m_fake          (false),
     m_encrypted     (false),
@@ -822,6 +822,13 @@ ValueObject::CreateChildAtIndex (size_t idx, bool synthetic_array_member, int32_
 {
     ValueObject *valobj = NULL;
     
+    if (!synthetic_array_member)
+    {
+        valobj = CreateArrayElementAtIndex (idx);
+        if (valobj)
+            return valobj;
+    }
+    
     bool omit_empty_base_classes = true;
     bool ignore_array_bounds = synthetic_array_member;
     std::string child_name_str;
@@ -876,6 +883,53 @@ ValueObject::CreateChildAtIndex (size_t idx, bool synthetic_array_member, int32_
     return valobj;
 }
 
+ValueObject *
+ValueObject::CreateArrayElementAtIndex (size_t idx)
+{
+    ClangASTType element_type;
+    uint64_t element_count = 0;
+    if (!GetClangType().IsArrayType (&element_type, &element_count, NULL) || idx >= element_count)
+        return NULL;
+    if (!element_type.GetCompleteType())
+        return NULL;
+    
+    ExecutionContext exe_ctx (GetExecutionContextRef());
+    const uint64_t element_byte_size = element_type.GetByteSize (exe_ctx.GetBestExecutionContextScope());
+    if (element_byte_size == 0 || element_byte_size > UINT32_MAX)
+        return NULL;
+    
+    if (!m_children.HasChildrenInPage (idx))
+    {
+        // This is the first element made in its page, read the whole page
+        // now rather than one element at a time.  Really big elements are
+        // left to the memory cache's own read-ahead.
+        const uint64_t max_prefetch_byte_size = 64 * 1024;
+        AddressType address_type = eAddressTypeInvalid;
+        const lldb::addr_t array_addr = GetAddressOf (true, &address_type);
+        lldb::ProcessSP process_sp (GetProcessSP());
+        if (process_sp && address_type == eAddressTypeLoad && array_addr != LLDB_INVALID_ADDRESS)
+        {
+            const uint64_t first_idx = idx - idx % ChildrenManager::kPageSize;
+            const uint64_t end_idx = std::min<uint64_t> (first_idx + ChildrenManager::kPageSize, element_count);
+            process_sp->PrefetchMemory (array_addr + first_idx * element_byte_size,
+                                        std::min<uint64_t> ((end_idx - first_idx) * element_byte_size, max_prefetch_byte_size));
+        }
+    }
+    
+    char element_name[64];
+    ::snprintf (element_name, sizeof (element_name), "[%zu]", idx);
+    return new ValueObjectChild (*this,
+                                 element_type,
+                                 ConstString (element_name),
+                                 element_byte_size,
+                                 (int32_t)idx * (int32_t)element_byte_size,
+                                 0,
+                                 0,
+                                 false,
+                                 false,
+                                 eAddressTypeInvalid);
+}
+
 bool
 ValueObject::GetSummaryAsCString (TypeSummaryImpl* summary_ptr,
                                   std::string& destination)
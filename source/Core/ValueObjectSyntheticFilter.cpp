@@ -13,6 +13,7 @@
 
 // C Includes
 // C++ Includes
+#include <algorithm>
 // Other libraries and framework includes
 // Project includes
 #include "lldb/Core/ValueObject.h"
@@ -63,6 +64,8 @@ ValueObjectSynthetic::ValueObjectSynthetic (ValueObject &parent, lldb::Synthetic
     ValueObject(parent),
     m_synth_sp(filter),
     m_children_byindex(),
+    m_paged_children(),
+    m_fetched_pages(),
     m_name_toindex(),
     m_synthetic_children_count(UINT32_MAX),
     m_parent_type_name(parent.GetTypeName()),
@@ -183,6 +186,8 @@ ValueObjectSynthetic::UpdateValue ()
     {
         // filter said that cached values are stale
         m_children_byindex.Clear();
+        m_paged_children.Clear();
+        m_fetched_pages.Clear();
         m_name_toindex.Clear();
         // usually, an object's value can change but this does not alter its children count
         // for a synthetic VO that might indeed happen, so we need to tell the upper echelons
@@ -221,7 +226,10 @@ ValueObjectSynthetic::GetChildAtIndex (size_t idx, bool can_create)
     {
         if (can_create && m_synth_filter_ap.get() != NULL)
         {
-            lldb::ValueObjectSP synth_guy = m_synth_filter_ap->GetChildAtIndex (idx);
+            lldb::ValueObjectSP synth_guy = FetchChildPage (idx);
+            if (synth_guy)
+                return synth_guy;
+            synth_guy = m_synth_filter_ap->GetChildAtIndex (idx);
             if (!synth_guy)
                 return synth_guy;
             m_children_byindex.SetValueForKey(idx, synth_guy.get());
@@ -234,6 +242,56 @@ ValueObjectSynthetic::GetChildAtIndex (size_t idx, bool can_create)
         return valobj->GetSP();
 }
 
+// Children are mostly asked for in order (printing a value, or an IDE showing a window of
+// them), so fetch the whole page around the requested one; for scripted front-ends that is
+// one trip into the script interpreter instead of one per child.
+lldb::ValueObjectSP
+ValueObjectSynthetic::FetchChildPage (size_t idx)
+{
+    static const size_t g_child_page_size = 64;
+
+    const size_t page_start = idx - (idx % g_child_page_size);
+    size_t page_count = g_child_page_size;
+    if (m_synthetic_children_count < UINT32_MAX)
+    {
+        if (page_start >= m_synthetic_children_count)
+            return lldb::ValueObjectSP();
+        page_count = std::min<size_t> (page_count, m_synthetic_children_count - page_start);
+    }
+
+    // Only ask for each page once.  If the front-end didn't hand over all of it, the children
+    // that are still missing are fetched one at a time by our caller.
+    bool fetched;
+    if (m_fetched_pages.GetValueForKey (page_start, fetched))
+        return lldb::ValueObjectSP();
+    m_fetched_pages.SetValueForKey (page_start, true);
+
+    std::vector<lldb::ValueObjectSP> children;
+    const size_t num_fetched = std::min (m_synth_filter_ap->GetChildrenInRange (page_start, page_count, children),
+                                         children.size());
+
+    lldb::ValueObjectSP child_sp;
+    for (size_t i = 0; i < num_fetched; ++i)
+    {
+        if (!children[i])
+            break;
+        const uint32_t child_idx = page_start + i;
+        ValueObject *valobj;
+        if (m_children_byindex.GetValueForKey (child_idx, valobj))
+        {
+            // Somebody got here first; keep the child everyone already has.
+            if (child_idx == idx)
+                child_sp = valobj->GetSP();
+            continue;
+        }
+        m_paged_children.SetValueForKey (child_idx, children[i]);
+        m_children_byindex.SetValueForKey (child_idx, children[i].get());
+        if (child_idx == idx)
+            child_sp = children[i];
+    }
+    return child_sp;
+}
+
 lldb::ValueObjectSP
 ValueObjectSynthetic::GetChildMemberWithName (const ConstString &name, bool can_create)
 {
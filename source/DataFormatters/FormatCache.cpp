@@ -161,41 +161,52 @@ FormatCache::Entry::SetValidator (lldb::TypeValidatorImplSP validator_sp)
 }
 
 FormatCache::FormatCache () :
-m_map(),
-m_mutex (Mutex::eMutexTypeRecursive)
-#ifdef LLDB_CONFIGURATION_DEBUG
-,m_cache_hits(0),m_cache_misses(0)
-#endif
+m_shards(),
+m_cache_hits(0),
+m_cache_misses(0)
 {
 }
 
-FormatCache::Entry&
-FormatCache::GetEntry (const ConstString& type)
+FormatCache::Shard&
+FormatCache::GetShard (const ConstString& type)
 {
-    auto i = m_map.find(type),
-    e = m_map.end();
-    if (i != e)
-        return i->second;
-    m_map[type] = FormatCache::Entry();
-    return m_map[type];
+    return m_shards[ConstStringHasher()(type) % kNumShards];
 }
 
 bool
-FormatCache::GetFormat (const ConstString& type,lldb::TypeFormatImplSP& format_sp)
+FormatCache::LookupEntry (const ConstString& type, Entry& entry)
+{
+    Shard& shard = GetShard(type);
+    llvm::sys::ScopedReader lock(shard.m_mutex);
+    auto pos = shard.m_map.find(type);
+    if (pos == shard.m_map.end())
+        return false;
+    entry = pos->second;
+    return true;
+}
+
+void
+FormatCache::CountLookup (bool hit)
 {
-    Mutex::Locker lock(m_mutex);
-    auto entry = GetEntry(type);
-    if (entry.IsSummaryCached())
-    {
 #ifdef LLDB_CONFIGURATION_DEBUG
-        m_cache_hits++;
+    if (hit)
+        m_cache_hits.fetch_add(1, std::memory_order_relaxed);
+    else
+        m_cache_misses.fetch_add(1, std::memory_order_relaxed);
 #endif
+}
+
+bool
+FormatCache::GetFormat (const ConstString& type,lldb::TypeFormatImplSP& format_sp)
+{
+    Entry entry;
+    if (LookupEntry(type, entry) && entry.IsFormatCached())
+    {
+        CountLookup(true);
         format_sp = entry.GetFormat();
         return true;
     }
-#ifdef LLDB_CONFIGURATION_DEBUG
-    m_cache_misses++;
-#endif
+    CountLookup(false);
     format_sp.reset();
     return false;
 }
@@ -203,19 +214,14 @@ FormatCache::GetFormat (const ConstString& type,lldb::TypeFormatImplSP& format_s
 bool
 FormatCache::GetSummary (const ConstString& type,lldb::TypeSummaryImplSP& summary_sp)
 {
-    Mutex::Locker lock(m_mutex);
-    auto entry = GetEntry(type);
-    if (entry.IsSummaryCached())
+    Entry entry;
+    if (LookupEntry(type, entry) && entry.IsSummaryCached())
     {
-#ifdef LLDB_CONFIGURATION_DEBUG
-        m_cache_hits++;
-#endif
+        CountLookup(true);
         summary_sp = entry.GetSummary();
         return true;
     }
-#ifdef LLDB_CONFIGURATION_DEBUG
-    m_cache_misses++;
-#endif
+    CountLookup(false);
     summary_sp.reset();
     return false;
 }
@@ -223,19 +229,14 @@ FormatCache::GetSummary (const ConstString& type,lldb::TypeSummaryImplSP& summar
 bool
 FormatCache::GetSynthetic (const ConstString& type,lldb::SyntheticChildrenSP& synthetic_sp)
 {
-    Mutex::Locker lock(m_mutex);
-    auto entry = GetEntry(type);
-    if (entry.IsSyntheticCached())
+    Entry entry;
+    if (LookupEntry(type, entry) && entry.IsSyntheticCached())
     {
-#ifdef LLDB_CONFIGURATION_DEBUG
-        m_cache_hits++;
-#endif
+        CountLookup(true);
         synthetic_sp = entry.GetSynthetic();
         return true;
     }
-#ifdef LLDB_CONFIGURATION_DEBUG
-    m_cache_misses++;
-#endif
+    CountLookup(false);
     synthetic_sp.reset();
     return false;
 }
@@ -243,19 +244,14 @@ FormatCache::GetSynthetic (const ConstString& type,lldb::SyntheticChildrenSP& sy
 bool
 FormatCache::GetValidator (const ConstString& type,lldb::TypeValidatorImplSP& validator_sp)
 {
-    Mutex::Locker lock(m_mutex);
-    auto entry = GetEntry(type);
-    if (entry.IsValidatorCached())
+    Entry entry;
+    if (LookupEntry(type, entry) && entry.IsValidatorCached())
     {
-#ifdef LLDB_CONFIGURATION_DEBUG
-        m_cache_hits++;
-#endif
+        CountLookup(true);
         validator_sp = entry.GetValidator();
         return true;
     }
-#ifdef LLDB_CONFIGURATION_DEBUG
-    m_cache_misses++;
-#endif
+    CountLookup(false);
     validator_sp.reset();
     return false;
 }
@@ -263,35 +259,41 @@ FormatCache::GetValidator (const ConstString& type,lldb::TypeValidatorImplSP& va
 void
 FormatCache::SetFormat (const ConstString& type,lldb::TypeFormatImplSP& format_sp)
 {
-    Mutex::Locker lock(m_mutex);
-    GetEntry(type).SetFormat(format_sp);
+    Shard& shard = GetShard(type);
+    llvm::sys::ScopedWriter lock(shard.m_mutex);
+    shard.m_map[type].SetFormat(format_sp);
 }
 
 void
 FormatCache::SetSummary (const ConstString& type,lldb::TypeSummaryImplSP& summary_sp)
 {
-    Mutex::Locker lock(m_mutex);
-    GetEntry(type).SetSummary(summary_sp);
+    Shard& shard = GetShard(type);
+    llvm::sys::ScopedWriter lock(shard.m_mutex);
+    shard.m_map[type].SetSummary(summary_sp);
 }
 
 void
 FormatCache::SetSynthetic (const ConstString& type,lldb::SyntheticChildrenSP& synthetic_sp)
 {
-    Mutex::Locker lock(m_mutex);
-    GetEntry(type).SetSynthetic(synthetic_sp);
+    Shard& shard = GetShard(type);
+    llvm::sys::ScopedWriter lock(shard.m_mutex);
+    shard.m_map[type].SetSynthetic(synthetic_sp);
 }
 
 void
 FormatCache::SetValidator (const ConstString& type,lldb::TypeValidatorImplSP& validator_sp)
 {
-    Mutex::Locker lock(m_mutex);
-    GetEntry(type).SetValidator(validator_sp);
+    Shard& shard = GetShard(type);
+    llvm::sys::ScopedWriter lock(shard.m_mutex);
+    shard.m_map[type].SetValidator(validator_sp);
 }
 
 void
 FormatCache::Clear ()
 {
-    Mutex::Locker lock(m_mutex);
-    m_map.clear();
+    for (Shard& shard : m_shards)
+    {
+        llvm::sys::ScopedWriter lock(shard.m_mutex);
+        shard.m_map.clear();
+    }
 }
-
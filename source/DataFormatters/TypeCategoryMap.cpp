@@ -26,7 +26,9 @@ TypeCategoryMap::TypeCategoryMap (IFormatChangeListener* lst) :
 m_map_mutex(Mutex::eMutexTypeRecursive),
 listener(lst),
 m_map(),
-m_active_categories()
+m_active_categories(),
+m_snapshot_mutex(),
+m_active_snapshot(new ActiveCategoriesSnapshot())
 {
     ConstString default_cs("default");
     lldb::TypeCategoryImplSP default_sp = lldb::TypeCategoryImplSP(new TypeCategoryImpl(listener, default_cs));
@@ -99,6 +101,7 @@ TypeCategoryMap::Enable (ValueSP category, Position pos)
         }
         else
             return false;
+        UpdateActiveCategoriesSnapshot();
         category->Enable(true,
                          pos);
         return true;
@@ -113,6 +116,7 @@ TypeCategoryMap::Disable (ValueSP category)
     if (category.get())
     {
         m_active_categories.remove_if(delete_matching_categories(category));
+        UpdateActiveCategoriesSnapshot();
         category->Disable();
         return true;
     }
@@ -165,10 +169,27 @@ TypeCategoryMap::Clear ()
     Mutex::Locker locker(m_map_mutex);
     m_map.clear();
     m_active_categories.clear();
+    UpdateActiveCategoriesSnapshot();
     if (listener)
         listener->Changed();
 }
 
+void
+TypeCategoryMap::UpdateActiveCategoriesSnapshot ()
+{
+    ActiveCategoriesSnapshotSP snapshot_sp(new ActiveCategoriesSnapshot(m_active_categories.begin(),
+                                                                        m_active_categories.end()));
+    llvm::sys::ScopedWriter lock(m_snapshot_mutex);
+    m_active_snapshot.swap(snapshot_sp);
+}
+
+TypeCategoryMap::ActiveCategoriesSnapshotSP
+TypeCategoryMap::GetActiveCategoriesSnapshot ()
+{
+    llvm::sys::ScopedReader lock(m_snapshot_mutex);
+    return m_active_snapshot;
+}
+
 bool
 TypeCategoryMap::Get (KeyType name, ValueSP& entry)
 {
@@ -223,18 +244,15 @@ lldb::TypeFormatImplSP
 TypeCategoryMap::GetFormat (ValueObject& valobj,
                             lldb::DynamicValueType use_dynamic)
 {
-    Mutex::Locker locker(m_map_mutex);
-    
     uint32_t reason_why;
-    ActiveCategoriesIterator begin, end = m_active_categories.end();
+    ActiveCategoriesSnapshotSP active_categories_sp = GetActiveCategoriesSnapshot();
     
     Log *log(lldb_private::GetLogIfAllCategoriesSet (LIBLLDB_LOG_TYPES));
     
     FormattersMatchVector matches = FormatManager::GetPossibleMatches(valobj, use_dynamic);
     
-    for (begin = m_active_categories.begin(); begin != end; begin++)
+    for (const lldb::TypeCategoryImplSP& category_sp : *active_categories_sp)
     {
-        lldb::TypeCategoryImplSP category_sp = *begin;
         lldb::TypeFormatImplSP current_format;
         if (log)
             log->Printf("\n[TypeCategoryMap::GetFormat] Trying to use category %s", category_sp->GetName());
@@ -251,18 +269,15 @@ lldb::TypeSummaryImplSP
 TypeCategoryMap::GetSummaryFormat (ValueObject& valobj,
                                    lldb::DynamicValueType use_dynamic)
 {
-    Mutex::Locker locker(m_map_mutex);
-    
     uint32_t reason_why;
-    ActiveCategoriesIterator begin, end = m_active_categories.end();
+    ActiveCategoriesSnapshotSP active_categories_sp = GetActiveCategoriesSnapshot();
     
     Log *log(lldb_private::GetLogIfAllCategoriesSet (LIBLLDB_LOG_TYPES));
     
     FormattersMatchVector matches = FormatManager::GetPossibleMatches(valobj, use_dynamic);
     
-    for (begin = m_active_categories.begin(); begin != end; begin++)
+    for (const lldb::TypeCategoryImplSP& category_sp : *active_categories_sp)
     {
-        lldb::TypeCategoryImplSP category_sp = *begin;
         lldb::TypeSummaryImplSP current_format;
         if (log)
             log->Printf("\n[CategoryMap::GetSummaryFormat] Trying to use category %s", category_sp->GetName());
@@ -280,19 +295,16 @@ lldb::SyntheticChildrenSP
 TypeCategoryMap::GetSyntheticChildren (ValueObject& valobj,
                                        lldb::DynamicValueType use_dynamic)
 {
-    Mutex::Locker locker(m_map_mutex);
-    
     uint32_t reason_why;
     
-    ActiveCategoriesIterator begin, end = m_active_categories.end();
+    ActiveCategoriesSnapshotSP active_categories_sp = GetActiveCategoriesSnapshot();
     
     Log *log(lldb_private::GetLogIfAllCategoriesSet (LIBLLDB_LOG_TYPES));
     
     FormattersMatchVector matches = FormatManager::GetPossibleMatches(valobj, use_dynamic);
     
-    for (begin = m_active_categories.begin(); begin != end; begin++)
+    for (const lldb::TypeCategoryImplSP& category_sp : *active_categories_sp)
     {
-        lldb::TypeCategoryImplSP category_sp = *begin;
         lldb::SyntheticChildrenSP current_format;
         if (log)
             log->Printf("\n[CategoryMap::GetSyntheticChildren] Trying to use category %s", category_sp->GetName());
@@ -310,18 +322,15 @@ lldb::TypeValidatorImplSP
 TypeCategoryMap::GetValidator (ValueObject& valobj,
                                lldb::DynamicValueType use_dynamic)
 {
-    Mutex::Locker locker(m_map_mutex);
-    
     uint32_t reason_why;
-    ActiveCategoriesIterator begin, end = m_active_categories.end();
+    ActiveCategoriesSnapshotSP active_categories_sp = GetActiveCategoriesSnapshot();
     
     Log *log(lldb_private::GetLogIfAllCategoriesSet (LIBLLDB_LOG_TYPES));
     
     FormattersMatchVector matches = FormatManager::GetPossibleMatches(valobj, use_dynamic);
     
-    for (begin = m_active_categories.begin(); begin != end; begin++)
+    for (const lldb::TypeCategoryImplSP& category_sp : *active_categories_sp)
     {
-        lldb::TypeCategoryImplSP category_sp = *begin;
         lldb::TypeValidatorImplSP current_format;
         if (log)
             log->Printf("\n[CategoryMap::GetValidator] Trying to use category %s", category_sp->GetName());
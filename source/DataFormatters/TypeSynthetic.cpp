@@ -164,7 +164,8 @@ ScriptedSyntheticChildren::FrontEnd::FrontEnd(std::string pclass, ValueObject &b
 SyntheticChildrenFrontEnd(backend),
 m_python_class(pclass),
 m_wrapper_sp(),
-m_interpreter(NULL)
+m_interpreter(NULL),
+m_can_get_children_in_range(true)
 {
     if (backend == LLDB_INVALID_UID)
         return;
@@ -193,6 +194,24 @@ ScriptedSyntheticChildren::FrontEnd::GetChildAtIndex (size_t idx)
     return m_interpreter->GetChildAtIndex(m_wrapper_sp, idx);
 }
 
+size_t
+ScriptedSyntheticChildren::FrontEnd::GetChildrenInRange (size_t idx, size_t count, std::vector<lldb::ValueObjectSP> &children)
+{
+    if (!m_wrapper_sp || !m_interpreter || !m_can_get_children_in_range)
+        return 0;
+    
+    // Most providers don't implement the batch call; don't pay for asking every time.  A
+    // provider that does can still return None or a short list for any one range, which only
+    // makes the caller fall back to GetChildAtIndex() for the rest of that range.
+    const size_t num_children = m_interpreter->GetChildrenInRange(m_wrapper_sp, m_backend.GetSP(), idx, count, children);
+    if (num_children == UINT32_MAX)
+    {
+        m_can_get_children_in_range = false;
+        return 0;
+    }
+    return num_children;
+}
+
 bool
 ScriptedSyntheticChildren::FrontEnd::IsValid ()
 {
@@ -16,6 +16,7 @@
 #include "lldb/Core/Debugger.h"
 #include "lldb/DataFormatters/DataVisualization.h"
 #include "lldb/Interpreter/CommandInterpreter.h"
+#include "lldb/Target/Process.h"
 #include "lldb/Target/Target.h"
 
 using namespace lldb;
@@ -520,6 +521,43 @@ ValueObjectPrinter::GetMaxNumChildrenToPrint (bool& print_dotdotdot)
     return num_children;
 }
 
+//----------------------------------------------------------------------
+// Each char pointer child reads its string on its own when its summary
+// is printed, which is one round trip per child against a remote stub.
+// Collect the string addresses up front and let the process fetch them
+// in as few batched reads as it can so those reads hit the memory cache.
+//----------------------------------------------------------------------
+void
+ValueObjectPrinter::PrefetchChildStrings (ValueObject* synth_valobj,
+                                          size_t num_children)
+{
+    if (num_children < 2 || options.m_omit_summary_depth > 1)
+        return;
+
+    ProcessSP process_sp (m_valobj->GetProcessSP());
+    if (!process_sp)
+        return;
+
+    std::vector<addr_t> string_addrs;
+    for (size_t idx=0; idx<num_children; ++idx)
+    {
+        ValueObjectSP child_sp(synth_valobj->GetChildAtIndex(idx, true));
+        if (!child_sp)
+            continue;
+        ClangASTType pointee_type;
+        const Flags type_flags (child_sp->GetTypeInfo (&pointee_type));
+        if (!type_flags.Test (eTypeIsPointer) || !pointee_type.IsCharType ())
+            continue;
+        AddressType addr_type = eAddressTypeInvalid;
+        const addr_t addr = child_sp->GetPointerValue (&addr_type);
+        if (addr_type == eAddressTypeLoad && addr != 0 && addr != LLDB_INVALID_ADDRESS)
+            string_addrs.push_back (addr);
+    }
+
+    if (string_addrs.size() > 1)
+        process_sp->PrefetchMemory (string_addrs, process_sp->GetMemoryCacheLineSize());
+}
+
 void
 ValueObjectPrinter::PrintChildrenPostamble (bool print_dotdotdot)
 {
@@ -546,6 +584,8 @@ ValueObjectPrinter::PrintChildren (uint32_t curr_ptr_depth)
     {
         PrintChildrenPreamble ();
         
+        PrefetchChildStrings (synth_m_valobj, num_children);
+        
         for (size_t idx=0; idx<num_children; ++idx)
         {
             ValueObjectSP child_sp(synth_m_valobj->GetChildAtIndex(idx, true));
@@ -586,6 +626,8 @@ ValueObjectPrinter::PrintChildrenOneLiner (bool hide_names)
     
     if (num_children)
     {
+        PrefetchChildStrings (synth_m_valobj, num_children);
+        
         m_stream->PutChar('(');
         
         for (uint32_t idx=0; idx<num_children; ++idx)
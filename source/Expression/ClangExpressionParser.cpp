@@ -24,11 +24,13 @@
 #include "lldb/Expression/ClangExpression.h"
 #include "lldb/Expression/ClangExpressionDeclMap.h"
 #include "lldb/Expression/ClangModulesDeclVendor.h"
+#include "lldb/Expression/ClangPredefinesCache.h"
 #include "lldb/Expression/IRExecutionUnit.h"
 #include "lldb/Expression/IRDynamicChecks.h"
 #include "lldb/Expression/IRInterpreter.h"
 #include "lldb/Host/File.h"
 #include "lldb/Host/HostInfo.h"
+#include "lldb/Host/Mutex.h"
 #include "lldb/Symbol/SymbolVendor.h"
 #include "lldb/Target/ExecutionContext.h"
 #include "lldb/Target/ObjCLanguageRuntime.h"
@@ -50,6 +52,7 @@
 #include "clang/Frontend/TextDiagnosticBuffer.h"
 #include "clang/Frontend/TextDiagnosticPrinter.h"
 #include "clang/Lex/Preprocessor.h"
+#include "clang/Lex/PreprocessorOptions.h"
 #include "clang/Parse/ParseAST.h"
 #include "clang/Rewrite/Frontend/FrontendActions.h"
 #include "clang/Sema/SemaConsumer.h"
@@ -70,6 +73,8 @@
 #include "llvm/Support/Host.h"
 #include "llvm/Support/Signals.h"
 
+#include <map>
+
 using namespace clang;
 using namespace llvm;
 using namespace lldb_private;
@@ -291,7 +296,22 @@ ClangExpressionParser::ClangExpressionParser (ExecutionContextScope *exe_scope,
         m_compiler->createSourceManager(*m_file_manager.get());
 
     m_compiler->createFileManager();
+
+    // If an earlier expression was compiled for the same target and language
+    // options, reuse its predefined macros instead of building them again.
+    ClangPredefinesCache &predefines_cache (ClangPredefinesCache::GetSharedCache());
+    const std::string predefines_key (ClangPredefinesCache::GetKey(m_compiler->getTargetOpts(), m_compiler->getLangOpts()));
+    std::string predefines;
+    const bool have_predefines = predefines_cache.GetPredefines(predefines_key, predefines);
+    if (have_predefines)
+        m_compiler->getPreprocessorOpts().UsePredefines = false;
+
     m_compiler->createPreprocessor(TU_Complete);
+
+    if (have_predefines)
+        m_compiler->getPreprocessor().setPredefines(predefines);
+    else
+        predefines_cache.SetPredefines(predefines_key, m_compiler->getPreprocessor().getPredefines());
     
     if (ClangModulesDeclVendor *decl_vendor = target_sp->GetClangModulesDeclVendor())
     {
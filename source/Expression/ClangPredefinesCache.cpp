@@ -0,0 +1,80 @@
+//===-- ClangPredefinesCache.cpp --------------------------------*- C++ -*-===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+
+#include "lldb/Expression/ClangPredefinesCache.h"
+
+#include "clang/Basic/LangOptions.h"
+#include "clang/Basic/TargetOptions.h"
+
+#include "llvm/Support/raw_ostream.h"
+
+using namespace lldb_private;
+
+ClangPredefinesCache::ClangPredefinesCache () :
+    m_mutex (),
+    m_predefines ()
+{
+}
+
+ClangPredefinesCache::~ClangPredefinesCache ()
+{
+}
+
+ClangPredefinesCache &
+ClangPredefinesCache::GetSharedCache ()
+{
+    static ClangPredefinesCache *g_predefines_cache = new ClangPredefinesCache();
+    return *g_predefines_cache;
+}
+
+std::string
+ClangPredefinesCache::GetKey (const clang::TargetOptions &target_opts,
+                              const clang::LangOptions &lang_opts)
+{
+    std::string key;
+    llvm::raw_string_ostream key_stream (key);
+
+    key_stream << target_opts.Triple << '|' << target_opts.CPU << '|' << target_opts.FPMath
+               << '|' << target_opts.ABI << '|' << target_opts.LinkerVersion;
+    for (const std::string &feature : target_opts.FeaturesAsWritten)
+        key_stream << '|' << feature;
+    key_stream << '|';
+    for (const std::string &feature : target_opts.Features)
+        key_stream << '|' << feature;
+
+    // Take every language option from clang's own list rather than the
+    // ones ClangExpressionParser happens to change today.
+    key_stream << '|';
+#define LANGOPT(Name, Bits, Default, Description) \
+    key_stream << static_cast<unsigned>(lang_opts.Name) << ',';
+#define ENUM_LANGOPT(Name, Type, Bits, Default, Description) \
+    key_stream << static_cast<unsigned>(lang_opts.get##Name()) << ',';
+#include "clang/Basic/LangOptions.def"
+    key_stream << '|' << lang_opts.ObjCRuntime.getAsString();
+
+    return key_stream.str();
+}
+
+bool
+ClangPredefinesCache::GetPredefines (const std::string &key, std::string &predefines)
+{
+    Mutex::Locker locker (m_mutex);
+    PredefinesMap::const_iterator pos = m_predefines.find(key);
+    if (pos == m_predefines.end())
+        return false;
+    predefines = pos->second;
+    return true;
+}
+
+void
+ClangPredefinesCache::SetPredefines (const std::string &key, const std::string &predefines)
+{
+    Mutex::Locker locker (m_mutex);
+    m_predefines[key] = predefines;
+}
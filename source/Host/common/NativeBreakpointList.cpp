@@ -12,6 +12,7 @@
 #include "lldb/Core/Log.h"
 
 #include "lldb/Host/common/NativeBreakpoint.h"
+#include "lldb/Host/common/SoftwareBreakpoint.h"
 
 using namespace lldb;
 using namespace lldb_private;
@@ -197,3 +198,28 @@ NativeBreakpointList::GetBreakpoint (lldb::addr_t addr, NativeBreakpointSP &brea
     return Error ();
 }
 
+void
+NativeBreakpointList::RemoveTrapsFromBuffer (lldb::addr_t addr, void *buf, size_t size)
+{
+    Mutex::Locker locker (m_mutex);
+
+    uint8_t *bytes = static_cast<uint8_t *> (buf);
+    const lldb::addr_t end_addr = addr + size;
+
+    // A trap that starts a little before addr may still cover its first bytes.
+    const lldb::addr_t search_addr = (addr > SoftwareBreakpoint::MAX_TRAP_OPCODE_SIZE) ? addr - SoftwareBreakpoint::MAX_TRAP_OPCODE_SIZE : 0;
+    for (auto iter = m_breakpoints.lower_bound (search_addr); iter != m_breakpoints.end () && iter->first < end_addr; ++iter)
+    {
+        const NativeBreakpointSP &breakpoint_sp = iter->second;
+        if (!breakpoint_sp->IsSoftwareBreakpoint () || !breakpoint_sp->IsEnabled ())
+            continue;
+
+        const SoftwareBreakpoint &software_breakpoint = static_cast<const SoftwareBreakpoint &> (*breakpoint_sp);
+        for (size_t i = 0; i < software_breakpoint.m_opcode_size; ++i)
+        {
+            const lldb::addr_t byte_addr = iter->first + i;
+            if (byte_addr >= addr && byte_addr < end_addr)
+                bytes[byte_addr - addr] = software_breakpoint.m_saved_opcodes[i];
+        }
+    }
+}
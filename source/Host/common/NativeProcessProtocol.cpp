@@ -29,6 +29,7 @@ using namespace lldb_private;
 NativeProcessProtocol::NativeProcessProtocol (lldb::pid_t pid) :
     m_pid (pid),
     m_threads (),
+    m_threads_by_id (),
     m_current_thread_id (LLDB_INVALID_THREAD_ID),
     m_threads_mutex (Mutex::eMutexTypeRecursive),
     m_state (lldb::eStateInvalid),
@@ -41,7 +42,8 @@ NativeProcessProtocol::NativeProcessProtocol (lldb::pid_t pid) :
     m_breakpoint_list (),
     m_watchpoint_list (),
     m_terminal_fd (-1),
-    m_stop_id (0)
+    m_stop_id (0),
+    m_non_stop_mode (false)
 {
 }
 
@@ -126,11 +128,9 @@ NativeProcessProtocol::GetThreadAtIndex (uint32_t idx)
 NativeThreadProtocolSP
 NativeProcessProtocol::GetThreadByIDUnlocked (lldb::tid_t tid)
 {
-    for (auto thread_sp : m_threads)
-    {
-        if (thread_sp->GetID() == tid)
-            return thread_sp;
-    }
+    auto find_it = m_threads_by_id.find (tid);
+    if (find_it != m_threads_by_id.end ())
+        return find_it->second;
     return NativeThreadProtocolSP ();
 }
 
@@ -360,6 +360,29 @@ NativeProcessProtocol::NotifyDidExec ()
     }
 }
 
+void
+NativeProcessProtocol::NotifyThreadStopped (lldb::tid_t tid)
+{
+    Log *log (GetLogIfAllCategoriesSet (LIBLLDB_LOG_PROCESS | LIBLLDB_LOG_THREAD));
+    if (log)
+        log->Printf ("NativeProcessProtocol::%s: sending non-stop notification for pid %" PRIu64 " tid %" PRIu64,
+                __FUNCTION__, GetID (), tid);
+
+    Mutex::Locker locker (m_delegates_mutex);
+    for (auto native_delegate: m_delegates)
+        native_delegate->ThreadStopped (this, tid);
+}
+
+Error
+NativeProcessProtocol::SetNonStopMode (bool enabled)
+{
+    // Default implementation only knows how to stop the world.
+    if (enabled)
+        return Error ("non-stop mode is not supported by this process plugin");
+
+    m_non_stop_mode = false;
+    return Error ();
+}
 
 Error
 NativeProcessProtocol::SetSoftwareBreakpoint (lldb::addr_t addr, uint32_t size_hint)
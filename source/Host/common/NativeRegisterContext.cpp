@@ -31,10 +31,16 @@ NativeRegisterContext::~NativeRegisterContext()
 {
 }
 
-// FIXME revisit invalidation, process stop ids, etc.  Right now we don't
-// support caching in NativeRegisterContext.  We can do this later by
-// utilizing NativeProcessProtocol::GetStopID () and adding a stop id to
-// NativeRegisterContext.
+void
+NativeRegisterContext::InvalidateAllRegisters ()
+{
+}
+
+// FIXME revisit invalidation, process stop ids, etc.  Subclasses may cache
+// register sets between InvalidateAllRegisters() calls, which the owning
+// thread issues on every resume.  Stop-id based invalidation could be done
+// later by utilizing NativeProcessProtocol::GetStopID () and adding a stop
+// id to NativeRegisterContext.
 
 // void
 // NativeRegisterContext::InvalidateIfNeeded (bool force)
@@ -32,6 +32,10 @@
 #include <termios.h>
 #endif
 
+#if defined(__linux__)
+#include <poll.h>
+#endif
+
 // C++ Includes
 // Other libraries and framework includes
 #include "llvm/Support/ErrorHandling.h"
@@ -45,6 +49,7 @@
 #include "lldb/Core/Timer.h"
 #include "lldb/Host/Host.h"
 #include "lldb/Host/Socket.h"
+#include "lldb/Host/TimeValue.h"
 #include "lldb/Interpreter/Args.h"
 
 using namespace lldb;
@@ -519,25 +524,101 @@ ConnectionFileDescriptor::GetURI()
     return m_uri;
 }
 
-// This ConnectionFileDescriptor::BytesAvailable() uses select().
+// Waits for data on the connection's handle or on the command pipe.  On Linux
+// this uses poll(), which has no FD_SETSIZE limit, so a process with many open
+// connections (like lldb-server in platform mode with many gdbserver sessions)
+// can use descriptors above 1024.  Elsewhere it uses select(), which behaves
+// the same across most unix platforms.  The Apple specific version allows for
+// unlimited fds in the fd_sets by setting the _DARWIN_UNLIMITED_SELECT define
+// prior to including the required header files; other select() platforms only
+// support descriptors below FD_SETSIZE and will assert if they hit that limit.
 //
-// PROS:
-//  - select is consistent across most unix platforms
-//  - The Apple specific version allows for unlimited fds in the fd_sets by
-//    setting the _DARWIN_UNLIMITED_SELECT define prior to including the
-//    required header files.
-// CONS:
-//  - on non-Apple platforms, only supports file descriptors up to FD_SETSIZE.
-//     This implementation  will assert if it runs into that hard limit to let
-//     users know that another ConnectionFileDescriptor::BytesAvailable() should
-//     be used or a new version of ConnectionFileDescriptor::BytesAvailable()
-//     should be written for the system that is running into the limitations.
+// "timeout_usec" is UINT32_MAX for an infinite wait.  Returns the result of
+// the system call: the number of ready descriptors, zero on a timeout, or -1
+// with errno set.
 
+#if !defined(__linux__)
 #if defined(__APPLE__)
 #define FD_SET_DATA(fds) fds.data()
 #else
 #define FD_SET_DATA(fds) &fds
 #endif
+#endif
+
+static int
+WaitForReadableDescriptors(int handle, int pipe_fd, uint32_t timeout_usec, bool &handle_ready, bool &handle_invalid,
+                           bool &pipe_ready)
+{
+    handle_ready = false;
+    handle_invalid = false;
+    pipe_ready = false;
+    const bool have_pipe_fd = pipe_fd >= 0;
+
+#if defined(__linux__)
+    // poll() only has millisecond granularity, so round sub-millisecond timeouts up
+    int timeout_msec = -1; // Infinite wait...
+    if (timeout_usec != UINT32_MAX)
+        timeout_msec = static_cast<int>((static_cast<uint64_t>(timeout_usec) + 999) / 1000);
+
+    struct pollfd fds[2];
+    fds[0].fd = handle;
+    fds[0].events = POLLIN;
+    fds[0].revents = 0;
+    fds[1].fd = pipe_fd;
+    fds[1].events = POLLIN;
+    fds[1].revents = 0;
+
+    const int num_set_fds = ::poll(fds, have_pipe_fd ? 2 : 1, timeout_msec);
+    if (num_set_fds > 0)
+    {
+        handle_invalid = (fds[0].revents & POLLNVAL) != 0;
+        // Let the following read report the end-of-file or error on a hang up
+        handle_ready = (fds[0].revents & (POLLIN | POLLHUP | POLLERR)) != 0;
+        pipe_ready = have_pipe_fd && (fds[1].revents & POLLIN) != 0;
+    }
+    return num_set_fds;
+#else
+    struct timeval *tv_ptr = nullptr; // Infinite wait...
+    struct timeval tv;
+    if (timeout_usec != UINT32_MAX)
+    {
+        tv.tv_sec = timeout_usec / TimeValue::MicroSecPerSec;
+        tv.tv_usec = timeout_usec % TimeValue::MicroSecPerSec;
+        tv_ptr = &tv;
+    }
+
+#if !defined(__APPLE__)
+    assert(handle < FD_SETSIZE);
+    if (have_pipe_fd)
+        assert(pipe_fd < FD_SETSIZE);
+#endif
+
+    const int nfds = std::max<int>(handle, pipe_fd) + 1;
+#if defined(__APPLE__)
+    llvm::SmallVector<fd_set, 1> read_fds;
+    read_fds.resize((nfds / FD_SETSIZE) + 1);
+    for (size_t i = 0; i < read_fds.size(); ++i)
+        FD_ZERO(&read_fds[i]);
+// FD_SET doesn't bounds check, it just happily walks off the end
+// but we have taken care of making the extra storage with our
+// SmallVector of fd_set objects
+#else
+    fd_set read_fds;
+    FD_ZERO(&read_fds);
+#endif
+    FD_SET(handle, FD_SET_DATA(read_fds));
+    if (have_pipe_fd)
+        FD_SET(pipe_fd, FD_SET_DATA(read_fds));
+
+    const int num_set_fds = ::select(nfds, FD_SET_DATA(read_fds), NULL, NULL, tv_ptr);
+    if (num_set_fds > 0)
+    {
+        handle_ready = FD_ISSET(handle, FD_SET_DATA(read_fds));
+        pipe_ready = have_pipe_fd && FD_ISSET(pipe_fd, FD_SET_DATA(read_fds));
+    }
+    return num_set_fds;
+#endif
+}
 
 ConnectionStatus
 ConnectionFileDescriptor::BytesAvailable(uint32_t timeout_usec, Error *error_ptr)
@@ -549,93 +630,54 @@ ConnectionFileDescriptor::BytesAvailable(uint32_t timeout_usec, Error *error_ptr
     if (log)
         log->Printf("%p ConnectionFileDescriptor::BytesAvailable (timeout_usec = %u)", static_cast<void *>(this), timeout_usec);
 
-    struct timeval *tv_ptr;
-    struct timeval tv;
-    if (timeout_usec == UINT32_MAX)
+    // Compute the deadline once so that a wait that gets interrupted by a
+    // signal only waits for whatever is left of the original timeout
+    TimeValue deadline;
+    if (timeout_usec != UINT32_MAX)
     {
-        // Inifinite wait...
-        tv_ptr = nullptr;
-    }
-    else
-    {
-        TimeValue time_value;
-        time_value.OffsetWithMicroSeconds(timeout_usec);
-        tv.tv_sec = time_value.seconds();
-        tv.tv_usec = time_value.microseconds();
-        tv_ptr = &tv;
+        deadline = TimeValue::Now();
+        deadline.OffsetWithMicroSeconds(timeout_usec);
     }
 
     // Make a copy of the file descriptors to make sure we don't
     // have another thread change these values out from under us
     // and cause problems in the loop below where like in FS_SET()
     const IOObject::WaitableHandle handle = m_read_sp->GetWaitableHandle();
+#if defined(_MSC_VER)
+    // select() won't accept pipes on Windows.  The entire Windows codepath needs to be
+    // converted over to using WaitForMultipleObjects and event HANDLEs, but for now at least
+    // this will allow ::select() to not return an error.
+    const int pipe_fd = -1;
+#else
     const int pipe_fd = m_pipe.GetReadFileDescriptor();
+#endif
 
     if (handle != IOObject::kInvalidHandleValue)
     {
-#if defined(_MSC_VER)
-        // select() won't accept pipes on Windows.  The entire Windows codepath needs to be
-        // converted over to using WaitForMultipleObjects and event HANDLEs, but for now at least
-        // this will allow ::select() to not return an error.
-        const bool have_pipe_fd = false;
-#else
-        const bool have_pipe_fd = pipe_fd >= 0;
-#if !defined(__APPLE__)
-        assert(handle < FD_SETSIZE);
-        if (have_pipe_fd)
-            assert(pipe_fd < FD_SETSIZE);
-#endif
-#endif
         while (handle == m_read_sp->GetWaitableHandle())
         {
-            const int nfds = std::max<int>(handle, pipe_fd) + 1;
-#if defined(__APPLE__)
-            llvm::SmallVector<fd_set, 1> read_fds;
-            read_fds.resize((nfds / FD_SETSIZE) + 1);
-            for (size_t i = 0; i < read_fds.size(); ++i)
-                FD_ZERO(&read_fds[i]);
-// FD_SET doesn't bounds check, it just happily walks off the end
-// but we have taken care of making the extra storage with our
-// SmallVector of fd_set objects
-#else
-            fd_set read_fds;
-            FD_ZERO(&read_fds);
-#endif
-            FD_SET(handle, FD_SET_DATA(read_fds));
-            if (have_pipe_fd)
-                FD_SET(pipe_fd, FD_SET_DATA(read_fds));
-
-            Error error;
-
-            if (log)
+            uint32_t remaining_usec = UINT32_MAX;
+            if (timeout_usec != UINT32_MAX)
             {
-                if (have_pipe_fd)
-                    log->Printf(
-                        "%p ConnectionFileDescriptor::BytesAvailable()  ::select (nfds=%i, fds={%i, %i}, NULL, NULL, timeout=%p)...",
-                        static_cast<void *>(this), nfds, handle, pipe_fd, static_cast<void *>(tv_ptr));
-                else
-                    log->Printf("%p ConnectionFileDescriptor::BytesAvailable()  ::select (nfds=%i, fds={%i}, NULL, NULL, timeout=%p)...",
-                                static_cast<void *>(this), nfds, handle, static_cast<void *>(tv_ptr));
+                const TimeValue now = TimeValue::Now();
+                remaining_usec = now < deadline ? (deadline - now) / TimeValue::NanoSecPerMicroSec : 0;
             }
 
-            const int num_set_fds = ::select(nfds, FD_SET_DATA(read_fds), NULL, NULL, tv_ptr);
+            Error error;
+            bool handle_ready;
+            bool handle_invalid;
+            bool pipe_ready;
+
+            const int num_set_fds =
+                WaitForReadableDescriptors(handle, pipe_fd, remaining_usec, handle_ready, handle_invalid, pipe_ready);
             if (num_set_fds < 0)
                 error.SetErrorToErrno();
             else
                 error.Clear();
 
             if (log)
-            {
-                if (have_pipe_fd)
-                    log->Printf("%p ConnectionFileDescriptor::BytesAvailable()  ::select (nfds=%i, fds={%i, %i}, NULL, NULL, timeout=%p) "
-                                "=> %d, error = %s",
-                                static_cast<void *>(this), nfds, handle, pipe_fd, static_cast<void *>(tv_ptr), num_set_fds,
-                                error.AsCString());
-                else
-                    log->Printf("%p ConnectionFileDescriptor::BytesAvailable()  ::select (nfds=%i, fds={%i}, NULL, NULL, timeout=%p) => "
-                                "%d, error = %s",
-                                static_cast<void *>(this), nfds, handle, static_cast<void *>(tv_ptr), num_set_fds, error.AsCString());
-            }
+                log->Printf("%p ConnectionFileDescriptor::BytesAvailable()  wait (fds={%i, %i}, timeout_usec=%u) => %d, error = %s",
+                            static_cast<void *>(this), handle, pipe_fd, remaining_usec, num_set_fds, error.AsCString());
 
             if (error_ptr)
                 *error_ptr = error;
@@ -647,13 +689,14 @@ ConnectionFileDescriptor::BytesAvailable(uint32_t timeout_usec, Error *error_ptr
                     case EBADF: // One of the descriptor sets specified an invalid descriptor.
                         return eConnectionStatusLostConnection;
 
-                    case EINVAL: // The specified time limit is invalid. One of its components is negative or too large.
+                    case EFAULT: // The fds array isn't in our address space.
+                    case EINVAL: // The timeout or the number of descriptors is invalid.
                     default:     // Other unknown error
                         return eConnectionStatusError;
 
                     case EAGAIN: // The kernel was (perhaps temporarily) unable to
-                                 // allocate the requested number of file descriptors,
-                                 // or we have non-blocking IO
+                                 // allocate internal tables, or we have non-blocking IO
+                    case ENOMEM: // Same as above
                     case EINTR:  // A signal was delivered before the time limit
                         // expired and before any of the selected events
                         // occurred.
@@ -666,9 +709,11 @@ ConnectionFileDescriptor::BytesAvailable(uint32_t timeout_usec, Error *error_ptr
             }
             else if (num_set_fds > 0)
             {
-                if (FD_ISSET(handle, FD_SET_DATA(read_fds)))
+                if (handle_invalid)
+                    return eConnectionStatusLostConnection;
+                if (handle_ready)
                     return eConnectionStatusSuccess;
-                if (have_pipe_fd && FD_ISSET(pipe_fd, FD_SET_DATA(read_fds)))
+                if (pipe_ready)
                 {
                     // We got a command to exit.  Read the data from that pipe:
                     char buffer[16];
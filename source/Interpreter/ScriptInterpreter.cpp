@@ -120,6 +120,7 @@ ScriptInterpreter::InitializeInterpreter (SWIGInitCallback python_swig_init_call
                                           SWIGPythonCreateCommandObject swig_create_cmd,
                                           SWIGPythonCalculateNumChildren swig_calc_children,
                                           SWIGPythonGetChildAtIndex swig_get_child_index,
+                                          SWIGPythonGetChildrenInRange swig_get_children_in_range,
                                           SWIGPythonGetIndexOfChildWithName swig_get_index_child,
                                           SWIGPythonCastPyObjectToSBValue swig_cast_to_sbvalue ,
                                           SWIGPythonGetValueObjectSPFromSBValue swig_get_valobj_sp_from_sbvalue,
@@ -148,6 +149,7 @@ ScriptInterpreter::InitializeInterpreter (SWIGInitCallback python_swig_init_call
                                                     swig_create_cmd,
                                                     swig_calc_children,
                                                     swig_get_child_index,
+                                                    swig_get_children_in_range,
                                                     swig_get_index_child,
                                                     swig_cast_to_sbvalue ,
                                                     swig_get_valobj_sp_from_sbvalue,
@@ -29,6 +29,7 @@
 #include "lldb/Breakpoint/WatchpointOptions.h"
 #include "lldb/Core/Communication.h"
 #include "lldb/Core/Debugger.h"
+#include "lldb/Core/State.h"
 #include "lldb/Core/Timer.h"
 #include "lldb/Core/ValueObject.h"
 #include "lldb/DataFormatters/TypeSummary.h"
@@ -38,6 +39,8 @@
 #include "lldb/Interpreter/CommandInterpreter.h"
 #include "lldb/Interpreter/CommandReturnObject.h"
 #include "lldb/Interpreter/PythonDataObjects.h"
+#include "lldb/Target/Process.h"
+#include "lldb/Target/Target.h"
 #include "lldb/Target/Thread.h"
 #include "lldb/Target/ThreadPlan.h"
 
@@ -57,6 +60,7 @@ static ScriptInterpreter::SWIGPythonCreateSyntheticProvider g_swig_synthetic_scr
 static ScriptInterpreter::SWIGPythonCreateCommandObject g_swig_create_cmd = nullptr;
 static ScriptInterpreter::SWIGPythonCalculateNumChildren g_swig_calc_children = nullptr;
 static ScriptInterpreter::SWIGPythonGetChildAtIndex g_swig_get_child_index = nullptr;
+static ScriptInterpreter::SWIGPythonGetChildrenInRange g_swig_get_children_in_range = nullptr;
 static ScriptInterpreter::SWIGPythonGetIndexOfChildWithName g_swig_get_index_child = nullptr;
 static ScriptInterpreter::SWIGPythonCastPyObjectToSBValue g_swig_cast_to_sbvalue  = nullptr;
 static ScriptInterpreter::SWIGPythonGetValueObjectSPFromSBValue g_swig_get_valobj_sp_from_sbvalue = nullptr;
@@ -98,6 +102,10 @@ ScriptInterpreterPython::Locker::Locker (ScriptInterpreterPython *py_interpreter
             m_teardown_session = false;
         }
     }
+    else if ((on_entry & InitDebugger) == InitDebugger && m_python_interpreter)
+    {
+        m_python_interpreter->SetDebuggerGlobals ();
+    }
 }
 
 bool
@@ -164,6 +172,16 @@ ScriptInterpreterPython::ScriptInterpreterPython (CommandInterpreter &interprete
     m_lldb_module (),
     m_session_dict (false),     // Don't create an empty dictionary, leave it invalid
     m_sys_module_dict (false),  // Don't create an empty dictionary, leave it invalid
+    m_py_debugger (),
+    m_py_target (),
+    m_py_process (),
+    m_py_thread (),
+    m_py_frame (),
+    m_globals_target (nullptr),
+    m_globals_process (nullptr),
+    m_globals_stop_id (UINT32_MAX),
+    m_globals_tid (LLDB_INVALID_THREAD_ID),
+    m_globals_frame_idx (UINT32_MAX),
     m_run_one_line_function (),
     m_run_one_line_str_global (),
     m_dictionary_name (interpreter.GetDebugger().GetInstanceName().AsCString()),
@@ -419,28 +437,10 @@ ScriptInterpreterPython::EnterSession (uint16_t on_entry_flags,
 
     m_session_is_active = true;
 
-    StreamString run_string;
-
+    // If we aren't initing the globals, we should still always set the debugger (since that is always unique.)
+    SetDebuggerGlobals ();
     if (on_entry_flags & Locker::InitGlobals)
-    {
-        run_string.Printf (    "run_one_line (%s, 'lldb.debugger_unique_id = %" PRIu64, m_dictionary_name.c_str(), GetCommandInterpreter().GetDebugger().GetID());
-        run_string.Printf (    "; lldb.debugger = lldb.SBDebugger.FindDebuggerWithID (%" PRIu64 ")", GetCommandInterpreter().GetDebugger().GetID());
-        run_string.PutCString ("; lldb.target = lldb.debugger.GetSelectedTarget()");
-        run_string.PutCString ("; lldb.process = lldb.target.GetProcess()");
-        run_string.PutCString ("; lldb.thread = lldb.process.GetSelectedThread ()");
-        run_string.PutCString ("; lldb.frame = lldb.thread.GetSelectedFrame ()");
-        run_string.PutCString ("')");
-    }
-    else
-    {
-        // If we aren't initing the globals, we should still always set the debugger (since that is always unique.)
-        run_string.Printf (    "run_one_line (%s, 'lldb.debugger_unique_id = %" PRIu64, m_dictionary_name.c_str(), GetCommandInterpreter().GetDebugger().GetID());
-        run_string.Printf (    "; lldb.debugger = lldb.SBDebugger.FindDebuggerWithID (%" PRIu64 ")", GetCommandInterpreter().GetDebugger().GetID());
-        run_string.PutCString ("')");
-    }
-
-    PyRun_SimpleString (run_string.GetData());
-    run_string.Clear();
+        SetSelectionGlobals ();
 
     PythonDictionary &sys_module_dict = GetSysModuleDictionary ();
     if (sys_module_dict)
@@ -527,6 +527,160 @@ ScriptInterpreterPython::GetSessionDictionary ()
     return m_session_dict;
 }
 
+PythonObject &
+ScriptInterpreterPython::GetLLDBModule ()
+{
+    if (!m_lldb_module)
+        m_lldb_module.Reset(PyImport_AddModule ("lldb"));
+    return m_lldb_module;
+}
+
+// Call a method that takes no arguments on object and hold on to the result.
+static void
+CallMethodNoArgs (PyObject *object, const char *method_name, PythonObject &result)
+{
+    result.Reset ();
+    if (object == nullptr)
+        return;
+    PyObject *py_result = PyObject_CallMethod (object, const_cast<char *>(method_name), nullptr);
+    if (py_result == nullptr)
+    {
+        PyErr_Clear ();
+        return;
+    }
+    result.Reset (py_result);
+    Py_DECREF (py_result);
+}
+
+// True if the lldb module attribute attr_name is object itself.
+static bool
+ModuleAttributeIs (PyObject *module, const char *attr_name, const PythonObject &object)
+{
+    PyObject *attr = PyObject_GetAttrString (module, attr_name);
+    if (attr == nullptr)
+    {
+        PyErr_Clear ();
+        return false;
+    }
+    Py_DECREF (attr);
+    return attr == object.get();
+}
+
+// Point lldb.debugger and lldb.debugger_unique_id at our debugger.  All debuggers share the one
+// lldb module, so this has to be redone whenever somebody else set them last; otherwise it is just
+// an attribute lookup.
+void
+ScriptInterpreterPython::SetDebuggerGlobals ()
+{
+    PythonObject &lldb_module = GetLLDBModule ();
+    if (!lldb_module)
+        return;
+
+    const lldb::user_id_t debugger_id = GetCommandInterpreter().GetDebugger().GetID();
+    if (!m_py_debugger)
+    {
+        PyObject *py_class = PyObject_GetAttrString (lldb_module.get(), "SBDebugger");
+        if (py_class == nullptr)
+        {
+            PyErr_Clear ();
+            return;
+        }
+        PyObject *py_debugger = PyObject_CallMethod (py_class, const_cast<char *>("FindDebuggerWithID"), const_cast<char *>("K"),
+                                                     static_cast<unsigned long long>(debugger_id));
+        Py_DECREF (py_class);
+        if (py_debugger == nullptr)
+        {
+            PyErr_Clear ();
+            return;
+        }
+        m_py_debugger.Reset (py_debugger);
+        Py_DECREF (py_debugger);
+    }
+    else if (ModuleAttributeIs (lldb_module.get(), "debugger", m_py_debugger))
+        return;
+
+    PyObject *py_debugger_id = PyLong_FromUnsignedLongLong (debugger_id);
+    if (py_debugger_id)
+    {
+        PyObject_SetAttrString (lldb_module.get(), "debugger_unique_id", py_debugger_id);
+        Py_DECREF (py_debugger_id);
+    }
+    PyObject_SetAttrString (lldb_module.get(), "debugger", m_py_debugger.get());
+    if (PyErr_Occurred())
+        PyErr_Clear ();
+}
+
+// Point lldb.target, lldb.process, lldb.thread and lldb.frame at the current selection.  Making
+// the SB objects is only needed when the selection changed (or the process stopped again) since the
+// last time, or if a script assigned something else to one of them.
+void
+ScriptInterpreterPython::SetSelectionGlobals ()
+{
+    PythonObject &lldb_module = GetLLDBModule ();
+    if (!lldb_module || !m_py_debugger)
+        return;
+
+    Target *target = nullptr;
+    Process *process = nullptr;
+    uint32_t stop_id = UINT32_MAX;
+    lldb::tid_t tid = LLDB_INVALID_THREAD_ID;
+    uint32_t frame_idx = UINT32_MAX;
+
+    TargetSP target_sp (GetCommandInterpreter().GetDebugger().GetSelectedTarget());
+    if (target_sp)
+    {
+        target = target_sp.get();
+        ProcessSP process_sp (target_sp->GetProcessSP());
+        if (process_sp)
+        {
+            process = process_sp.get();
+            stop_id = process_sp->GetStopID();
+            ThreadSP thread_sp (process_sp->GetThreadList().GetSelectedThread());
+            if (thread_sp)
+            {
+                tid = thread_sp->GetID();
+                if (StateIsStoppedState (process_sp->GetState(), true))
+                    frame_idx = thread_sp->GetSelectedFrameIndex();
+            }
+        }
+    }
+
+    if (m_py_target
+        && target == m_globals_target
+        && process == m_globals_process
+        && stop_id == m_globals_stop_id
+        && tid == m_globals_tid
+        && frame_idx == m_globals_frame_idx
+        && ModuleAttributeIs (lldb_module.get(), "target", m_py_target)
+        && ModuleAttributeIs (lldb_module.get(), "process", m_py_process)
+        && ModuleAttributeIs (lldb_module.get(), "thread", m_py_thread)
+        && ModuleAttributeIs (lldb_module.get(), "frame", m_py_frame))
+        return;
+
+    CallMethodNoArgs (m_py_debugger.get(), "GetSelectedTarget", m_py_target);
+    CallMethodNoArgs (m_py_target.get(), "GetProcess", m_py_process);
+    CallMethodNoArgs (m_py_process.get(), "GetSelectedThread", m_py_thread);
+    CallMethodNoArgs (m_py_thread.get(), "GetSelectedFrame", m_py_frame);
+    if (!m_py_target || !m_py_process || !m_py_thread || !m_py_frame)
+    {
+        m_py_target.Reset ();
+        return;
+    }
+
+    PyObject_SetAttrString (lldb_module.get(), "target", m_py_target.get());
+    PyObject_SetAttrString (lldb_module.get(), "process", m_py_process.get());
+    PyObject_SetAttrString (lldb_module.get(), "thread", m_py_thread.get());
+    PyObject_SetAttrString (lldb_module.get(), "frame", m_py_frame.get());
+    if (PyErr_Occurred())
+        PyErr_Clear ();
+
+    m_globals_target = target;
+    m_globals_process = process;
+    m_globals_stop_id = stop_id;
+    m_globals_tid = tid;
+    m_globals_frame_idx = frame_idx;
+}
+
 PythonDictionary &
 ScriptInterpreterPython::GetSysModuleDictionary ()
 {
@@ -1813,7 +1967,7 @@ ScriptInterpreterPython::CreateSyntheticScriptedProvider(const char *class_name,
     void *ret_val = nullptr;
 
     {
-        Locker py_lock(this, Locker::AcquireLock | Locker::InitSession | Locker::NoSTDIN);
+        Locker py_lock(this, Locker::AcquireLock | Locker::InitDebugger, Locker::FreeLock);
         ret_val = g_swig_synthetic_script (class_name,
                                            python_interpreter->m_dictionary_name.c_str(),
                                            valobj);
@@ -1936,7 +2090,7 @@ ScriptInterpreterPython::GetScriptedSummary(const char *python_function_name, ll
     if (python_function_name && *python_function_name)
     {
         {
-            Locker py_lock(this, Locker::AcquireLock | Locker::InitSession | Locker::NoSTDIN);
+            Locker py_lock(this, Locker::AcquireLock | Locker::InitDebugger, Locker::FreeLock);
             {
                 TypeSummaryOptionsSP options_sp(new TypeSummaryOptions(options));
                 
@@ -1975,6 +2129,13 @@ ScriptInterpreterPython::Clear ()
     // order and we can't guarantee that we can access these.
     if (Py_IsInitialized())
         PyRun_SimpleString("lldb.debugger = None; lldb.target = None; lldb.process = None; lldb.thread = None; lldb.frame = None");
+
+    // Our cached copies hold references to the debugger too.
+    m_py_frame.Reset ();
+    m_py_thread.Reset ();
+    m_py_process.Reset ();
+    m_py_target.Reset ();
+    m_py_debugger.Reset ();
 }
 
 bool
@@ -2102,7 +2263,7 @@ ScriptInterpreterPython::CalculateNumChildren(const StructuredData::ObjectSP &im
     size_t ret_val = 0;
     
     {
-        Locker py_lock(this, Locker::AcquireLock | Locker::InitSession | Locker::NoSTDIN);
+        Locker py_lock(this, Locker::AcquireLock | Locker::InitDebugger, Locker::FreeLock);
         ret_val = g_swig_calc_children (implementor);
     }
     
@@ -2128,7 +2289,7 @@ ScriptInterpreterPython::GetChildAtIndex(const StructuredData::ObjectSP &impleme
     lldb::ValueObjectSP ret_val;
     
     {
-        Locker py_lock(this, Locker::AcquireLock | Locker::InitSession | Locker::NoSTDIN);
+        Locker py_lock(this, Locker::AcquireLock | Locker::InitDebugger, Locker::FreeLock);
         void* child_ptr = g_swig_get_child_index (implementor,idx);
         if (child_ptr != nullptr && child_ptr != Py_None)
         {
@@ -2147,6 +2308,36 @@ ScriptInterpreterPython::GetChildAtIndex(const StructuredData::ObjectSP &impleme
     return ret_val;
 }
 
+size_t
+ScriptInterpreterPython::GetChildrenInRange(const StructuredData::ObjectSP &implementor_sp,
+                                            const lldb::ValueObjectSP &parent_sp,
+                                            uint32_t start_idx,
+                                            uint32_t count,
+                                            std::vector<lldb::ValueObjectSP> &children)
+{
+    if (!implementor_sp)
+        return UINT32_MAX;
+
+    StructuredData::Generic *generic = implementor_sp->GetAsGeneric();
+    if (!generic)
+        return UINT32_MAX;
+    void *implementor = generic->GetValue();
+    if (!implementor)
+        return UINT32_MAX;
+
+    if (!g_swig_get_children_in_range)
+        return UINT32_MAX;
+
+    size_t ret_val = 0;
+
+    {
+        Locker py_lock(this, Locker::AcquireLock | Locker::InitDebugger, Locker::FreeLock);
+        ret_val = g_swig_get_children_in_range (implementor, parent_sp, start_idx, count, children);
+    }
+
+    return ret_val;
+}
+
 int
 ScriptInterpreterPython::GetIndexOfChildWithName(const StructuredData::ObjectSP &implementor_sp, const char *child_name)
 {
@@ -2166,7 +2357,7 @@ ScriptInterpreterPython::GetIndexOfChildWithName(const StructuredData::ObjectSP
     int ret_val = UINT32_MAX;
     
     {
-        Locker py_lock(this, Locker::AcquireLock | Locker::InitSession | Locker::NoSTDIN);
+        Locker py_lock(this, Locker::AcquireLock | Locker::InitDebugger, Locker::FreeLock);
         ret_val = g_swig_get_index_child (implementor, child_name);
     }
     
@@ -2192,7 +2383,7 @@ ScriptInterpreterPython::UpdateSynthProviderInstance(const StructuredData::Objec
         return ret_val;
     
     {
-        Locker py_lock(this, Locker::AcquireLock | Locker::InitSession | Locker::NoSTDIN);
+        Locker py_lock(this, Locker::AcquireLock | Locker::InitDebugger, Locker::FreeLock);
         ret_val = g_swig_update_provider (implementor);
     }
     
@@ -2218,7 +2409,7 @@ ScriptInterpreterPython::MightHaveChildrenSynthProviderInstance(const Structured
         return ret_val;
     
     {
-        Locker py_lock(this, Locker::AcquireLock | Locker::InitSession | Locker::NoSTDIN);
+        Locker py_lock(this, Locker::AcquireLock | Locker::InitDebugger, Locker::FreeLock);
         ret_val = g_swig_mighthavechildren_provider (implementor);
     }
     
@@ -2244,7 +2435,7 @@ ScriptInterpreterPython::GetSyntheticValue(const StructuredData::ObjectSP &imple
         return ret_val;
     
     {
-        Locker py_lock(this, Locker::AcquireLock | Locker::InitSession | Locker::NoSTDIN);
+        Locker py_lock(this, Locker::AcquireLock | Locker::InitDebugger, Locker::FreeLock);
         void* child_ptr = g_swig_getvalue_provider (implementor);
         if (child_ptr != nullptr && child_ptr != Py_None)
         {
@@ -2344,7 +2535,7 @@ ScriptInterpreterPython::RunScriptFormatKeyword (const char* impl_function,
     }
     {
         ProcessSP process_sp(process->shared_from_this());
-        Locker py_lock(this, Locker::AcquireLock | Locker::InitSession | Locker::NoSTDIN);
+        Locker py_lock(this, Locker::AcquireLock | Locker::InitDebugger, Locker::FreeLock);
         ret_val = g_swig_run_script_keyword_process (impl_function, m_dictionary_name.c_str(), process_sp, output);
         if (!ret_val)
             error.SetErrorString("python script evaluation failed");
@@ -2376,7 +2567,7 @@ ScriptInterpreterPython::RunScriptFormatKeyword (const char* impl_function,
     }
     {
         ThreadSP thread_sp(thread->shared_from_this());
-        Locker py_lock(this, Locker::AcquireLock | Locker::InitSession | Locker::NoSTDIN);
+        Locker py_lock(this, Locker::AcquireLock | Locker::InitDebugger, Locker::FreeLock);
         ret_val = g_swig_run_script_keyword_thread (impl_function, m_dictionary_name.c_str(), thread_sp, output);
         if (!ret_val)
             error.SetErrorString("python script evaluation failed");
@@ -2408,7 +2599,7 @@ ScriptInterpreterPython::RunScriptFormatKeyword (const char* impl_function,
     }
     {
         TargetSP target_sp(target->shared_from_this());
-        Locker py_lock(this, Locker::AcquireLock | Locker::InitSession | Locker::NoSTDIN);
+        Locker py_lock(this, Locker::AcquireLock | Locker::InitDebugger, Locker::FreeLock);
         ret_val = g_swig_run_script_keyword_target (impl_function, m_dictionary_name.c_str(), target_sp, output);
         if (!ret_val)
             error.SetErrorString("python script evaluation failed");
@@ -2440,7 +2631,7 @@ ScriptInterpreterPython::RunScriptFormatKeyword (const char* impl_function,
     }
     {
         StackFrameSP frame_sp(frame->shared_from_this());
-        Locker py_lock(this, Locker::AcquireLock | Locker::InitSession | Locker::NoSTDIN);
+        Locker py_lock(this, Locker::AcquireLock | Locker::InitDebugger, Locker::FreeLock);
         ret_val = g_swig_run_script_keyword_frame (impl_function, m_dictionary_name.c_str(), frame_sp, output);
         if (!ret_val)
             error.SetErrorString("python script evaluation failed");
@@ -2472,7 +2663,7 @@ ScriptInterpreterPython::RunScriptFormatKeyword (const char* impl_function,
     }
     {
         ValueObjectSP value_sp(value->GetSP());
-        Locker py_lock(this, Locker::AcquireLock | Locker::InitSession | Locker::NoSTDIN);
+        Locker py_lock(this, Locker::AcquireLock | Locker::InitDebugger, Locker::FreeLock);
         ret_val = g_swig_run_script_keyword_value (impl_function, m_dictionary_name.c_str(), value_sp, output);
         if (!ret_val)
             error.SetErrorString("python script evaluation failed");
@@ -2979,6 +3170,7 @@ ScriptInterpreterPython::InitializeInterpreter (SWIGInitCallback swig_init_callb
                                                 SWIGPythonCreateCommandObject swig_create_cmd,
                                                 SWIGPythonCalculateNumChildren swig_calc_children,
                                                 SWIGPythonGetChildAtIndex swig_get_child_index,
+                                                SWIGPythonGetChildrenInRange swig_get_children_in_range,
                                                 SWIGPythonGetIndexOfChildWithName swig_get_index_child,
                                                 SWIGPythonCastPyObjectToSBValue swig_cast_to_sbvalue ,
                                                 SWIGPythonGetValueObjectSPFromSBValue swig_get_valobj_sp_from_sbvalue,
@@ -3006,6 +3198,7 @@ ScriptInterpreterPython::InitializeInterpreter (SWIGInitCallback swig_init_callb
     g_swig_create_cmd = swig_create_cmd;
     g_swig_calc_children = swig_calc_children;
     g_swig_get_child_index = swig_get_child_index;
+    g_swig_get_children_in_range = swig_get_children_in_range;
     g_swig_get_index_child = swig_get_index_child;
     g_swig_cast_to_sbvalue = swig_cast_to_sbvalue;
     g_swig_get_valobj_sp_from_sbvalue = swig_get_valobj_sp_from_sbvalue;
@@ -1702,6 +1702,15 @@ ObjectFileELF::CreateSections(SectionList &unified_section_list)
 
             if (is_thread_specific)
                 section_sp->SetIsThreadSpecific (is_thread_specific);
+            if (header.sh_flags & SHF_ALLOC)
+            {
+                uint32_t permissions = ePermissionsReadable;
+                if (header.sh_flags & SHF_WRITE)
+                    permissions |= ePermissionsWritable;
+                if (header.sh_flags & SHF_EXECINSTR)
+                    permissions |= ePermissionsExecutable;
+                section_sp->SetPermissions (permissions);
+            }
             m_sections_ap->AddSection(section_sp);
         }
     }
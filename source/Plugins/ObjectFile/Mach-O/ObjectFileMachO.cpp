@@ -868,6 +868,19 @@ protected:
     }
 };
 
+static uint32_t
+GetSegmentPermissions (const segment_command_64 &seg_cmd)
+{
+    uint32_t permissions = 0;
+    if (seg_cmd.initprot & VM_PROT_READ)
+        permissions |= ePermissionsReadable;
+    if (seg_cmd.initprot & VM_PROT_WRITE)
+        permissions |= ePermissionsWritable;
+    if (seg_cmd.initprot & VM_PROT_EXECUTE)
+        permissions |= ePermissionsExecutable;
+    return permissions;
+}
+
 static uint32_t
 MachHeaderSizeFromMagic(uint32_t magic)
 {
@@ -1583,6 +1596,7 @@ ObjectFileMachO::CreateSections (SectionList &unified_section_list)
                                                           load_cmd.flags));       // Flags for this section
 
                             segment_sp->SetIsEncrypted (segment_is_encrypted);
+                            segment_sp->SetPermissions (GetSegmentPermissions (load_cmd));
                             m_sections_ap->AddSection(segment_sp);
                             if (add_to_unified)
                                 unified_section_list.AddSection(segment_sp);
@@ -1715,6 +1729,7 @@ ObjectFileMachO::CreateSections (SectionList &unified_section_list)
                                                                       sect64.align,
                                                                       load_cmd.flags));      // Flags for this section
                                         segment_sp->SetIsFake(true);
+                                        segment_sp->SetPermissions (GetSegmentPermissions (load_cmd));
                                         
                                         m_sections_ap->AddSection(segment_sp);
                                         if (add_to_unified)
@@ -1863,6 +1878,7 @@ ObjectFileMachO::CreateSections (SectionList &unified_section_list)
                                     section_is_encrypted = encrypted_file_ranges.FindEntryThatContains(sect64.offset) != NULL;
 
                                 section_sp->SetIsEncrypted (segment_is_encrypted || section_is_encrypted);
+                                section_sp->SetPermissions (GetSegmentPermissions (load_cmd));
                                 segment_sp->GetChildren().AddSection(section_sp);
 
                                 if (segment_sp->IsFake())
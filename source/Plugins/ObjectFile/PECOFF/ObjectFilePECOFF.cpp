@@ -768,6 +768,15 @@ ObjectFilePECOFF::CreateSections (SectionList &unified_section_list)
 
                 //section_sp->SetIsEncrypted (segment_is_encrypted);
 
+                uint32_t permissions = 0;
+                if (m_sect_headers[idx].flags & llvm::COFF::IMAGE_SCN_MEM_READ)
+                    permissions |= ePermissionsReadable;
+                if (m_sect_headers[idx].flags & llvm::COFF::IMAGE_SCN_MEM_WRITE)
+                    permissions |= ePermissionsWritable;
+                if (m_sect_headers[idx].flags & llvm::COFF::IMAGE_SCN_MEM_EXECUTE)
+                    permissions |= ePermissionsExecutable;
+                section_sp->SetPermissions (permissions);
+
                 unified_section_list.AddSection(section_sp);
                 m_sections_ap->AddSection (section_sp);
             }
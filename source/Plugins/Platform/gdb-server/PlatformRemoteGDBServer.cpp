@@ -34,6 +34,8 @@
 
 #include "Utility/UriParser.h"
 
+#include "Plugins/Process/gdb-remote/ProcessGDBRemote.h"
+
 using namespace lldb;
 using namespace lldb_private;
 
@@ -437,6 +439,9 @@ PlatformRemoteGDBServer::ConnectRemote (Args& args)
             {
                 if (m_gdb_client.HandshakeWithServer(&error))
                 {
+                    const uint64_t compression_min_size = ProcessGDBRemote::GetCompressionMinSize();
+                    if (compression_min_size > 0)
+                        m_gdb_client.EnableCompression(std::min<uint64_t>(compression_min_size, UINT32_MAX));
                     m_gdb_client.GetHostInfo();
                     // If a working directory was set prior to connecting, send it down now
                     if (m_working_dir)
@@ -0,0 +1,547 @@
+//===-- DisplacedStepping.cpp -----------------------------------*- C++ -*-===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+
+#include "DisplacedStepping.h"
+
+#include <string.h>
+
+using namespace lldb_private;
+
+namespace
+{
+    // Immediate operand encodings understood by the x86-64 length decoder.
+    enum ImmediateKind
+    {
+        eImmediateNone,
+        eImmediate8,
+        eImmediate16,
+        eImmediateZ,        // 16 or 32 bits, depending on the operand size.
+        eImmediateV,        // 16, 32 or 64 bits (mov r64, imm64).
+        eImmediateEnter,    // iw, ib
+        eImmediateMoffs     // Address sized absolute offset.
+    };
+
+    struct X86Instruction
+    {
+        size_t length;
+        size_t rip_disp_offset;     // Offset of a RIP-relative disp32, 0 if none.
+        bool relative_branch;
+        bool absolute_branch;
+        bool is_call;
+    };
+
+    uint32_t
+    ReadLE32 (const uint8_t *bytes)
+    {
+        return static_cast<uint32_t> (bytes[0]) |
+               static_cast<uint32_t> (bytes[1]) << 8 |
+               static_cast<uint32_t> (bytes[2]) << 16 |
+               static_cast<uint32_t> (bytes[3]) << 24;
+    }
+
+    void
+    WriteLE32 (uint8_t *bytes, uint32_t value)
+    {
+        bytes[0] = value & 0xff;
+        bytes[1] = (value >> 8) & 0xff;
+        bytes[2] = (value >> 16) & 0xff;
+        bytes[3] = (value >> 24) & 0xff;
+    }
+
+    // Classifies a one-byte-map opcode.  Returns false for opcodes that are
+    // invalid in 64-bit mode or that must not be stepped out of line (far
+    // transfers, interrupts, hlt).
+    bool
+    DecodeOneByteOpcode (uint8_t opcode, bool &has_modrm, ImmediateKind &imm, X86Instruction &insn)
+    {
+        if (opcode < 0x40)
+        {
+            switch (opcode & 7)
+            {
+            case 0: case 1: case 2: case 3:
+                has_modrm = true;
+                return true;
+            case 4:
+                imm = eImmediate8;
+                return true;
+            case 5:
+                imm = eImmediateZ;
+                return true;
+            default:
+                // Segment push/pop and BCD adjustments; the segment override
+                // prefixes in this column were consumed as prefixes.
+                return false;
+            }
+        }
+
+        if (opcode >= 0x50 && opcode <= 0x5f)
+            return true;
+        if (opcode >= 0x70 && opcode <= 0x7f)
+        {
+            imm = eImmediate8;
+            insn.relative_branch = true;
+            return true;
+        }
+        if (opcode >= 0x80 && opcode <= 0x8f)
+        {
+            if (opcode == 0x82)
+                return false;
+            has_modrm = true;
+            if (opcode == 0x81)
+                imm = eImmediateZ;
+            else if (opcode == 0x80 || opcode == 0x83)
+                imm = eImmediate8;
+            return true;
+        }
+        if (opcode >= 0x90 && opcode <= 0x9f)
+            return opcode != 0x9a;
+        if (opcode >= 0xa0 && opcode <= 0xa3)
+        {
+            imm = eImmediateMoffs;
+            return true;
+        }
+        if (opcode >= 0xa4 && opcode <= 0xaf)
+        {
+            if (opcode == 0xa8)
+                imm = eImmediate8;
+            else if (opcode == 0xa9)
+                imm = eImmediateZ;
+            return true;
+        }
+        if (opcode >= 0xb0 && opcode <= 0xb7)
+        {
+            imm = eImmediate8;
+            return true;
+        }
+        if (opcode >= 0xb8 && opcode <= 0xbf)
+        {
+            imm = eImmediateV;
+            return true;
+        }
+        if (opcode >= 0xd8 && opcode <= 0xdf)
+        {
+            has_modrm = true;
+            return true;
+        }
+
+        switch (opcode)
+        {
+        case 0x63:
+            has_modrm = true;
+            return true;
+        case 0x68:
+            imm = eImmediateZ;
+            return true;
+        case 0x69:
+            has_modrm = true;
+            imm = eImmediateZ;
+            return true;
+        case 0x6a:
+            imm = eImmediate8;
+            return true;
+        case 0x6b:
+            has_modrm = true;
+            imm = eImmediate8;
+            return true;
+        case 0x6c: case 0x6d: case 0x6e: case 0x6f:
+            return true;
+        case 0xc0: case 0xc1:
+            has_modrm = true;
+            imm = eImmediate8;
+            return true;
+        case 0xc2:
+            imm = eImmediate16;
+            insn.absolute_branch = true;
+            return true;
+        case 0xc3:
+            insn.absolute_branch = true;
+            return true;
+        case 0xc6:
+            has_modrm = true;
+            imm = eImmediate8;
+            return true;
+        case 0xc7:
+            has_modrm = true;
+            imm = eImmediateZ;
+            return true;
+        case 0xc8:
+            imm = eImmediateEnter;
+            return true;
+        case 0xc9:
+            return true;
+        case 0xd0: case 0xd1: case 0xd2: case 0xd3:
+            has_modrm = true;
+            return true;
+        case 0xd7:
+            return true;
+        case 0xe0: case 0xe1: case 0xe2: case 0xe3: case 0xeb:
+            imm = eImmediate8;
+            insn.relative_branch = true;
+            return true;
+        case 0xe4: case 0xe5: case 0xe6: case 0xe7:
+            imm = eImmediate8;
+            return true;
+        case 0xe8:
+            insn.is_call = true;
+            // Fall through.
+        case 0xe9:
+            imm = eImmediateZ;
+            insn.relative_branch = true;
+            return true;
+        case 0xec: case 0xed: case 0xee: case 0xef:
+        case 0xf5: case 0xf8: case 0xf9: case 0xfa: case 0xfb: case 0xfc: case 0xfd:
+            return true;
+        case 0xf6: case 0xf7: case 0xfe: case 0xff:
+            has_modrm = true;
+            return true;
+        default:
+            return false;
+        }
+    }
+
+    // Classifies an opcode in the 0x0f map (other than the 0x0f 0x38 and
+    // 0x0f 0x3a escapes).
+    bool
+    DecodeTwoByteOpcode (uint8_t opcode, bool &has_modrm, ImmediateKind &imm, X86Instruction &insn)
+    {
+        if (opcode >= 0x80 && opcode <= 0x8f)
+        {
+            imm = eImmediateZ;
+            insn.relative_branch = true;
+            return true;
+        }
+        if (opcode >= 0xc8 && opcode <= 0xcf)
+            return true;
+
+        switch (opcode)
+        {
+        // System calls, privileged and undefined instructions.
+        case 0x04: case 0x05: case 0x06: case 0x07: case 0x08: case 0x09:
+        case 0x0a: case 0x0b: case 0x0c: case 0x0e: case 0x0f:
+        case 0x24: case 0x25: case 0x26: case 0x27:
+        case 0x34: case 0x35: case 0x36: case 0x37:
+        case 0x7a: case 0x7b: case 0xa6: case 0xa7: case 0xaa:
+            return false;
+        case 0x30: case 0x31: case 0x32: case 0x33:
+        case 0x77: case 0xa0: case 0xa1: case 0xa2: case 0xa8: case 0xa9:
+            return true;
+        case 0x70: case 0x71: case 0x72: case 0x73:
+        case 0xa4: case 0xac: case 0xba:
+        case 0xc2: case 0xc4: case 0xc5: case 0xc6:
+            has_modrm = true;
+            imm = eImmediate8;
+            return true;
+        default:
+            has_modrm = true;
+            return true;
+        }
+    }
+
+    // Determines the length of the x86-64 instruction at the start of bytes
+    // and where its RIP-relative displacement, if any, lives.
+    bool
+    DecodeX86_64 (const uint8_t *bytes, size_t size, X86Instruction &insn)
+    {
+        size_t pos = 0;
+        bool operand_size_prefix = false;
+        bool address_size_prefix = false;
+        bool rep_prefix = false;
+        bool rex_w = false;
+
+        for (; pos < size; ++pos)
+        {
+            const uint8_t prefix = bytes[pos];
+            if (prefix == 0x66)
+                operand_size_prefix = true;
+            else if (prefix == 0x67)
+                address_size_prefix = true;
+            else if (prefix == 0xf2 || prefix == 0xf3)
+                rep_prefix = true;
+            else if (prefix != 0xf0 &&
+                     prefix != 0x2e && prefix != 0x36 && prefix != 0x3e &&
+                     prefix != 0x26 && prefix != 0x64 && prefix != 0x65)
+                break;
+        }
+
+        if (pos < size && (bytes[pos] & 0xf0) == 0x40)
+        {
+            rex_w = (bytes[pos] & 0x08) != 0;
+            ++pos;
+        }
+
+        if (pos >= size)
+            return false;
+
+        int opcode_map = 0;     // 0: one byte, 1: 0x0f, 2: 0x0f 0x38, 3: 0x0f 0x3a.
+        bool has_modrm = false;
+        ImmediateKind imm = eImmediateNone;
+        uint8_t opcode = bytes[pos++];
+
+        if (opcode == 0xc4 || opcode == 0xc5)
+        {
+            // VEX prefixed; the opcode map comes from the prefix itself.
+            if (opcode == 0xc5)
+            {
+                opcode_map = 1;
+                pos += 1;
+            }
+            else
+            {
+                if (pos >= size)
+                    return false;
+                opcode_map = bytes[pos] & 0x1f;
+                if (opcode_map < 1 || opcode_map > 3)
+                    return false;
+                pos += 2;
+            }
+            if (pos >= size)
+                return false;
+            opcode = bytes[pos++];
+            has_modrm = !(opcode_map == 1 && opcode == 0x77);
+            if (opcode_map == 3 ||
+                (opcode_map == 1 && ((opcode >= 0x70 && opcode <= 0x73) || opcode == 0xc2 || (opcode >= 0xc4 && opcode <= 0xc6))))
+                imm = eImmediate8;
+        }
+        else if (opcode == 0x0f)
+        {
+            if (pos >= size)
+                return false;
+            opcode = bytes[pos++];
+            if (opcode == 0x38 || opcode == 0x3a)
+            {
+                opcode_map = (opcode == 0x38) ? 2 : 3;
+                if (pos >= size)
+                    return false;
+                opcode = bytes[pos++];
+                has_modrm = true;
+                if (opcode_map == 3)
+                    imm = eImmediate8;
+            }
+            else
+            {
+                opcode_map = 1;
+                if (!DecodeTwoByteOpcode (opcode, has_modrm, imm, insn))
+                    return false;
+            }
+        }
+        else if (rep_prefix && ((opcode >= 0xa4 && opcode <= 0xa7) || (opcode >= 0xaa && opcode <= 0xaf) ||
+                                (opcode >= 0x6c && opcode <= 0x6f)))
+        {
+            // A single step of a repeated string instruction only runs one
+            // iteration and leaves the pc on the instruction, which would be
+            // the scratch slot rather than the original address.
+            return false;
+        }
+        else if (!DecodeOneByteOpcode (opcode, has_modrm, imm, insn))
+            return false;
+
+        if (has_modrm)
+        {
+            if (pos >= size)
+                return false;
+            const uint8_t modrm = bytes[pos++];
+            const uint8_t mod = modrm >> 6;
+            const uint8_t reg = (modrm >> 3) & 7;
+            const uint8_t rm = modrm & 7;
+
+            size_t disp_size = 0;
+            if (mod == 1)
+                disp_size = 1;
+            else if (mod == 2)
+                disp_size = 4;
+
+            if (mod != 3 && rm == 4)
+            {
+                if (pos >= size)
+                    return false;
+                const uint8_t sib = bytes[pos++];
+                if (mod == 0 && (sib & 7) == 5)
+                    disp_size = 4;
+            }
+            else if (mod == 0 && rm == 5)
+            {
+                // EIP-relative addressing isn't worth supporting.
+                if (address_size_prefix)
+                    return false;
+                insn.rip_disp_offset = pos;
+                disp_size = 4;
+            }
+            pos += disp_size;
+
+            if (opcode_map == 0)
+            {
+                switch (opcode)
+                {
+                case 0x8f:
+                    // Anything but pop Ev is an XOP prefix.
+                    if (reg != 0)
+                        return false;
+                    break;
+                case 0xc6: case 0xc7:
+                    // xabort, xbegin
+                    if (modrm == 0xf8)
+                        return false;
+                    break;
+                case 0xf6:
+                    if (reg < 2)
+                        imm = eImmediate8;
+                    break;
+                case 0xf7:
+                    if (reg < 2)
+                        imm = eImmediateZ;
+                    break;
+                case 0xfe:
+                    if (reg > 1)
+                        return false;
+                    break;
+                case 0xff:
+                    if (reg == 2 || reg == 4)
+                    {
+                        insn.absolute_branch = true;
+                        insn.is_call = (reg == 2);
+                    }
+                    else if (reg == 3 || reg == 5 || reg == 7)
+                        return false;
+                    break;
+                }
+            }
+        }
+
+        // The operand size prefix turns near branches into ones that
+        // truncate the target to 16 bits; leave those alone.
+        if (insn.relative_branch && operand_size_prefix)
+            return false;
+
+        switch (imm)
+        {
+        case eImmediateNone:  break;
+        case eImmediate8:     pos += 1; break;
+        case eImmediate16:    pos += 2; break;
+        case eImmediateZ:     pos += operand_size_prefix ? 2 : 4; break;
+        case eImmediateV:     pos += rex_w ? 8 : (operand_size_prefix ? 2 : 4); break;
+        case eImmediateEnter: pos += 3; break;
+        case eImmediateMoffs: pos += address_size_prefix ? 4 : 8; break;
+        }
+
+        if (pos > size || pos > 15)
+            return false;
+
+        insn.length = pos;
+        return true;
+    }
+}
+
+DisplacedInstruction::DisplacedInstruction () :
+    m_size (0),
+    m_orig_addr (LLDB_INVALID_ADDRESS),
+    m_slot_addr (LLDB_INVALID_ADDRESS),
+    m_relocate_pc (true),
+    m_is_call (false)
+{
+    ::memset (m_bytes, 0, sizeof (m_bytes));
+}
+
+bool
+DisplacedInstruction::Relocate (llvm::Triple::ArchType machine,
+                                const uint8_t *bytes,
+                                size_t size,
+                                lldb::addr_t orig_addr,
+                                lldb::addr_t slot_addr)
+{
+    m_size = 0;
+    m_orig_addr = orig_addr;
+    m_slot_addr = slot_addr;
+    m_relocate_pc = true;
+    m_is_call = false;
+
+    if (!bytes)
+        return false;
+    if (size > kMaxInstructionSize)
+        size = kMaxInstructionSize;
+
+    switch (machine)
+    {
+    case llvm::Triple::x86_64:
+        return RelocateX86_64 (bytes, size);
+    case llvm::Triple::aarch64:
+        return RelocateARM64 (bytes, size);
+    default:
+        return false;
+    }
+}
+
+bool
+DisplacedInstruction::RelocateX86_64 (const uint8_t *bytes, size_t size)
+{
+    X86Instruction insn;
+    ::memset (&insn, 0, sizeof (insn));
+    if (!DecodeX86_64 (bytes, size, insn))
+        return false;
+
+    ::memcpy (m_bytes, bytes, insn.length);
+
+    if (insn.rip_disp_offset != 0)
+    {
+        // Keep the operand pointing at the same address when the instruction
+        // executes from the slot.
+        const int64_t disp = static_cast<int32_t> (ReadLE32 (bytes + insn.rip_disp_offset));
+        const int64_t new_disp = disp + static_cast<int64_t> (m_orig_addr - m_slot_addr);
+        if (static_cast<int32_t> (new_disp) != new_disp)
+            return false;
+        WriteLE32 (m_bytes + insn.rip_disp_offset, static_cast<uint32_t> (new_disp));
+    }
+
+    m_size = insn.length;
+    m_relocate_pc = !insn.absolute_branch;
+    m_is_call = insn.is_call;
+    return true;
+}
+
+bool
+DisplacedInstruction::RelocateARM64 (const uint8_t *bytes, size_t size)
+{
+    if (size < 4)
+        return false;
+
+    const uint32_t insn = ReadLE32 (bytes);
+    if ((insn & 0x7c000000) == 0x14000000)
+    {
+        // B, BL
+        m_is_call = (insn & 0x80000000) != 0;
+    }
+    else if ((insn & 0xfe000000) == 0xd6000000)
+    {
+        // Branch to register: only plain BR, BLR and RET.
+        const uint32_t opc = (insn >> 21) & 0xf;
+        if (opc > 2 || ((insn >> 10) & 0x7ff) != 0x7c0 || (insn & 0x1f) != 0)
+            return false;
+        m_relocate_pc = false;
+        m_is_call = (opc == 1);
+    }
+    else if ((insn & 0x1f000000) == 0x10000000 ||   // ADR, ADRP
+             (insn & 0x3b000000) == 0x18000000 ||   // Load register (literal)
+             (insn & 0xff000000) == 0xd4000000)     // Exception generation
+    {
+        return false;
+    }
+    // Everything else, including B.cond, CB(N)Z and TB(N)Z, either falls
+    // through or branches relative to the pc, which FixupPC handles.
+
+    ::memcpy (m_bytes, bytes, 4);
+    m_size = 4;
+    return true;
+}
+
+lldb::addr_t
+DisplacedInstruction::FixupPC (lldb::addr_t pc) const
+{
+    if (m_relocate_pc || pc == m_slot_addr)
+        return m_orig_addr + (pc - m_slot_addr);
+    return pc;
+}
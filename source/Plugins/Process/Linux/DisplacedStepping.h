@@ -0,0 +1,147 @@
+//===-- DisplacedStepping.h -------------------------------------*- C++ -*-===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+
+#ifndef lldb_DisplacedStepping_h
+#define lldb_DisplacedStepping_h
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "llvm/ADT/Triple.h"
+
+#include "lldb/lldb-defines.h"
+#include "lldb/lldb-types.h"
+
+namespace lldb_private
+{
+    //----------------------------------------------------------------------
+    /// @class DisplacedInstruction DisplacedStepping.h
+    /// @brief Relocates a single instruction so it can be stepped out of line.
+    ///
+    /// NativeProcessLinux moves a thread off a software breakpoint by
+    /// single stepping a copy of the original instruction placed in a
+    /// scratch slot, so the trap never has to be lifted and the other
+    /// threads can keep running through the breakpoint.  This class decides
+    /// whether an instruction can execute from another address, produces
+    /// the bytes for the slot, and maps the thread's pc and return address
+    /// back to the original instruction stream afterwards.
+    //----------------------------------------------------------------------
+    class DisplacedInstruction
+    {
+    public:
+        enum
+        {
+            // Enough for the longest x86 instruction and for a single
+            // AArch64 instruction.
+            kMaxInstructionSize = 16
+        };
+
+        DisplacedInstruction ();
+
+        //------------------------------------------------------------------
+        /// Analyze the instruction at the start of @a bytes, which lives at
+        /// @a orig_addr, for execution at @a slot_addr.
+        ///
+        /// @param[in] machine
+        ///     The inferior's architecture.  Only x86_64 and aarch64 are
+        ///     supported.
+        ///
+        /// @param[in] bytes
+        ///     The original instruction bytes, with any breakpoint traps
+        ///     already replaced by the opcodes they cover.
+        ///
+        /// @param[in] size
+        ///     The number of valid bytes in @a bytes.
+        ///
+        /// @return
+        ///     \b true if the instruction can be stepped from @a slot_addr,
+        ///     \b false if it touches state that can't be relocated (system
+        ///     calls, traps, pc-relative operands that don't reach, ...).
+        //------------------------------------------------------------------
+        bool
+        Relocate (llvm::Triple::ArchType machine,
+                  const uint8_t *bytes,
+                  size_t size,
+                  lldb::addr_t orig_addr,
+                  lldb::addr_t slot_addr);
+
+        const uint8_t *
+        GetBytes () const
+        {
+            return m_bytes;
+        }
+
+        size_t
+        GetSize () const
+        {
+            return m_size;
+        }
+
+        lldb::addr_t
+        GetOriginalAddress () const
+        {
+            return m_orig_addr;
+        }
+
+        lldb::addr_t
+        GetSlotAddress () const
+        {
+            return m_slot_addr;
+        }
+
+        //------------------------------------------------------------------
+        /// Translate a pc reported by a thread that stepped (or was stopped
+        /// before stepping) the slot copy back to the original code.  Pcs
+        /// produced by absolute control transfers are returned unchanged.
+        //------------------------------------------------------------------
+        lldb::addr_t
+        FixupPC (lldb::addr_t pc) const;
+
+        //------------------------------------------------------------------
+        /// True if the instruction is a call.  After a completed step the
+        /// stored return address (on the stack for x86_64, in the link
+        /// register for aarch64) equals GetSlotReturnAddress () and must be
+        /// replaced with GetReturnAddress ().
+        //------------------------------------------------------------------
+        bool
+        IsCall () const
+        {
+            return m_is_call;
+        }
+
+        lldb::addr_t
+        GetSlotReturnAddress () const
+        {
+            return m_slot_addr + m_size;
+        }
+
+        lldb::addr_t
+        GetReturnAddress () const
+        {
+            return m_orig_addr + m_size;
+        }
+
+    private:
+        bool
+        RelocateX86_64 (const uint8_t *bytes, size_t size);
+
+        bool
+        RelocateARM64 (const uint8_t *bytes, size_t size);
+
+        uint8_t m_bytes[kMaxInstructionSize];
+        size_t m_size;
+        lldb::addr_t m_orig_addr;
+        lldb::addr_t m_slot_addr;
+        bool m_relocate_pc;     // The next pc is relative to the instruction's address.
+        bool m_is_call;
+    };
+
+} // namespace lldb_private
+
+#endif // #ifndef lldb_DisplacedStepping_h
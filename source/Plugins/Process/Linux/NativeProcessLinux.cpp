@@ -19,10 +19,12 @@
 #include <unistd.h>
 
 // C++ Includes
+#include <algorithm>
 #include <fstream>
 #include <string>
 
 // Other libraries and framework includes
+#include "lldb/Core/DataBuffer.h"
 #include "lldb/Core/Debugger.h"
 #include "lldb/Core/Error.h"
 #include "lldb/Core/Module.h"
@@ -53,8 +55,12 @@
 // System includes - They have to be included after framework includes because they define some
 // macros which collide with variable names in other modules
 #include <linux/unistd.h>
+#include <sys/auxv.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
 #include <sys/personality.h>
 #include <sys/ptrace.h>
+#include <sys/signalfd.h>
 #include <sys/socket.h>
 #include <sys/syscall.h>
 #include <sys/types.h>
@@ -142,7 +148,17 @@ namespace
     using namespace lldb;
     using namespace lldb_private;
 
-    static void * const EXIT_OPERATION = nullptr;
+    // Handed to the operation thread to stop its event loop.  It must differ
+    // from nullptr, which the loop reads as "no operation pending".
+    static char g_exit_operation;
+    static void * const EXIT_OPERATION = &g_exit_operation;
+
+    // Number of displaced stepping slots.  They overwrite the start of the
+    // executable's entry point function, whose size we cannot know without
+    // symbols, so keep them within the smallest _start we support (about 40
+    // bytes on x86_64 and aarch64).  Threads that find every slot taken step
+    // over their breakpoint in place instead.
+    const size_t kNumDisplacedStepSlots = 2;
 
     const UnixSignals&
     GetUnixSignals ()
@@ -514,6 +530,9 @@ namespace
         const Error &
         GetError () const { return m_error; }
 
+        void
+        SetError (const Error &error) { m_error = error; }
+
     protected:
         Error m_error;
     };
@@ -1271,31 +1290,46 @@ NativeProcessLinux::NativeProcessLinux () :
     NativeProcessProtocol (LLDB_INVALID_PROCESS_ID),
     m_arch (),
     m_operation_thread (),
-    m_monitor_thread (),
+    m_tracer_thread (LLDB_INVALID_HOST_THREAD),
     m_operation (nullptr),
     m_operation_mutex (),
-    m_operation_pending (),
     m_operation_done (),
+    m_event_loop_exited (false),
+    m_wakeup_fd (-1),
+    m_sigchld_fd (-1),
+    m_epoll_fd (-1),
     m_supports_mem_region (eLazyBoolCalculate),
     m_mem_region_cache (),
     m_mem_region_cache_mutex (),
     m_coordinator_up (new ThreadStateCoordinator (GetThreadLoggerFunction ())),
-    m_coordinator_thread ()
+    m_displaced_step_area (LLDB_INVALID_ADDRESS),
+    m_displaced_steps (),
+    m_displaced_steps_mutex (),
+    m_inline_step_tid (LLDB_INVALID_THREAD_ID),
+    m_inline_step_addr (LLDB_INVALID_ADDRESS),
+    m_inline_step_state (eStateInvalid),
+    m_inline_step_actions (),
+    m_inline_stepped_tids (),
+    m_inline_step_held_tids (),
+    m_non_stop_stop_requests ()
 {
 }
 
 //------------------------------------------------------------------------------
-/// The basic design of the NativeProcessLinux is built around two threads.
+/// The basic design of the NativeProcessLinux is built around a single
+/// privileged thread (@see RunEventLoop).
 ///
-/// One thread (@see SignalThread) simply blocks on a call to waitpid() looking
-/// for changes in the debugee state.  When a change is detected a
-/// ProcessMessage is sent to the associated ProcessLinux instance.  This thread
-/// "drives" state changes in the debugger.
+/// That thread first launches or attaches to the inferior, which makes it the
+/// only thread allowed to ptrace() it.  It then sits in an epoll() loop that
+/// wakes on SIGCHLD (via a signalfd) to reap wait statuses, on queued
+/// ThreadStateCoordinator events, and on operations such as register
+/// reads/writes handed over from other threads.  Stop handling, the
+/// coordinator's deferred actions and the ptrace calls they make all run
+/// inline on this thread.  See the comments on the Operation class for more
+/// info as to why this is needed.
 ///
-/// The second thread (@see OperationThread) is responsible for two things 1)
-/// launching or attaching to the inferior process, and then 2) servicing
-/// operations such as register reads/writes, stepping, etc.  See the comments
-/// on the Operation class for more info as to why this is needed.
+/// SIGCHLD must be blocked in every thread of the process for the signalfd to
+/// see it; lldb-server blocks it before starting any thread.
 void
 NativeProcessLinux::LaunchInferior (
     Module *module,
@@ -1319,14 +1353,11 @@ NativeProcessLinux::LaunchInferior (
             stdin_path, stdout_path, stderr_path,
             working_dir, launch_info));
 
-    sem_init (&m_operation_pending, 0, 0);
-    sem_init (&m_operation_done, 0, 0);
-
-    StartLaunchOpThread (args.get(), error);
+    error = InitializeEventLoop ();
     if (!error.Success ())
         return;
 
-    error = StartCoordinatorThread ();
+    StartLaunchOpThread (args.get(), error);
     if (!error.Success ())
         return;
 
@@ -1347,20 +1378,9 @@ WAIT_AGAIN:
     if (!args->m_error.Success())
     {
         StopOpThread();
-        StopCoordinatorThread ();
         error = args->m_error;
         return;
     }
-
-    // Finally, start monitoring the child process for change in state.
-    m_monitor_thread = Host::StartMonitoringChildProcess(
-        NativeProcessLinux::MonitorCallback, this, GetID(), true);
-    if (!m_monitor_thread.IsJoinable())
-    {
-        error.SetErrorToGenericError();
-        error.SetErrorString ("Process attach failed to create monitor thread for NativeProcessLinux::MonitorCallback.");
-        return;
-    }
 }
 
 void
@@ -1407,8 +1427,9 @@ NativeProcessLinux::AttachToInferior (lldb::pid_t pid, lldb_private::Error &erro
     m_pid = pid;
     SetState(eStateAttaching);
 
-    sem_init (&m_operation_pending, 0, 0);
-    sem_init (&m_operation_done, 0, 0);
+    error = InitializeEventLoop ();
+    if (!error.Success ())
+        return;
 
     std::unique_ptr<AttachArgs> args (new AttachArgs (this, pid));
 
@@ -1416,10 +1437,6 @@ NativeProcessLinux::AttachToInferior (lldb::pid_t pid, lldb_private::Error &erro
     if (!error.Success ())
         return;
 
-    error = StartCoordinatorThread ();
-    if (!error.Success ())
-        return;
-
 WAIT_AGAIN:
     // Wait for the operation thread to initialize.
     if (sem_wait (&args->m_semaphore))
@@ -1437,20 +1454,9 @@ WAIT_AGAIN:
     if (!args->m_error.Success ())
     {
         StopOpThread ();
-        StopCoordinatorThread ();
         error = args->m_error;
         return;
     }
-
-    // Finally, start monitoring the child process for change in state.
-    m_monitor_thread = Host::StartMonitoringChildProcess (
-        NativeProcessLinux::MonitorCallback, this, GetID (), true);
-    if (!m_monitor_thread.IsJoinable())
-    {
-        error.SetErrorToGenericError ();
-        error.SetErrorString ("Process attach failed to create monitor thread for NativeProcessLinux::MonitorCallback.");
-        return;
-    }
 }
 
 void
@@ -1483,7 +1489,7 @@ NativeProcessLinux::LaunchOpThread(void *arg)
         return NULL;
     }
 
-    ServeOperation(args);
+    RunEventLoop(args);
     return NULL;
 }
 
@@ -1497,6 +1503,9 @@ NativeProcessLinux::Launch(LaunchArgs *args)
     NativeProcessLinux *monitor = args->m_monitor;
     assert (monitor && "monitor is NULL");
 
+    // This thread becomes the tracer; operations it issues run inline.
+    monitor->m_tracer_thread = Host::GetCurrentThread ();
+
     const char **argv = args->m_argv;
     const char **envp = args->m_envp;
     const char *working_dir = args->m_working_dir;
@@ -1542,6 +1551,12 @@ NativeProcessLinux::Launch(LaunchArgs *args)
         if (args->m_error.Fail())
             exit(ePtraceFailed);
 
+        // Don't let the inferior inherit the SIGCHLD block the monitor relies on.
+        sigset_t sigchld_set;
+        sigemptyset (&sigchld_set);
+        sigaddset (&sigchld_set, SIGCHLD);
+        sigprocmask (SIG_UNBLOCK, &sigchld_set, nullptr);
+
         // terminal has already dupped the tty descriptors to stdin/out/err.
         // This closes original fd from which they were copied (and avoids
         // leaking descriptors to the debugged process.
@@ -1765,7 +1780,7 @@ NativeProcessLinux::AttachOpThread(void *arg)
         return nullptr;
     }
 
-    ServeOperation(args);
+    RunEventLoop(args);
     return nullptr;
 }
 
@@ -1778,6 +1793,9 @@ NativeProcessLinux::Attach(AttachArgs *args)
     lldb::ThreadSP inferior;
     Log *log (GetLogIfAllCategoriesSet (LIBLLDB_LOG_PROCESS));
 
+    // This thread becomes the tracer; operations it issues run inline.
+    monitor->m_tracer_thread = Host::GetCurrentThread ();
+
     // Use a map to keep track of the threads which we have attached/need to attach.
     Host::TidMap tids_to_attach;
     if (pid <= 1)
@@ -2156,6 +2174,24 @@ NativeProcessLinux::MonitorSIGTRAP(const siginfo_t *info, lldb::pid_t pid)
         // The thread state coordinator needs to reset due to the exec.
         m_coordinator_up->ResetForExec ();
 
+        // The new image has its own entry point, and no step over a
+        // breakpoint survives the exec.
+        {
+            Mutex::Locker displaced_steps_locker (m_displaced_steps_mutex);
+            m_displaced_step_area = LLDB_INVALID_ADDRESS;
+            m_displaced_steps.clear ();
+            m_inline_step_tid = LLDB_INVALID_THREAD_ID;
+            m_inline_step_addr = LLDB_INVALID_ADDRESS;
+            m_inline_step_state = eStateInvalid;
+            m_inline_step_actions.Clear ();
+            m_inline_stepped_tids.clear ();
+            m_inline_step_held_tids.clear ();
+        }
+        {
+            Mutex::Locker threads_locker (m_threads_mutex);
+            m_non_stop_stop_requests.clear ();
+        }
+
         // Remove all but the main thread here.  Linux fork creates a new process which only copies the main thread.  Mutexes are in undefined state.
         if (log)
             log->Printf ("NativeProcessLinux::%s exec received, stop tracking all but main thread", __FUNCTION__);
@@ -2178,10 +2214,12 @@ NativeProcessLinux::MonitorSIGTRAP(const siginfo_t *info, lldb::pid_t pid)
         }
 
         m_threads.clear ();
+        m_threads_by_id.clear ();
 
         if (main_thread_sp)
         {
             m_threads.push_back (main_thread_sp);
+            m_threads_by_id[main_thread_sp->GetID ()] = main_thread_sp;
             SetCurrentThreadID (main_thread_sp->GetID ());
             std::static_pointer_cast<NativeThreadLinux> (main_thread_sp)->SetStoppedByExec ();
         }
@@ -2248,6 +2286,40 @@ NativeProcessLinux::MonitorSIGTRAP(const siginfo_t *info, lldb::pid_t pid)
                                                },
                                                CoordinatorErrorHandler);
 
+        // An exiting thread never gets past its breakpoint.  If the others
+        // were waiting on it to do so, let them go now.
+        if (thread_sp)
+        {
+            bool resume_when_done = false;
+            FinishDisplacedStep (thread_sp, resume_when_done);
+
+            bool inline_step = false;
+            bool resume_others = false;
+            ResumeActionList resume_actions;
+            {
+                Mutex::Locker locker (m_displaced_steps_mutex);
+                inline_step = (pid == m_inline_step_tid);
+                if (inline_step)
+                {
+                    resume_actions = m_inline_step_actions;
+                    resume_others = (m_inline_step_state == eStateRunning);
+                }
+            }
+
+            if (inline_step)
+            {
+                FinishInlineStepOver (thread_sp, false);
+                if (resume_others)
+                {
+                    {
+                        Mutex::Locker locker (m_displaced_steps_mutex);
+                        m_inline_stepped_tids.insert (pid);
+                    }
+                    Resume (resume_actions);
+                }
+            }
+        }
+
         break;
     }
 
@@ -2256,6 +2328,12 @@ NativeProcessLinux::MonitorSIGTRAP(const siginfo_t *info, lldb::pid_t pid)
     case TRAP_HWBKPT: // We receive this on watchpoint hit
         if (thread_sp)
         {
+            // Put a thread that stepped over a breakpoint back on the original
+            // code before anything is reported about it.
+            bool resume_when_done = false;
+            const bool displaced_step = FinishDisplacedStep (thread_sp, resume_when_done);
+            const bool inline_step = IsSteppingOverBreakpointInPlace (pid);
+
             // If a watchpoint was hit, report it
             uint32_t wp_index;
             Error error = thread_sp->GetRegisterContext()->GetWatchpointHitIndex(wp_index);
@@ -2266,9 +2344,28 @@ NativeProcessLinux::MonitorSIGTRAP(const siginfo_t *info, lldb::pid_t pid)
                             __FUNCTION__, pid, error.AsCString());
             if (wp_index != LLDB_INVALID_INDEX32)
             {
+                if (inline_step)
+                    FinishInlineStepOver (thread_sp, false);
                 MonitorWatchpoint(pid, thread_sp, wp_index);
                 break;
             }
+
+            if (inline_step)
+            {
+                FinishInlineStepOver (thread_sp, true);
+                break;
+            }
+
+            if (displaced_step && resume_when_done)
+            {
+                // The thread was continued, not stepped: let it carry on.
+                std::static_pointer_cast<NativeThreadLinux> (thread_sp)->SetRunning ();
+                error = Resume (pid, LLDB_INVALID_SIGNAL_NUMBER);
+                if (error.Fail () && log)
+                    log->Printf ("NativeProcessLinux::%s() failed to resume tid %" PRIu64 " after a displaced step: %s",
+                                 __FUNCTION__, pid, error.AsCString ());
+                break;
+            }
         }
         // Otherwise, report step over
         MonitorTrace(pid, thread_sp);
@@ -2431,6 +2528,12 @@ NativeProcessLinux::MonitorSignal(const siginfo_t *info, lldb::pid_t pid, bool e
         if (log)
             log->Printf ("NativeProcessLinux::%s() pid %" PRIu64 " no thread found for tid %" PRIu64, __FUNCTION__, GetID (), pid);
     }
+    else
+    {
+        // The signal beat a step over a breakpoint; the thread stops on the
+        // original code and will try again when next resumed.
+        AbortBreakpointStepOver (thread_sp);
+    }
 
     // Handle the signal.
     if (info->si_code == SI_TKILL || info->si_code == SI_USER)
@@ -2513,10 +2616,23 @@ NativeProcessLinux::MonitorSignal(const siginfo_t *info, lldb::pid_t pid, bool e
                 // stop signal as 0 to let lldb know this isn't the important stop.
                 linux_thread_sp->SetStoppedBySignal (0);
                 SetCurrentThreadID (thread_sp->GetID ());
-                m_coordinator_up->NotifyThreadStop (thread_sp->GetID (), true, CoordinatorErrorHandler);
+                if (TakeNonStopStopRequest (thread_sp->GetID ()))
+                {
+                    // Interrupted on its own in non-stop mode: this stop is
+                    // the one to report, and it must not be undone by the
+                    // coordinator, which never asked for it.
+                    NotifyThreadStop (thread_sp->GetID ());
+                    ReportNonStopThreadStop (thread_sp->GetID ());
+                }
+                else
+                    m_coordinator_up->NotifyThreadStop (thread_sp->GetID (), true, CoordinatorErrorHandler);
             }
             else
             {
+                // A non-stop interrupt that lost the race with a real stop;
+                // that stop has been reported already.
+                TakeNonStopStopRequest (thread_sp->GetID ());
+
                 if (log)
                 {
                     // Retrieve the signal name if the thread was stopped by a signal.
@@ -2610,12 +2726,173 @@ NativeProcessLinux::Resume (const ResumeActionList &resume_actions)
     NativeThreadProtocolSP deferred_signal_thread_sp;
     bool stepping = false;
 
-    Mutex::Locker locker (m_threads_mutex);
+    // Work on a snapshot of the thread list.  Stepping over breakpoints below
+    // reads registers and memory through the privileged thread, which must
+    // stay free to take m_threads_mutex while it handles stops.
+    std::vector<NativeThreadProtocolSP> threads;
+    {
+        Mutex::Locker locker (m_threads_mutex);
+        threads = m_threads;
+    }
 
-    for (auto thread_sp : m_threads)
+    // Work out how each thread sitting on a software breakpoint gets past
+    // it.  Nothing is changed until every thread has a plan, since a single
+    // thread that has to step in place holds up all the others.
+    std::map<lldb::tid_t, std::pair<DisplacedInstruction, size_t>> displaced_steps;
+    std::vector<size_t> free_slots;
+    const lldb::addr_t displaced_step_area = GetDisplacedStepArea ();
+    if (displaced_step_area != LLDB_INVALID_ADDRESS)
+    {
+        Mutex::Locker locker (m_displaced_steps_mutex);
+        for (size_t slot_index = kNumDisplacedStepSlots; slot_index-- > 0; )
+        {
+            bool used = false;
+            for (const auto &step : m_displaced_steps)
+                used |= (step.second.slot_index == slot_index);
+            if (!used)
+                free_slots.push_back (slot_index);
+        }
+    }
+
+    for (auto thread_sp : threads)
     {
         assert (thread_sp && "thread list should not contain NULL threads");
 
+        const ResumeAction *const action = resume_actions.GetActionForThread (thread_sp->GetID (), true);
+        if (action == nullptr || (action->state != eStateRunning && action->state != eStateStepping))
+            continue;
+
+        // In non-stop mode a thread can still be running from an earlier
+        // request; it has no breakpoint to get past.
+        if (!StateIsStoppedState (thread_sp->GetState (), false))
+            continue;
+
+        // A thread that just stepped over its breakpoint in place may have
+        // landed right back on one; that one it should hit.
+        {
+            Mutex::Locker locker (m_displaced_steps_mutex);
+            if (m_inline_stepped_tids.count (thread_sp->GetID ()))
+                continue;
+        }
+
+        const lldb::addr_t bp_addr = GetSoftwareBreakpointAtPC (thread_sp);
+        if (bp_addr == LLDB_INVALID_ADDRESS)
+            continue;
+
+        // Signal handlers would run with the pc in the slot, so threads
+        // resumed with a signal always step in place.
+        DisplacedInstruction instruction;
+        if (action->signal <= 0 && !free_slots.empty () &&
+            RelocateBreakpointInstruction (bp_addr, displaced_step_area + free_slots.back () * DisplacedInstruction::kMaxInstructionSize, instruction))
+        {
+            displaced_steps[thread_sp->GetID ()] = std::make_pair (instruction, free_slots.back ());
+            free_slots.pop_back ();
+            continue;
+        }
+
+        if (log)
+            log->Printf ("NativeProcessLinux::%s tid %" PRIu64 " stepping over the breakpoint at 0x%" PRIx64 " in place",
+                         __FUNCTION__, thread_sp->GetID (), bp_addr);
+
+        // In non-stop mode other threads may be running on their own and
+        // would go straight through the lifted trap.  They are held until
+        // this thread is past it, and FinishInlineStepOver lets them go.
+        std::unordered_set<lldb::tid_t> held_tids;
+        if (GetNonStopMode ())
+        {
+            for (auto other_thread_sp : threads)
+            {
+                if (other_thread_sp != thread_sp && !StateIsStoppedState (other_thread_sp->GetState (), false))
+                    held_tids.insert (other_thread_sp->GetID ());
+            }
+        }
+
+        // Step just this thread with its breakpoint lifted.  The whole
+        // request is replayed from MonitorSIGTRAP once it is past the trap.
+        if (held_tids.empty ())
+        {
+            Error error = m_breakpoint_list.DisableBreakpoint (bp_addr);
+            if (error.Fail ())
+                return error;
+        }
+
+        // The thread's signal goes in with the step below, so the request
+        // replayed afterwards must not deliver it a second time.
+        ResumeActionList replay_actions;
+        replay_actions.AppendAction (thread_sp->GetID (), action->state);
+        for (size_t i = 0; i < resume_actions.GetSize (); ++i)
+        {
+            const ResumeAction &replay_action = resume_actions.GetFirst ()[i];
+            if (replay_action.tid != thread_sp->GetID ())
+                replay_actions.Append (replay_action);
+        }
+
+        {
+            Mutex::Locker locker (m_displaced_steps_mutex);
+            m_inline_step_tid = thread_sp->GetID ();
+            m_inline_step_addr = bp_addr;
+            m_inline_step_state = action->state;
+            m_inline_step_actions = replay_actions;
+            m_inline_step_held_tids = held_tids;
+        }
+
+        const lldb::tid_t tid = thread_sp->GetID ();
+        const int signo = action->signal;
+        const StateType state = action->state;
+        const ThreadStateCoordinator::ResumeThreadFunction step_function =
+            [=](lldb::tid_t tid_to_step, bool supress_signal)
+            {
+                if (state == eStateStepping)
+                    std::static_pointer_cast<NativeThreadLinux> (thread_sp)->SetStepping ();
+                else
+                    std::static_pointer_cast<NativeThreadLinux> (thread_sp)->SetRunning ();
+                const auto step_result = SingleStep (tid_to_step, (signo > 0 && !supress_signal) ? signo : LLDB_INVALID_SIGNAL_NUMBER);
+                if (step_result.Success())
+                    SetState(state, true);
+                return step_result;
+            };
+
+        if (held_tids.empty ())
+        {
+            m_coordinator_up->RequestThreadResume (tid, step_function, CoordinatorErrorHandler);
+            return Error ();
+        }
+
+        const lldb::pid_t pid = GetID ();
+        m_coordinator_up->CallAfterThreadsStop (tid,
+                                                held_tids,
+                                                [=](lldb::tid_t request_stop_tid)
+                                                {
+                                                    return RequestThreadStop (pid, request_stop_tid);
+                                                },
+                                                [=](lldb::tid_t)
+                                                {
+                                                    Error error = m_breakpoint_list.DisableBreakpoint (bp_addr);
+                                                    if (error.Fail ())
+                                                    {
+                                                        Log *log (GetLogIfAnyCategoriesSet (LIBLLDB_LOG_BREAKPOINTS | LIBLLDB_LOG_STEP));
+                                                        if (log)
+                                                            log->Printf ("NativeProcessLinux::Resume failed to lift the breakpoint at 0x%" PRIx64 " for tid %" PRIu64 ": %s",
+                                                                         bp_addr, tid, error.AsCString ());
+
+                                                        // Let the held threads go and report this one where it is.
+                                                        FinishInlineStepOver (thread_sp, false);
+                                                        ReportNonStopThreadStop (tid);
+                                                        return;
+                                                    }
+                                                    m_coordinator_up->RequestThreadResume (tid, step_function, CoordinatorErrorHandler);
+                                                },
+                                                CoordinatorErrorHandler);
+        return Error ();
+    }
+
+    {
+        Mutex::Locker locker (m_displaced_steps_mutex);
+        m_inline_stepped_tids.clear ();
+    }
+
+    for (auto thread_sp : threads)
+    {
         const ResumeAction *const action = resume_actions.GetActionForThread (thread_sp->GetID (), true);
 
         if (action == nullptr)
@@ -2632,6 +2909,53 @@ NativeProcessLinux::Resume (const ResumeActionList &resume_actions)
                     __FUNCTION__, StateAsCString (action->state), GetID (), thread_sp->GetID ());
         }
 
+        if (GetNonStopMode ())
+        {
+            // Each thread is handled on its own: a stop request interrupts
+            // just that thread, and threads already running are left alone.
+            const bool thread_running = !StateIsStoppedState (thread_sp->GetState (), false);
+            if (action->state == eStateStopped)
+            {
+                if (thread_running)
+                {
+                    Error error = RequestNonStopThreadStop (thread_sp);
+                    if (error.Fail ())
+                        return error;
+                }
+                continue;
+            }
+            if (action->state == eStateSuspended || thread_running)
+                continue;
+        }
+
+        auto displaced_iter = displaced_steps.find (thread_sp->GetID ());
+        if (displaced_iter != displaced_steps.end ())
+        {
+            // Step the relocated instruction; MonitorSIGTRAP puts the thread
+            // back and, for a continue, lets it go without a stop.
+            const StateType state = action->state;
+            Error error = StartDisplacedStep (thread_sp, displaced_iter->second.first, displaced_iter->second.second, state == eStateRunning);
+            if (error.Fail ())
+                return error;
+
+            m_coordinator_up->RequestThreadResume (thread_sp->GetID (),
+                                                   [=](lldb::tid_t tid_to_step, bool supress_signal)
+                                                   {
+                                                       if (state == eStateStepping)
+                                                           std::static_pointer_cast<NativeThreadLinux> (thread_sp)->SetStepping ();
+                                                       else
+                                                           std::static_pointer_cast<NativeThreadLinux> (thread_sp)->SetRunning ();
+                                                       const auto step_result = SingleStep (tid_to_step, LLDB_INVALID_SIGNAL_NUMBER);
+                                                       if (step_result.Success())
+                                                           SetState(state, true);
+                                                       return step_result;
+                                                   },
+                                                   CoordinatorErrorHandler);
+            if (state == eStateStepping)
+                stepping = true;
+            continue;
+        }
+
         switch (action->state)
         {
         case eStateRunning:
@@ -2691,7 +3015,7 @@ NativeProcessLinux::Resume (const ResumeActionList &resume_actions)
     // If we had any thread stopping, then do a deferred notification of the chosen stop thread id and signal
     // after all other running threads have stopped.
     // If there is a stepping thread involved we'll be eventually stopped by SIGTRAP trace signal.
-    if (deferred_signal_tid != LLDB_INVALID_THREAD_ID && !stepping)
+    if (deferred_signal_tid != LLDB_INVALID_THREAD_ID && !stepping && !GetNonStopMode ())
     {
         CallAfterRunningThreadsStopWithSkipTID (deferred_signal_tid,
                                                 deferred_signal_skip_tid,
@@ -2763,12 +3087,30 @@ NativeProcessLinux::Interrupt ()
 
     NativeThreadProtocolSP running_thread_sp;
     NativeThreadProtocolSP stopped_thread_sp;
-        
-    if (log)
-        log->Printf ("NativeProcessLinux::%s selecting running thread for interrupt target", __FUNCTION__);
 
     Mutex::Locker locker (m_threads_mutex);
 
+    if (GetNonStopMode ())
+    {
+        // Stop whatever is still running; each thread reports on its own.
+        if (log)
+            log->Printf ("NativeProcessLinux::%s interrupting all running threads in non-stop mode", __FUNCTION__);
+
+        for (auto thread_sp : m_threads)
+        {
+            if (!thread_sp || StateIsStoppedState (thread_sp->GetState (), false))
+                continue;
+
+            Error error = RequestNonStopThreadStop (thread_sp);
+            if (error.Fail ())
+                return error;
+        }
+        return Error ();
+    }
+
+    if (log)
+        log->Printf ("NativeProcessLinux::%s selecting running thread for interrupt target", __FUNCTION__);
+
     for (auto thread_sp : m_threads)
     {
         // The thread shouldn't be null but lets just cover that here.
@@ -2824,6 +3166,29 @@ NativeProcessLinux::Interrupt ()
     return Error();
 }
 
+Error
+NativeProcessLinux::SetNonStopMode (bool enabled)
+{
+    Log *log (GetLogIfAllCategoriesSet (LIBLLDB_LOG_PROCESS));
+    if (log)
+        log->Printf ("NativeProcessLinux::%s pid %" PRIu64 " %s non-stop mode", __FUNCTION__, GetID (), enabled ? "entering" : "leaving");
+
+    if (!enabled && GetNonStopMode ())
+    {
+        // The next all-stop stop would have no way to account for threads
+        // that are still running on their own.
+        Mutex::Locker locker (m_threads_mutex);
+        for (auto thread_sp : m_threads)
+        {
+            if (thread_sp && !StateIsStoppedState (thread_sp->GetState (), false))
+                return Error ("all threads must be stopped to leave non-stop mode");
+        }
+    }
+
+    m_non_stop_mode = enabled;
+    return Error ();
+}
+
 Error
 NativeProcessLinux::Kill ()
 {
@@ -3387,53 +3752,202 @@ NativeProcessLinux::GetCrashReasonForSIGBUS(const siginfo_t *info)
 }
 #endif
 
+// Fails an operation the event loop will never get to execute.
+static void
+FailUnservedOperation (void *op)
+{
+    static_cast<Operation*>(op)->SetError (Error ("the inferior's event loop has exited"));
+}
+
 void
-NativeProcessLinux::ServeOperation(OperationArgs *args)
+NativeProcessLinux::RunEventLoop(OperationArgs *args)
 {
     NativeProcessLinux *monitor = args->m_monitor;
+    Log *log (GetLogIfAllCategoriesSet (LIBLLDB_LOG_PROCESS));
+
+    // Keep SIGCHLD pending for the signalfd rather than having it delivered
+    // (and discarded) here.  Anything that slipped through before this point
+    // is still picked up by the waitpid() sweep at the top of the loop.
+    sigset_t sigchld_set;
+    sigemptyset (&sigchld_set);
+    sigaddset (&sigchld_set, SIGCHLD);
+    pthread_sigmask (SIG_BLOCK, &sigchld_set, nullptr);
+
+    // Collect statuses for every child in the inferior's process group, as
+    // the previous dedicated monitor thread did.
+    const ::pid_t pgid = ::getpgid (monitor->GetID ());
+    const ::pid_t wait_pid = pgid > 0 ? -pgid : static_cast< ::pid_t> (monitor->GetID ());
+    bool reaping = true;
 
     // We are finised with the arguments and are ready to go.  Sync with the
-    // parent thread and start serving operations on the inferior.
+    // parent thread and start serving the inferior.
     sem_post(&args->m_semaphore);
 
-    for(;;)
+    for (;;)
     {
-        // wait for next pending operation
-        if (sem_wait(&monitor->m_operation_pending))
-        {
-            if (errno == EINTR)
-                continue;
-            assert(false && "Unexpected errno from sem_wait");
-        }
+        // Handle every state change first so operations queued below observe
+        // up-to-date thread states.
+        if (reaping)
+            reaping = monitor->ReapWaitStatuses (wait_pid);
+
+        // Run the thread state coordinator inline.  Its deferred actions
+        // issue their ptrace calls directly from this thread.
+        monitor->m_coordinator_up->ProcessPendingEvents ();
+
+        // Serve an operation handed over from another thread, if any.
+        void *op = monitor->m_operation.exchange (nullptr);
 
         // EXIT_OPERATION used to stop the operation thread because Cancel() isn't supported on
         // android. We don't have to send a post to the m_operation_done semaphore because in this
         // case the synchronization is achieved by a Join() call
-        if (monitor->m_operation == EXIT_OPERATION)
+        if (op == EXIT_OPERATION)
             break;
+        if (op)
+        {
+            static_cast<Operation*>(op)->Execute(monitor);
 
-        static_cast<Operation*>(monitor->m_operation)->Execute(monitor);
+            // notify calling thread that operation is complete
+            sem_post(&monitor->m_operation_done);
+            continue;
+        }
 
-        // notify calling thread that operation is complete
-        sem_post(&monitor->m_operation_done);
+        struct epoll_event events[2];
+        const int num_events = ::epoll_wait (monitor->m_epoll_fd, events, 2, -1);
+        if (num_events < 0)
+        {
+            if (errno == EINTR)
+                continue;
+            if (log)
+                log->Printf ("NativeProcessLinux::%s epoll_wait failed: %s", __FUNCTION__, strerror (errno));
+
+            // Nothing serves operations from here on.  Fail the one that may
+            // already be queued so its caller doesn't block forever on
+            // m_operation_done; DoOperation fails any that come later.
+            monitor->m_event_loop_exited = true;
+            void *pending_op = monitor->m_operation.exchange (nullptr);
+            if (pending_op && pending_op != EXIT_OPERATION)
+            {
+                FailUnservedOperation (pending_op);
+                sem_post(&monitor->m_operation_done);
+            }
+            break;
+        }
+
+        for (int i = 0; i < num_events; ++i)
+        {
+            if (events[i].data.fd == monitor->m_sigchld_fd)
+            {
+                // Statuses are reaped at the top of the loop; just drain
+                // the queued signals.
+                struct signalfd_siginfo fdsi;
+                while (::read (monitor->m_sigchld_fd, &fdsi, sizeof (fdsi)) == sizeof (fdsi))
+                {
+                }
+            }
+            else if (events[i].data.fd == monitor->m_wakeup_fd)
+            {
+                uint64_t count;
+                ::read (monitor->m_wakeup_fd, &count, sizeof (count));
+            }
+        }
+    }
+
+    if (log)
+        log->Printf ("NativeProcessLinux::%s pid %" PRIu64 " exiting event loop", __FUNCTION__, monitor->GetID ());
+}
+
+bool
+NativeProcessLinux::ReapWaitStatuses(::pid_t wait_pid)
+{
+    Log *log (GetLogIfAllCategoriesSet (LIBLLDB_LOG_PROCESS));
+
+    for (;;)
+    {
+        int status = -1;
+        const ::pid_t pid = ::waitpid (wait_pid, &status, __WALL | WNOHANG);
+        if (pid == 0)
+            return true;
+
+        if (pid < 0)
+        {
+            if (errno == EINTR)
+                continue;
+            if (log)
+                log->Printf ("NativeProcessLinux::%s waitpid (%" PRIi32 ") failed: %s, no longer reaping", __FUNCTION__, wait_pid, strerror (errno));
+            return false;
+        }
+
+        bool exited = false;
+        int signal = 0;
+        int exit_status = 0;
+        if (WIFSTOPPED(status))
+            signal = WSTOPSIG(status);
+        else if (WIFEXITED(status))
+        {
+            exit_status = WEXITSTATUS(status);
+            exited = true;
+        }
+        else if (WIFSIGNALED(status))
+        {
+            signal = WTERMSIG(status);
+            if (static_cast<lldb::pid_t> (pid) == GetID ())
+            {
+                exited = true;
+                exit_status = -1;
+            }
+        }
+
+        if (log)
+            log->Printf ("NativeProcessLinux::%s waitpid (%" PRIi32 ") => pid = %" PRIi32 ", status = 0x%8.8x, signal = %i, exit_status = %i",
+                         __FUNCTION__, wait_pid, pid, status, signal, exit_status);
+
+        if (exited || signal != 0)
+        {
+            const bool stop_monitoring = MonitorCallback (this, pid, exited, signal, exit_status);
+            if (stop_monitoring || (exited && static_cast<lldb::pid_t> (pid) == GetID ()))
+                return false;
+        }
     }
 }
 
 void
 NativeProcessLinux::DoOperation(void *op)
 {
+    // The privileged thread runs its own operations (issued while handling a
+    // stop or a coordinator action) inline.
+    if (IsTracerThread ())
+    {
+        assert (op != EXIT_OPERATION && "the operation thread cannot stop itself");
+        if (op != EXIT_OPERATION)
+            static_cast<Operation*>(op)->Execute(this);
+        return;
+    }
+
     Mutex::Locker lock(m_operation_mutex);
 
     m_operation = op;
 
     // notify operation thread that an operation is ready to be processed
-    sem_post(&m_operation_pending);
+    WakeEventLoop ();
 
     // Don't wait for the operation to complete in case of an exit operation. The operation thread
     // will exit without posting to the semaphore
-    if (m_operation == EXIT_OPERATION)
+    if (op == EXIT_OPERATION)
         return;
 
+    // If the event loop has already exited nobody will run the operation.
+    // Take it back, unless the loop claimed it on its way out, in which case
+    // the loop failed it and posted m_operation_done.
+    if (m_event_loop_exited)
+    {
+        void *expected_op = op;
+        if (m_operation.compare_exchange_strong (expected_op, nullptr))
+        {
+            FailUnservedOperation (op);
+            return;
+        }
+    }
+
     // wait for operation to complete
     while (sem_wait(&m_operation_done))
     {
@@ -3443,6 +3957,84 @@ NativeProcessLinux::DoOperation(void *op)
     }
 }
 
+Error
+NativeProcessLinux::InitializeEventLoop ()
+{
+    Error error;
+
+    sem_init (&m_operation_done, 0, 0);
+
+    m_wakeup_fd = ::eventfd (0, EFD_CLOEXEC | EFD_NONBLOCK);
+    if (m_wakeup_fd < 0)
+    {
+        error.SetErrorToErrno ();
+        return error;
+    }
+
+    sigset_t sigchld_set;
+    sigemptyset (&sigchld_set);
+    sigaddset (&sigchld_set, SIGCHLD);
+    m_sigchld_fd = ::signalfd (-1, &sigchld_set, SFD_CLOEXEC | SFD_NONBLOCK);
+    if (m_sigchld_fd < 0)
+    {
+        error.SetErrorToErrno ();
+        return error;
+    }
+
+    m_epoll_fd = ::epoll_create1 (EPOLL_CLOEXEC);
+    if (m_epoll_fd < 0)
+    {
+        error.SetErrorToErrno ();
+        return error;
+    }
+
+    for (int fd : { m_wakeup_fd, m_sigchld_fd })
+    {
+        struct epoll_event event;
+        ::memset (&event, 0, sizeof (event));
+        event.events = EPOLLIN;
+        event.data.fd = fd;
+        if (::epoll_ctl (m_epoll_fd, EPOLL_CTL_ADD, fd, &event) < 0)
+        {
+            error.SetErrorToErrno ();
+            return error;
+        }
+    }
+
+    // Events queued from other threads (resume requests, halts) must wake
+    // the loop that now processes them.
+    // The event loop drains the coordinator queue on every pass, so events
+    // queued from the loop itself (e.g. one per reaped thread stop while
+    // stopping every thread) need no wakeup.
+    m_coordinator_up->SetEventQueuedFunction ([this] () {
+        if (!IsTracerThread ())
+            WakeEventLoop ();
+    });
+
+    // Enable verbose logging if lldb thread logging is enabled.
+    m_coordinator_up->LogEnableEventProcessing (GetLogIfAllCategoriesSet (LIBLLDB_LOG_THREAD) != nullptr);
+
+    return error;
+}
+
+void
+NativeProcessLinux::WakeEventLoop ()
+{
+    if (m_wakeup_fd < 0)
+        return;
+
+    const uint64_t one = 1;
+    while (::write (m_wakeup_fd, &one, sizeof (one)) < 0 && errno == EINTR)
+    {
+    }
+}
+
+bool
+NativeProcessLinux::IsTracerThread () const
+{
+    return m_tracer_thread != LLDB_INVALID_HOST_THREAD && ::pthread_equal (m_tracer_thread, Host::GetCurrentThread ());
+}
+
 Error
 NativeProcessLinux::ReadMemory (lldb::addr_t addr, void *buf, lldb::addr_t size, lldb::addr_t &bytes_read)
 {
@@ -3589,25 +4181,22 @@ NativeProcessLinux::DupDescriptor(const char *path, int fd, int flags)
     return (close(target_fd) == -1) ? false : true;
 }
 
-void
-NativeProcessLinux::StopMonitorThread()
-{
-    if (m_monitor_thread.IsJoinable())
-    {
-        ::pthread_kill(m_monitor_thread.GetNativeThread().GetSystemHandle(), SIGUSR1);
-        m_monitor_thread.Join(nullptr);
-    }
-}
-
 void
 NativeProcessLinux::StopMonitor()
 {
-    StopMonitorThread();
-    StopCoordinatorThread ();
     StopOpThread();
-    sem_destroy(&m_operation_pending);
     sem_destroy(&m_operation_done);
 
+    m_coordinator_up->SetEventQueuedFunction (ThreadStateCoordinator::EventQueuedFunction ());
+    for (int *fd : { &m_epoll_fd, &m_sigchld_fd, &m_wakeup_fd })
+    {
+        if (*fd >= 0)
+        {
+            ::close (*fd);
+            *fd = -1;
+        }
+    }
+
     // TODO: validate whether this still holds, fix up comment.
     // Note: ProcessPOSIX passes the m_terminal_fd file descriptor to
     // Process::SetSTDIOFileDescriptor, which in turn transfers ownership of
@@ -3618,123 +4207,42 @@ NativeProcessLinux::StopMonitor()
 void
 NativeProcessLinux::StopOpThread()
 {
-    if (!m_operation_thread.IsJoinable())
+    if (!m_operation_thread.IsJoinable() || IsTracerThread ())
         return;
 
     DoOperation(EXIT_OPERATION);
     m_operation_thread.Join(nullptr);
 }
 
-Error
-NativeProcessLinux::StartCoordinatorThread ()
-{
-    Error error;
-    static const char *g_thread_name = "lldb.process.linux.ts_coordinator";
-    Log *const log (GetLogIfAllCategoriesSet (LIBLLDB_LOG_THREAD));
-
-    // Skip if thread is already running
-    if (m_coordinator_thread.IsJoinable())
-    {
-        error.SetErrorString ("ThreadStateCoordinator's run loop is already running");
-        if (log)
-            log->Printf ("NativeProcessLinux::%s %s", __FUNCTION__, error.AsCString ());
-        return error;
-    }
-
-    // Enable verbose logging if lldb thread logging is enabled.
-    m_coordinator_up->LogEnableEventProcessing (log != nullptr);
-
-    if (log)
-        log->Printf ("NativeProcessLinux::%s launching ThreadStateCoordinator thread for pid %" PRIu64, __FUNCTION__, GetID ());
-    m_coordinator_thread = ThreadLauncher::LaunchThread(g_thread_name, CoordinatorThread, this, &error);
-    return error;
-}
-
-void *
-NativeProcessLinux::CoordinatorThread (void *arg)
-{
-    Log *const log (GetLogIfAllCategoriesSet (LIBLLDB_LOG_THREAD));
-
-    NativeProcessLinux *const process = static_cast<NativeProcessLinux*> (arg);
-    assert (process && "null process passed to CoordinatorThread");
-    if (!process)
-    {
-        if (log)
-            log->Printf ("NativeProcessLinux::%s null process, exiting ThreadStateCoordinator processing loop", __FUNCTION__);
-        return nullptr;
-    }
-
-    // Run the thread state coordinator loop until it is done.  This call uses
-    // efficient waiting for an event to be ready.
-    while (process->m_coordinator_up->ProcessNextEvent () == ThreadStateCoordinator::eventLoopResultContinue)
-    {
-    }
-
-    if (log)
-        log->Printf ("NativeProcessLinux::%s pid %" PRIu64 " exiting ThreadStateCoordinator processing loop due to coordinator indicating completion", __FUNCTION__, process->GetID ());
-
-    return nullptr;
-}
-
-void
-NativeProcessLinux::StopCoordinatorThread()
-{
-    Log *const log (GetLogIfAllCategoriesSet (LIBLLDB_LOG_THREAD));
-    if (log)
-        log->Printf ("NativeProcessLinux::%s requesting ThreadStateCoordinator stop for pid %" PRIu64, __FUNCTION__, GetID ());
-
-    // Tell the coordinator we're done.  This will cause the coordinator
-    // run loop thread to exit when the processing queue hits this message.
-    m_coordinator_up->StopCoordinator ();
-    m_coordinator_thread.Join (nullptr);
-}
-
 bool
 NativeProcessLinux::HasThreadNoLock (lldb::tid_t thread_id)
 {
-    for (auto thread_sp : m_threads)
-    {
-        assert (thread_sp && "thread list should not contain NULL threads");
-        if (thread_sp->GetID () == thread_id)
-        {
-            // We have this thread.
-            return true;
-        }
-    }
-
-    // We don't have this thread.
-    return false;
+    return m_threads_by_id.count (thread_id) > 0;
 }
 
 NativeThreadProtocolSP
 NativeProcessLinux::MaybeGetThreadNoLock (lldb::tid_t thread_id)
 {
-    // CONSIDER organize threads by map - we can do better than linear.
-    for (auto thread_sp : m_threads)
-    {
-        if (thread_sp->GetID () == thread_id)
-            return thread_sp;
-    }
-
-    // We don't have this thread.
-    return NativeThreadProtocolSP ();
+    return GetThreadByIDUnlocked (thread_id);
 }
 
 bool
 NativeProcessLinux::StopTrackingThread (lldb::tid_t thread_id)
 {
     Mutex::Locker locker (m_threads_mutex);
-    for (auto it = m_threads.begin (); it != m_threads.end (); ++it)
+    auto find_it = m_threads_by_id.find (thread_id);
+    if (find_it == m_threads_by_id.end ())
     {
-        if (*it && ((*it)->GetID () == thread_id))
-        {
-            m_threads.erase (it);
-            return true;
-        }
+        // Didn't find it.
+        return false;
     }
 
-    // Didn't find it.
-    return false;
+    NativeThreadProtocolSP thread_sp = find_it->second;
+    m_threads_by_id.erase (find_it);
+
+    AbortBreakpointStepOver (thread_sp);
+    m_threads.erase (std::find (m_threads.begin (), m_threads.end (), thread_sp));
+    return true;
 }
 
 NativeThreadProtocolSP
@@ -3760,6 +4268,7 @@ NativeProcessLinux::AddThread (lldb::tid_t thread_id)
 
     NativeThreadProtocolSP thread_sp (new NativeThreadLinux (this, thread_id));
     m_threads.push_back (thread_sp);
+    m_threads_by_id[thread_id] = thread_sp;
 
     return thread_sp;
 }
@@ -3801,6 +4310,7 @@ NativeProcessLinux::GetOrCreateThread (lldb::tid_t thread_id, bool &created)
 
     thread_sp.reset (new NativeThreadLinux (this, thread_id));
     m_threads.push_back (thread_sp);
+    m_threads_by_id[thread_id] = thread_sp;
     created = true;
     
     return thread_sp;
@@ -3904,6 +4414,274 @@ NativeProcessLinux::FixupBreakpointPCAsNeeded (NativeThreadProtocolSP &thread_sp
     return error;
 }
 
+lldb::addr_t
+NativeProcessLinux::GetSoftwareBreakpointAtPC (const NativeThreadProtocolSP &thread_sp)
+{
+    NativeRegisterContextSP context_sp = thread_sp->GetRegisterContext ();
+    if (!context_sp)
+        return LLDB_INVALID_ADDRESS;
+
+    const lldb::addr_t pc = context_sp->GetPC ();
+    NativeBreakpointSP breakpoint_sp;
+    if (pc == LLDB_INVALID_ADDRESS || m_breakpoint_list.GetBreakpoint (pc, breakpoint_sp).Fail () || !breakpoint_sp)
+        return LLDB_INVALID_ADDRESS;
+
+    if (!breakpoint_sp->IsSoftwareBreakpoint () || !breakpoint_sp->IsEnabled ())
+        return LLDB_INVALID_ADDRESS;
+
+    return pc;
+}
+
+lldb::addr_t
+NativeProcessLinux::GetDisplacedStepArea ()
+{
+    Mutex::Locker locker (m_displaced_steps_mutex);
+
+    if (m_displaced_step_area == LLDB_INVALID_ADDRESS)
+    {
+        // Both supported architectures are 64-bit, so auxv is a list of
+        // 64-bit type/value pairs.
+        DataBufferSP auxv_sp = ProcFileReader::ReadIntoDataBuffer (GetID (), "auxv");
+        if (auxv_sp)
+        {
+            const uint64_t *entries = reinterpret_cast<const uint64_t *> (auxv_sp->GetBytes ());
+            const size_t num_entries = auxv_sp->GetByteSize () / sizeof (uint64_t);
+            for (size_t i = 0; i + 1 < num_entries && entries[i] != AT_NULL; i += 2)
+            {
+                if (entries[i] == AT_ENTRY)
+                {
+                    m_displaced_step_area = entries[i + 1];
+                    break;
+                }
+            }
+        }
+    }
+
+    return m_displaced_step_area;
+}
+
+bool
+NativeProcessLinux::RelocateBreakpointInstruction (lldb::addr_t bp_addr, lldb::addr_t slot_addr, DisplacedInstruction &instruction)
+{
+    const llvm::Triple::ArchType machine = m_arch.GetMachine ();
+    if (machine != llvm::Triple::x86_64 && machine != llvm::Triple::aarch64)
+        return false;
+
+    uint8_t bytes[DisplacedInstruction::kMaxInstructionSize];
+    lldb::addr_t bytes_read = 0;
+    Error error = ReadMemory (bp_addr, bytes, sizeof (bytes), bytes_read);
+    if (error.Fail () || bytes_read == 0)
+        return false;
+
+    // Look through our own traps, this one included, at the real instruction.
+    m_breakpoint_list.RemoveTrapsFromBuffer (bp_addr, bytes, bytes_read);
+
+    return instruction.Relocate (machine, bytes, bytes_read, bp_addr, slot_addr);
+}
+
+Error
+NativeProcessLinux::StartDisplacedStep (const NativeThreadProtocolSP &thread_sp,
+                                        const DisplacedInstruction &instruction,
+                                        size_t slot_index,
+                                        bool resume_when_done)
+{
+    Log *log (GetLogIfAnyCategoriesSet (LIBLLDB_LOG_BREAKPOINTS | LIBLLDB_LOG_STEP));
+
+    DisplacedStep step;
+    step.instruction = instruction;
+    step.slot_index = slot_index;
+    step.resume_when_done = resume_when_done;
+
+    const lldb::addr_t slot_addr = instruction.GetSlotAddress ();
+    const size_t size = instruction.GetSize ();
+
+    lldb::addr_t bytes_transferred = 0;
+    Error error = ReadMemory (slot_addr, step.saved_slot_bytes, size, bytes_transferred);
+    if (error.Success () && bytes_transferred != size)
+        error.SetErrorStringWithFormat ("short read of displaced step slot at 0x%" PRIx64, slot_addr);
+    if (error.Success ())
+        error = WriteMemory (slot_addr, instruction.GetBytes (), size, bytes_transferred);
+    if (error.Success () && bytes_transferred != size)
+        error.SetErrorStringWithFormat ("short write of displaced step slot at 0x%" PRIx64, slot_addr);
+    if (error.Success ())
+    {
+        NativeRegisterContextSP context_sp = thread_sp->GetRegisterContext ();
+        if (context_sp)
+            error = context_sp->SetPC (slot_addr);
+        else
+            error.SetErrorString ("cannot get a NativeRegisterContext for the thread");
+    }
+
+    if (error.Fail ())
+    {
+        if (log)
+            log->Printf ("NativeProcessLinux::%s tid %" PRIu64 " failed to set up displaced step of 0x%" PRIx64 ": %s",
+                         __FUNCTION__, thread_sp->GetID (), instruction.GetOriginalAddress (), error.AsCString ());
+        return error;
+    }
+
+    if (log)
+        log->Printf ("NativeProcessLinux::%s tid %" PRIu64 " stepping the %zu byte instruction at 0x%" PRIx64 " from slot 0x%" PRIx64,
+                     __FUNCTION__, thread_sp->GetID (), size, instruction.GetOriginalAddress (), slot_addr);
+
+    Mutex::Locker locker (m_displaced_steps_mutex);
+    m_displaced_steps[thread_sp->GetID ()] = step;
+    return error;
+}
+
+bool
+NativeProcessLinux::FinishDisplacedStep (const NativeThreadProtocolSP &thread_sp, bool &resume_when_done)
+{
+    Log *log (GetLogIfAnyCategoriesSet (LIBLLDB_LOG_BREAKPOINTS | LIBLLDB_LOG_STEP));
+
+    DisplacedStep step;
+    {
+        Mutex::Locker locker (m_displaced_steps_mutex);
+        auto iter = m_displaced_steps.find (thread_sp->GetID ());
+        if (iter == m_displaced_steps.end ())
+            return false;
+        step = iter->second;
+        m_displaced_steps.erase (iter);
+    }
+
+    const DisplacedInstruction &instruction = step.instruction;
+    resume_when_done = step.resume_when_done;
+
+    lldb::addr_t bytes_written = 0;
+    Error error = WriteMemory (instruction.GetSlotAddress (), step.saved_slot_bytes, instruction.GetSize (), bytes_written);
+    if (error.Fail () && log)
+        log->Printf ("NativeProcessLinux::%s failed to restore displaced step slot 0x%" PRIx64 ": %s",
+                     __FUNCTION__, instruction.GetSlotAddress (), error.AsCString ());
+
+    NativeRegisterContextSP context_sp = thread_sp->GetRegisterContext ();
+    if (!context_sp)
+        return true;
+
+    const lldb::addr_t pc = context_sp->GetPC ();
+    if (pc == LLDB_INVALID_ADDRESS)
+        return true;
+
+    const lldb::addr_t new_pc = instruction.FixupPC (pc);
+    if (new_pc != pc)
+        context_sp->SetPC (new_pc);
+
+    // A call pushed (or put in the link register) a return address that
+    // points past the slot rather than past the original instruction.
+    if (pc != instruction.GetSlotAddress () && instruction.IsCall ())
+    {
+        if (m_arch.GetMachine () == llvm::Triple::aarch64)
+        {
+            const uint32_t lr_regnum = context_sp->ConvertRegisterKindToRegisterNumber (eRegisterKindGeneric, LLDB_REGNUM_GENERIC_RA);
+            if (context_sp->ReadRegisterAsUnsigned (lr_regnum, LLDB_INVALID_ADDRESS) == instruction.GetSlotReturnAddress ())
+                context_sp->WriteRegisterFromUnsigned (lr_regnum, instruction.GetReturnAddress ());
+        }
+        else
+        {
+            const lldb::addr_t sp = context_sp->GetSP ();
+            uint64_t return_addr = 0;
+            lldb::addr_t bytes_read = 0;
+            if (ReadMemory (sp, &return_addr, sizeof (return_addr), bytes_read).Success () &&
+                bytes_read == sizeof (return_addr) &&
+                return_addr == instruction.GetSlotReturnAddress ())
+            {
+                return_addr = instruction.GetReturnAddress ();
+                WriteMemory (sp, &return_addr, sizeof (return_addr), bytes_written);
+            }
+        }
+    }
+
+    if (log)
+        log->Printf ("NativeProcessLinux::%s tid %" PRIu64 " finished displaced step of 0x%" PRIx64 ", pc 0x%" PRIx64 " -> 0x%" PRIx64,
+                     __FUNCTION__, thread_sp->GetID (), instruction.GetOriginalAddress (), pc, new_pc);
+
+    return true;
+}
+
+void
+NativeProcessLinux::FinishInlineStepOver (const NativeThreadProtocolSP &thread_sp, bool completed)
+{
+    Log *log (GetLogIfAnyCategoriesSet (LIBLLDB_LOG_BREAKPOINTS | LIBLLDB_LOG_STEP));
+
+    const lldb::tid_t tid = thread_sp->GetID ();
+    lldb::addr_t bp_addr;
+    StateType state;
+    ResumeActionList resume_actions;
+    std::unordered_set<lldb::tid_t> held_tids;
+    {
+        Mutex::Locker locker (m_displaced_steps_mutex);
+        bp_addr = m_inline_step_addr;
+        state = m_inline_step_state;
+        resume_actions = m_inline_step_actions;
+        held_tids.swap (m_inline_step_held_tids);
+
+        m_inline_step_tid = LLDB_INVALID_THREAD_ID;
+        m_inline_step_addr = LLDB_INVALID_ADDRESS;
+        m_inline_step_state = eStateInvalid;
+        m_inline_step_actions.Clear ();
+
+        // The held threads were stopped short of any breakpoint they sit on.
+        m_inline_stepped_tids.clear ();
+        m_inline_stepped_tids.insert (held_tids.begin (), held_tids.end ());
+    }
+
+    Error error = m_breakpoint_list.EnableBreakpoint (bp_addr);
+    if (error.Fail () && log)
+        log->Printf ("NativeProcessLinux::%s failed to re-enable breakpoint at 0x%" PRIx64 ": %s",
+                     __FUNCTION__, bp_addr, error.AsCString ());
+
+    // Let the threads held for a non-stop step carry on.
+    if (!held_tids.empty ())
+    {
+        ResumeActionList held_actions;
+        for (auto held_tid : held_tids)
+            held_actions.AppendAction (held_tid, eStateRunning);
+        error = Resume (held_actions);
+        if (error.Fail () && log)
+            log->Printf ("NativeProcessLinux::%s failed to resume the threads held while stepping tid %" PRIu64 " over 0x%" PRIx64 ": %s",
+                         __FUNCTION__, tid, bp_addr, error.AsCString ());
+    }
+
+    if (completed && state != eStateStepping)
+    {
+        Mutex::Locker locker (m_displaced_steps_mutex);
+        m_inline_stepped_tids.insert (tid);
+    }
+
+    if (!completed)
+        return;
+
+    if (state == eStateStepping)
+    {
+        // The step the client asked for is the one we just did.
+        MonitorTrace (tid, thread_sp);
+        return;
+    }
+
+    // Now let everybody go as originally requested.
+    NotifyThreadStop (tid);
+    error = Resume (resume_actions);
+    if (error.Fail () && log)
+        log->Printf ("NativeProcessLinux::%s failed to resume after stepping tid %" PRIu64 " over 0x%" PRIx64 ": %s",
+                     __FUNCTION__, tid, bp_addr, error.AsCString ());
+}
+
+void
+NativeProcessLinux::AbortBreakpointStepOver (const NativeThreadProtocolSP &thread_sp)
+{
+    bool resume_when_done = false;
+    FinishDisplacedStep (thread_sp, resume_when_done);
+
+    if (IsSteppingOverBreakpointInPlace (thread_sp->GetID ()))
+        FinishInlineStepOver (thread_sp, false);
+}
+
+bool
+NativeProcessLinux::IsSteppingOverBreakpointInPlace (lldb::tid_t tid)
+{
+    Mutex::Locker locker (m_displaced_steps_mutex);
+    return tid == m_inline_step_tid;
+}
+
 void
 NativeProcessLinux::NotifyThreadCreateStopped (lldb::tid_t tid)
 {
@@ -3931,6 +4709,14 @@ NativeProcessLinux::CallAfterRunningThreadsStop (lldb::tid_t tid,
     if (log)
         log->Printf("NativeProcessLinux::%s tid %" PRIu64, __FUNCTION__, tid);
 
+    if (GetNonStopMode ())
+    {
+        // Nothing else is stopped in non-stop mode, and the all-stop
+        // continuation, which announces a process-wide stop, doesn't apply.
+        ReportNonStopThreadStop (tid);
+        return;
+    }
+
     const lldb::pid_t pid = GetID ();
     m_coordinator_up->CallAfterRunningThreadsStop (tid,
                                                    [=](lldb::tid_t request_stop_tid)
@@ -3950,6 +4736,12 @@ NativeProcessLinux::CallAfterRunningThreadsStopWithSkipTID (lldb::tid_t deferred
     if (log)
         log->Printf("NativeProcessLinux::%s deferred_signal_tid %" PRIu64 ", skip_stop_request_tid %" PRIu64, __FUNCTION__, deferred_signal_tid, skip_stop_request_tid);
 
+    if (GetNonStopMode ())
+    {
+        ReportNonStopThreadStop (deferred_signal_tid);
+        return;
+    }
+
     const lldb::pid_t pid = GetID ();
     m_coordinator_up->CallAfterRunningThreadsStopWithSkipTIDs (deferred_signal_tid,
                                                                skip_stop_request_tid != LLDB_INVALID_THREAD_ID ? ThreadStateCoordinator::ThreadIDSet {skip_stop_request_tid} : ThreadStateCoordinator::ThreadIDSet (),
@@ -3979,3 +4771,73 @@ NativeProcessLinux::RequestThreadStop (const lldb::pid_t pid, const lldb::tid_t
 
     return err;
 }
+
+Error
+NativeProcessLinux::RequestNonStopThreadStop (const NativeThreadProtocolSP &thread_sp)
+{
+    Mutex::Locker locker (m_threads_mutex);
+
+    // Once the SIGSTOP arrives, MonitorSignal reports the stop instead of
+    // letting the coordinator treat it as an unrequested llgs stop.
+    auto insert_result = m_non_stop_stop_requests.insert (thread_sp->GetID ());
+    if (!insert_result.second)
+        return Error ();
+
+    Error error = RequestThreadStop (GetID (), thread_sp->GetID ());
+    if (error.Fail ())
+        m_non_stop_stop_requests.erase (insert_result.first);
+    return error;
+}
+
+bool
+NativeProcessLinux::TakeNonStopStopRequest (lldb::tid_t tid)
+{
+    Mutex::Locker locker (m_threads_mutex);
+    return m_non_stop_stop_requests.erase (tid) > 0;
+}
+
+void
+NativeProcessLinux::ReportNonStopThreadStop (lldb::tid_t tid)
+{
+    Log *const log (GetLogIfAllCategoriesSet (LIBLLDB_LOG_THREAD));
+    if (log)
+        log->Printf("NativeProcessLinux::%s tid %" PRIu64, __FUNCTION__, tid);
+
+    // A thread held for an in-place step that stopped for a reason of its
+    // own stays stopped once that is reported.
+    {
+        Mutex::Locker locker (m_displaced_steps_mutex);
+        m_inline_step_held_tids.erase (tid);
+    }
+
+    // Go through the coordinator so the report is ordered after the stop
+    // notification for the thread; only that one thread is waited for.
+    const lldb::pid_t pid = GetID ();
+    m_coordinator_up->CallAfterThreadsStop (tid,
+                                            ThreadStateCoordinator::ThreadIDSet {tid},
+                                            [=](lldb::tid_t request_stop_tid)
+                                            {
+                                                return RequestThreadStop(pid, request_stop_tid);
+                                            },
+                                            [=](lldb::tid_t stopped_tid)
+                                            {
+                                                SetCurrentThreadID (stopped_tid);
+
+                                                // The process as a whole only counts as stopped
+                                                // once its last running thread has stopped.
+                                                bool all_stopped = true;
+                                                {
+                                                    Mutex::Locker locker (m_threads_mutex);
+                                                    for (auto thread_sp : m_threads)
+                                                    {
+                                                        if (thread_sp && !StateIsStoppedState (thread_sp->GetState (), false))
+                                                            all_stopped = false;
+                                                    }
+                                                }
+                                                if (all_stopped)
+                                                    SetState (StateType::eStateStopped, false);
+
+                                                NotifyThreadStopped (stopped_tid);
+                                            },
+                                            CoordinatorErrorHandler);
+}
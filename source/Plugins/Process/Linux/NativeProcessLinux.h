@@ -15,6 +15,8 @@
 #include <signal.h>
 
 // C++ Includes
+#include <atomic>
+#include <map>
 #include <unordered_set>
 
 // Other libraries and framework includes
@@ -27,6 +29,8 @@
 
 #include "lldb/Host/common/NativeProcessProtocol.h"
 
+#include "DisplacedStepping.h"
+
 namespace lldb_private
 {
     class Error;
@@ -76,6 +80,9 @@ namespace lldb_private
         Error
         Interrupt () override;
 
+        Error
+        SetNonStopMode (bool enabled) override;
+
         Error
         Kill () override;
 
@@ -169,24 +176,71 @@ namespace lldb_private
 
         lldb_private::ArchSpec m_arch;
 
+        // The privileged thread: it launches or attaches to the inferior,
+        // reaps its wait statuses, runs the ThreadStateCoordinator and
+        // executes every ptrace operation.
         HostThread m_operation_thread;
-        HostThread m_monitor_thread;
+        lldb::thread_t m_tracer_thread;
 
         // current operation which must be executed on the priviliged thread
-        void *m_operation;
+        std::atomic<void *> m_operation;
         lldb_private::Mutex m_operation_mutex;
 
-        // semaphores notified when Operation is ready to be processed and when
-        // the operation is complete.
-        sem_t m_operation_pending;
+        // semaphore notified when the operation is complete.
         sem_t m_operation_done;
 
+        // Set when the event loop stops on an error rather than on
+        // EXIT_OPERATION, so later operations fail instead of waiting.
+        std::atomic<bool> m_event_loop_exited;
+
+        // Descriptors the privileged thread's event loop waits on: an eventfd
+        // poked when an operation or coordinator event is queued, a signalfd
+        // for SIGCHLD, and the epoll instance multiplexing the two.
+        int m_wakeup_fd;
+        int m_sigchld_fd;
+        int m_epoll_fd;
+
         lldb_private::LazyBool m_supports_mem_region;
         std::vector<MemoryRegionInfo> m_mem_region_cache;
         lldb_private::Mutex m_mem_region_cache_mutex;
 
         std::unique_ptr<ThreadStateCoordinator> m_coordinator_up;
-        HostThread m_coordinator_thread;
+
+        // A thread resumed from a software breakpoint gets past it by single
+        // stepping a relocated copy of the instruction in a scratch slot, so
+        // the trap stays in memory and the other threads keep running.  The
+        // slots live at the executable's entry point, which never runs again
+        // once the process is up.
+        struct DisplacedStep
+        {
+            DisplacedInstruction instruction;
+            uint8_t saved_slot_bytes[DisplacedInstruction::kMaxInstructionSize];
+            size_t slot_index;
+            bool resume_when_done;      // The thread was continued, not stepped.
+        };
+
+        lldb::addr_t m_displaced_step_area;
+        std::map<lldb::tid_t, DisplacedStep> m_displaced_steps;
+        lldb_private::Mutex m_displaced_steps_mutex;
+
+        // Instructions that can't be displaced are stepped in place with the
+        // trap lifted while every other thread stays stopped; the rest of the
+        // resume request is replayed once the thread is past the breakpoint.
+        // Resume sets this up on the gdb-remote thread and the privileged
+        // thread finishes it, so it is guarded by m_displaced_steps_mutex.
+        lldb::tid_t m_inline_step_tid;
+        lldb::addr_t m_inline_step_addr;
+        lldb::StateType m_inline_step_state;
+        ResumeActionList m_inline_step_actions;
+        std::unordered_set<lldb::tid_t> m_inline_stepped_tids;
+        // Threads stopped so they can't run through the lifted trap while
+        // the process is in non-stop mode.
+        std::unordered_set<lldb::tid_t> m_inline_step_held_tids;
+
+        // Threads sent a SIGSTOP on their own in non-stop mode.  Their
+        // stops are reported rather than resumed by the coordinator.
+        // Guarded by m_threads_mutex.
+        std::unordered_set<lldb::tid_t> m_non_stop_stop_requests;
 
         struct OperationArgs
         {
@@ -283,7 +337,13 @@ namespace lldb_private
         SetDefaultPtraceOpts(const lldb::pid_t);
 
         static void
-        ServeOperation(OperationArgs *args);
+        RunEventLoop(OperationArgs *args);
+
+        /// Reaps every wait status currently available for the inferior and
+        /// dispatches it to MonitorCallback.  Returns false once the main
+        /// thread is gone and no further statuses should be collected.
+        bool
+        ReapWaitStatuses(::pid_t wait_pid);
 
         static bool
         DupDescriptor(const char *path, int fd, int flags);
@@ -324,22 +384,21 @@ namespace lldb_private
         void
         DoOperation(void *op);
 
-        /// Stops the child monitor thread.
-        void
-        StopMonitorThread();
+        /// Creates the descriptors used by the privileged thread's event loop.
+        Error
+        InitializeEventLoop();
 
-        /// Stops the operation thread used to attach/launch a process.
+        /// Wakes the privileged thread's event loop.  Safe to call from any
+        /// thread.
         void
-        StopOpThread();
-
-        Error
-        StartCoordinatorThread ();
+        WakeEventLoop();
 
-        static void*
-        CoordinatorThread (void *arg);
+        bool
+        IsTracerThread() const;
 
+        /// Stops the operation thread used to attach/launch a process.
         void
-        StopCoordinatorThread ();
+        StopOpThread();
 
         /// Stops monitoring the child process thread.
         void
@@ -366,6 +425,47 @@ namespace lldb_private
         Error
         FixupBreakpointPCAsNeeded (NativeThreadProtocolSP &thread_sp);
 
+        /// Returns the address of the enabled software breakpoint under the
+        /// thread's pc, or LLDB_INVALID_ADDRESS.
+        lldb::addr_t
+        GetSoftwareBreakpointAtPC (const NativeThreadProtocolSP &thread_sp);
+
+        /// Returns the start of the scratch area used for displaced steps, or
+        /// LLDB_INVALID_ADDRESS if the process has none.
+        lldb::addr_t
+        GetDisplacedStepArea ();
+
+        /// Relocates the instruction under the breakpoint at @a bp_addr so it
+        /// can be stepped from @a slot_addr.
+        bool
+        RelocateBreakpointInstruction (lldb::addr_t bp_addr, lldb::addr_t slot_addr, DisplacedInstruction &instruction);
+
+        /// Copies @a instruction into its slot and moves the thread's pc there.
+        Error
+        StartDisplacedStep (const NativeThreadProtocolSP &thread_sp,
+                            const DisplacedInstruction &instruction,
+                            size_t slot_index,
+                            bool resume_when_done);
+
+        /// Restores the thread's slot and maps its pc (and, after a call, its
+        /// return address) back to the original code.  Returns false if the
+        /// thread wasn't stepping a displaced instruction.
+        bool
+        FinishDisplacedStep (const NativeThreadProtocolSP &thread_sp, bool &resume_when_done);
+
+        /// Puts the breakpoint lifted for an in-place step back.  If the step
+        /// @a completed, reports it or replays the deferred resume request.
+        void
+        FinishInlineStepOver (const NativeThreadProtocolSP &thread_sp, bool completed);
+
+        /// Undoes any step over a breakpoint the thread was in the middle of.
+        void
+        AbortBreakpointStepOver (const NativeThreadProtocolSP &thread_sp);
+
+        /// Returns true if @a tid is stepping over a breakpoint in place.
+        bool
+        IsSteppingOverBreakpointInPlace (lldb::tid_t tid);
+
         /// Writes a siginfo_t structure corresponding to the given thread ID to the
         /// memory region pointed to by @p siginfo.
         Error
@@ -414,6 +514,17 @@ namespace lldb_private
 
         lldb_private::Error
         RequestThreadStop (const lldb::pid_t pid, const lldb::tid_t tid);
+
+        lldb_private::Error
+        RequestNonStopThreadStop (const NativeThreadProtocolSP &thread_sp);
+
+        // Returns true, and forgets the request, if @a tid was sent a
+        // SIGSTOP by RequestNonStopThreadStop.
+        bool
+        TakeNonStopStopRequest (lldb::tid_t tid);
+
+        void
+        ReportNonStopThreadStop (lldb::tid_t tid);
     };
 } // End lldb_private namespace.
 
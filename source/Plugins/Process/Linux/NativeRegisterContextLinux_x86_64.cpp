@@ -336,7 +336,9 @@ NativeRegisterContextLinux_x86_64::NativeRegisterContextLinux_x86_64 (NativeThre
     m_iovec (),
     m_ymm_set (),
     m_reg_info (),
-    m_gpr_x86_64 ()
+    m_gpr_x86_64 (),
+    m_gpr_valid (false),
+    m_fpr_valid (false)
 {
     // Set up data about ranges of valid registers.
     switch (reg_info_interface_p->GetTargetArchitecture ().GetMachine ())
@@ -506,7 +508,26 @@ NativeRegisterContextLinux_x86_64::ReadRegister (const RegisterInfo *reg_info, R
             full_reg = reg_info->invalidate_regs[0];
         }
 
-        error = ReadRegisterRaw(full_reg, reg_value);
+        if (IsGPR(full_reg))
+        {
+            // Serve general purpose registers from the cached GPR set, which
+            // is fetched with a single ptrace call per stop.
+            const RegisterInfo *const full_reg_info = GetRegisterInfoAtIndex (full_reg);
+            if (!full_reg_info || full_reg_info->byte_offset + full_reg_info->byte_size > GetRegisterInfoInterface ().GetGPRSize ())
+                error = ReadRegisterRaw(full_reg, reg_value);
+            else if (!ReadGPR ())
+                error.SetErrorString ("failed to read general purpose registers");
+            else
+            {
+                const uint8_t *src = reinterpret_cast<const uint8_t *> (&m_gpr_x86_64) + full_reg_info->byte_offset;
+                if (full_reg_info->byte_size == 8)
+                    reg_value.SetUInt64 (*reinterpret_cast<const uint64_t *> (src));
+                else
+                    reg_value.SetUInt32 (*reinterpret_cast<const uint32_t *> (src));
+            }
+        }
+        else
+            error = ReadRegisterRaw(full_reg, reg_value);
 
         if (error.Success ())
         {
@@ -644,6 +665,10 @@ NativeRegisterContextLinux_x86_64::WriteRegister(const uint32_t reg,
         return error;
     }
 
+    // The cached GPR set no longer reflects the thread once we poke into it.
+    if (IsGPR(reg_to_write))
+        m_gpr_valid = false;
+
     NativeProcessLinux *const process_p = reinterpret_cast<NativeProcessLinux*> (process_sp.get ());
     return process_p->WriteRegisterValue(m_thread.GetID(),
                                          register_to_write_info_p->byte_offset,
@@ -665,6 +690,11 @@ NativeRegisterContextLinux_x86_64::WriteRegister (const RegisterInfo *reg_info,
 
     if (IsFPR(reg_index, GetFPRType()))
     {
+        // Only the register being written changes; the rest of the set
+        // written back below must hold the thread's current values.
+        if (!ReadFPR())
+            return Error ("failed to read floating point registers");
+
         if (reg_info->encoding == lldb::eEncodingVector)
         {
             if (reg_index >= m_reg_info.first_st && reg_index <= m_reg_info.last_st)
@@ -928,11 +958,14 @@ NativeRegisterContextLinux_x86_64::WriteFPR()
     NativeProcessLinux *const process_p = reinterpret_cast<NativeProcessLinux*> (process_sp.get ());
 
     if (GetFPRType() == eFPRTypeFXSAVE)
-        return process_p->WriteFPR (m_thread.GetID (), &m_fpr.xstate.fxsave, sizeof (m_fpr.xstate.fxsave)).Success();
+        m_fpr_valid = process_p->WriteFPR (m_thread.GetID (), &m_fpr.xstate.fxsave, sizeof (m_fpr.xstate.fxsave)).Success();
+    else if (GetFPRType() == eFPRTypeXSAVE)
+        m_fpr_valid = process_p->WriteRegisterSet (m_thread.GetID (), &m_iovec, sizeof (m_fpr.xstate.xsave), NT_X86_XSTATE).Success();
+    else
+        m_fpr_valid = false;
 
-    if (GetFPRType() == eFPRTypeXSAVE)
-        return process_p->WriteRegisterSet (m_thread.GetID (), &m_iovec, sizeof (m_fpr.xstate.xsave), NT_X86_XSTATE).Success();
-    return false;
+    // On success m_fpr matches what the thread now holds.
+    return m_fpr_valid;
 }
 
 bool
@@ -1005,6 +1038,9 @@ NativeRegisterContextLinux_x86_64::CopyYMMtoXSTATE(uint32_t reg, lldb::ByteOrder
 bool
 NativeRegisterContextLinux_x86_64::ReadFPR ()
 {
+    if (m_fpr_valid)
+        return true;
+
     NativeProcessProtocolSP process_sp (m_thread.GetProcess ());
     if (!process_sp)
         return false;
@@ -1014,25 +1050,32 @@ NativeRegisterContextLinux_x86_64::ReadFPR ()
     switch (fpr_type)
     {
     case FPRType::eFPRTypeFXSAVE:
-        return process_p->ReadFPR (m_thread.GetID (), &m_fpr.xstate.fxsave, sizeof (m_fpr.xstate.fxsave)).Success();
+        m_fpr_valid = process_p->ReadFPR (m_thread.GetID (), &m_fpr.xstate.fxsave, sizeof (m_fpr.xstate.fxsave)).Success();
+        break;
 
     case FPRType::eFPRTypeXSAVE:
-        return process_p->ReadRegisterSet (m_thread.GetID (), &m_iovec, sizeof (m_fpr.xstate.xsave), NT_X86_XSTATE).Success();
+        m_fpr_valid = process_p->ReadRegisterSet (m_thread.GetID (), &m_iovec, sizeof (m_fpr.xstate.xsave), NT_X86_XSTATE).Success();
+        break;
 
     default:
-        return false;
+        break;
     }
+    return m_fpr_valid;
 }
 
 bool
 NativeRegisterContextLinux_x86_64::ReadGPR()
 {
+    if (m_gpr_valid)
+        return true;
+
     NativeProcessProtocolSP process_sp (m_thread.GetProcess ());
     if (!process_sp)
         return false;
     NativeProcessLinux *const process_p = reinterpret_cast<NativeProcessLinux*> (process_sp.get ());
 
-    return process_p->ReadGPR (m_thread.GetID (), &m_gpr_x86_64, GetRegisterInfoInterface ().GetGPRSize ()).Success();
+    m_gpr_valid = process_p->ReadGPR (m_thread.GetID (), &m_gpr_x86_64, GetRegisterInfoInterface ().GetGPRSize ()).Success();
+    return m_gpr_valid;
 }
 
 bool
@@ -1043,7 +1086,16 @@ NativeRegisterContextLinux_x86_64::WriteGPR()
         return false;
     NativeProcessLinux *const process_p = reinterpret_cast<NativeProcessLinux*> (process_sp.get ());
 
-    return process_p->WriteGPR (m_thread.GetID (), &m_gpr_x86_64, GetRegisterInfoInterface ().GetGPRSize ()).Success();
+    // On success m_gpr_x86_64 matches what the thread now holds.
+    m_gpr_valid = process_p->WriteGPR (m_thread.GetID (), &m_gpr_x86_64, GetRegisterInfoInterface ().GetGPRSize ()).Success();
+    return m_gpr_valid;
+}
+
+void
+NativeRegisterContextLinux_x86_64::InvalidateAllRegisters ()
+{
+    m_gpr_valid = false;
+    m_fpr_valid = false;
 }
 
 Error
@@ -74,6 +74,9 @@ namespace lldb_private
         uint32_t
         NumSupportedHardwareWatchpoints() override;
 
+        void
+        InvalidateAllRegisters () override;
+
     private:
 
         // Private member types.
@@ -116,6 +119,10 @@ namespace lldb_private
         YMM m_ymm_set;
         RegInfo m_reg_info;
         uint64_t m_gpr_x86_64[k_num_gpr_registers_x86_64];
+        // The GPR and FPR sets are each fetched with one ptrace call and
+        // served from m_gpr_x86_64/m_fpr until the thread resumes.
+        bool m_gpr_valid;
+        bool m_fpr_valid;
 
         // Private member methods.
         lldb_private::Error
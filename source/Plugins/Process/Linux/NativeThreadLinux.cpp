@@ -308,6 +308,10 @@ NativeThreadLinux::SetRunning ()
     m_state = new_state;
 
     m_stop_info.reason = StopReason::eStopReasonNone;
+
+    // Register values cached during the stop are stale once the thread runs.
+    if (m_reg_context_sp)
+        m_reg_context_sp->InvalidateAllRegisters ();
     m_stop_description.clear();
 
     // If watchpoints have been set, but none on this thread,
@@ -337,6 +341,10 @@ NativeThreadLinux::SetStepping ()
     m_state = new_state;
 
     m_stop_info.reason = StopReason::eStopReasonNone;
+
+    // Register values cached during the stop are stale once the thread runs.
+    if (m_reg_context_sp)
+        m_reg_context_sp->InvalidateAllRegisters ();
 }
 
 void
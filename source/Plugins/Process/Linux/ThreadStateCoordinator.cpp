@@ -78,7 +78,8 @@ public:
                                const ErrorFunction &error_function):
     EventBase (),
     m_triggering_tid (triggering_tid),
-    m_wait_for_stop_tids (wait_for_stop_tids),
+    m_wait_id (0),
+    m_remaining_wait_count (0),
     m_original_wait_for_stop_tids (wait_for_stop_tids),
     m_request_thread_stop_function (request_thread_stop_function),
     m_call_after_function (call_after_function),
@@ -94,7 +95,8 @@ public:
                                const ErrorFunction &error_function) :
     EventBase (),
     m_triggering_tid (triggering_tid),
-    m_wait_for_stop_tids (),
+    m_wait_id (0),
+    m_remaining_wait_count (0),
     m_original_wait_for_stop_tids (),
     m_request_thread_stop_function (request_thread_stop_function),
     m_call_after_function (call_after_function),
@@ -111,7 +113,8 @@ public:
                                const ErrorFunction &error_function) :
     EventBase (),
     m_triggering_tid (triggering_tid),
-    m_wait_for_stop_tids (),
+    m_wait_id (0),
+    m_remaining_wait_count (0),
     m_original_wait_for_stop_tids (),
     m_request_thread_stop_function (request_thread_stop_function),
     m_call_after_function (call_after_function),
@@ -126,16 +129,16 @@ public:
         return m_triggering_tid;
     }
 
-    ThreadIDSet &
-    GetRemainingWaitTIDs ()
+    uint32_t
+    GetWaitID () const
     {
-        return m_wait_for_stop_tids;
+        return m_wait_id;
     }
 
-    const ThreadIDSet &
-    GetRemainingWaitTIDs () const
+    size_t
+    GetRemainingWaitCount () const
     {
-        return m_wait_for_stop_tids;
+        return m_remaining_wait_count;
     }
 
 
@@ -160,6 +163,12 @@ public:
             return eventLoopResultContinue;
         }
 
+        // Threads we wait on are tagged with this id, which stops matching
+        // as soon as this notification fires or gets replaced.
+        m_wait_id = coordinator.m_next_stop_wait_id++;
+        if (coordinator.m_next_stop_wait_id == 0)
+            coordinator.m_next_stop_wait_id = 1;
+
         if (m_request_stop_on_all_unstopped_threads)
         {
             RequestStopOnAllRunningThreads (coordinator);
@@ -170,7 +179,7 @@ public:
                 return eventLoopResultContinue;
         }
 
-        if (m_wait_for_stop_tids.empty ())
+        if (m_remaining_wait_count == 0)
         {
             // We're not waiting for any threads.  Fire off the deferred signal delivery event.
             NotifyNow ();
@@ -187,16 +196,18 @@ public:
         return eventLoopResultContinue;
     }
 
+    // Called for a thread this notification waits on once it stops or dies.
     // Return true if still pending thread stops waiting; false if no more stops.
     // If no more pending stops, signal.
     bool
-    RemoveThreadStopRequirementAndMaybeSignal (lldb::tid_t tid)
+    RemoveThreadStopRequirementAndMaybeSignal ()
     {
-        // Remove this tid if it was in it.
-        m_wait_for_stop_tids.erase (tid);
+        assert (m_remaining_wait_count > 0 && "no thread stops left to wait for");
+        if (m_remaining_wait_count > 0)
+            --m_remaining_wait_count;
 
         // Fire pending notification if no pending thread stops remain.
-        if (m_wait_for_stop_tids.empty ())
+        if (m_remaining_wait_count == 0)
         {
             // Fire the pending notification now.
             NotifyNow ();
@@ -208,14 +219,15 @@ public:
     }
 
     void
-    AddThreadStopRequirement (lldb::tid_t tid)
+    AddThreadStopRequirement (ThreadContext &context)
     {
-        // Add this tid.
-        auto insert_result = m_wait_for_stop_tids.insert (tid);
+        // If it wasn't already waited on, send the stop request to it.
+        if (context.m_stop_wait_id == m_wait_id)
+            return;
 
-        // If it was really added, send the stop request to it.
-        if (insert_result.second)
-            m_request_thread_stop_function (tid);
+        context.m_stop_wait_id = m_wait_id;
+        ++m_remaining_wait_count;
+        m_request_thread_stop_function (context.m_tid);
     }
 
     std::string
@@ -237,17 +249,12 @@ private:
     bool
     RequestStopOnAllSpecifiedThreads (ThreadStateCoordinator &coordinator)
     {
-        // Request a stop for all the thread stops that need to be stopped
-        // and are not already known to be stopped.  Keep a list of all the
-        // threads from which we still need to hear a stop reply.
-
-        ThreadIDSet sent_tids;
-        for (auto tid : m_wait_for_stop_tids)
+        // Validate we know about all tids for which we must first receive a stop before
+        // triggering the deferred stop notification.  Do this up front so that
+        // no stop requests go out for a notification that is then dropped.
+        for (auto tid : m_original_wait_for_stop_tids)
         {
-            // Validate we know about all tids for which we must first receive a stop before
-            // triggering the deferred stop notification.
-            auto find_it = coordinator.m_tid_map.find (tid);
-            if (find_it == coordinator.m_tid_map.end ())
+            if (!coordinator.IsKnownThread (tid))
             {
                 // This is an error.  We shouldn't be asking for waiting pids that aren't known.
                 // NOTE: we may be stripping out the specification of wait tids and handle this
@@ -259,21 +266,23 @@ private:
                 // Bail out here.
                 return false;
             }
+        }
 
-            // If the pending stop thread is currently running, we need to send it a stop request.
-            auto& context = find_it->second;
-            if (context.m_state == ThreadState::Running)
+        // Request a stop for all the thread stops that need to be stopped
+        // and are not already known to be stopped, and wait on exactly
+        // those.  The rest are already stopped and we won't be receiving
+        // stop notifications for them.
+        for (auto tid : m_original_wait_for_stop_tids)
+        {
+            ThreadContext *context = coordinator.FindThreadContext (tid);
+            if (context->m_state == ThreadState::Running)
             {
-                RequestThreadStop (tid, coordinator, context);
-                sent_tids.insert (tid);
+                RequestThreadStop (coordinator, *context);
+                context->m_stop_wait_id = m_wait_id;
+                ++m_remaining_wait_count;
             }
         }
 
-        // We only need to wait for the sent_tids - so swap our wait set
-        // to the sent tids.  The rest are already stopped and we won't
-        // be receiving stop notifications for them.
-        m_wait_for_stop_tids.swap (sent_tids);
-
         // Succeeded, keep running.
         return true;
     }
@@ -282,36 +291,32 @@ private:
     RequestStopOnAllRunningThreads (ThreadStateCoordinator &coordinator)
     {
         // Request a stop for all the thread stops that need to be stopped
-        // and are not already known to be stopped.  Keep a list of all the
-        // threads from which we still need to hear a stop reply.
-
-        ThreadIDSet sent_tids;
-        for (auto it = coordinator.m_tid_map.begin(); it != coordinator.m_tid_map.end(); ++it)
+        // and are not already known to be stopped, in a single pass over
+        // the thread array so that every thread is signalled before the
+        // first of them gets reaped.
+        const bool have_skip_tids = !m_skip_stop_request_tids.empty ();
+        for (auto &context : coordinator.m_thread_contexts)
         {
             // We only care about threads not stopped.
-            const bool running = it->second.m_state == ThreadState::Running;
-            if (running)
-            {
-                const lldb::tid_t tid = it->first;
-
-                // Request this thread stop if the tid stop request is not explicitly ignored.
-                const bool skip_stop_request = m_skip_stop_request_tids.count (tid) > 0;
-                if (!skip_stop_request)
-                    RequestThreadStop (tid, coordinator, it->second);
-
-                // Even if we skipped sending the stop request for other reasons (like stepping),
-                // we still need to wait for that stepping thread to notify completion/stop.
-                sent_tids.insert (tid);
-            }
+            if (context.m_state != ThreadState::Running)
+                continue;
+
+            // Request this thread stop if the tid stop request is not explicitly ignored.
+            const bool skip_stop_request = have_skip_tids && m_skip_stop_request_tids.count (context.m_tid) > 0;
+            if (!skip_stop_request)
+                RequestThreadStop (coordinator, context);
+
+            // Even if we skipped sending the stop request for other reasons (like stepping),
+            // we still need to wait for that stepping thread to notify completion/stop.
+            context.m_stop_wait_id = m_wait_id;
+            ++m_remaining_wait_count;
         }
-
-        // Set the wait list to the set of tids for which we requested stops.
-        m_wait_for_stop_tids.swap (sent_tids);
     }
 
     void
-    RequestThreadStop (lldb::tid_t tid, ThreadStateCoordinator &coordinator, ThreadContext& context)
+    RequestThreadStop (ThreadStateCoordinator &coordinator, ThreadContext& context)
     {
+        const lldb::tid_t tid = context.m_tid;
         const auto error = m_request_thread_stop_function (tid);
         if (error.Success ())
         {
@@ -325,7 +330,8 @@ private:
     }
 
     const lldb::tid_t m_triggering_tid;
-    ThreadIDSet m_wait_for_stop_tids;
+    uint32_t m_wait_id;
+    size_t m_remaining_wait_count;
     const ThreadIDSet m_original_wait_for_stop_tids;
     StopThreadFunction m_request_thread_stop_function;
     ThreadIDFunction m_call_after_function;
@@ -487,8 +493,8 @@ public:
     ProcessEvent(ThreadStateCoordinator &coordinator) override
     {
         // Ensure we know about the thread.
-        auto find_it = coordinator.m_tid_map.find (m_tid);
-        if (find_it == coordinator.m_tid_map.end ())
+        ThreadContext *const context_ptr = coordinator.FindThreadContext (m_tid);
+        if (!context_ptr)
         {
             // We don't know about this thread.  This is an error condition.
             std::ostringstream error_message;
@@ -496,7 +502,7 @@ public:
             m_error_function (error_message.str ());
             return eventLoopResultContinue;
         }
-        auto& context = find_it->second;
+        auto& context = *context_ptr;
         // Tell the thread to resume if we don't already think it is running.
         const bool is_stopped = context.m_state == ThreadState::Stopped;
         if (!is_stopped)
@@ -532,19 +538,21 @@ public:
         const EventCallAfterThreadsStop *const pending_stop_notification = coordinator.GetPendingThreadStopNotification ();
         if (pending_stop_notification)
         {
-            if (pending_stop_notification->GetRemainingWaitTIDs ().count (m_tid) > 0)
+            if (context.m_stop_wait_id == pending_stop_notification->GetWaitID ())
             {
                 coordinator.Log ("EventRequestResume::%s about to resume tid %" PRIu64 " per explicit request but we have a pending stop notification (tid %" PRIu64 ") that is actively waiting for this thread to stop. Valid sequence of events?", __FUNCTION__, m_tid, pending_stop_notification->GetTriggeringTID ());
             }
             else if (pending_stop_notification->GetInitialWaitTIDs ().count (m_tid) > 0)
             {
                 coordinator.Log ("EventRequestResume::%s about to resume tid %" PRIu64 " per explicit request but we have a pending stop notification (tid %" PRIu64 ") that hasn't fired yet and this is one of the threads we had been waiting on (and already marked satisfied for this tid). Valid sequence of events?", __FUNCTION__, m_tid, pending_stop_notification->GetTriggeringTID ());
-                for (auto tid : pending_stop_notification->GetRemainingWaitTIDs ())
+                for (const auto &waited_context : coordinator.m_thread_contexts)
                 {
+                    if (waited_context.m_stop_wait_id != pending_stop_notification->GetWaitID ())
+                        continue;
                     coordinator.Log ("EventRequestResume::%s tid %" PRIu64 " deferred stop notification still waiting on tid  %" PRIu64,
                                      __FUNCTION__,
                                      pending_stop_notification->GetTriggeringTID (),
-                                     tid);
+                                     waited_context.m_tid);
                 }
             }
         }
@@ -590,7 +598,10 @@ ThreadStateCoordinator::ThreadStateCoordinator (const LogFunction &log_function)
     m_event_queue (),
     m_queue_condition (),
     m_queue_mutex (),
-    m_tid_map (),
+    m_event_queued_function (),
+    m_thread_contexts (),
+    m_tid_slots (),
+    m_next_stop_wait_id (1),
     m_log_event_processing (false)
 {
 }
@@ -598,13 +609,21 @@ ThreadStateCoordinator::ThreadStateCoordinator (const LogFunction &log_function)
 void
 ThreadStateCoordinator::EnqueueEvent (EventBaseSP event_sp)
 {
-    std::lock_guard<std::mutex> lock (m_queue_mutex);
+    EventQueuedFunction event_queued_function;
+    {
+        std::lock_guard<std::mutex> lock (m_queue_mutex);
 
-    m_event_queue.push (event_sp);
-    if (m_log_event_processing)
-        Log ("ThreadStateCoordinator::%s enqueued event: %s", __FUNCTION__, event_sp->GetDescription ().c_str ());
+        m_event_queue.push (event_sp);
+        if (m_log_event_processing)
+            Log ("ThreadStateCoordinator::%s enqueued event: %s", __FUNCTION__, event_sp->GetDescription ().c_str ());
+
+        m_queue_condition.notify_one ();
+        event_queued_function = m_event_queued_function;
+    }
 
-    m_queue_condition.notify_one ();
+    // Notify outside the lock; the callee may well turn around and drain the queue.
+    if (event_queued_function)
+        event_queued_function ();
 }
 
 ThreadStateCoordinator::EventBaseSP
@@ -622,6 +641,19 @@ ThreadStateCoordinator::DequeueEventWithWait ()
     return event_sp;
 }
 
+ThreadStateCoordinator::EventBaseSP
+ThreadStateCoordinator::DequeueEventNoWait ()
+{
+    std::lock_guard<std::mutex> lock (m_queue_mutex);
+    if (m_event_queue.empty ())
+        return EventBaseSP ();
+
+    EventBaseSP event_sp = m_event_queue.front ();
+    m_event_queue.pop ();
+
+    return event_sp;
+}
+
 void
 ThreadStateCoordinator::SetPendingNotification (const EventBaseSP &event_sp)
 {
@@ -690,8 +722,8 @@ void
 ThreadStateCoordinator::ThreadDidStop (lldb::tid_t tid, bool initiated_by_llgs, ErrorFunction &error_function)
 {
     // Ensure we know about the thread.
-    auto find_it = m_tid_map.find (tid);
-    if (find_it == m_tid_map.end ())
+    ThreadContext *const context_ptr = FindThreadContext (tid);
+    if (!context_ptr)
     {
         // We don't know about this thread.  This is an error condition.
         std::ostringstream error_message;
@@ -701,16 +733,17 @@ ThreadStateCoordinator::ThreadDidStop (lldb::tid_t tid, bool initiated_by_llgs,
     }
 
     // Update the global list of known thread states.  This one is definitely stopped.
-    auto& context = find_it->second;
+    auto& context = *context_ptr;
     const auto stop_was_requested = context.m_stop_requested;
     context.m_state = ThreadState::Stopped;
     context.m_stop_requested = false;
 
-    // If we have a pending notification, remove this from the set.
-    EventCallAfterThreadsStop *const call_after_event = GetPendingThreadStopNotification ();
-    if (call_after_event)
+    // If we have a pending notification waiting on this thread, it's one
+    // less to wait for.
+    if (IsPendingStopWait (context))
     {
-        const bool pending_stops_remain = call_after_event->RemoveThreadStopRequirementAndMaybeSignal (tid);
+        context.m_stop_wait_id = 0;
+        const bool pending_stops_remain = GetPendingThreadStopNotification ()->RemoveThreadStopRequirementAndMaybeSignal ();
         if (!pending_stops_remain)
         {
             // Clear the pending notification now.
@@ -740,8 +773,7 @@ void
 ThreadStateCoordinator::ThreadWasCreated (lldb::tid_t tid, bool is_stopped, ErrorFunction &error_function)
 {
     // Ensure we don't already know about the thread.
-    auto find_it = m_tid_map.find (tid);
-    if (find_it != m_tid_map.end ())
+    if (IsKnownThread (tid))
     {
         // We already know about this thread.  This is an error condition.
         std::ostringstream error_message;
@@ -750,17 +782,19 @@ ThreadStateCoordinator::ThreadWasCreated (lldb::tid_t tid, bool is_stopped, Erro
         return;
     }
 
-    // Add the new thread to the stop map.
+    // Add the new thread to the end of the context array.
     ThreadContext ctx;
+    ctx.m_tid = tid;
     ctx.m_state = (is_stopped) ? ThreadState::Stopped : ThreadState::Running;
-    m_tid_map[tid] = std::move(ctx);
+    m_tid_slots[tid] = m_thread_contexts.size ();
+    m_thread_contexts.push_back (std::move(ctx));
 
     EventCallAfterThreadsStop *const call_after_event = GetPendingThreadStopNotification ();
     if (call_after_event && !is_stopped)
     {
         // Tell the pending notification that we need to wait
         // for this new thread to stop.
-        call_after_event->AddThreadStopRequirement (tid);
+        call_after_event->AddThreadStopRequirement (m_thread_contexts.back ());
     }
 }
 
@@ -768,8 +802,8 @@ void
 ThreadStateCoordinator::ThreadDidDie (lldb::tid_t tid, ErrorFunction &error_function)
 {
     // Ensure we know about the thread.
-    auto find_it = m_tid_map.find (tid);
-    if (find_it == m_tid_map.end ())
+    ThreadContext *const context_ptr = FindThreadContext (tid);
+    if (!context_ptr)
     {
         // We don't know about this thread.  This is an error condition.
         std::ostringstream error_message;
@@ -781,13 +815,14 @@ ThreadStateCoordinator::ThreadDidDie (lldb::tid_t tid, ErrorFunction &error_func
     // Update the global list of known thread states.  While this one is stopped, it is also dead.
     // So stop tracking it.  We assume the user of this coordinator will not keep trying to add
     // dependencies on a thread after it is known to be dead.
-    m_tid_map.erase (find_it);
+    const bool was_pending_stop_wait = IsPendingStopWait (*context_ptr);
+    RemoveThreadContext (tid);
 
-    // If we have a pending notification, remove this from the set.
-    EventCallAfterThreadsStop *const call_after_event = GetPendingThreadStopNotification ();
-    if (call_after_event)
+    // If we have a pending notification waiting on this thread, it's one
+    // less to wait for.
+    if (was_pending_stop_wait)
     {
-        const bool pending_stops_remain = call_after_event->RemoveThreadStopRequirementAndMaybeSignal (tid);
+        const bool pending_stops_remain = GetPendingThreadStopNotification ()->RemoveThreadStopRequirementAndMaybeSignal ();
         if (!pending_stops_remain)
         {
             // Clear the pending notification now.
@@ -806,7 +841,8 @@ ThreadStateCoordinator::ResetNow ()
     // The caller is expected to reset thread states for all threads, and we
     // will assume anything we haven't heard about is running and requires a
     // stop.
-    m_tid_map.clear ();
+    m_thread_contexts.clear ();
+    m_tid_slots.clear ();
 }
 
 void
@@ -900,6 +936,30 @@ ThreadStateCoordinator::ProcessNextEvent ()
         return eventLoopResultStop;
     }
 
+    return ProcessEvent (event_sp);
+}
+
+ThreadStateCoordinator::EventLoopResult
+ThreadStateCoordinator::ProcessPendingEvents ()
+{
+    while (EventBaseSP event_sp = DequeueEventNoWait ())
+    {
+        if (ProcessEvent (event_sp) == eventLoopResultStop)
+            return eventLoopResultStop;
+    }
+    return eventLoopResultContinue;
+}
+
+void
+ThreadStateCoordinator::SetEventQueuedFunction (const EventQueuedFunction &event_queued_function)
+{
+    std::lock_guard<std::mutex> lock (m_queue_mutex);
+    m_event_queued_function = event_queued_function;
+}
+
+ThreadStateCoordinator::EventLoopResult
+ThreadStateCoordinator::ProcessEvent (const EventBaseSP &event_sp)
+{
     if (m_log_event_processing)
     {
         Log ("ThreadStateCoordinator::%s about to process event: %s", __FUNCTION__, event_sp->GetDescription ().c_str ());
@@ -932,5 +992,39 @@ ThreadStateCoordinator::GetPendingThreadStopNotification ()
 bool
 ThreadStateCoordinator::IsKnownThread (lldb::tid_t tid) const
 {
-    return m_tid_map.find (tid) != m_tid_map.end ();
+    return m_tid_slots.find (tid) != m_tid_slots.end ();
+}
+
+ThreadStateCoordinator::ThreadContext *
+ThreadStateCoordinator::FindThreadContext (lldb::tid_t tid)
+{
+    auto find_it = m_tid_slots.find (tid);
+    if (find_it == m_tid_slots.end ())
+        return nullptr;
+    return &m_thread_contexts[find_it->second];
+}
+
+void
+ThreadStateCoordinator::RemoveThreadContext (lldb::tid_t tid)
+{
+    auto find_it = m_tid_slots.find (tid);
+    if (find_it == m_tid_slots.end ())
+        return;
+
+    // Keep the array dense: move the last context into the vacated slot.
+    const size_t slot = find_it->second;
+    m_tid_slots.erase (find_it);
+    if (slot + 1 != m_thread_contexts.size ())
+    {
+        m_thread_contexts[slot] = std::move (m_thread_contexts.back ());
+        m_tid_slots[m_thread_contexts[slot].m_tid] = slot;
+    }
+    m_thread_contexts.pop_back ();
+}
+
+bool
+ThreadStateCoordinator::IsPendingStopWait (const ThreadContext &context)
+{
+    const EventCallAfterThreadsStop *const call_after_event = GetPendingThreadStopNotification ();
+    return call_after_event && context.m_stop_wait_id == call_after_event->GetWaitID ();
 }
@@ -16,6 +16,7 @@
 #include <queue>
 #include <unordered_map>
 #include <unordered_set>
+#include <vector>
 
 #include "lldb/lldb-types.h"
 
@@ -42,6 +43,7 @@ namespace lldb_private
         typedef std::function<void (const std::string &error_message)> ErrorFunction;
         typedef std::function<Error (lldb::tid_t tid)> StopThreadFunction;
         typedef std::function<Error (lldb::tid_t tid, bool supress_signal)> ResumeThreadFunction;
+        typedef std::function<void ()> EventQueuedFunction;
 
         // Constructors.
         ThreadStateCoordinator (const LogFunction &log_function);
@@ -143,6 +145,19 @@ namespace lldb_private
         EventLoopResult
         ProcessNextEvent ();
 
+        // Process every event queued so far without blocking, returning
+        // eventLoopResultStop if one of them asked the coordinator to stop.
+        // For use by a caller that multiplexes the coordinator with other
+        // work and gets woken through SetEventQueuedFunction().  The same
+        // single-thread rule as ProcessNextEvent() applies.
+        EventLoopResult
+        ProcessPendingEvents ();
+
+        // Set a function called, from whichever thread queued it, each time
+        // an event is added to the queue.  Pass an empty function to clear.
+        void
+        SetEventQueuedFunction (const EventQueuedFunction &event_queued_function);
+
         // Enable/disable verbose logging of event processing.
         void
         LogEnableEventProcessing (bool enabled);
@@ -173,11 +188,20 @@ namespace lldb_private
 
         struct ThreadContext
         {
+            lldb::tid_t m_tid;
             ThreadState m_state;
             bool m_stop_requested = false;
+            // Wait id of the pending notification waiting for this thread to
+            // stop; only meaningful while that notification is pending.
+            uint32_t m_stop_wait_id = 0;
             ResumeThreadFunction m_request_resume_function;
         };
-        typedef std::unordered_map<lldb::tid_t, ThreadContext> TIDContextMap;
+
+        // Thread contexts are kept in a flat array so that stopping or
+        // resuming every thread is a linear walk over contiguous memory;
+        // m_tid_slots maps each tid to its slot in the array.
+        typedef std::vector<ThreadContext> ThreadContextArray;
+        typedef std::unordered_map<lldb::tid_t, size_t> TIDSlotMap;
 
 
         // Private member functions.
@@ -187,6 +211,12 @@ namespace lldb_private
         EventBaseSP
         DequeueEventWithWait ();
 
+        EventBaseSP
+        DequeueEventNoWait ();
+
+        EventLoopResult
+        ProcessEvent (const EventBaseSP &event_sp);
+
         void
         SetPendingNotification (const EventBaseSP &event_sp);
 
@@ -205,6 +235,15 @@ namespace lldb_private
         bool
         IsKnownThread(lldb::tid_t tid) const;
 
+        ThreadContext *
+        FindThreadContext (lldb::tid_t tid);
+
+        void
+        RemoveThreadContext (lldb::tid_t tid);
+
+        bool
+        IsPendingStopWait (const ThreadContext &context);
+
         void
         Log (const char *format, ...);
 
@@ -221,11 +260,17 @@ namespace lldb_private
         // event mechanism.
         std::condition_variable m_queue_condition;
         std::mutex m_queue_mutex;
+        EventQueuedFunction m_event_queued_function;
 
         EventBaseSP m_pending_notification_sp;
 
-        // Maps known TIDs to ThreadContext.
-        TIDContextMap m_tid_map;
+        // Known threads, and the slot of each in m_thread_contexts.
+        ThreadContextArray m_thread_contexts;
+        TIDSlotMap m_tid_slots;
+
+        // Handed out to each CallAfterThreadsStop notification as it starts
+        // waiting; never zero.
+        uint32_t m_next_stop_wait_id;
 
         bool m_log_event_processing;
     };
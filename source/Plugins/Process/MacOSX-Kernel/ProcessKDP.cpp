@@ -757,6 +757,7 @@ ProcessKDP::EnableBreakpointSite (BreakpointSite *bp_site)
             {
                 bp_site->SetEnabled(true);
                 bp_site->SetType (BreakpointSite::eExternal);
+                FlushBreakpointSiteMemory (bp_site->GetLoadAddress(), GetSoftwareBreakpointTrapOpcode (bp_site));
             }
             else
             {
@@ -787,7 +788,10 @@ ProcessKDP::DisableBreakpointSite (BreakpointSite *bp_site)
                 else
                 {
                     if (m_comm.SendRequestBreakpoint(false, bp_site->GetLoadAddress()))
+                    {
                         bp_site->SetEnabled(false);
+                        FlushBreakpointSiteMemory (bp_site->GetLoadAddress(), GetSoftwareBreakpointTrapOpcode (bp_site));
+                    }
                     else
                         error.SetErrorString ("KDP remove breakpoint failed");
                 }
@@ -999,10 +999,9 @@ RegisterContextLLDB::ReadRegisterValueFromRegisterLocation (lldb_private::Unwind
         break;
     case UnwindLLDB::RegisterLocation::eRegisterSavedAtMemoryLocation:
         {
-            Error error (ReadRegisterValueFromMemory(reg_info,
-                                                     regloc.location.target_memory_location,
-                                                     reg_info->byte_size,
-                                                     value));
+            Error error (ReadSavedRegisterValueFromMemory (reg_info,
+                                                           regloc.location.target_memory_location,
+                                                           value));
             success = error.Success();
         }
         break;
@@ -1459,6 +1458,8 @@ RegisterContextLLDB::SavedLocationForRegister (uint32_t lldb_regnum, lldb_privat
         dwarfexpr.SetRegisterKind (unwindplan_registerkind);
         Value result;
         Error error;
+        // The expression may read the stack behind our back.
+        m_parent_unwind.NoteUnverifiableStackRead ();
         if (dwarfexpr.Evaluate (&exe_ctx, NULL, NULL, this, 0, NULL, result, &error))
         {
             addr_t val;
@@ -1699,10 +1700,9 @@ RegisterContextLLDB::ReadCFAValueForRow (lldb::RegisterKind row_register_kind,
                 RegisterValue reg_value;
                 if (reg_info)
                 {
-                    Error error = ReadRegisterValueFromMemory(reg_info,
-                                                              cfa_reg_contents,
-                                                              reg_info->byte_size,
-                                                              reg_value);
+                    Error error = ReadSavedRegisterValueFromMemory (reg_info,
+                                                                    cfa_reg_contents,
+                                                                    reg_value);
                     if (error.Success ())
                     {
                         cfa_value = reg_value.GetAsUInt64();
@@ -1755,6 +1755,7 @@ RegisterContextLLDB::ReadCFAValueForRow (lldb::RegisterKind row_register_kind,
             dwarfexpr.SetRegisterKind (row_register_kind);
             Value result;
             Error error;
+            m_parent_unwind.NoteUnverifiableStackRead ();
             if (dwarfexpr.Evaluate (&exe_ctx, NULL, NULL, this, 0, NULL, result, &error))
             {
                 cfa_value = result.GetScalar().ULongLong();
@@ -1943,6 +1944,23 @@ RegisterContextLLDB::GetPrevFrame () const
     return m_parent_unwind.GetRegisterContextForFrameNum (m_frame_number + 1);
 }
 
+void
+RegisterContextLLDB::SetFrameNumber (uint32_t frame_number, uint32_t stop_id)
+{
+    m_frame_number = frame_number;
+    m_concrete_frame_idx = frame_number;
+    SetStopID (stop_id);
+}
+
+Error
+RegisterContextLLDB::ReadSavedRegisterValueFromMemory (const RegisterInfo *reg_info, addr_t addr, RegisterValue &value)
+{
+    Error error (ReadRegisterValueFromMemory (reg_info, addr, reg_info->byte_size, value));
+    if (error.Success())
+        m_parent_unwind.NoteStackRead (addr, value);
+    return error;
+}
+
 // Retrieve the address of the start of the function of THIS frame
 
 bool
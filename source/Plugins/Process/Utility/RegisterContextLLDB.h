@@ -122,6 +122,19 @@ private:
     SharedPtr
     GetPrevFrame () const;
 
+    // Used by UnwindLLDB when it carries this frame over from an earlier stop
+    // to a (possibly different) position in the current stack.
+    void
+    SetFrameNumber (uint32_t frame_number, uint32_t stop_id);
+
+    // Read a register value that was saved to the stack, telling our
+    // UnwindLLDB about the read so it can later check that the stack slot
+    // still holds the same value.
+    lldb_private::Error
+    ReadSavedRegisterValueFromMemory (const lldb_private::RegisterInfo *reg_info,
+                                      lldb::addr_t addr,
+                                      lldb_private::RegisterValue &value);
+
     // A SkipFrame occurs when the unwind out of frame 0 didn't go right -- we've got one bogus frame at frame #1.
     // There is a good chance we'll get back on track if we follow the frame pointer chain (or whatever is appropriate
     // on this ABI) so we allow one invalid frame to be in the stack.  Ideally we'll mark this frame specially at some
@@ -7,8 +7,13 @@
 //
 //===----------------------------------------------------------------------===//
 
+#include <algorithm>
+
+#include "lldb/Core/DataBufferHeap.h"
+#include "lldb/Core/DataExtractor.h"
 #include "lldb/Core/Module.h"
 #include "lldb/Core/Log.h"
+#include "lldb/Core/RegisterValue.h"
 #include "lldb/Symbol/FuncUnwinders.h"
 #include "lldb/Symbol/Function.h"
 #include "lldb/Symbol/UnwindPlan.h"
@@ -28,7 +33,13 @@ UnwindLLDB::UnwindLLDB (Thread &thread) :
     Unwind (thread),
     m_frames(),
     m_unwind_complete(false),
-    m_user_supplied_trap_handler_functions()
+    m_user_supplied_trap_handler_functions(),
+    m_prev_frames(),
+    m_prev_frame_index(),
+    m_prev_unwind_complete(false),
+    m_pending_stack_reads(),
+    m_pending_reads_verifiable(true),
+    m_recording_stack_reads(false)
 {
     ProcessSP process_sp(thread.GetProcess());
     if (process_sp)
@@ -44,6 +55,26 @@ UnwindLLDB::UnwindLLDB (Thread &thread) :
     }
 }
 
+void
+UnwindLLDB::DoClear ()
+{
+    // Don't throw the frames away -- after the next stop most of them are probably still
+    // on the stack and ReusePreviousStopFrames() can pick them up again.  If we didn't
+    // unwind at all during this stop, the frames from the stop before are still the best
+    // candidates, so keep those.
+    if (!m_frames.empty())
+    {
+        m_prev_frames.swap (m_frames);
+        m_prev_unwind_complete = m_unwind_complete;
+        m_prev_frame_index.clear();
+        // Frame 0 is never reused, it is rebuilt from the live registers every time.
+        for (uint32_t i = 1; i < m_prev_frames.size(); ++i)
+            m_prev_frame_index.insert (std::make_pair (m_prev_frames[i]->cfa, i));
+    }
+    m_frames.clear();
+    m_unwind_complete = false;
+}
+
 uint32_t
 UnwindLLDB::DoGetFrameCount()
 {
@@ -135,6 +166,12 @@ UnwindLLDB::AddOneMoreFrame (ABI *abi)
     if (m_frames.size() == 0)
         return false;
 
+    // Everything the new RegisterContextLLDB reads from the stack from here on is what
+    // the frame's CFA and pc depend on.
+    m_pending_stack_reads.clear();
+    m_pending_reads_verifiable = true;
+    m_recording_stack_reads = true;
+
     uint32_t cur_idx = m_frames.size ();
     RegisterContextLLDBSP reg_ctx_sp(new RegisterContextLLDB (m_thread, 
                                                               m_frames[cur_idx - 1]->reg_ctx_lldb_sp, 
@@ -282,7 +319,11 @@ UnwindLLDB::AddOneMoreFrame (ABI *abi)
     }
 
     cursor_sp->reg_ctx_lldb_sp = reg_ctx_sp;
+    cursor_sp->stack_reads.swap (m_pending_stack_reads);
+    cursor_sp->stack_reads_verifiable = m_pending_reads_verifiable;
+    m_recording_stack_reads = false;
     m_frames.push_back (cursor_sp);
+    ReusePreviousStopFrames ();
     return true;
     
 unwind_done:
@@ -290,6 +331,7 @@ unwind_done:
     {
         log->Printf ("th%d Unwind of this thread is complete.", m_thread.GetIndexID());
     }
+    m_recording_stack_reads = false;
     m_unwind_complete = true;
     return false;
 }
@@ -413,3 +455,145 @@ UnwindLLDB::SearchForSavedLocationForRegister (uint32_t lldb_regnum, lldb_privat
     }
     return false;
 }
+
+void
+UnwindLLDB::NoteStackRead (addr_t addr, const RegisterValue &value)
+{
+    // Reads made on behalf of the user after the frame was added don't matter.
+    if (!m_recording_stack_reads)
+        return;
+
+    const uint32_t size = value.GetByteSize();
+    bool success = false;
+    const uint64_t uval = value.GetAsUInt64 (0, &success);
+    if (success && size > 0 && size <= sizeof(uint64_t))
+    {
+        StackRead read = { addr, size, uval };
+        m_pending_stack_reads.push_back (read);
+    }
+    else
+        m_pending_reads_verifiable = false;
+}
+
+// Called right after a frame was appended to m_frames.  If that frame is one we also had
+// at the previous stop -- same CFA and same pc -- the frames above it were computed from
+// values that are very likely still in place: the registers a caller sees at a call site
+// are, by the ABI, the callee-saved ones, and those don't change while the caller is
+// suspended.  So the old frames are good if every stack slot they were derived from still
+// holds the value we read then.  When that's the case, splice them in and skip unwinding
+// them again.  Either way the previous stop's frames are only considered once.
+void
+UnwindLLDB::ReusePreviousStopFrames ()
+{
+    if (m_prev_frames.empty())
+        return;
+
+    const CursorSP &cursor_sp = m_frames.back();
+    std::map<addr_t, uint32_t>::const_iterator pos = m_prev_frame_index.find (cursor_sp->cfa);
+    if (pos == m_prev_frame_index.end())
+        return;
+
+    // Despite its name, Cursor::start_pc is the frame's pc as returned by ReadPC, not the
+    // start of its function, so this requires the same call site and not just the same function.
+    const uint32_t prev_idx = pos->second;
+    const CursorSP &prev_cursor_sp = m_prev_frames[prev_idx];
+    if (prev_cursor_sp->start_pc != cursor_sp->start_pc)
+        return;
+
+    Log *log(GetLogIfAllCategoriesSet (LIBLLDB_LOG_UNWIND));
+    ProcessSP process_sp (m_thread.GetProcess());
+
+    // Unusual frames (trap handlers, skip frames, ...) change how the frames above them are
+    // computed; only carry frames over across ordinary frames.
+    uint32_t end_idx = prev_idx + 1;
+    if (process_sp
+        && cursor_sp->reg_ctx_lldb_sp->m_frame_type == RegisterContextLLDB::eNormalFrame
+        && prev_cursor_sp->reg_ctx_lldb_sp->m_frame_type == RegisterContextLLDB::eNormalFrame)
+    {
+        while (end_idx < m_prev_frames.size()
+               && m_prev_frames[end_idx]->stack_reads_verifiable
+               && m_prev_frames[end_idx]->reg_ctx_lldb_sp->m_frame_type == RegisterContextLLDB::eNormalFrame)
+            ++end_idx;
+    }
+
+    if (end_idx > prev_idx + 1 && StackReadsAreCurrent (*process_sp, prev_idx + 1, end_idx))
+    {
+        const uint32_t stop_id = process_sp->GetStopID();
+        const uint32_t first_new_idx = m_frames.size();
+        for (uint32_t i = prev_idx + 1; i < end_idx; ++i)
+        {
+            m_prev_frames[i]->reg_ctx_lldb_sp->SetFrameNumber (m_frames.size(), stop_id);
+            m_frames.push_back (m_prev_frames[i]);
+        }
+        if (end_idx == m_prev_frames.size())
+            m_unwind_complete = m_prev_unwind_complete;
+
+        if (log)
+            log->Printf ("th%d reused %u frames from the previous stop as frames %u-%u",
+                         m_thread.GetIndexID(), end_idx - prev_idx - 1, first_new_idx, (uint32_t) m_frames.size() - 1);
+    }
+    else if (log)
+    {
+        log->Printf ("th%d frame %u was on the stack at the previous stop but the frames above it changed",
+                     m_thread.GetIndexID(), (uint32_t) m_frames.size() - 1);
+    }
+
+    m_prev_frames.clear();
+    m_prev_frame_index.clear();
+}
+
+bool
+UnwindLLDB::StackReadsAreCurrent (Process &process, uint32_t start_idx, uint32_t end_idx)
+{
+    addr_t min_addr = LLDB_INVALID_ADDRESS;
+    addr_t max_addr = 0;
+    for (uint32_t i = start_idx; i < end_idx; ++i)
+    {
+        const std::vector<StackRead> &reads = m_prev_frames[i]->stack_reads;
+        for (size_t j = 0; j < reads.size(); ++j)
+        {
+            min_addr = std::min (min_addr, reads[j].addr);
+            max_addr = std::max (max_addr, reads[j].addr + reads[j].size);
+        }
+    }
+    if (min_addr == LLDB_INVALID_ADDRESS)
+        return true;
+
+    // The saved registers of a run of frames are usually all within a page or two of each
+    // other, so fetch them with one read when we can.
+    const addr_t max_bulk_read_size = 64 * 1024;
+    DataBufferHeap bulk_data;
+    Error error;
+    if (max_addr - min_addr <= max_bulk_read_size)
+    {
+        bulk_data.SetByteSize (max_addr - min_addr);
+        if (process.ReadMemory (min_addr, bulk_data.GetBytes(), bulk_data.GetByteSize(), error) != bulk_data.GetByteSize())
+            bulk_data.Clear();
+    }
+    DataExtractor data (bulk_data.GetBytes(), bulk_data.GetByteSize(),
+                        process.GetByteOrder(), process.GetAddressByteSize());
+
+    for (uint32_t i = start_idx; i < end_idx; ++i)
+    {
+        const std::vector<StackRead> &reads = m_prev_frames[i]->stack_reads;
+        for (size_t j = 0; j < reads.size(); ++j)
+        {
+            const StackRead &read = reads[j];
+            uint64_t current_value;
+            if (bulk_data.GetByteSize() > 0)
+            {
+                lldb::offset_t offset = read.addr - min_addr;
+                current_value = data.GetMaxU64 (&offset, read.size);
+            }
+            else
+            {
+                current_value = process.ReadUnsignedIntegerFromMemory (read.addr, read.size, 0, error);
+                if (error.Fail())
+                    return false;
+            }
+            if (current_value != read.value)
+                return false;
+        }
+    }
+    return true;
+}
@@ -10,6 +10,7 @@
 #ifndef lldb_UnwindLLDB_h_
 #define lldb_UnwindLLDB_h_
 
+#include <map>
 #include <vector>
 
 #include "lldb/lldb-public.h"
@@ -62,11 +63,7 @@ protected:
     };
 
     void
-    DoClear()
-    {
-        m_frames.clear();
-        m_unwind_complete = false;
-    }
+    DoClear();
 
     virtual uint32_t
     DoGetFrameCount();
@@ -110,16 +107,47 @@ protected:
         return m_user_supplied_trap_handler_functions;
     }
 
+    //------------------------------------------------------------------
+    /// Record a read of a saved register value from the inferior's stack.
+    ///
+    /// Called by the RegisterContextLLDB's while a frame is being added.
+    /// The reads made while computing a frame's CFA and pc are kept with
+    /// the frame so that, after the next stop, we can tell whether the
+    /// frame can be reused without unwinding it again.
+    //------------------------------------------------------------------
+    void
+    NoteStackRead (lldb::addr_t addr, const RegisterValue &value);
+
+    //------------------------------------------------------------------
+    /// Note that the frame being added depends on inferior memory that
+    /// we can't track (e.g. a DWARF expression did the reading), so it
+    /// must never be reused at a later stop.
+    //------------------------------------------------------------------
+    void
+    NoteUnverifiableStackRead ()
+    {
+        m_pending_reads_verifiable = false;
+    }
+
 private:
 
+    struct StackRead
+    {
+        lldb::addr_t addr;
+        uint32_t size;
+        uint64_t value;
+    };
+
     struct Cursor
     {
-        lldb::addr_t start_pc;  // The start address of the function/symbol for this frame - current pc if unknown
+        lldb::addr_t start_pc;  // The pc of this frame, as returned by ReadPC (not the start of its function)
         lldb::addr_t cfa;       // The canonical frame address for this stack frame
         lldb_private::SymbolContext sctx;  // A symbol context we'll contribute to & provide to the StackFrame creation
         RegisterContextLLDBSP reg_ctx_lldb_sp; // These are all RegisterContextLLDB's
+        std::vector<StackRead> stack_reads; // The saved register values this frame's CFA and pc were derived from
+        bool stack_reads_verifiable;        // False if the frame depends on memory reads we didn't record
 
-        Cursor () : start_pc (LLDB_INVALID_ADDRESS), cfa (LLDB_INVALID_ADDRESS), sctx(), reg_ctx_lldb_sp() { }
+        Cursor () : start_pc (LLDB_INVALID_ADDRESS), cfa (LLDB_INVALID_ADDRESS), sctx(), reg_ctx_lldb_sp(), stack_reads(), stack_reads_verifiable (false) { }
     private:
         DISALLOW_COPY_AND_ASSIGN (Cursor);
     };
@@ -132,9 +160,27 @@ private:
  
     std::vector<ConstString> m_user_supplied_trap_handler_functions;
 
+    // The frames from the last stop at which we unwound this thread, indexed by CFA.  Between
+    // two stops usually only the bottom few frames change, so once we unwind into a frame that
+    // was also on the stack last time, the frames above it can be carried over.
+    std::vector<CursorSP> m_prev_frames;
+    std::map<lldb::addr_t, uint32_t> m_prev_frame_index;
+    bool m_prev_unwind_complete;
+
+    // The stack reads made so far while adding the current frame.
+    std::vector<StackRead> m_pending_stack_reads;
+    bool m_pending_reads_verifiable;
+    bool m_recording_stack_reads;
+
     bool AddOneMoreFrame (ABI *abi);
     bool AddFirstFrame ();
 
+    void
+    ReusePreviousStopFrames ();
+
+    bool
+    StackReadsAreCurrent (Process &process, uint32_t start_idx, uint32_t end_idx);
+
     //------------------------------------------------------------------
     // For UnwindLLDB only
     //------------------------------------------------------------------
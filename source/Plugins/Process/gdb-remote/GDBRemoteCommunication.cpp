@@ -31,6 +31,8 @@
 #include "lldb/Host/TimeValue.h"
 #include "lldb/Target/Process.h"
 #include "llvm/ADT/SmallString.h"
+#include "llvm/ADT/SmallVector.h"
+#include "llvm/Support/Compression.h"
 
 // Project includes
 #include "ProcessGDBRemoteLog.h"
@@ -150,10 +152,17 @@ GDBRemoteCommunication::GDBRemoteCommunication(const char *comm_name,
     m_packet_timeout (1),
 #endif
     m_sequence_mutex (Mutex::eMutexTypeRecursive),
+    m_write_mutex (),
     m_public_is_running (false),
     m_private_is_running (false),
     m_history (512),
     m_send_acks (true),
+    m_send_compression_type (CompressionType::None),
+    m_send_compression_min_size (0),
+    m_receive_compression_type (CompressionType::None),
+    m_compressed_packet_count (0),
+    m_compression_payload_bytes (0),
+    m_compression_wire_bytes (0),
     m_listen_url ()
 {
 }
@@ -206,6 +215,202 @@ GDBRemoteCommunication::SendNack ()
     return bytes_written;
 }
 
+//----------------------------------------------------------------------
+// Expand the run-length encoding and binary escapes of a packet payload
+// from [begin, end) and append the result to dst.
+//----------------------------------------------------------------------
+static void
+ExpandPacketPayload (const char *begin, const char *end, std::string &dst)
+{
+    for (const char *c = begin; c != end; ++c)
+    {
+        // Copy everything up to the next RLE or escape character in one go,
+        // most packets don't contain any.
+        const char *run_end = c;
+        while (run_end != end && *run_end != '*' && *run_end != 0x7d)
+            ++run_end;
+        if (run_end != c)
+        {
+            dst.append(c, run_end);
+            c = run_end;
+            if (c == end)
+                break;
+        }
+
+        if (*c == '*' && !dst.empty() && c + 1 != end)
+        {
+            // '*' indicates RLE. Next character will give us the
+            // repeat count and previous character is what is to be
+            // repeated.
+            char char_to_repeat = dst.back();
+            // Number of time the previous character is repeated
+            int repeat_count = *++c + 3 - ' ';
+            // We have the char_to_repeat and repeat_count. Now push
+            // it in the packet.
+            dst.append(repeat_count, char_to_repeat);
+        }
+        else if (*c == 0x7d && c + 1 != end)
+        {
+            // 0x7d is the escape character.  The next character is to
+            // be XOR'd with 0x20.
+            char escapee = *++c ^ 0x20;
+            dst.push_back(escapee);
+        }
+        else
+        {
+            dst.push_back(*c);
+        }
+    }
+}
+
+bool
+GDBRemoteCommunication::IsCompressionTypeSupported (CompressionType type)
+{
+    switch (type)
+    {
+    case CompressionType::None:
+        return true;
+    case CompressionType::ZlibDeflate:
+        return llvm::zlib::isAvailable();
+    }
+    return false;
+}
+
+const char *
+GDBRemoteCommunication::GetCompressionTypeName (CompressionType type)
+{
+    switch (type)
+    {
+    case CompressionType::None:
+        return "none";
+    case CompressionType::ZlibDeflate:
+        return "zlib-deflate";
+    }
+    return NULL;
+}
+
+void
+GDBRemoteCommunication::SetSendCompression (CompressionType type, uint32_t min_size)
+{
+    Mutex::Locker locker(m_sequence_mutex);
+    m_send_compression_type = type;
+    m_send_compression_min_size = min_size;
+}
+
+void
+GDBRemoteCommunication::SetReceiveCompression (CompressionType type)
+{
+    Mutex::Locker locker(m_bytes_mutex);
+    m_receive_compression_type = type;
+}
+
+void
+GDBRemoteCommunication::DumpCompressionStatistics (Stream &strm) const
+{
+    const CompressionType type = m_send_compression_type != CompressionType::None ? m_send_compression_type : m_receive_compression_type;
+    strm.Printf ("compression: %s\n", GetCompressionTypeName (type));
+    strm.Printf ("compressed packets: %" PRIu64 "\n", m_compressed_packet_count);
+    strm.Printf ("payload bytes: %" PRIu64 "\n", m_compression_payload_bytes);
+    strm.Printf ("bytes on the wire: %" PRIu64 "\n", m_compression_wire_bytes);
+    if (m_compression_payload_bytes > m_compression_wire_bytes)
+        strm.Printf ("bytes saved: %" PRIu64 " (%.1f%%)\n",
+                     m_compression_payload_bytes - m_compression_wire_bytes,
+                     100.0 * (m_compression_payload_bytes - m_compression_wire_bytes) / m_compression_payload_bytes);
+}
+
+void
+GDBRemoteCommunication::EncodeCompressedPayload (const char *payload, size_t payload_length, std::string &encoded)
+{
+    encoded.clear();
+
+    if (m_send_compression_type == CompressionType::ZlibDeflate && payload_length >= m_send_compression_min_size)
+    {
+        llvm::SmallVector<char, 0> compressed;
+        if (llvm::zlib::compress (llvm::StringRef (payload, payload_length), compressed) == llvm::zlib::StatusOK)
+        {
+            StreamString header;
+            header.Printf ("C%" PRIu64 ":", (uint64_t)payload_length);
+            encoded.reserve (header.GetSize() + compressed.size() + compressed.size() / 32);
+            encoded.append (header.GetString());
+            for (char ch : compressed)
+            {
+                switch (ch)
+                {
+                case '#':
+                case '$':
+                case '}':
+                case '*':
+                    encoded.push_back ('}');
+                    encoded.push_back (ch ^ 0x20);
+                    break;
+                default:
+                    encoded.push_back (ch);
+                    break;
+                }
+            }
+
+            // Only keep the compressed form if it actually ended up smaller
+            if (encoded.size() < payload_length + 1)
+            {
+                ++m_compressed_packet_count;
+                m_compression_payload_bytes += payload_length;
+                m_compression_wire_bytes += encoded.size();
+                return;
+            }
+            encoded.clear();
+        }
+    }
+
+    encoded.reserve (payload_length + 1);
+    encoded.push_back ('N');
+    encoded.append (payload, payload_length);
+}
+
+bool
+GDBRemoteCommunication::DecompressPacket (std::string &packet_str, size_t wire_length)
+{
+    if (packet_str.empty())
+        return false;
+
+    switch (packet_str[0])
+    {
+    case 'N':
+        packet_str.erase (0, 1);
+        return true;
+
+    case 'C':
+        {
+            const size_t colon_pos = packet_str.find (':');
+            if (colon_pos == std::string::npos)
+                return false;
+
+            bool success = false;
+            const uint64_t payload_size = StringConvert::ToUInt64 (packet_str.substr (1, colon_pos - 1).c_str(), 0, 10, &success);
+            if (!success || payload_size > k_max_decompressed_packet_size)
+                return false;
+
+            llvm::SmallVector<char, 0> payload;
+            llvm::StringRef compressed (packet_str.data() + colon_pos + 1, packet_str.size() - colon_pos - 1);
+            if (llvm::zlib::uncompress (compressed, payload, payload_size) != llvm::zlib::StatusOK)
+                return false;
+
+            ++m_compressed_packet_count;
+            m_compression_payload_bytes += payload_size;
+            m_compression_wire_bytes += wire_length;
+
+            // The payload was compressed with its own escapes in place
+            packet_str.clear();
+            packet_str.reserve (payload.size());
+            ExpandPacketPayload (payload.data(), payload.data() + payload.size(), packet_str);
+            return true;
+        }
+
+    default:
+        break;
+    }
+    return false;
+}
+
 GDBRemoteCommunication::PacketResult
 GDBRemoteCommunication::SendPacket (const char *payload, size_t payload_length)
 {
@@ -218,6 +423,14 @@ GDBRemoteCommunication::SendPacketNoLock (const char *payload, size_t payload_le
 {
     if (IsConnected())
     {
+        std::string encoded_payload;
+        if (m_send_compression_type != CompressionType::None)
+        {
+            EncodeCompressedPayload (payload, payload_length, encoded_payload);
+            payload = encoded_payload.data();
+            payload_length = encoded_payload.size();
+        }
+
         StreamString packet(0, 4, eByteOrderBig);
 
         packet.PutChar('$');
@@ -229,7 +442,11 @@ GDBRemoteCommunication::SendPacketNoLock (const char *payload, size_t payload_le
         ConnectionStatus status = eConnectionStatusSuccess;
         const char *packet_data = packet.GetData();
         const size_t packet_length = packet.GetSize();
-        size_t bytes_written = Write (packet_data, packet_length, status, NULL);
+        size_t bytes_written;
+        {
+            Mutex::Locker write_locker (m_write_mutex);
+            bytes_written = Write (packet_data, packet_length, status, NULL);
+        }
         if (log)
         {
             size_t binary_start_offset = 0;
@@ -287,6 +504,46 @@ GDBRemoteCommunication::SendPacketNoLock (const char *payload, size_t payload_le
     return PacketResult::ErrorSendFailed;
 }
 
+GDBRemoteCommunication::PacketResult
+GDBRemoteCommunication::SendNotificationPacketNoLock (const char *notify_type, const char *payload, size_t payload_length)
+{
+    if (!IsConnected())
+        return PacketResult::ErrorSendFailed;
+
+    // Notifications go out as "%<type>:<payload>#<checksum>" and are never
+    // acknowledged, so they can be sent while another thread is waiting
+    // for a packet.
+    StreamString packet(0, 4, eByteOrderBig);
+    packet.PutChar('%');
+    packet.PutCString(notify_type);
+    packet.PutChar(':');
+    packet.Write (payload, payload_length);
+    packet.PutChar('#');
+    packet.PutHex8(CalculcateChecksum (packet.GetData() + 1, packet.GetSize() - 2));
+
+    ConnectionStatus status = eConnectionStatusSuccess;
+    const char *packet_data = packet.GetData();
+    const size_t packet_length = packet.GetSize();
+    size_t bytes_written;
+    {
+        Mutex::Locker write_locker (m_write_mutex);
+        bytes_written = Write (packet_data, packet_length, status, NULL);
+    }
+
+    Log *log (ProcessGDBRemoteLog::GetLogIfAllCategoriesSet (GDBR_LOG_PACKETS));
+    if (log)
+        log->Printf("<%4" PRIu64 "> send notification: %.*s", (uint64_t)bytes_written, (int)packet_length, packet_data);
+
+    m_history.AddPacket (packet.GetString(), packet_length, History::ePacketTypeSend, bytes_written);
+
+    if (bytes_written == packet_length)
+        return PacketResult::Success;
+
+    if (log)
+        log->Printf ("error: failed to send notification: %.*s", (int)packet_length, packet_data);
+    return PacketResult::ErrorSendFailed;
+}
+
 GDBRemoteCommunication::PacketResult
 GDBRemoteCommunication::GetAck ()
 {
@@ -322,7 +579,9 @@ GDBRemoteCommunication::WaitForNotRunningPrivate (const TimeValue *timeout_ptr)
 GDBRemoteCommunication::PacketResult
 GDBRemoteCommunication::WaitForPacketWithTimeoutMicroSecondsNoLock (StringExtractorGDBRemote &packet, uint32_t timeout_usec)
 {
-    uint8_t buffer[8192];
+    // Large enough to take in a maximum sized reply (see the PacketSize
+    // in qSupported) with a handful of reads.
+    uint8_t buffer[32 * 1024];
     Error error;
 
     Log *log (ProcessGDBRemoteLog::GetLogIfAllCategoriesSet (GDBR_LOG_PACKETS | GDBR_LOG_VERBOSE));
@@ -556,34 +815,8 @@ GDBRemoteCommunication::CheckForPacket (const uint8_t *src, size_t src_len, Stri
             // Copy the packet from m_bytes to packet_str expanding the
             // run-length encoding in the process.
             // Reserve enough byte for the most common case (no RLE used)
-            packet_str.reserve(m_bytes.length());
-            for (std::string::const_iterator c = m_bytes.begin() + content_start; c != m_bytes.begin() + content_end; ++c)
-            {
-                if (*c == '*')
-                {
-                    // '*' indicates RLE. Next character will give us the
-                    // repeat count and previous character is what is to be
-                    // repeated.
-                    char char_to_repeat = packet_str.back();
-                    // Number of time the previous character is repeated
-                    int repeat_count = *++c + 3 - ' ';
-                    // We have the char_to_repeat and repeat_count. Now push
-                    // it in the packet.
-                    for (int i = 0; i < repeat_count; ++i)
-                        packet_str.push_back(char_to_repeat);
-                }
-                else if (*c == 0x7d)
-                {
-                    // 0x7d is the escape character.  The next character is to
-                    // be XOR'd with 0x20.
-                    char escapee = *++c ^ 0x20;
-                    packet_str.push_back(escapee);
-                }
-                else
-                {
-                    packet_str.push_back(*c);
-                }
-            }
+            packet_str.reserve(content_length);
+            ExpandPacketPayload (m_bytes.data() + content_start, m_bytes.data() + content_end, packet_str);
 
             if (m_bytes[0] == '$')
             {
@@ -621,7 +854,19 @@ GDBRemoteCommunication::CheckForPacket (const uint8_t *src, size_t src_len, Stri
                 }
             }
             
-            m_bytes.erase(0, total_length);
+            if (success && m_bytes[0] == '$' && m_receive_compression_type != CompressionType::None)
+            {
+                success = DecompressPacket (packet_str, content_length);
+                if (!success && log)
+                    log->Printf ("error: invalid compressed packet: '%.*s'", (int)(total_length), m_bytes.c_str());
+            }
+
+            // Most of the time the packet is the only thing in the buffer,
+            // in which case we can avoid moving any bytes around.
+            if (total_length == m_bytes.size())
+                m_bytes.clear();
+            else
+                m_bytes.erase(0, total_length);
             packet.SetFilePos(0);
             return success;
         }
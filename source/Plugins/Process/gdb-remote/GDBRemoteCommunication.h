@@ -60,6 +60,12 @@ public:
         ErrorNoSequenceLock // We couldn't get the sequence lock for a multi-packet request
     };
 
+    enum class CompressionType
+    {
+        None = 0,           // Packets are sent as-is
+        ZlibDeflate         // Large packets are deflated with zlib
+    };
+
     // Class to change the timeout for a given scope and restore it to the original value when the
     // created ScopedTimeout object got out of scope
     class ScopedTimeout
@@ -153,7 +159,37 @@ public:
 
     void
     DumpHistory(lldb_private::Stream &strm);
-    
+
+    //------------------------------------------------------------------
+    // Packet compression.
+    //
+    // Once negotiated with "QEnableCompression", every packet in the
+    // compressed direction carries a one character encoding prefix:
+    // 'N' for a packet that is sent as-is, or 'C<decimal size>:' for a
+    // packet whose payload was deflated from <size> bytes.
+    //------------------------------------------------------------------
+    // The largest payload a compressed packet may expand to.  This is well
+    // above anything either side sends, so a packet claiming more is
+    // rejected as corrupt instead of being allocated.
+    static const size_t k_max_decompressed_packet_size = 16 * 1024 * 1024;
+
+    static bool
+    IsCompressionTypeSupported (CompressionType type);
+
+    static const char *
+    GetCompressionTypeName (CompressionType type);
+
+    // Compress outgoing packets whose payload is at least min_size bytes.
+    void
+    SetSendCompression (CompressionType type, uint32_t min_size);
+
+    // Expect incoming packets to carry a compression encoding prefix.
+    void
+    SetReceiveCompression (CompressionType type);
+
+    void
+    DumpCompressionStatistics (lldb_private::Stream &strm) const;
+
 protected:
 
     class History
@@ -269,6 +305,11 @@ protected:
     SendPacketNoLock (const char *payload, 
                       size_t payload_length);
 
+    PacketResult
+    SendNotificationPacketNoLock (const char *notify_type,
+                                  const char *payload,
+                                  size_t payload_length);
+
     PacketResult
     WaitForPacketWithTimeoutMicroSecondsNoLock (StringExtractorGDBRemote &response, 
                                                 uint32_t timeout_usec);
@@ -276,6 +317,15 @@ protected:
     bool
     WaitForNotRunningPrivate (const lldb_private::TimeValue *timeout_ptr);
 
+    void
+    EncodeCompressedPayload (const char *payload,
+                             size_t payload_length,
+                             std::string &encoded);
+
+    bool
+    DecompressPacket (std::string &packet_str,
+                      size_t wire_length);
+
     //------------------------------------------------------------------
     // Classes that inherit from GDBRemoteCommunication can see and modify these
     //------------------------------------------------------------------
@@ -285,6 +335,7 @@ protected:
 #else
     lldb_private::Mutex m_sequence_mutex;    // Restrict access to sending/receiving packets to a single thread at a time
 #endif
+    lldb_private::Mutex m_write_mutex;      // Keeps packets written by different threads from interleaving
     lldb_private::Predicate<bool> m_public_is_running;
     lldb_private::Predicate<bool> m_private_is_running;
     History m_history;
@@ -292,6 +343,12 @@ protected:
     bool m_is_platform; // Set to true if this class represents a platform,
                         // false if this class represents a debug session for
                         // a single process
+    CompressionType m_send_compression_type;
+    uint32_t m_send_compression_min_size;
+    CompressionType m_receive_compression_type;
+    uint64_t m_compressed_packet_count;         // Packets that went over the wire compressed
+    uint64_t m_compression_payload_bytes;       // Their payload size before compression
+    uint64_t m_compression_wire_bytes;          // Their payload size on the wire
     
 
     lldb_private::Error
@@ -18,6 +18,8 @@
 
 // Other libraries and framework includes
 #include "llvm/ADT/STLExtras.h"
+#include "llvm/ADT/SmallVector.h"
+#include "llvm/ADT/StringRef.h"
 #include "llvm/ADT/Triple.h"
 #include "lldb/Interpreter/Args.h"
 #include "lldb/Core/Log.h"
@@ -80,6 +82,8 @@ GDBRemoteCommunicationClient::GDBRemoteCommunicationClient() :
     m_supports_qXfer_libraries_svr4_read (eLazyBoolCalculate),
     m_supports_augmented_libraries_svr4_read (eLazyBoolCalculate),
     m_supports_jThreadExtendedInfo (eLazyBoolCalculate),
+    m_supports_zlib_compression (eLazyBoolCalculate),
+    m_supports_breakpoint_step_over (eLazyBoolCalculate),
     m_supports_qProcessInfoPID (true),
     m_supports_qfProcessInfo (true),
     m_supports_qUserName (true),
@@ -212,6 +216,16 @@ GDBRemoteCommunicationClient::GetQXferAuxvReadSupported ()
     return (m_supports_qXfer_auxv_read == eLazyBoolYes);
 }
 
+bool
+GDBRemoteCommunicationClient::GetBreakpointStepOverSupported ()
+{
+    if (m_supports_breakpoint_step_over == eLazyBoolCalculate)
+    {
+        GetRemoteQSupported();
+    }
+    return (m_supports_breakpoint_step_over == eLazyBoolYes);
+}
+
 uint64_t
 GDBRemoteCommunicationClient::GetRemoteMaxPacketSize()
 {
@@ -251,6 +265,44 @@ GDBRemoteCommunicationClient::QueryNoAckModeSupported ()
     return false;
 }
 
+bool
+GDBRemoteCommunicationClient::EnableCompression (uint32_t min_size)
+{
+    // Compressed packets aren't checksummed, so require no-ack mode
+    if (m_send_acks)
+        return false;
+
+    if (!IsCompressionTypeSupported (CompressionType::ZlibDeflate))
+        return false;
+
+    if (m_supports_zlib_compression == eLazyBoolCalculate)
+        GetRemoteQSupported();
+    if (m_supports_zlib_compression != eLazyBoolYes)
+        return false;
+
+    StreamString packet;
+    packet.Printf ("QEnableCompression:type:%s;minsize:%u;",
+                   GetCompressionTypeName (CompressionType::ZlibDeflate),
+                   min_size);
+
+    StringExtractorGDBRemote response;
+    if (SendPacketAndWaitForResponse (packet.GetData(), packet.GetSize(), response, false) == PacketResult::Success)
+    {
+        if (response.IsOKResponse())
+        {
+            SetReceiveCompression (CompressionType::ZlibDeflate);
+            Log *log (ProcessGDBRemoteLog::GetLogIfAllCategoriesSet (GDBR_LOG_PROCESS));
+            if (log)
+                log->Printf ("GDBRemoteCommunicationClient::%s enabled %s compression for packets >= %u bytes",
+                             __FUNCTION__,
+                             GetCompressionTypeName (CompressionType::ZlibDeflate),
+                             min_size);
+            return true;
+        }
+    }
+    return false;
+}
+
 void
 GDBRemoteCommunicationClient::GetListThreadsInStopReplySupported ()
 {
@@ -334,6 +386,9 @@ GDBRemoteCommunicationClient::ResetDiscoverableSettings()
     m_supports_qXfer_libraries_read = eLazyBoolCalculate;
     m_supports_qXfer_libraries_svr4_read = eLazyBoolCalculate;
     m_supports_augmented_libraries_svr4_read = eLazyBoolCalculate;
+    m_supports_zlib_compression = eLazyBoolCalculate;
+    m_supports_breakpoint_step_over = eLazyBoolCalculate;
+    SetReceiveCompression (CompressionType::None);
 
     m_supports_qProcessInfoPID = true;
     m_supports_qfProcessInfo = true;
@@ -371,6 +426,8 @@ GDBRemoteCommunicationClient::GetRemoteQSupported ()
     m_supports_qXfer_libraries_read = eLazyBoolNo;
     m_supports_qXfer_libraries_svr4_read = eLazyBoolNo;
     m_supports_augmented_libraries_svr4_read = eLazyBoolNo;
+    m_supports_zlib_compression = eLazyBoolNo;
+    m_supports_breakpoint_step_over = eLazyBoolNo;
     m_max_packet_size = UINT64_MAX;  // It's supposed to always be there, but if not, we assume no limit
 
     StringExtractorGDBRemote response;
@@ -390,6 +447,23 @@ GDBRemoteCommunicationClient::GetRemoteQSupported ()
         }
         if (::strstr (response_cstr, "qXfer:libraries:read+"))
             m_supports_qXfer_libraries_read = eLazyBoolYes;
+        if (::strstr (response_cstr, "BreakpointStepOver+"))
+            m_supports_breakpoint_step_over = eLazyBoolYes;
+
+        const char *compressions_str = ::strstr (response_cstr, "SupportedCompressions=");
+        if (compressions_str)
+        {
+            compressions_str += strlen("SupportedCompressions=");
+            const char *compressions_end = ::strchr (compressions_str, ';');
+            llvm::StringRef compressions (compressions_str, compressions_end ? compressions_end - compressions_str : ::strlen (compressions_str));
+            llvm::SmallVector<llvm::StringRef, 4> compression_names;
+            compressions.split (compression_names, ",");
+            for (llvm::StringRef name : compression_names)
+            {
+                if (name == GetCompressionTypeName (CompressionType::ZlibDeflate))
+                    m_supports_zlib_compression = eLazyBoolYes;
+            }
+        }
 
         const char *packet_size_str = ::strstr (response_cstr, "PacketSize=");
         if (packet_size_str)
@@ -727,6 +801,74 @@ GDBRemoteCommunicationClient::SendPacketAndWaitForResponse
     return packet_result;
 }
 
+GDBRemoteCommunicationClient::PacketResult
+GDBRemoteCommunicationClient::SendPacketsAndWaitForResponses (const std::vector<std::string> &payloads,
+                                                              std::vector<StringExtractorGDBRemote> &responses)
+{
+    // Bound the number of requests in flight so neither side blocks writing
+    // while the other one is still busy writing instead of reading.
+    const size_t max_packets_in_flight = 64;
+
+    responses.clear();
+    responses.resize(payloads.size());
+
+    Mutex::Locker locker;
+    if (!GetSequenceMutex (locker, "Didn't get sequence mutex for packet batch."))
+        return PacketResult::ErrorNoSequenceLock;
+
+    PacketResult packet_result = PacketResult::Success;
+    if (GetSendAcks ())
+    {
+        // Every packet must be acked before the next one can go out.
+        for (size_t i = 0; i < payloads.size(); ++i)
+        {
+            PacketResult result = SendPacketAndWaitForResponseNoLock (payloads[i].data(), payloads[i].size(), responses[i]);
+            if (result != PacketResult::Success && packet_result == PacketResult::Success)
+                packet_result = result;
+        }
+        return packet_result;
+    }
+
+    Log *log (ProcessGDBRemoteLog::GetLogIfAllCategoriesSet (GDBR_LOG_PACKETS));
+    if (log)
+        log->Printf ("GDBRemoteCommunicationClient::%s sending %" PRIu64 " packets", __FUNCTION__, (uint64_t)payloads.size());
+
+    size_t num_to_send = payloads.size();
+    size_t send_idx = 0;
+    size_t recv_idx = 0;
+    while (recv_idx < num_to_send)
+    {
+        while (send_idx < num_to_send && send_idx - recv_idx < max_packets_in_flight)
+        {
+            PacketResult result = SendPacketNoLock (payloads[send_idx].data(), payloads[send_idx].size());
+            if (result != PacketResult::Success)
+            {
+                // Don't send anything else, but still collect the responses
+                // to what did go out so they don't answer later requests.
+                packet_result = result;
+                num_to_send = send_idx;
+                break;
+            }
+            ++send_idx;
+        }
+
+        if (recv_idx == send_idx)
+            break;
+
+        PacketResult result = WaitForPacketWithTimeoutMicroSecondsNoLock (responses[recv_idx], GetPacketTimeoutInMicroSeconds ());
+        if (result != PacketResult::Success)
+        {
+            // The remaining responses can't be matched up anymore.
+            if (packet_result == PacketResult::Success)
+                packet_result = result;
+            break;
+        }
+        ++recv_idx;
+    }
+    responses.resize(recv_idx);
+    return packet_result;
+}
+
 static const char *end_delimiter = "--end--;";
 static const int end_delimiter_len = 8;
 
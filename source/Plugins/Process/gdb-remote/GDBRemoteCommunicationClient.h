@@ -49,6 +49,17 @@ public:
                                   StringExtractorGDBRemote &response,
                                   bool send_async);
 
+    // Send a batch of independent packets and collect their responses,
+    // which are stored in the same order as the requests. In no-ack mode
+    // the packets are written back to back and the responses are read as
+    // they arrive, so the whole batch costs about one round trip instead
+    // of one per packet. If any packet fails, the return value indicates
+    // the first failure and responses only holds the replies that were
+    // received before it.
+    PacketResult
+    SendPacketsAndWaitForResponses (const std::vector<std::string> &payloads,
+                                    std::vector<StringExtractorGDBRemote> &responses);
+
     // For packets which specify a range of output to be returned,
     // return all of the output via a series of request packets of the form
     // <prefix>0,<size>
@@ -91,6 +102,17 @@ public:
     void
     GetListThreadsInStopReplySupported ();
 
+    //------------------------------------------------------------------
+    // Ask the remote server to compress packets whose payload is at
+    // least min_size bytes. Only possible once acks have been disabled
+    // and when both sides support a common compression type.
+    //
+    // @return
+    //     True if compression was enabled, false otherwise.
+    //------------------------------------------------------------------
+    bool
+    EnableCompression (uint32_t min_size);
+
     bool
     SendAsyncSignal (int signo);
 
@@ -413,6 +435,11 @@ public:
     bool
     GetQXferAuxvReadSupported ();
 
+    // True if the stub moves threads past its own software breakpoints when
+    // they are resumed, without the breakpoints ever leaving memory.
+    bool
+    GetBreakpointStepOverSupported ();
+
     bool
     GetQXferLibrariesReadSupported ();
 
@@ -584,6 +611,8 @@ protected:
     lldb_private::LazyBool m_supports_qXfer_libraries_svr4_read;
     lldb_private::LazyBool m_supports_augmented_libraries_svr4_read;
     lldb_private::LazyBool m_supports_jThreadExtendedInfo;
+    lldb_private::LazyBool m_supports_zlib_compression;
+    lldb_private::LazyBool m_supports_breakpoint_step_over;
 
     bool
         m_supports_qProcessInfoPID:1,
@@ -108,6 +108,8 @@ GDBRemoteCommunicationServerCommon::GDBRemoteCommunicationServerCommon(const cha
                                   &GDBRemoteCommunicationServerCommon::Handle_qsProcessInfo);
     RegisterMemberFunctionHandler(StringExtractorGDBRemote::eServerPacketType_QStartNoAckMode,
                                   &GDBRemoteCommunicationServerCommon::Handle_QStartNoAckMode);
+    RegisterMemberFunctionHandler(StringExtractorGDBRemote::eServerPacketType_QEnableCompression,
+                                  &GDBRemoteCommunicationServerCommon::Handle_QEnableCompression);
     RegisterMemberFunctionHandler(StringExtractorGDBRemote::eServerPacketType_qSupported,
                                   &GDBRemoteCommunicationServerCommon::Handle_qSupported);
     RegisterMemberFunctionHandler(StringExtractorGDBRemote::eServerPacketType_QThreadSuffixSupported,
@@ -908,10 +910,19 @@ GDBRemoteCommunicationServerCommon::Handle_qSupported (StringExtractorGDBRemote
 #if defined(__linux__)
     response.PutCString (";qXfer:auxv:read+");
 #endif
+    if (IsCompressionTypeSupported (CompressionType::ZlibDeflate))
+        response.Printf (";SupportedCompressions=%s", GetCompressionTypeName (CompressionType::ZlibDeflate));
+
+    AppendSupportedFeatures (response);
 
     return SendPacketNoLock(response.GetData(), response.GetSize());
 }
 
+void
+GDBRemoteCommunicationServerCommon::AppendSupportedFeatures (StreamGDBRemote &response)
+{
+}
+
 GDBRemoteCommunication::PacketResult
 GDBRemoteCommunicationServerCommon::Handle_QThreadSuffixSupported (StringExtractorGDBRemote &packet)
 {
@@ -946,6 +957,47 @@ GDBRemoteCommunicationServerCommon::Handle_QStartNoAckMode (StringExtractorGDBRe
     return packet_result;
 }
 
+GDBRemoteCommunication::PacketResult
+GDBRemoteCommunicationServerCommon::Handle_QEnableCompression (StringExtractorGDBRemote &packet)
+{
+    // The checksum of a compressed packet isn't meaningful, so we only
+    // compress once acks have been turned off.
+    if (m_send_acks)
+        return SendErrorResponse (0x01);
+
+    CompressionType type = CompressionType::None;
+    uint32_t min_size = 0;
+
+    packet.SetFilePos(::strlen ("QEnableCompression:"));
+    std::string key;
+    std::string value;
+    while (packet.GetNameColonValue(key, value))
+    {
+        if (key.compare ("type") == 0)
+        {
+            if (value.compare (GetCompressionTypeName (CompressionType::ZlibDeflate)) == 0)
+                type = CompressionType::ZlibDeflate;
+        }
+        else if (key.compare ("minsize") == 0)
+        {
+            bool success = false;
+            min_size = StringConvert::ToUInt32 (value.c_str (), 0, 10, &success);
+            if (!success)
+                return SendIllFormedResponse (packet, "QEnableCompression: invalid minsize");
+        }
+    }
+
+    if (type == CompressionType::None || !IsCompressionTypeSupported (type))
+        return SendErrorResponse (0x02);
+
+    // Send the response before compression kicks in so the client can
+    // read it as a plain packet.
+    PacketResult packet_result = SendOKResponse ();
+    if (packet_result == PacketResult::Success)
+        SetSendCompression (type, min_size);
+    return packet_result;
+}
+
 GDBRemoteCommunication::PacketResult
 GDBRemoteCommunicationServerCommon::Handle_QSetSTDIN (StringExtractorGDBRemote &packet)
 {
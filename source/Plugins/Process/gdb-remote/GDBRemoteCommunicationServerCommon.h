@@ -16,6 +16,7 @@
 
 // Other libraries and framework includes
 #include "lldb/lldb-private-forward.h"
+#include "lldb/Core/StreamGDBRemote.h"
 #include "lldb/Host/Mutex.h"
 #include "lldb/Target/Process.h"
 
@@ -140,6 +141,13 @@ protected:
     PacketResult
     Handle_qSupported (StringExtractorGDBRemote &packet);
 
+    //------------------------------------------------------------------
+    /// Append the qSupported features that only this kind of server
+    /// provides, each preceded by a ';', to \a response.
+    //------------------------------------------------------------------
+    virtual void
+    AppendSupportedFeatures (lldb_private::StreamGDBRemote &response);
+
     PacketResult
     Handle_QThreadSuffixSupported (StringExtractorGDBRemote &packet);
 
@@ -152,6 +160,9 @@ protected:
     PacketResult
     Handle_QStartNoAckMode (StringExtractorGDBRemote &packet);
 
+    PacketResult
+    Handle_QEnableCompression (StringExtractorGDBRemote &packet);
+
     PacketResult
     Handle_QSetSTDIN (StringExtractorGDBRemote &packet);
 
@@ -66,7 +66,8 @@ namespace
         eErrorFirst = 29,
         eErrorNoProcess = eErrorFirst,
         eErrorResume,
-        eErrorExitStatus
+        eErrorExitStatus,
+        eErrorNonStop
     };
 }
 
@@ -89,7 +90,10 @@ GDBRemoteCommunicationServerLLGS::GDBRemoteCommunicationServerLLGS(
     m_active_auxv_buffer_sp (),
     m_saved_registers_mutex (),
     m_saved_registers_map (),
-    m_next_saved_registers_id (1)
+    m_next_saved_registers_id (1),
+    m_non_stop (false),
+    m_stop_notification_mutex (),
+    m_stop_notification_queue ()
 {
     assert(platform_sp);
     assert(debugger_sp && "must specify non-NULL debugger_sp for lldb-gdbserver");
@@ -143,6 +147,8 @@ GDBRemoteCommunicationServerLLGS::RegisterPacketHandlers()
                                   &GDBRemoteCommunicationServerLLGS::Handle_qMemoryRegionInfo);
     RegisterMemberFunctionHandler(StringExtractorGDBRemote::eServerPacketType_qMemoryRegionInfoSupported,
                                   &GDBRemoteCommunicationServerLLGS::Handle_qMemoryRegionInfoSupported);
+    RegisterMemberFunctionHandler(StringExtractorGDBRemote::eServerPacketType_QNonStop,
+                                  &GDBRemoteCommunicationServerLLGS::Handle_QNonStop);
     RegisterMemberFunctionHandler(StringExtractorGDBRemote::eServerPacketType_qProcessInfo,
                                   &GDBRemoteCommunicationServerLLGS::Handle_qProcessInfo);
     RegisterMemberFunctionHandler(StringExtractorGDBRemote::eServerPacketType_qRegisterInfo,
@@ -173,6 +179,8 @@ GDBRemoteCommunicationServerLLGS::RegisterPacketHandlers()
                                   &GDBRemoteCommunicationServerLLGS::Handle_vCont);
     RegisterMemberFunctionHandler(StringExtractorGDBRemote::eServerPacketType_vCont_actions,
                                   &GDBRemoteCommunicationServerLLGS::Handle_vCont_actions);
+    RegisterMemberFunctionHandler(StringExtractorGDBRemote::eServerPacketType_vStopped,
+                                  &GDBRemoteCommunicationServerLLGS::Handle_vStopped);
     RegisterMemberFunctionHandler(StringExtractorGDBRemote::eServerPacketType_Z,
                                   &GDBRemoteCommunicationServerLLGS::Handle_Z);
     RegisterMemberFunctionHandler(StringExtractorGDBRemote::eServerPacketType_z,
@@ -351,10 +359,27 @@ GDBRemoteCommunicationServerLLGS::InitializeDelegate (lldb_private::NativeProces
                 process->GetID (),
                 StateAsCString (process->GetState ()));
     }
+
+    // The client may have asked for non-stop mode before there was a process.
+    if (m_non_stop)
+    {
+        Error error = process->SetNonStopMode (true);
+        if (error.Fail () && log)
+            log->Printf ("GDBRemoteCommunicationServerLLGS::%s failed to enable non-stop mode for pid %" PRIu64 ": %s",
+                         __FUNCTION__, process->GetID (), error.AsCString ());
+    }
 }
 
 GDBRemoteCommunication::PacketResult
 GDBRemoteCommunicationServerLLGS::SendWResponse (lldb_private::NativeProcessProtocol *process)
+{
+    StreamGDBRemote response;
+    PrepareWResponse (process, response);
+    return SendPacketNoLock(response.GetData(), response.GetSize());
+}
+
+void
+GDBRemoteCommunicationServerLLGS::PrepareWResponse (lldb_private::NativeProcessProtocol *process, StreamString &response)
 {
     assert (process && "process cannot be NULL");
     Log *log (GetLogIfAnyCategoriesSet(LIBLLDB_LOG_PROCESS));
@@ -370,18 +395,14 @@ GDBRemoteCommunicationServerLLGS::SendWResponse (lldb_private::NativeProcessProt
         if (log)
             log->Printf ("GDBRemoteCommunicationServerLLGS::%s pid %" PRIu64 ", failed to retrieve process exit status", __FUNCTION__, process->GetID ());
 
-        StreamGDBRemote response;
         response.PutChar ('E');
         response.PutHex8 (GDBRemoteServerError::eErrorExitStatus);
-        return SendPacketNoLock(response.GetData(), response.GetSize());
     }
     else
     {
         if (log)
             log->Printf ("GDBRemoteCommunicationServerLLGS::%s pid %" PRIu64 ", returning exit type %d, return code %d [%s]", __FUNCTION__, process->GetID (), exit_type, return_code, exit_description.c_str ());
 
-        StreamGDBRemote response;
-
         char return_type_code;
         switch (exit_type)
         {
@@ -402,8 +423,6 @@ GDBRemoteCommunicationServerLLGS::SendWResponse (lldb_private::NativeProcessProt
 
         // POSIX exit status limited to unsigned 8 bits.
         response.PutHex8 (return_code);
-
-        return SendPacketNoLock(response.GetData(), response.GetSize());
     }
 }
 
@@ -455,12 +474,23 @@ WriteRegisterValueInHexFixedWidth (StreamString &response,
 
 GDBRemoteCommunication::PacketResult
 GDBRemoteCommunicationServerLLGS::SendStopReplyPacketForThread (lldb::tid_t tid)
+{
+    StreamString response;
+    const uint8_t error = PrepareStopReplyPacketForThread (tid, response);
+    if (error != 0)
+        return SendErrorResponse (error);
+
+    return SendPacketNoLock (response.GetData(), response.GetSize());
+}
+
+uint8_t
+GDBRemoteCommunicationServerLLGS::PrepareStopReplyPacketForThread (lldb::tid_t tid, StreamString &response)
 {
     Log *log (GetLogIfAnyCategoriesSet (LIBLLDB_LOG_PROCESS | LIBLLDB_LOG_THREAD));
 
     // Ensure we have a debugged process.
     if (!m_debugged_process_sp || (m_debugged_process_sp->GetID () == LLDB_INVALID_PROCESS_ID))
-        return SendErrorResponse (50);
+        return 50;
 
     if (log)
         log->Printf ("GDBRemoteCommunicationServerLLGS::%s preparing packet for pid %" PRIu64 " tid %" PRIu64,
@@ -469,13 +499,13 @@ GDBRemoteCommunicationServerLLGS::SendStopReplyPacketForThread (lldb::tid_t tid)
     // Ensure we can get info on the given thread.
     NativeThreadProtocolSP thread_sp (m_debugged_process_sp->GetThreadByID (tid));
     if (!thread_sp)
-        return SendErrorResponse (51);
+        return 51;
 
     // Grab the reason this thread stopped.
     struct ThreadStopInfo tid_stop_info;
     std::string description;
     if (!thread_sp->GetStopReason (tid_stop_info, description))
-        return SendErrorResponse (52);
+        return 52;
 
     // FIXME implement register handling for exec'd inferiors.
     // if (tid_stop_info.reason == eStopReasonExec)
@@ -484,7 +514,6 @@ GDBRemoteCommunicationServerLLGS::SendStopReplyPacketForThread (lldb::tid_t tid)
     //     InitializeRegisters(force);
     // }
 
-    StreamString response;
     // Output the T packet with the thread
     response.PutChar ('T');
     int signum = tid_stop_info.details.signal.signo;
@@ -649,7 +678,7 @@ GDBRemoteCommunicationServerLLGS::SendStopReplyPacketForThread (lldb::tid_t tid)
         }
     }
 
-    return SendPacketNoLock (response.GetData(), response.GetSize());
+    return 0;
 }
 
 void
@@ -664,7 +693,15 @@ GDBRemoteCommunicationServerLLGS::HandleInferiorState_Exited (lldb_private::Nati
     // Send the exit result, and don't flush output.
     // Note: flushing output here would join the inferior stdio reflection thread, which
     // would gunk up the waitpid monitor thread that is calling this.
-    PacketResult result = SendStopReasonForState (StateType::eStateExited, false);
+    PacketResult result;
+    if (m_non_stop)
+    {
+        StreamGDBRemote response;
+        PrepareWResponse (process, response);
+        result = QueueStopNotification (response.GetString ());
+    }
+    else
+        result = SendStopReasonForState (StateType::eStateExited, false);
     if (result != PacketResult::Success)
     {
         if (log)
@@ -722,6 +759,13 @@ GDBRemoteCommunicationServerLLGS::HandleInferiorState_Stopped (lldb_private::Nat
             // Don't send anything per debugserver behavior.
             break;
         default:
+            // In non-stop mode, announce it like any other thread stop.
+            if (m_non_stop)
+            {
+                ThreadStopped (process, process->GetCurrentThreadID ());
+                break;
+            }
+
             // In all other cases, send the stop reason.
             PacketResult result = SendStopReasonForState (StateType::eStateStopped, false);
             if (result != PacketResult::Success)
@@ -777,6 +821,41 @@ GDBRemoteCommunicationServerLLGS::DidExec (NativeProcessProtocol *process)
     ClearProcessSpecificData ();
 }
 
+void
+GDBRemoteCommunicationServerLLGS::ThreadStopped (NativeProcessProtocol *process, lldb::tid_t tid)
+{
+    assert (process && "process cannot be NULL");
+    Log *log (GetLogIfAnyCategoriesSet(LIBLLDB_LOG_PROCESS | LIBLLDB_LOG_THREAD));
+
+    StreamString response;
+    const uint8_t error = PrepareStopReplyPacketForThread (tid, response);
+    if (error != 0)
+    {
+        if (log)
+            log->Printf ("GDBRemoteCommunicationServerLLGS::%s failed to build stop reply for pid %" PRIu64 " tid %" PRIu64 ": error %" PRIu8,
+                         __FUNCTION__, process->GetID (), tid, error);
+        return;
+    }
+
+    if (QueueStopNotification (response.GetString ()) != PacketResult::Success && log)
+        log->Printf ("GDBRemoteCommunicationServerLLGS::%s failed to send stop notification for pid %" PRIu64 " tid %" PRIu64,
+                     __FUNCTION__, process->GetID (), tid);
+}
+
+GDBRemoteCommunication::PacketResult
+GDBRemoteCommunicationServerLLGS::QueueStopNotification (const std::string &stop_reply)
+{
+    Mutex::Locker locker (m_stop_notification_mutex);
+    m_stop_notification_queue.push_back (stop_reply);
+
+    // Only announce a stop when the client isn't already working through
+    // the queue; otherwise its next vStopped picks this one up.
+    if (m_stop_notification_queue.size () > 1)
+        return PacketResult::Success;
+
+    return SendNotificationPacketNoLock ("Stop", stop_reply.data (), stop_reply.size ());
+}
+
 GDBRemoteCommunication::PacketResult
 GDBRemoteCommunicationServerLLGS::SendONotification (const char *buffer, uint32_t len)
 {
@@ -1049,6 +1128,10 @@ GDBRemoteCommunicationServerLLGS::Handle_C (StringExtractorGDBRemote &packet)
         return SendErrorResponse (0x38);
     }
 
+    // In non-stop mode the stop comes later as a notification.
+    if (m_non_stop)
+        return SendOKResponse ();
+
     // Don't send an "OK" packet; response is the stopped/exited message.
     return PacketResult::Success;
 }
@@ -1098,6 +1181,10 @@ GDBRemoteCommunicationServerLLGS::Handle_c (StringExtractorGDBRemote &packet)
     if (log)
         log->Printf ("GDBRemoteCommunicationServerLLGS::%s continued process %" PRIu64, __FUNCTION__, m_debugged_process_sp->GetID ());
 
+    // In non-stop mode the stop comes later as a notification.
+    if (m_non_stop)
+        return SendOKResponse ();
+
     // No response required from continue.
     return PacketResult::Success;
 }
@@ -1106,7 +1193,7 @@ GDBRemoteCommunication::PacketResult
 GDBRemoteCommunicationServerLLGS::Handle_vCont_actions (StringExtractorGDBRemote &packet)
 {
     StreamString response;
-    response.Printf("vCont;c;C;s;S");
+    response.Printf("vCont;c;C;s;S;t");
 
     return SendPacketNoLock(response.GetData(), response.GetSize());
 }
@@ -1134,7 +1221,7 @@ GDBRemoteCommunicationServerLLGS::Handle_vCont (StringExtractorGDBRemote &packet
         packet.SetFilePos (packet.GetFilePos () + 1);
         return Handle_c (packet);
     }
-    else if (::strcmp (packet.Peek (), ";s") == 0)
+    else if (::strcmp (packet.Peek (), ";s") == 0 && !m_non_stop)
     {
         // Move past the ';', then do a simple 's'.
         packet.SetFilePos (packet.GetFilePos () + 1);
@@ -1187,6 +1274,13 @@ GDBRemoteCommunicationServerLLGS::Handle_vCont (StringExtractorGDBRemote &packet
                 thread_action.state = eStateStepping;
                 break;
 
+            case 't':
+                // Stop, which only makes sense while other threads run.
+                if (!m_non_stop)
+                    return SendIllFormedResponse (packet, "vCont t action requires non-stop mode");
+                thread_action.state = eStateStopped;
+                break;
+
             default:
                 return SendIllFormedResponse (packet, "Unsupported vCont action");
                 break;
@@ -1222,10 +1316,78 @@ GDBRemoteCommunicationServerLLGS::Handle_vCont (StringExtractorGDBRemote &packet
     if (log)
         log->Printf ("GDBRemoteCommunicationServerLLGS::%s continued process %" PRIu64, __FUNCTION__, m_debugged_process_sp->GetID ());
 
+    // In non-stop mode the stops come later as notifications.
+    if (m_non_stop)
+        return SendOKResponse ();
+
     // No response required from vCont.
     return PacketResult::Success;
 }
 
+void
+GDBRemoteCommunicationServerLLGS::AppendSupportedFeatures (StreamGDBRemote &response)
+{
+    // Only NativeProcessLinux steps over breakpoints and stops threads on
+    // its own.
+#if defined(__linux__)
+    response.PutCString (";BreakpointStepOver+");
+    response.PutCString (";QNonStop+");
+#endif
+}
+
+GDBRemoteCommunication::PacketResult
+GDBRemoteCommunicationServerLLGS::Handle_QNonStop (StringExtractorGDBRemote &packet)
+{
+    Log *log (GetLogIfAnyCategoriesSet(LIBLLDB_LOG_PROCESS));
+
+    packet.SetFilePos (::strlen ("QNonStop:"));
+    const char mode = packet.GetChar ();
+    if ((mode != '0' && mode != '1') || packet.GetBytesLeft () > 0)
+        return SendIllFormedResponse (packet, "QNonStop expects 0 or 1");
+
+    const bool enabled = (mode == '1');
+    if (m_debugged_process_sp)
+    {
+        Error error = m_debugged_process_sp->SetNonStopMode (enabled);
+        if (error.Fail ())
+        {
+            if (log)
+                log->Printf ("GDBRemoteCommunicationServerLLGS::%s failed to %s non-stop mode for pid %" PRIu64 ": %s",
+                             __FUNCTION__,
+                             enabled ? "enable" : "disable",
+                             m_debugged_process_sp->GetID (),
+                             error.AsCString ());
+            return SendErrorResponse (GDBRemoteServerError::eErrorNonStop);
+        }
+    }
+
+    m_non_stop = enabled;
+    {
+        Mutex::Locker locker (m_stop_notification_mutex);
+        m_stop_notification_queue.clear ();
+    }
+    return SendOKResponse ();
+}
+
+GDBRemoteCommunication::PacketResult
+GDBRemoteCommunicationServerLLGS::Handle_vStopped (StringExtractorGDBRemote &packet)
+{
+    if (!m_non_stop)
+        return SendUnimplementedResponse (packet.GetStringRef().c_str());
+
+    Mutex::Locker locker (m_stop_notification_mutex);
+
+    // The stop at the head of the queue is the one being acknowledged.
+    if (!m_stop_notification_queue.empty ())
+        m_stop_notification_queue.pop_front ();
+
+    if (m_stop_notification_queue.empty ())
+        return SendOKResponse ();
+
+    const std::string &stop_reply = m_stop_notification_queue.front ();
+    return SendPacketNoLock (stop_reply.data (), stop_reply.size ());
+}
+
 void
 GDBRemoteCommunicationServerLLGS::SetCurrentThreadID (lldb::tid_t tid)
 {
@@ -1257,6 +1419,32 @@ GDBRemoteCommunicationServerLLGS::Handle_stop_reason (StringExtractorGDBRemote &
     if (!m_debugged_process_sp)
         return SendErrorResponse (02);
 
+    if (m_non_stop && m_debugged_process_sp->GetState () != eStateExited)
+    {
+        // Start the queue over with every thread that is stopped right now:
+        // the first goes back as the reply, vStopped returns the rest.
+        Mutex::Locker locker (m_stop_notification_mutex);
+        m_stop_notification_queue.clear ();
+
+        uint32_t thread_index = 0;
+        NativeThreadProtocolSP thread_sp;
+        for (thread_sp = m_debugged_process_sp->GetThreadAtIndex (thread_index); thread_sp; ++thread_index, thread_sp = m_debugged_process_sp->GetThreadAtIndex (thread_index))
+        {
+            if (!StateIsStoppedState (thread_sp->GetState (), false))
+                continue;
+
+            StreamString response;
+            if (PrepareStopReplyPacketForThread (thread_sp->GetID (), response) == 0)
+                m_stop_notification_queue.push_back (response.GetString ());
+        }
+
+        if (m_stop_notification_queue.empty ())
+            return SendOKResponse ();
+
+        const std::string &stop_reply = m_stop_notification_queue.front ();
+        return SendPacketNoLock (stop_reply.data (), stop_reply.size ());
+    }
+
     return SendStopReasonForState (m_debugged_process_sp->GetState (), true);
 }
 
@@ -2240,8 +2428,10 @@ GDBRemoteCommunicationServerLLGS::Handle_s (StringExtractorGDBRemote &packet)
     lldb_private::ResumeActionList actions;
     actions.Append (action);
 
-    // All other threads stop while we're single stepping a thread.
-    actions.SetDefaultThreadActionIfNeeded(eStateStopped, 0);
+    // All other threads stop while we're single stepping a thread, unless
+    // in non-stop mode where they are left as they are.
+    if (!m_non_stop)
+        actions.SetDefaultThreadActionIfNeeded(eStateStopped, 0);
     Error error = m_debugged_process_sp->Resume (actions);
     if (error.Fail ())
     {
@@ -2250,6 +2440,10 @@ GDBRemoteCommunicationServerLLGS::Handle_s (StringExtractorGDBRemote &packet)
         return SendErrorResponse(0x49);
     }
 
+    // In non-stop mode the stop comes later as a notification.
+    if (m_non_stop)
+        return SendOKResponse ();
+
     // No response here - the stop or exit will come from the resulting action.
     return PacketResult::Success;
 }
@@ -12,6 +12,8 @@
 
 // C Includes
 // C++ Includes
+#include <deque>
+#include <string>
 #include <unordered_map>
 
 // Other libraries and framework includes
@@ -108,6 +110,9 @@ public:
     void
     DidExec (lldb_private::NativeProcessProtocol *process) override;
 
+    void
+    ThreadStopped (lldb_private::NativeProcessProtocol *process, lldb::tid_t tid) override;
+
 protected:
     lldb::PlatformSP m_platform_sp;
     lldb::thread_t m_async_thread;
@@ -123,6 +128,13 @@ protected:
     std::unordered_map<uint32_t, lldb::DataBufferSP> m_saved_registers_map;
     uint32_t m_next_saved_registers_id;
 
+    // Non-stop mode (QNonStop:1).  Stop replies are queued; the first one
+    // goes out as a %Stop notification and the client drains the rest
+    // with vStopped, which also acknowledges the one at the head.
+    bool m_non_stop;
+    lldb_private::Mutex m_stop_notification_mutex;
+    std::deque<std::string> m_stop_notification_queue;
+
     PacketResult
     SendONotification (const char *buffer, uint32_t len);
 
@@ -132,6 +144,16 @@ protected:
     PacketResult
     SendStopReplyPacketForThread (lldb::tid_t tid);
 
+    // Returns 0 on success, otherwise the error number to reply with.
+    uint8_t
+    PrepareStopReplyPacketForThread (lldb::tid_t tid, lldb_private::StreamString &response);
+
+    void
+    PrepareWResponse (lldb_private::NativeProcessProtocol *process, lldb_private::StreamString &response);
+
+    PacketResult
+    QueueStopNotification (const std::string &stop_reply);
+
     PacketResult
     SendStopReasonForState (lldb::StateType process_state, bool flush_on_exit);
 
@@ -165,6 +187,15 @@ protected:
     PacketResult
     Handle_vCont_actions (StringExtractorGDBRemote &packet);
 
+    PacketResult
+    Handle_QNonStop (StringExtractorGDBRemote &packet);
+
+    void
+    AppendSupportedFeatures (lldb_private::StreamGDBRemote &response) override;
+
+    PacketResult
+    Handle_vStopped (StringExtractorGDBRemote &packet);
+
     PacketResult
     Handle_stop_reason (StringExtractorGDBRemote &packet);
 
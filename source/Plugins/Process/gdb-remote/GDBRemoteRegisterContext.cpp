@@ -149,6 +149,45 @@ GDBRemoteRegisterContext::PrivateSetRegisterValue (uint32_t reg, StringExtractor
     return success;
 }
 
+std::string
+GDBRemoteRegisterContext::MakeReadRegisterPacket (uint32_t reg) const
+{
+    char packet[64];
+    ::snprintf (packet, sizeof(packet), "p%x;thread:%4.4" PRIx64 ";", reg, m_thread.GetProtocolID());
+    return packet;
+}
+
+bool
+GDBRemoteRegisterContext::ReadRegistersPipelined (GDBRemoteCommunicationClient &gdb_comm,
+                                                  const std::vector<uint32_t> &regs)
+{
+    // Without thread suffixes each "p" needs an "Hg" in front of it, and
+    // those can't be interleaved with other requests.
+    if (m_read_all_at_once || !gdb_comm.GetThreadSuffixSupported())
+        return false;
+
+    InvalidateIfNeeded(false);
+
+    std::vector<uint32_t> missing_regs;
+    std::vector<std::string> payloads;
+    for (uint32_t reg : regs)
+    {
+        if (GetRegisterIsValid(reg))
+            continue;
+        missing_regs.push_back(reg);
+        payloads.push_back(MakeReadRegisterPacket(reg));
+    }
+
+    if (!payloads.empty())
+    {
+        std::vector<StringExtractorGDBRemote> responses;
+        gdb_comm.SendPacketsAndWaitForResponses(payloads, responses);
+        for (size_t i = 0; i < responses.size(); ++i)
+            PrivateSetRegisterValue (missing_regs[i], responses[i]);
+    }
+    return true;
+}
+
 // Helper function for GDBRemoteRegisterContext::ReadRegisterBytes().
 bool
 GDBRemoteRegisterContext::GetPrimordialRegister(const lldb_private::RegisterInfo *reg_info,
@@ -192,6 +231,13 @@ GDBRemoteRegisterContext::ReadRegisterBytes (const RegisterInfo *reg_info, DataE
         {
             // Process this composite register request by delegating to the constituent
             // primordial registers.
+
+            // Fetch all the constituents we don't have yet in one batch.
+            std::vector<uint32_t> prim_regs;
+            for (uint32_t idx = 0; reg_info->value_regs[idx] != LLDB_INVALID_REGNUM; ++idx)
+                prim_regs.push_back(reg_info->value_regs[idx]);
+            if (prim_regs.size() > 1)
+                ReadRegistersPipelined (gdb_comm, prim_regs);
             
             // Index of the primordial register.
             bool success = true;
@@ -222,8 +268,36 @@ GDBRemoteRegisterContext::ReadRegisterBytes (const RegisterInfo *reg_info, DataE
         }
         else
         {
+            // Unwinding a frame reads its pc, sp, fp and return address one
+            // after the other, so when one of them is asked for, fetch the
+            // others we don't have yet in the same batch.
+            switch (reg_info->kinds[eRegisterKindGeneric])
+            {
+            case LLDB_REGNUM_GENERIC_PC:
+            case LLDB_REGNUM_GENERIC_SP:
+            case LLDB_REGNUM_GENERIC_FP:
+            case LLDB_REGNUM_GENERIC_RA:
+                {
+                    const uint32_t frame_generic_regs[] = { LLDB_REGNUM_GENERIC_PC, LLDB_REGNUM_GENERIC_SP,
+                                                            LLDB_REGNUM_GENERIC_FP, LLDB_REGNUM_GENERIC_RA };
+                    std::vector<uint32_t> frame_regs;
+                    for (uint32_t generic_reg : frame_generic_regs)
+                    {
+                        const uint32_t frame_reg = ConvertRegisterKindToRegisterNumber (eRegisterKindGeneric, generic_reg);
+                        if (frame_reg != LLDB_INVALID_REGNUM)
+                            frame_regs.push_back(frame_reg);
+                    }
+                    if (frame_regs.size() > 1)
+                        ReadRegistersPipelined (gdb_comm, frame_regs);
+                }
+                break;
+            default:
+                break;
+            }
+
             // Get each register individually
-            GetPrimordialRegister(reg_info, gdb_comm);
+            if (!GetRegisterIsValid(reg))
+                GetPrimordialRegister(reg_info, gdb_comm);
         }
 
         // Make sure we got a valid register value after reading it
@@ -580,6 +654,20 @@ GDBRemoteRegisterContext::ReadAllRegisterValues (lldb::DataBufferSP &data_sp)
                 // data_sp will take ownership of this DataBufferHeap pointer soon.
                 DataBufferSP reg_ctx(new DataBufferHeap(m_reg_info.GetRegisterDataByteSize(), 0));
 
+                // With thread suffixes the "p" packets for all registers we
+                // don't have yet are independent, so send them as one batch.
+                if (thread_suffix_supported)
+                {
+                    std::vector<uint32_t> regs;
+                    for (uint32_t i = 0; (reg_info = GetRegisterInfoAtIndex (i)) != NULL; i++)
+                    {
+                        if (reg_info->value_regs) // skip registers that are slices of real registers
+                            continue;
+                        regs.push_back(reg_info->kinds[eRegisterKindLLDB]);
+                    }
+                    ReadRegistersPipelined (gdb_comm, regs);
+                }
+
                 for (uint32_t i = 0; (reg_info = GetRegisterInfoAtIndex (i)) != NULL; i++)
                 {
                     if (reg_info->value_regs) // skip registers that are slices of real registers
@@ -102,6 +102,7 @@ public:
 
 protected:
     friend class ThreadGDBRemote;
+    friend class ProcessGDBRemote;
 
     bool
     ReadRegisterBytes (const lldb_private::RegisterInfo *reg_info,
@@ -114,6 +115,27 @@ protected:
 
     bool
     PrivateSetRegisterValue (uint32_t reg, StringExtractor &response);
+
+    //------------------------------------------------------------------
+    /// Make the "p" packet, with a thread suffix, that reads register
+    /// \a reg of this thread.
+    //------------------------------------------------------------------
+    std::string
+    MakeReadRegisterPacket (uint32_t reg) const;
+
+    //------------------------------------------------------------------
+    /// Read the registers in \a regs that aren't valid yet with one
+    /// pipelined batch of "p" packets.
+    ///
+    /// @return
+    ///     False if this context reads all registers at once or the
+    ///     server doesn't support thread suffixes, so nothing was read.
+    ///     Registers that are still invalid afterwards are left for
+    ///     ReadRegisterBytes to read one at a time.
+    //------------------------------------------------------------------
+    bool
+    ReadRegistersPipelined (GDBRemoteCommunicationClient &gdb_comm,
+                            const std::vector<uint32_t> &regs);
     
     void
     SetAllRegisterValid (bool b);
@@ -104,13 +104,15 @@ namespace {
     {
         { "packet-timeout" , OptionValue::eTypeUInt64 , true , 1, NULL, NULL, "Specify the default packet timeout in seconds." },
         { "target-definition-file" , OptionValue::eTypeFileSpec , true, 0 , NULL, NULL, "The file that provides the description for remote target registers." },
+        { "compression-min-size" , OptionValue::eTypeUInt64 , true , 384, NULL, NULL, "Ask the remote server to compress packets whose payload is at least this many bytes. Zero disables packet compression." },
         {  NULL            , OptionValue::eTypeInvalid, false, 0, NULL, NULL, NULL  }
     };
     
     enum
     {
         ePropertyPacketTimeout,
-        ePropertyTargetDefinitionFile
+        ePropertyTargetDefinitionFile,
+        ePropertyCompressionMinSize
     };
     
     class PluginProperties : public Properties
@@ -155,6 +157,13 @@ namespace {
             const uint32_t idx = ePropertyTargetDefinitionFile;
             return m_collection_sp->GetPropertyAtIndexAsFileSpec (NULL, idx);
         }
+
+        uint64_t
+        GetCompressionMinSize () const
+        {
+            const uint32_t idx = ePropertyCompressionMinSize;
+            return m_collection_sp->GetPropertyAtIndexAsUInt64(NULL, idx, g_properties[idx].default_uint_value);
+        }
     };
     
     typedef std::shared_ptr<PluginProperties> ProcessKDPPropertiesSP;
@@ -212,6 +221,12 @@ ProcessGDBRemote::GetPluginDescriptionStatic()
     return "GDB Remote protocol based debugging plug-in.";
 }
 
+uint64_t
+ProcessGDBRemote::GetCompressionMinSize()
+{
+    return GetGlobalPluginProperties()->GetCompressionMinSize();
+}
+
 void
 ProcessGDBRemote::Terminate()
 {
@@ -1041,6 +1056,9 @@ ProcessGDBRemote::ConnectToDebugserver (const char *connect_url)
             error.SetErrorString("not connected to remote gdb server");
         return error;
     }
+    const uint64_t compression_min_size = GetCompressionMinSize();
+    if (compression_min_size > 0)
+        m_gdb_comm.EnableCompression (std::min<uint64_t> (compression_min_size, UINT32_MAX));
     m_gdb_comm.GetThreadSuffixSupported ();
     m_gdb_comm.GetListThreadsInStopReplySupported ();
     m_gdb_comm.GetHostInfo ();
@@ -1296,9 +1314,57 @@ ProcessGDBRemote::WillResume ()
     m_continue_C_tids.clear();
     m_continue_s_tids.clear();
     m_continue_S_tids.clear();
+    PrefetchThreadPCs ();
     return Error();
 }
 
+void
+ProcessGDBRemote::PrefetchThreadPCs ()
+{
+    // Thread::SetupForResume reads the pc of every thread that is about to
+    // run, and the stop reply only expedites the registers of the thread
+    // that stopped.  Without this each of the other threads costs a round
+    // trip.
+    if (!m_gdb_comm.GetThreadSuffixSupported())
+        return;
+
+    Mutex::Locker locker (m_thread_list_real.GetMutex());
+    std::vector<lldb::RegisterContextSP> reg_ctxs;
+    std::vector<uint32_t> regs;
+    std::vector<std::string> payloads;
+    const uint32_t num_threads = m_thread_list_real.GetSize (false);
+    for (uint32_t i = 0; i < num_threads; ++i)
+    {
+        ThreadSP thread_sp (m_thread_list_real.GetThreadAtIndex (i, false));
+        if (!thread_sp || thread_sp->GetResumeState() == eStateSuspended)
+            continue;
+        lldb::RegisterContextSP reg_ctx_sp (thread_sp->GetRegisterContext());
+        GDBRemoteRegisterContext *gdb_reg_ctx = static_cast<GDBRemoteRegisterContext *>(reg_ctx_sp.get());
+        if (gdb_reg_ctx == NULL || gdb_reg_ctx->m_read_all_at_once)
+            continue;
+        gdb_reg_ctx->InvalidateIfNeeded (false);
+        const uint32_t pc_reg = gdb_reg_ctx->ConvertRegisterKindToRegisterNumber (eRegisterKindGeneric, LLDB_REGNUM_GENERIC_PC);
+        if (pc_reg == LLDB_INVALID_REGNUM || gdb_reg_ctx->GetRegisterIsValid (pc_reg))
+            continue;
+        reg_ctxs.push_back (reg_ctx_sp);
+        regs.push_back (pc_reg);
+        payloads.push_back (gdb_reg_ctx->MakeReadRegisterPacket (pc_reg));
+    }
+
+    // A single read gains nothing from being batched.
+    if (payloads.size() < 2)
+        return;
+
+    Log *log (ProcessGDBRemoteLog::GetLogIfAllCategoriesSet (GDBR_LOG_THREAD));
+    if (log)
+        log->Printf ("ProcessGDBRemote::%s reading the pc of %" PRIu64 " threads", __FUNCTION__, (uint64_t)payloads.size());
+
+    std::vector<StringExtractorGDBRemote> responses;
+    m_gdb_comm.SendPacketsAndWaitForResponses (payloads, responses);
+    for (size_t i = 0; i < responses.size(); ++i)
+        static_cast<GDBRemoteRegisterContext *>(reg_ctxs[i].get())->PrivateSetRegisterValue (regs[i], responses[i]);
+}
+
 Error
 ProcessGDBRemote::DoResume ()
 {
@@ -2282,61 +2348,111 @@ ProcessGDBRemote::DoReadMemory (addr_t addr, void *buf, size_t size, Error &erro
     GetMaxMemorySize ();
     if (size > m_max_memory_size)
     {
+        // Without acks the chunks are independent requests, so send them
+        // all at once instead of one round trip each.  Reads while the
+        // process runs have to interrupt it, so they stay one at a time.
+        if (!m_gdb_comm.GetSendAcks() && !m_gdb_comm.IsRunning())
+            return DoReadMemoryPipelined (addr, buf, size, error);
+
         // Keep memory read sizes down to a sane limit. This function will be
         // called multiple times in order to complete the task by 
         // lldb_private::Process so it is ok to do this.
         size = m_max_memory_size;
     }
 
-    char packet[64];
-    int packet_len;
-    bool binary_memory_read = m_gdb_comm.GetxPacketSupported();
-    if (binary_memory_read)
+    const std::string packet (MakeReadMemoryPacket (addr, size));
+    StringExtractorGDBRemote response;
+    if (m_gdb_comm.SendPacketAndWaitForResponse(packet.c_str(), packet.size(), response, true) == GDBRemoteCommunication::PacketResult::Success)
+        return GetMemoryFromResponse (packet, addr, buf, size, response, error);
+
+    error.SetErrorStringWithFormat("failed to send packet: '%s'", packet.c_str());
+    return 0;
+}
+
+size_t
+ProcessGDBRemote::DoReadMemoryPipelined (addr_t addr, void *buf, size_t size, Error &error)
+{
+    std::vector<std::string> payloads;
+    for (size_t offset = 0; offset < size; offset += m_max_memory_size)
+        payloads.push_back (MakeReadMemoryPacket (addr + offset, std::min<size_t> (size - offset, m_max_memory_size)));
+
+    std::vector<StringExtractorGDBRemote> responses;
+    m_gdb_comm.SendPacketsAndWaitForResponses (payloads, responses);
+
+    uint8_t *dst = static_cast<uint8_t *>(buf);
+    size_t bytes_read = 0;
+    for (size_t i = 0; i < payloads.size(); ++i)
     {
-        packet_len = ::snprintf (packet, sizeof(packet), "x0x%" PRIx64 ",0x%" PRIx64, (uint64_t)addr, (uint64_t)size);
+        const size_t chunk_size = std::min<size_t> (size - bytes_read, m_max_memory_size);
+        Error chunk_error;
+        size_t chunk_bytes_read = 0;
+        if (i < responses.size())
+            chunk_bytes_read = GetMemoryFromResponse (payloads[i], addr + bytes_read, dst + bytes_read, chunk_size, responses[i], chunk_error);
+        else
+            chunk_error.SetErrorStringWithFormat("failed to send packet: '%s'", payloads[i].c_str());
+        bytes_read += chunk_bytes_read;
+        if (chunk_bytes_read < chunk_size)
+        {
+            // Return what is contiguous so far.  lldb_private::Process asks
+            // again for the rest and gets the error then.
+            if (bytes_read == 0)
+                error = chunk_error;
+            break;
+        }
     }
+    if (bytes_read > 0)
+        error.Clear();
+    return bytes_read;
+}
+
+std::string
+ProcessGDBRemote::MakeReadMemoryPacket (addr_t addr, size_t size)
+{
+    char packet[64];
+    if (m_gdb_comm.GetxPacketSupported())
+        ::snprintf (packet, sizeof(packet), "x0x%" PRIx64 ",0x%" PRIx64, (uint64_t)addr, (uint64_t)size);
     else
+        ::snprintf (packet, sizeof(packet), "m%" PRIx64 ",%" PRIx64, (uint64_t)addr, (uint64_t)size);
+    return packet;
+}
+
+size_t
+ProcessGDBRemote::GetMemoryFromResponse (const std::string &packet,
+                                         addr_t addr,
+                                         void *buf,
+                                         size_t size,
+                                         StringExtractorGDBRemote &response,
+                                         Error &error)
+{
+    if (response.IsNormalResponse())
     {
-        packet_len = ::snprintf (packet, sizeof(packet), "m%" PRIx64 ",%" PRIx64, (uint64_t)addr, (uint64_t)size);
-    }
-    assert (packet_len + 1 < (int)sizeof(packet));
-    StringExtractorGDBRemote response;
-    if (m_gdb_comm.SendPacketAndWaitForResponse(packet, packet_len, response, true) == GDBRemoteCommunication::PacketResult::Success)
-    {
-        if (response.IsNormalResponse())
+        error.Clear();
+        if (packet[0] == 'x')
         {
-            error.Clear();
-            if (binary_memory_read)
-            {
-                // The lower level GDBRemoteCommunication packet receive layer has already de-quoted any
-                // 0x7d character escaping that was present in the packet
+            // The lower level GDBRemoteCommunication packet receive layer has already de-quoted any
+            // 0x7d character escaping that was present in the packet
 
-                size_t data_received_size = response.GetBytesLeft();
-                if (data_received_size > size)
-                {
-                    // Don't write past the end of BUF if the remote debug server gave us too
-                    // much data for some reason.
-                    data_received_size = size;
-                }
-                memcpy (buf, response.GetStringRef().data(), data_received_size);
-                return data_received_size;
-            }
-            else
+            size_t data_received_size = response.GetBytesLeft();
+            if (data_received_size > size)
             {
-                return response.GetHexBytes(buf, size, '\xdd');
+                // Don't write past the end of BUF if the remote debug server gave us too
+                // much data for some reason.
+                data_received_size = size;
             }
+            memcpy (buf, response.GetStringRef().data(), data_received_size);
+            return data_received_size;
         }
-        else if (response.IsErrorResponse())
-            error.SetErrorStringWithFormat("memory read failed for 0x%" PRIx64, addr);
-        else if (response.IsUnsupportedResponse())
-            error.SetErrorStringWithFormat("GDB server does not support reading memory");
         else
-            error.SetErrorStringWithFormat("unexpected response to GDB server memory read packet '%s': '%s'", packet, response.GetStringRef().c_str());
+        {
+            return response.GetHexBytes(buf, size, '\xdd');
+        }
     }
+    else if (response.IsErrorResponse())
+        error.SetErrorStringWithFormat("memory read failed for 0x%" PRIx64, addr);
+    else if (response.IsUnsupportedResponse())
+        error.SetErrorStringWithFormat("GDB server does not support reading memory");
     else
-    {
-        error.SetErrorStringWithFormat("failed to send packet: '%s'", packet);
-    }
+        error.SetErrorStringWithFormat("unexpected response to GDB server memory read packet '%s': '%s'", packet.c_str(), response.GetStringRef().c_str());
     return 0;
 }
 
@@ -2542,6 +2658,7 @@ ProcessGDBRemote::EnableBreakpointSite (BreakpointSite *bp_site)
             // The breakpoint was placed successfully
             bp_site->SetEnabled(true);
             bp_site->SetType(BreakpointSite::eExternal);
+            FlushBreakpointSiteMemory (addr, bp_op_size);
             return error;
         }
 
@@ -2642,6 +2759,8 @@ ProcessGDBRemote::DisableBreakpointSite (BreakpointSite *bp_site)
                 
                 if (m_gdb_comm.SendGDBStoppointTypePacket(stoppoint_type, false, addr, bp_op_size))
                 error.SetErrorToGenericError();
+                if (stoppoint_type == eBreakpointSoftware)
+                    FlushBreakpointSiteMemory (addr, bp_op_size);
             }
             break;
         }
@@ -2660,6 +2779,16 @@ ProcessGDBRemote::DisableBreakpointSite (BreakpointSite *bp_site)
     return error;
 }
 
+bool
+ProcessGDBRemote::StepsOverBreakpointSiteOnResume (BreakpointSite *bp_site)
+{
+    // Only breakpoints the stub inserted itself with a Z0 packet are known
+    // to it; traps we wrote into memory ourselves still need a step-over plan.
+    if (bp_site == NULL || bp_site->GetType() != BreakpointSite::eExternal || bp_site->IsHardware())
+        return false;
+    return m_gdb_comm.GetBreakpointStepOverSupported();
+}
+
 // Pre-requisite: wp != NULL.
 static GDBStoppointType
 GetGDBStoppointType (Watchpoint *wp)
@@ -3438,6 +3567,46 @@ public:
     }
 };
 
+class CommandObjectProcessGDBRemotePacketCompression : public CommandObjectParsed
+{
+private:
+    
+public:
+    CommandObjectProcessGDBRemotePacketCompression(CommandInterpreter &interpreter) :
+    CommandObjectParsed (interpreter,
+                         "process plugin packet compression",
+                         "Dumps statistics about packet compression with the remote server. ",
+                         NULL)
+    {
+    }
+    
+    ~CommandObjectProcessGDBRemotePacketCompression ()
+    {
+    }
+    
+    bool
+    DoExecute (Args& command, CommandReturnObject &result)
+    {
+        const size_t argc = command.GetArgumentCount();
+        if (argc == 0)
+        {
+            ProcessGDBRemote *process = (ProcessGDBRemote *)m_interpreter.GetExecutionContext().GetProcessPtr();
+            if (process)
+            {
+                process->GetGDBRemote().DumpCompressionStatistics(result.GetOutputStream());
+                result.SetStatus (eReturnStatusSuccessFinishResult);
+                return true;
+            }
+        }
+        else
+        {
+            result.AppendErrorWithFormat ("'%s' takes no arguments", m_cmd_name.c_str());
+        }
+        result.SetStatus (eReturnStatusFailed);
+        return false;
+    }
+};
+
 class CommandObjectProcessGDBRemotePacketXferSize : public CommandObjectParsed
 {
 private:
@@ -3608,6 +3777,7 @@ public:
                                 NULL)
     {
         LoadSubCommand ("history", CommandObjectSP (new CommandObjectProcessGDBRemotePacketHistory (interpreter)));
+        LoadSubCommand ("compression", CommandObjectSP (new CommandObjectProcessGDBRemotePacketCompression (interpreter)));
         LoadSubCommand ("send", CommandObjectSP (new CommandObjectProcessGDBRemotePacketSend (interpreter)));
         LoadSubCommand ("monitor", CommandObjectSP (new CommandObjectProcessGDBRemotePacketMonitor (interpreter)));
         LoadSubCommand ("xfer-size", CommandObjectSP (new CommandObjectProcessGDBRemotePacketXferSize (interpreter)));
@@ -62,6 +62,11 @@ public:
     static const char *
     GetPluginDescriptionStatic();
 
+    // The plugin.process.gdb-remote.compression-min-size setting, which
+    // platform connections use as well.
+    static uint64_t
+    GetCompressionMinSize();
+
     //------------------------------------------------------------------
     // Constructors and Destructors
     //------------------------------------------------------------------
@@ -197,6 +202,9 @@ public:
     virtual lldb_private::Error
     DisableBreakpointSite (lldb_private::BreakpointSite *bp_site) override;
 
+    bool
+    StepsOverBreakpointSiteOnResume (lldb_private::BreakpointSite *bp_site) override;
+
     //----------------------------------------------------------------------
     // Process Watchpoints
     //----------------------------------------------------------------------
@@ -313,6 +321,35 @@ protected:
     void
     GetMaxMemorySize();
 
+    //------------------------------------------------------------------
+    /// Read the pc of every thread that is about to run and whose pc we
+    /// don't have yet as one pipelined batch.
+    //------------------------------------------------------------------
+    void
+    PrefetchThreadPCs ();
+
+    //------------------------------------------------------------------
+    /// Read \a size bytes at \a addr with pipelined memory packets of at
+    /// most m_max_memory_size bytes each.
+    //------------------------------------------------------------------
+    size_t
+    DoReadMemoryPipelined (lldb::addr_t addr, void *buf, size_t size, lldb_private::Error &error);
+
+    std::string
+    MakeReadMemoryPacket (lldb::addr_t addr, size_t size);
+
+    //------------------------------------------------------------------
+    /// Copy the bytes in the response to the memory read \a packet into
+    /// \a buf, or describe why there are none in \a error.
+    //------------------------------------------------------------------
+    size_t
+    GetMemoryFromResponse (const std::string &packet,
+                           lldb::addr_t addr,
+                           void *buf,
+                           size_t size,
+                           StringExtractorGDBRemote &response,
+                           lldb_private::Error &error);
+
     //------------------------------------------------------------------
     /// Broadcaster event bits definitions.
     //------------------------------------------------------------------
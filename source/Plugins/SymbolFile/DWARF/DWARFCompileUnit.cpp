@@ -42,6 +42,7 @@ DWARFCompileUnit::DWARFCompileUnit(SymbolFileDWARF* dwarf2Data) :
     m_user_data     (NULL),
     m_die_array     (),
     m_func_aranges_ap (),
+    m_line_sequence_index_ap (),
     m_base_addr     (0),
     m_offset        (DW_INVALID_OFFSET),
     m_length        (0),
@@ -66,6 +67,7 @@ DWARFCompileUnit::Clear()
     m_base_addr     = 0;
     m_die_array.clear();
     m_func_aranges_ap.reset();
+    m_line_sequence_index_ap.reset();
     m_user_data     = NULL;
     m_producer      = eProducerInvalid;
     m_is_dwarf64    = false;
@@ -475,6 +477,23 @@ DWARFCompileUnit::GetFunctionAranges ()
     return *m_func_aranges_ap.get();
 }
 
+const DWARFDebugLine::SequenceIndex &
+DWARFCompileUnit::GetLineSequenceIndex ()
+{
+    if (m_line_sequence_index_ap.get() == NULL)
+    {
+        m_line_sequence_index_ap.reset (new DWARFDebugLine::SequenceIndex());
+        const DWARFDebugInfoEntry* die = GetCompileUnitDIEOnly();
+        if (die)
+        {
+            const dw_offset_t stmt_list = die->GetAttributeValueAsUnsigned(m_dwarf2Data, this, DW_AT_stmt_list, DW_INVALID_OFFSET);
+            if (stmt_list != DW_INVALID_OFFSET)
+                DWARFDebugLine::ParseSequenceIndex (m_dwarf2Data->get_debug_line_data(), stmt_list, *m_line_sequence_index_ap);
+        }
+    }
+    return *m_line_sequence_index_ap.get();
+}
+
 bool
 DWARFCompileUnit::LookupAddress
 (
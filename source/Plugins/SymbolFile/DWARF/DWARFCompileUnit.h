@@ -11,6 +11,7 @@
 #define SymbolFileDWARF_DWARFCompileUnit_h_
 
 #include "DWARFDebugInfoEntry.h"
+#include "DWARFDebugLine.h"
 #include "SymbolFileDWARF.h"
 
 class NameToDIE;
@@ -168,6 +169,9 @@ public:
     const DWARFDebugAranges &
     GetFunctionAranges ();
 
+    const DWARFDebugLine::SequenceIndex &
+    GetLineSequenceIndex ();
+
     SymbolFileDWARF*
     GetSymbolFileDWARF () const
     {
@@ -195,6 +199,7 @@ protected:
     void *              m_user_data;
     DWARFDebugInfoEntry::collection m_die_array;    // The compile unit debug information entry item
     std::unique_ptr<DWARFDebugAranges> m_func_aranges_ap;   // A table similar to the .debug_aranges table, but this one points to the exact DW_TAG_subprogram DIEs
+    std::unique_ptr<DWARFDebugLine::SequenceIndex> m_line_sequence_index_ap; // The address ranges of the sequences in this compile unit's line table
     dw_addr_t           m_base_addr;
     dw_offset_t         m_offset;
     dw_offset_t         m_length;
@@ -579,46 +579,25 @@ DWARFDebugLine::ParseSupportFiles (const lldb::ModuleSP &module_sp,
 }
 
 //----------------------------------------------------------------------
-// ParseStatementTable
+// ParseStatementProgram
 //
-// Parse a single line table (prologue and all rows) and call the
-// callback function once for the prologue (row in state will be zero)
-// and each time a row is to be added to the line table.
+// Run the line table state machine over the opcodes at offset_ptr up to
+// end_offset, calling the state's callback for each row.  If
+// single_sequence is true, stop after the first DW_LNE_end_sequence.
+// A single sequence is decoded with a prologue whose file table is
+// already complete, so DW_LNE_define_file opcodes don't add to it.
 //----------------------------------------------------------------------
-bool
-DWARFDebugLine::ParseStatementTable
+static void
+ParseStatementProgram
 (
     const DWARFDataExtractor& debug_line_data,
     lldb::offset_t* offset_ptr,
-    DWARFDebugLine::State::Callback callback,
-    void* userData
+    dw_offset_t end_offset,
+    DWARFDebugLine::State& state,
+    bool single_sequence
 )
 {
-    Log *log (LogChannelDWARF::GetLogIfAll(DWARF_LOG_DEBUG_LINE));
-    Prologue::shared_ptr prologue(new Prologue());
-
-
-    const dw_offset_t debug_line_offset = *offset_ptr;
-
-    Timer scoped_timer (__PRETTY_FUNCTION__,
-                        "DWARFDebugLine::ParseStatementTable (.debug_line[0x%8.8x])",
-                        debug_line_offset);
-
-    if (!ParsePrologue(debug_line_data, offset_ptr, prologue.get()))
-    {
-        if (log)
-            log->Error ("failed to parse DWARF line table prologue");
-        // Restore our offset and return false to indicate failure!
-        *offset_ptr = debug_line_offset;
-        return false;
-    }
-
-    if (log)
-        prologue->Dump (log);
-
-    const dw_offset_t end_offset = debug_line_offset + prologue->total_length + (debug_line_data.GetDWARFSizeofInitialLength());
-
-    State state(prologue, log, callback, userData);
+    const DWARFDebugLine::Prologue::shared_ptr& prologue = state.prologue;
 
     while (*offset_ptr < end_offset)
     {
@@ -648,6 +627,8 @@ DWARFDebugLine::ParseStatementTable
                 state.end_sequence = true;
                 state.AppendRowToMatrix(*offset_ptr);
                 state.Reset();
+                if (single_sequence)
+                    return;
                 break;
 
             case DW_LNE_set_address:
@@ -684,12 +665,13 @@ DWARFDebugLine::ParseStatementTable
                 // the DW_LNE_define_file instruction. These numbers are used in the
                 // file register of the state machine.
                 {
-                    FileNameEntry fileEntry;
+                    DWARFDebugLine::FileNameEntry fileEntry;
                     fileEntry.name      = debug_line_data.GetCStr(offset_ptr);
                     fileEntry.dir_idx   = debug_line_data.GetULEB128(offset_ptr);
                     fileEntry.mod_time  = debug_line_data.GetULEB128(offset_ptr);
                     fileEntry.length    = debug_line_data.GetULEB128(offset_ptr);
-                    state.prologue->file_names.push_back(fileEntry);
+                    if (!single_sequence)
+                        state.prologue->file_names.push_back(fileEntry);
                 }
                 break;
 
@@ -855,6 +837,52 @@ DWARFDebugLine::ParseStatementTable
         }
     }
 
+}
+
+//----------------------------------------------------------------------
+// ParseStatementTable
+//
+// Parse a single line table (prologue and all rows) and call the
+// callback function once for the prologue (row in state will be zero)
+// and each time a row is to be added to the line table.
+//----------------------------------------------------------------------
+bool
+DWARFDebugLine::ParseStatementTable
+(
+    const DWARFDataExtractor& debug_line_data,
+    lldb::offset_t* offset_ptr,
+    DWARFDebugLine::State::Callback callback,
+    void* userData
+)
+{
+    Log *log (LogChannelDWARF::GetLogIfAll(DWARF_LOG_DEBUG_LINE));
+    Prologue::shared_ptr prologue(new Prologue());
+
+
+    const dw_offset_t debug_line_offset = *offset_ptr;
+
+    Timer scoped_timer (__PRETTY_FUNCTION__,
+                        "DWARFDebugLine::ParseStatementTable (.debug_line[0x%8.8x])",
+                        debug_line_offset);
+
+    if (!ParsePrologue(debug_line_data, offset_ptr, prologue.get()))
+    {
+        if (log)
+            log->Error ("failed to parse DWARF line table prologue");
+        // Restore our offset and return false to indicate failure!
+        *offset_ptr = debug_line_offset;
+        return false;
+    }
+
+    if (log)
+        prologue->Dump (log);
+
+    const dw_offset_t end_offset = debug_line_offset + prologue->total_length + (debug_line_data.GetDWARFSizeofInitialLength());
+
+    State state(prologue, log, callback, userData);
+
+    ParseStatementProgram (debug_line_data, offset_ptr, end_offset, state, false);
+
     state.Finalize( *offset_ptr );
 
     return end_offset;
@@ -897,6 +925,152 @@ DWARFDebugLine::ParseStatementTable(const DWARFDataExtractor& debug_line_data, l
     return ParseStatementTable(debug_line_data, offset_ptr, ParseStatementTableCallback, line_table);
 }
 
+//----------------------------------------------------------------------
+// ParseSequenceIndexCallback
+//----------------------------------------------------------------------
+struct ParseSequenceIndexInfo
+{
+    DWARFDebugLine::SequenceIndex* sequence_index;
+    dw_offset_t sequence_offset;    // The offset of the current sequence's first opcode
+    dw_addr_t sequence_low_pc;      // The address of the current sequence's first row
+    bool in_sequence;
+};
+
+static void
+ParseSequenceIndexCallback(dw_offset_t offset, const DWARFDebugLine::State& state, void* userData)
+{
+    if (state.row == DWARFDebugLine::State::StartParsingLineTable ||
+        state.row == DWARFDebugLine::State::DoneParsingLineTable)
+        return;
+
+    ParseSequenceIndexInfo* info = (ParseSequenceIndexInfo*)userData;
+    if (!info->in_sequence)
+    {
+        info->sequence_low_pc = state.address;
+        info->in_sequence = true;
+    }
+
+    if (state.end_sequence)
+    {
+        DWARFDebugLine::Sequence sequence = { info->sequence_low_pc, state.address, info->sequence_offset };
+        info->sequence_index->sequences.push_back(sequence);
+        // The offset is just past the DW_LNE_end_sequence opcode, which is
+        // where the next sequence starts.
+        info->sequence_offset = offset;
+        info->in_sequence = false;
+    }
+}
+
+//----------------------------------------------------------------------
+// ParseSequenceIndex
+//
+// Find the address range and starting offset of every sequence in the
+// line table at debug_line_offset without producing any rows.
+//----------------------------------------------------------------------
+bool
+DWARFDebugLine::ParseSequenceIndex(const DWARFDataExtractor& debug_line_data, dw_offset_t debug_line_offset, SequenceIndex& sequence_index)
+{
+    Log *log (LogChannelDWARF::GetLogIfAll(DWARF_LOG_DEBUG_LINE));
+    Timer scoped_timer (__PRETTY_FUNCTION__,
+                        "DWARFDebugLine::ParseSequenceIndex (.debug_line[0x%8.8x])",
+                        debug_line_offset);
+
+    Prologue::shared_ptr prologue(new Prologue());
+    lldb::offset_t offset = debug_line_offset;
+    if (!ParsePrologue(debug_line_data, &offset, prologue.get()))
+    {
+        if (log)
+            log->Error ("failed to parse DWARF line table prologue");
+        return false;
+    }
+
+    sequence_index.prologue = prologue;
+    sequence_index.end_offset = debug_line_offset + prologue->total_length + (debug_line_data.GetDWARFSizeofInitialLength());
+    sequence_index.sequences.clear();
+    sequence_index.max_high_pcs.clear();
+
+    ParseSequenceIndexInfo info = { &sequence_index, static_cast<dw_offset_t>(offset), 0, false };
+    // Rows aren't logged, this pass doesn't decode them for anyone.
+    State state(prologue, NULL, ParseSequenceIndexCallback, &info);
+    ParseStatementProgram (debug_line_data, &offset, sequence_index.end_offset, state, false);
+    state.Finalize(offset);
+
+    sequence_index.Finalize();
+    return true;
+}
+
+//----------------------------------------------------------------------
+// ParseStatementSequence
+//
+// Decode the rows of a single sequence found by ParseSequenceIndex and
+// call the callback function for each of them, as ParseStatementTable
+// does for a whole line table.
+//----------------------------------------------------------------------
+bool
+DWARFDebugLine::ParseStatementSequence
+(
+    const DWARFDataExtractor& debug_line_data,
+    const SequenceIndex& sequence_index,
+    const Sequence& sequence,
+    State::Callback callback,
+    void* userData
+)
+{
+    if (!sequence_index.prologue)
+        return false;
+
+    Log *log (LogChannelDWARF::GetLogIfAll(DWARF_LOG_DEBUG_LINE));
+    Prologue::shared_ptr prologue(sequence_index.prologue);
+    lldb::offset_t offset = sequence.offset;
+    State state(prologue, log, callback, userData);
+    ParseStatementProgram (debug_line_data, &offset, sequence_index.end_offset, state, true);
+    state.Finalize(offset);
+    return true;
+}
+
+//----------------------------------------------------------------------
+// DWARFDebugLine::SequenceIndex::Finalize
+//----------------------------------------------------------------------
+void
+DWARFDebugLine::SequenceIndex::Finalize()
+{
+    std::stable_sort(sequences.begin(), sequences.end(), Sequence::LowPCLessThan);
+
+    max_high_pcs.resize(sequences.size());
+    dw_addr_t max_high_pc = 0;
+    for (size_t i = 0; i < sequences.size(); ++i)
+    {
+        if (sequences[i].high_pc > max_high_pc)
+            max_high_pc = sequences[i].high_pc;
+        max_high_pcs[i] = max_high_pc;
+    }
+}
+
+//----------------------------------------------------------------------
+// DWARFDebugLine::SequenceIndex::FindSequenceContainingAddress
+//
+// Sequences can overlap, so the sequence with the closest low_pc at or
+// before the address doesn't necessarily contain it while an earlier
+// one does.  Walk back until none of the remaining sequences reaches
+// the address.
+//----------------------------------------------------------------------
+const DWARFDebugLine::Sequence*
+DWARFDebugLine::SequenceIndex::FindSequenceContainingAddress(dw_addr_t address) const
+{
+    Sequence key = { address, address, DW_INVALID_OFFSET };
+    Sequence::collection::const_iterator begin = sequences.begin();
+    Sequence::collection::const_iterator pos = upper_bound(begin, sequences.end(), key, Sequence::LowPCLessThan);
+    while (pos != begin)
+    {
+        --pos;
+        if (address < pos->high_pc)
+            return &(*pos);
+        if (max_high_pcs[pos - begin] <= address)
+            break;
+    }
+    return NULL;
+}
+
 
 inline bool
 DWARFDebugLine::Prologue::IsValid() const
@@ -155,6 +155,53 @@ public:
         Row::collection rows;
     };
 
+    //------------------------------------------------------------------
+    // Sequence
+    //
+    // The address range of one DW_LNE_end_sequence terminated sequence
+    // of rows, and the .debug_line offset of its first opcode.
+    //------------------------------------------------------------------
+    struct Sequence
+    {
+        typedef std::vector<Sequence> collection;
+
+        dw_addr_t   low_pc;     // The address of the first row of the sequence.
+        dw_addr_t   high_pc;    // The address of the DW_LNE_end_sequence row.
+        dw_offset_t offset;     // The .debug_line offset where decoding of the sequence starts.
+
+        static bool LowPCLessThan(const Sequence& lhs, const Sequence& rhs) { return lhs.low_pc < rhs.low_pc; }
+    };
+
+    //------------------------------------------------------------------
+    // SequenceIndex
+    //
+    // The sequences of one line table, sorted by address.  Built by a
+    // pass over the statement program that doesn't produce any rows, so
+    // a single sequence can be decoded when only the line entry for one
+    // address is needed.
+    //------------------------------------------------------------------
+    struct SequenceIndex
+    {
+        typedef std::shared_ptr<SequenceIndex> shared_ptr;
+
+        SequenceIndex() :
+            prologue(),
+            end_offset(DW_INVALID_OFFSET),
+            sequences(),
+            max_high_pcs()
+        {
+        }
+
+        // Sort the sequences by address once they have all been added.
+        void Finalize();
+        const Sequence* FindSequenceContainingAddress(dw_addr_t address) const;
+
+        Prologue::shared_ptr prologue;  // The prologue, including files added by DW_LNE_define_file.
+        dw_offset_t end_offset;         // The end of the line table's statement program.
+        Sequence::collection sequences;
+        std::vector<dw_addr_t> max_high_pcs; // max_high_pcs[i] is the highest high_pc of sequences[0...i].
+    };
+
     //------------------------------------------------------------------
     // State
     //------------------------------------------------------------------
@@ -200,6 +247,8 @@ public:
     static dw_offset_t DumpStatementTable(lldb_private::Log *log, const lldb_private::DWARFDataExtractor& debug_line_data, const dw_offset_t line_offset);
     static dw_offset_t DumpStatementOpcodes(lldb_private::Log *log, const lldb_private::DWARFDataExtractor& debug_line_data, const dw_offset_t line_offset, uint32_t flags);
     static bool ParseStatementTable(const lldb_private::DWARFDataExtractor& debug_line_data, lldb::offset_t *offset_ptr, LineTable* line_table);
+    static bool ParseSequenceIndex(const lldb_private::DWARFDataExtractor& debug_line_data, dw_offset_t debug_line_offset, SequenceIndex& sequence_index);
+    static bool ParseStatementSequence(const lldb_private::DWARFDataExtractor& debug_line_data, const SequenceIndex& sequence_index, const Sequence& sequence, State::Callback callback, void* userData);
     static void Parse(const lldb_private::DWARFDataExtractor& debug_line_data, DWARFDebugLine::State::Callback callback, void* userData);
 //  static void AppendLineTableData(const DWARFDebugLine::Prologue* prologue, const DWARFDebugLine::Row::collection& state_coll, const uint32_t addr_size, BinaryStreamBuf &debug_line_data);
 
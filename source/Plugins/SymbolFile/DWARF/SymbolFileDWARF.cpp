@@ -504,6 +504,7 @@ SymbolFileDWARF::SymbolFileDWARF(ObjectFile* objfile) :
     m_apple_types_ap (),
     m_apple_namespaces_ap (),
     m_apple_objc_ap (),
+    m_line_sequence_tables (),
     m_function_basename_index(),
     m_function_fullname_index(),
     m_function_method_index(),
@@ -1302,6 +1303,11 @@ SymbolFileDWARF::ParseCompileUnitLineTable (const SymbolContext &sc)
                     else
                     {
                         sc.comp_unit->SetLineTable(line_table_ap.release());
+                        // The whole line table answers address lookups from now
+                        // on, drop any single sequences decoded before.
+                        const dw_offset_t cu_offset = dwarf_cu->GetOffset();
+                        m_line_sequence_tables.erase (m_line_sequence_tables.lower_bound (LineSequenceTableMap::key_type (cu_offset, 0)),
+                                                      m_line_sequence_tables.lower_bound (LineSequenceTableMap::key_type (cu_offset + 1, 0)));
                         return true;
                     }
                 }
@@ -1311,6 +1317,36 @@ SymbolFileDWARF::ParseCompileUnitLineTable (const SymbolContext &sc)
     return false;
 }
 
+//----------------------------------------------------------------------
+// Decode only the line table sequence that contains file_addr.  Used to
+// resolve a single address (e.g. a frame in a backtrace) without parsing
+// the whole line table of its compile unit.
+//----------------------------------------------------------------------
+LineTable *
+SymbolFileDWARF::GetLineTableForSequenceContaining (DWARFCompileUnit* dwarf_cu,
+                                                    CompileUnit *comp_unit,
+                                                    dw_addr_t file_addr)
+{
+    const DWARFDebugLine::SequenceIndex &sequence_index = dwarf_cu->GetLineSequenceIndex();
+    const DWARFDebugLine::Sequence *sequence = sequence_index.FindSequenceContainingAddress (file_addr);
+    if (sequence == NULL)
+        return NULL;
+
+    std::unique_ptr<LineTable> &line_table_ap = m_line_sequence_tables[std::make_pair (dwarf_cu->GetOffset(), sequence->offset)];
+    if (line_table_ap.get() == NULL)
+    {
+        line_table_ap.reset (new LineTable (comp_unit));
+        ParseDWARFLineTableCallbackInfo info;
+        info.line_table = line_table_ap.get();
+        DWARFDebugLine::ParseStatementSequence (get_debug_line_data(),
+                                                sequence_index,
+                                                *sequence,
+                                                ParseDWARFLineTableCallback,
+                                                &info);
+    }
+    return line_table_ap.get();
+}
+
 size_t
 SymbolFileDWARF::ParseFunctionBlocks
 (
@@ -2952,7 +2988,15 @@ SymbolFileDWARF::ResolveSymbolContext (const Address& so_addr, uint32_t resolve_
                         
                         if ((resolve_scope & eSymbolContextLineEntry) || force_check_line_table)
                         {
-                            LineTable *line_table = sc.comp_unit->GetLineTable();
+                            // Unless the whole line table is already around, only
+                            // decode the sequence containing the address.  Line
+                            // tables in .o files need linking, so those are always
+                            // parsed in full.
+                            LineTable *line_table = NULL;
+                            if (m_debug_map_symfile || sc.comp_unit->HasParsedLineTable())
+                                line_table = sc.comp_unit->GetLineTable();
+                            else
+                                line_table = GetLineTableForSequenceContaining (dwarf_cu, sc.comp_unit, file_vm_addr);
                             if (line_table != NULL)
                             {
                                 // And address that makes it into this function should be in terms
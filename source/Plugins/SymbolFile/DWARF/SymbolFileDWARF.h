@@ -554,6 +554,11 @@ protected:
     bool
     FixupAddress (lldb_private::Address &addr);
 
+    lldb_private::LineTable *
+    GetLineTableForSequenceContaining (DWARFCompileUnit* dwarf_cu,
+                                       lldb_private::CompileUnit *comp_unit,
+                                       dw_addr_t file_addr);
+
     typedef std::set<lldb_private::Type *> TypeSet;
 
     void
@@ -597,6 +602,11 @@ protected:
     std::unique_ptr<DWARFMappedHash::MemoryTable> m_apple_namespaces_ap;
     std::unique_ptr<DWARFMappedHash::MemoryTable> m_apple_objc_ap;
     std::unique_ptr<GlobalVariableMap>  m_global_aranges_ap;
+    // Line tables holding a single sequence, keyed by compile unit offset and
+    // .debug_line offset of the sequence.  Used to resolve addresses in compile
+    // units whose full line table hasn't been parsed.
+    typedef std::map<std::pair<dw_offset_t, dw_offset_t>, std::unique_ptr<lldb_private::LineTable> > LineSequenceTableMap;
+    LineSequenceTableMap                m_line_sequence_tables;
     NameToDIE                           m_function_basename_index;  // All concrete functions
     NameToDIE                           m_function_fullname_index;  // All concrete functions
     NameToDIE                           m_function_method_index;    // All inlined functions
@@ -38,6 +38,14 @@ DWARFCallFrameInfo::DWARFCallFrameInfo(ObjectFile& objfile, SectionSP& section_s
     m_cfi_data_initialized (false),
     m_fde_index (),
     m_fde_index_initialized (false),
+    m_fde_index_mutex (Mutex::eMutexTypeRecursive),
+    m_hdr_data (),
+    m_hdr_addr (LLDB_INVALID_ADDRESS),
+    m_hdr_table_offset (0),
+    m_hdr_fde_count (0),
+    m_hdr_table_encoding (DW_EH_PE_omit),
+    m_hdr_field_size (0),
+    m_hdr_initialized (false),
     m_is_eh_frame (is_eh_frame)
 {
 }
@@ -73,14 +81,11 @@ DWARFCallFrameInfo::GetAddressRange (Address addr, AddressRange &range)
     if (module_sp.get() == nullptr || module_sp->GetObjectFile() == nullptr || module_sp->GetObjectFile() != &m_objfile)
         return false;
 
-    if (m_section_sp.get() == nullptr || m_section_sp->IsEncrypted())
-        return false;
-    GetFDEIndex();
-    FDEEntryMap::Entry *fde_entry = m_fde_index.FindEntryThatContains (addr.GetFileAddress());
-    if (!fde_entry)
+    FDEEntryMap::Entry fde_entry;
+    if (!GetFDEEntryByFileAddress (addr.GetFileAddress(), fde_entry))
         return false;
 
-    range = AddressRange(fde_entry->base, fde_entry->size, m_objfile.GetSectionList());
+    range = AddressRange(fde_entry.base, fde_entry.size, m_objfile.GetSectionList());
     return true;
 }
 
@@ -90,6 +95,12 @@ DWARFCallFrameInfo::GetFDEEntryByFileAddress (addr_t file_addr, FDEEntryMap::Ent
     if (m_section_sp.get() == nullptr || m_section_sp->IsEncrypted())
         return false;
 
+    // Scanning a large eh_frame for every FDE is slow, the linker's sorted
+    // table in .eh_frame_hdr lets us go straight to the one we want.  It is
+    // authoritative when present, so don't fall back to the scan on a miss.
+    if (!m_fde_index_initialized && HasEHFrameHeader())
+        return GetFDEEntryFromEHFrameHeader (file_addr, fde_entry);
+
     GetFDEIndex();
 
     if (m_fde_index.IsEmpty())
@@ -126,6 +137,8 @@ DWARFCallFrameInfo::GetFunctionAddressAndSizeVector (FunctionAddressAndSizeVecto
 const DWARFCallFrameInfo::CIE*
 DWARFCallFrameInfo::GetCIE(dw_offset_t cie_offset)
 {
+    Mutex::Locker locker(m_fde_index_mutex);
+
     cie_map_t::iterator pos = m_cie_map.find(cie_offset);
 
     if (pos != m_cie_map.end())
@@ -136,9 +149,194 @@ DWARFCallFrameInfo::GetCIE(dw_offset_t cie_offset)
 
         return pos->second.get();
     }
+
+    // FDEs found through .eh_frame_hdr can refer to CIEs that no scan of
+    // the section has come across yet.
+    if (!m_fde_index_initialized)
+    {
+        if (m_cfi_data_initialized == false)
+            GetCFIData();
+        if (m_cfi_data.ValidOffsetForDataOfSize (cie_offset, CFI_HEADER_SIZE))
+        {
+            CIESP cie_sp = ParseCIE (cie_offset);
+            m_cie_map[cie_offset] = cie_sp;
+            return cie_sp.get();
+        }
+    }
     return nullptr;
 }
 
+bool
+DWARFCallFrameInfo::GetFDEEntryAtOffset (dw_offset_t fde_offset, FDEEntryMap::Entry &fde_entry)
+{
+    if (m_cfi_data_initialized == false)
+        GetCFIData();
+
+    lldb::offset_t offset = fde_offset;
+    if (!m_cfi_data.ValidOffsetForDataOfSize (offset, CFI_HEADER_SIZE))
+        return false;
+
+    dw_offset_t cie_id, cie_offset;
+    uint32_t len = m_cfi_data.GetU32 (&offset);
+    if (len == UINT32_MAX)
+    {
+        len = m_cfi_data.GetU64 (&offset);
+        cie_id = m_cfi_data.GetU64 (&offset);
+        cie_offset = fde_offset + 12 - cie_id;
+    }
+    else
+    {
+        cie_id = m_cfi_data.GetU32 (&offset);
+        cie_offset = fde_offset + 4 - cie_id;
+    }
+
+    // Only eh_frame has a header, so the CIE pointer is relative.
+    if (cie_id == 0 || cie_id == UINT32_MAX || len == 0)
+        return false;
+
+    const CIE *cie = GetCIE (cie_offset);
+    if (cie == nullptr)
+        return false;
+
+    const lldb::addr_t pc_rel_addr = m_section_sp->GetFileAddress();
+    const lldb::addr_t text_addr = LLDB_INVALID_ADDRESS;
+    const lldb::addr_t data_addr = LLDB_INVALID_ADDRESS;
+
+    lldb::addr_t addr = m_cfi_data.GetGNUEHPointer(&offset, cie->ptr_encoding, pc_rel_addr, text_addr, data_addr);
+    lldb::addr_t length = m_cfi_data.GetGNUEHPointer(&offset, cie->ptr_encoding & DW_EH_PE_MASK_ENCODING, pc_rel_addr, text_addr, data_addr);
+    fde_entry = FDEEntryMap::Entry (addr, length, fde_offset);
+    return true;
+}
+
+bool
+DWARFCallFrameInfo::HasEHFrameHeader ()
+{
+    // m_hdr_initialized is only set after the m_hdr_* fields are filled in,
+    // so once it reads true they can be used without the lock.
+    if (!m_hdr_initialized)
+    {
+        Mutex::Locker locker(m_fde_index_mutex);
+        if (!m_hdr_initialized) // if two threads hit the locker
+        {
+            ParseEHFrameHeader ();
+            m_hdr_initialized = true;
+        }
+    }
+    return m_hdr_fde_count > 0;
+}
+
+bool
+DWARFCallFrameInfo::ParseEHFrameHeader ()
+{
+    if (!m_is_eh_frame)
+        return false;
+
+    SectionList *section_list = m_objfile.GetSectionList();
+    if (section_list == nullptr)
+        return false;
+
+    static ConstString g_eh_frame_hdr_name (".eh_frame_hdr");
+    SectionSP hdr_sp (section_list->FindSectionByName (g_eh_frame_hdr_name));
+    if (hdr_sp.get() == nullptr || hdr_sp->IsEncrypted())
+        return false;
+
+    DataExtractor hdr_data;
+    m_objfile.ReadSectionData (hdr_sp.get(), hdr_data);
+
+    // version, eh_frame_ptr_enc, fde_count_enc, table_enc, then the encoded
+    // eh_frame_ptr and fde_count.
+    lldb::offset_t offset = 0;
+    if (!hdr_data.ValidOffsetForDataOfSize (offset, 4))
+        return false;
+    const uint8_t version = hdr_data.GetU8 (&offset);
+    const uint8_t eh_frame_ptr_enc = hdr_data.GetU8 (&offset);
+    const uint8_t fde_count_enc = hdr_data.GetU8 (&offset);
+    const uint8_t table_enc = hdr_data.GetU8 (&offset);
+    if (version != 1 || eh_frame_ptr_enc == DW_EH_PE_omit || fde_count_enc == DW_EH_PE_omit || table_enc == DW_EH_PE_omit)
+        return false;
+
+    // The table can only be searched if its entries have a fixed size.
+    uint8_t field_size = 0;
+    switch (table_enc & DW_EH_PE_MASK_ENCODING)
+    {
+        case DW_EH_PE_absptr:   field_size = hdr_data.GetAddressByteSize(); break;
+        case DW_EH_PE_udata2:
+        case DW_EH_PE_sdata2:   field_size = 2; break;
+        case DW_EH_PE_udata4:
+        case DW_EH_PE_sdata4:   field_size = 4; break;
+        case DW_EH_PE_udata8:
+        case DW_EH_PE_sdata8:   field_size = 8; break;
+        default:
+            return false;
+    }
+    // Only pc and data relative values (both relative to the header here)
+    // and absolute ones can be decoded without a process.
+    switch (table_enc & 0x70)
+    {
+        case DW_EH_PE_absptr:
+        case DW_EH_PE_pcrel:
+        case DW_EH_PE_datarel:
+            break;
+        default:
+            return false;
+    }
+
+    const lldb::addr_t hdr_addr = hdr_sp->GetFileAddress();
+    const lldb::addr_t eh_frame_addr = hdr_data.GetGNUEHPointer (&offset, eh_frame_ptr_enc, hdr_addr, LLDB_INVALID_ADDRESS, hdr_addr);
+    if (eh_frame_addr != m_section_sp->GetFileAddress())
+        return false;
+    const uint64_t fde_count = hdr_data.GetGNUEHPointer (&offset, fde_count_enc, hdr_addr, LLDB_INVALID_ADDRESS, hdr_addr);
+    if (fde_count == 0 || fde_count > UINT32_MAX || !hdr_data.ValidOffsetForDataOfSize (offset, fde_count * 2 * field_size))
+        return false;
+
+    Log *log(GetLogIfAllCategoriesSet (LIBLLDB_LOG_UNWIND));
+    if (log)
+        m_objfile.GetModule()->LogMessage(log, "Using .eh_frame_hdr search table with %" PRIu64 " entries", fde_count);
+
+    m_hdr_data = hdr_data;
+    m_hdr_addr = hdr_addr;
+    m_hdr_table_offset = offset;
+    m_hdr_table_encoding = table_enc;
+    m_hdr_field_size = field_size;
+    m_hdr_fde_count = fde_count;
+    return true;
+}
+
+bool
+DWARFCallFrameInfo::GetFDEEntryFromEHFrameHeader (addr_t file_addr, FDEEntryMap::Entry &fde_entry)
+{
+    const lldb::offset_t entry_size = 2 * m_hdr_field_size;
+
+    // Find the last entry whose initial location is <= file_addr.
+    uint32_t low = 0;
+    uint32_t high = m_hdr_fde_count;
+    while (low < high)
+    {
+        const uint32_t mid = low + (high - low) / 2;
+        lldb::offset_t offset = m_hdr_table_offset + mid * entry_size;
+        const lldb::addr_t initial_loc = m_hdr_data.GetGNUEHPointer (&offset, m_hdr_table_encoding, m_hdr_addr, LLDB_INVALID_ADDRESS, m_hdr_addr);
+        if (initial_loc <= file_addr)
+            low = mid + 1;
+        else
+            high = mid;
+    }
+    if (low == 0)
+        return false;
+
+    lldb::offset_t offset = m_hdr_table_offset + (low - 1) * entry_size + m_hdr_field_size;
+    const lldb::addr_t fde_addr = m_hdr_data.GetGNUEHPointer (&offset, m_hdr_table_encoding, m_hdr_addr, LLDB_INVALID_ADDRESS, m_hdr_addr);
+    const lldb::addr_t eh_frame_addr = m_section_sp->GetFileAddress();
+    if (fde_addr < eh_frame_addr || fde_addr - eh_frame_addr >= m_section_sp->GetFileSize())
+        return false;
+
+    FDEEntryMap::Entry fde;
+    if (!GetFDEEntryAtOffset (fde_addr - eh_frame_addr, fde) || !fde.Contains (file_addr))
+        return false;
+
+    fde_entry = fde;
+    return true;
+}
+
 DWARFCallFrameInfo::CIESP
 DWARFCallFrameInfo::ParseCIE (const dw_offset_t cie_offset)
 {
@@ -316,6 +514,7 @@ DWARFCallFrameInfo::ParseCIE (const dw_offset_t cie_offset)
 void
 DWARFCallFrameInfo::GetCFIData()
 {
+    Mutex::Locker locker(m_fde_index_mutex);
     if (m_cfi_data_initialized == false)
     {
         Log *log(GetLogIfAllCategoriesSet (LIBLLDB_LOG_UNWIND));
@@ -367,7 +566,10 @@ DWARFCallFrameInfo::GetFDEIndex ()
 
         if (cie_id == 0 || cie_id == UINT32_MAX || len == 0)
         {
-            m_cie_map[current_entry] = ParseCIE (current_entry);
+            // A lookup through .eh_frame_hdr may already have parsed this CIE
+            // and handed out a pointer to it, so don't replace it.
+            if (m_cie_map.find (current_entry) == m_cie_map.end())
+                m_cie_map[current_entry] = ParseCIE (current_entry);
             offset = next_entry;
             continue;
         }
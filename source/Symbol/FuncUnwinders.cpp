@@ -76,12 +76,12 @@ FuncUnwinders::GetUnwindPlanAtCallSite (Target &target, int current_offset)
 UnwindPlanSP
 FuncUnwinders::GetCompactUnwindUnwindPlan (Target &target, int current_offset)
 {
+    Mutex::Locker lock (m_mutex);
     if (m_unwind_plan_compact_unwind.size() > 0)
         return m_unwind_plan_compact_unwind[0];    // FIXME support multiple compact unwind plans for one func
     if (m_tried_unwind_plan_compact_unwind)
         return UnwindPlanSP();
 
-    Mutex::Locker lock (m_mutex);
     m_tried_unwind_plan_compact_unwind = true;
     if (m_range.GetBaseAddress().IsValid())
     {
@@ -105,10 +105,10 @@ FuncUnwinders::GetCompactUnwindUnwindPlan (Target &target, int current_offset)
 UnwindPlanSP
 FuncUnwinders::GetEHFrameUnwindPlan (Target &target, int current_offset)
 {
+    Mutex::Locker lock (m_mutex);
     if (m_unwind_plan_eh_frame_sp.get() || m_tried_unwind_plan_eh_frame)
         return m_unwind_plan_eh_frame_sp;
 
-    Mutex::Locker lock (m_mutex);
     m_tried_unwind_plan_eh_frame = true;
     if (m_range.GetBaseAddress().IsValid())
     {
@@ -129,6 +129,7 @@ FuncUnwinders::GetEHFrameUnwindPlan (Target &target, int current_offset)
 UnwindPlanSP
 FuncUnwinders::GetEHFrameAugmentedUnwindPlan (Target &target, Thread &thread, int current_offset)
 {
+    Mutex::Locker lock (m_mutex);
     if (m_unwind_plan_eh_frame_augmented_sp.get() || m_tried_unwind_plan_eh_frame_augmented)
         return m_unwind_plan_eh_frame_augmented_sp;
 
@@ -142,7 +143,6 @@ FuncUnwinders::GetEHFrameAugmentedUnwindPlan (Target &target, Thread &thread, in
             return m_unwind_plan_eh_frame_augmented_sp;
     }
 
-    Mutex::Locker lock (m_mutex);
     m_tried_unwind_plan_eh_frame_augmented = true;
 
     if (m_range.GetBaseAddress().IsValid())
@@ -185,10 +185,10 @@ FuncUnwinders::GetEHFrameAugmentedUnwindPlan (Target &target, Thread &thread, in
 UnwindPlanSP
 FuncUnwinders::GetAssemblyUnwindPlan (Target &target, Thread &thread, int current_offset)
 {
+    Mutex::Locker lock (m_mutex);
     if (m_unwind_plan_assembly_sp.get() || m_tried_unwind_plan_assembly)
         return m_unwind_plan_assembly_sp;
 
-    Mutex::Locker lock (m_mutex);
     m_tried_unwind_plan_assembly = true;
 
     UnwindAssemblySP assembly_profiler_sp (GetUnwindAssemblyProfiler());
@@ -218,10 +218,10 @@ FuncUnwinders::GetUnwindPlanAtNonCallSite (Target& target, Thread& thread, int c
 UnwindPlanSP
 FuncUnwinders::GetUnwindPlanFastUnwind (Thread& thread)
 {
+    Mutex::Locker locker (m_mutex);
     if (m_unwind_plan_fast_sp.get() || m_tried_unwind_fast)
         return m_unwind_plan_fast_sp;
 
-    Mutex::Locker locker (m_mutex);
     m_tried_unwind_fast = true;
 
     UnwindAssemblySP assembly_profiler_sp (GetUnwindAssemblyProfiler());
@@ -239,10 +239,10 @@ FuncUnwinders::GetUnwindPlanFastUnwind (Thread& thread)
 UnwindPlanSP
 FuncUnwinders::GetUnwindPlanArchitectureDefault (Thread& thread)
 {
+    Mutex::Locker locker (m_mutex);
     if (m_unwind_plan_arch_default_sp.get() || m_tried_unwind_arch_default)
         return m_unwind_plan_arch_default_sp;
 
-    Mutex::Locker locker (m_mutex);
     m_tried_unwind_arch_default = true;
 
     Address current_pc;
@@ -266,10 +266,10 @@ FuncUnwinders::GetUnwindPlanArchitectureDefault (Thread& thread)
 UnwindPlanSP
 FuncUnwinders::GetUnwindPlanArchitectureDefaultAtFunctionEntry (Thread& thread)
 {
+    Mutex::Locker locker (m_mutex);
     if (m_unwind_plan_arch_default_at_func_entry_sp.get() || m_tried_unwind_arch_default_at_func_entry)
         return m_unwind_plan_arch_default_at_func_entry_sp;
 
-    Mutex::Locker locker (m_mutex);
     m_tried_unwind_arch_default_at_func_entry = true;
 
     Address current_pc;
@@ -294,10 +294,10 @@ FuncUnwinders::GetUnwindPlanArchitectureDefaultAtFunctionEntry (Thread& thread)
 Address&
 FuncUnwinders::GetFirstNonPrologueInsn (Target& target)
 {
+    Mutex::Locker locker (m_mutex);
     if (m_first_non_prologue_insn.IsValid())
         return m_first_non_prologue_insn;
 
-    Mutex::Locker locker (m_mutex);
     ExecutionContext exe_ctx (target.shared_from_this(), false);
     UnwindAssemblySP assembly_profiler_sp (GetUnwindAssemblyProfiler());
     if (assembly_profiler_sp)
@@ -18,12 +18,79 @@
 using namespace lldb;
 using namespace lldb_private;
 
+static void
+AppendULEB128 (std::vector<uint8_t> &data, uint64_t value)
+{
+    do
+    {
+        uint8_t byte = value & 0x7f;
+        value >>= 7;
+        if (value != 0)
+            byte |= 0x80;
+        data.push_back (byte);
+    } while (value != 0);
+}
+
+static void
+AppendSLEB128 (std::vector<uint8_t> &data, int64_t value)
+{
+    bool more = true;
+    while (more)
+    {
+        uint8_t byte = value & 0x7f;
+        value >>= 7;
+        if ((value == 0 && (byte & 0x40) == 0) || (value == -1 && (byte & 0x40) != 0))
+            more = false;
+        else
+            byte |= 0x80;
+        data.push_back (byte);
+    }
+}
+
+static uint64_t
+DecodeULEB128 (const uint8_t *data, size_t &offset)
+{
+    uint64_t value = 0;
+    unsigned shift = 0;
+    uint8_t byte;
+    do
+    {
+        byte = data[offset++];
+        value |= (uint64_t)(byte & 0x7f) << shift;
+        shift += 7;
+    } while (byte & 0x80);
+    return value;
+}
+
+static int64_t
+DecodeSLEB128 (const uint8_t *data, size_t &offset)
+{
+    int64_t value = 0;
+    unsigned shift = 0;
+    uint8_t byte;
+    do
+    {
+        byte = data[offset++];
+        value |= (uint64_t)(byte & 0x7f) << shift;
+        shift += 7;
+    } while (byte & 0x80);
+    if (shift < 64 && (byte & 0x40))
+        value |= -((uint64_t)1 << shift);
+    return value;
+}
+
 //----------------------------------------------------------------------
 // LineTable constructor
 //----------------------------------------------------------------------
 LineTable::LineTable(CompileUnit* comp_unit) :
     m_comp_unit(comp_unit),
-    m_entries()
+    m_entry_blocks(),
+    m_entry_data(),
+    m_entry_flags(),
+    m_num_entries(0),
+    m_pending_sequences(),
+    m_num_pending_entries(0),
+    m_file_line_index()
 {
 }
 
@@ -50,17 +117,10 @@ LineTable::InsertLineEntry
 {
     Entry entry(file_addr, line, column, file_idx, is_start_of_statement, is_start_of_basic_block, is_prologue_end, is_epilogue_begin, is_terminal_entry);
 
-    entry_collection::iterator begin_pos = m_entries.begin();
-    entry_collection::iterator end_pos = m_entries.end();
-    LineTable::Entry::LessThanBinaryPredicate less_than_bp(this);
-    entry_collection::iterator pos = upper_bound(begin_pos, end_pos, entry, less_than_bp);
-
-//  Stream s(stdout);
-//  s << "\n\nBefore:\n";
-//  Dump (&s, Address::DumpStyleFileAddress);
-    m_entries.insert(pos, entry);
-//  s << "After:\n";
-//  Dump (&s, Address::DumpStyleFileAddress);
+    // A lone entry is merged like a sequence of one entry.
+    m_pending_sequences.push_back (entry_collection (1, entry));
+    ++m_num_pending_entries;
+    m_file_line_index.clear();
 }
 
 LineSequence::LineSequence()
@@ -116,33 +176,155 @@ LineTable::InsertSequence (LineSequence* sequence)
     LineSequenceImpl* seq = reinterpret_cast<LineSequenceImpl*>(sequence);
     if (seq->m_entries.empty())
         return;
-    Entry& entry = seq->m_entries.front();
-    
-    // If the first entry address in this sequence is greater than or equal to
-    // the address of the last item in our entry collection, just append.
-    if (m_entries.empty() || !Entry::EntryAddressLessThan(entry, m_entries.back()))
-    {
-        m_entries.insert(m_entries.end(),
-                         seq->m_entries.begin(),
-                         seq->m_entries.end());
+    m_file_line_index.clear();
+
+    // The sequence is merged into the table by FinalizeEntries(), the next
+    // time the entries are needed.
+    m_num_pending_entries += seq->m_entries.size();
+    m_pending_sequences.push_back (entry_collection());
+    m_pending_sequences.back().swap (seq->m_entries);
+}
+
+void
+LineTable::FinalizeEntries ()
+{
+    if (m_pending_sequences.empty())
         return;
-    }
 
-    // Otherwise, find where this belongs in the collection
-    entry_collection::iterator begin_pos = m_entries.begin();
-    entry_collection::iterator end_pos = m_entries.end();
+    // Sequences are ordered by their first entry, and each one goes after
+    // all the existing entries that don't sort after its first entry.
     LineTable::Entry::LessThanBinaryPredicate less_than_bp(this);
-    entry_collection::iterator pos = upper_bound(begin_pos, end_pos, entry, less_than_bp);
+    std::stable_sort (m_pending_sequences.begin(),
+                      m_pending_sequences.end(),
+                      [&less_than_bp] (const entry_collection &lhs, const entry_collection &rhs)
+                      {
+                          return less_than_bp (lhs.front(), rhs.front());
+                      });
+
+    entry_collection entries;
+    entries.reserve (m_num_entries + m_num_pending_entries);
+    EntryReader reader (*this);
+    for (const entry_collection &sequence : m_pending_sequences)
+    {
+        while (reader.IsValid() && !less_than_bp (sequence.front(), reader.GetEntry()))
+        {
+            entries.push_back (reader.GetEntry());
+            reader.Next();
+        }
 #ifdef LLDB_CONFIGURATION_DEBUG
-    // If we aren't inserting at the beginning, the previous entry should
-    // terminate a sequence.
-    if (pos != begin_pos)
+        // If we aren't inserting at the beginning, the previous entry should
+        // terminate a sequence.
+        if (!entries.empty())
+            assert(entries.back().is_terminal_entry);
+#endif
+        entries.insert (entries.end(), sequence.begin(), sequence.end());
+    }
+    for (; reader.IsValid(); reader.Next())
+        entries.push_back (reader.GetEntry());
+
+    m_pending_sequences.clear();
+    m_num_pending_entries = 0;
+    EncodeEntries (entries);
+}
+
+void
+LineTable::EncodeEntries (const entry_collection &entries)
+{
+    m_entry_blocks.clear();
+    m_entry_data.clear();
+    m_entry_flags.clear();
+    m_num_entries = entries.size();
+
+    m_entry_blocks.reserve ((m_num_entries + kEntriesPerBlock - 1) / kEntriesPerBlock);
+    // Most entries take one byte for each of their four fields.
+    m_entry_data.reserve (m_num_entries * 4);
+    // One extra byte so the flags of any entry can be read as two bytes.
+    m_entry_flags.resize ((m_num_entries * kBitsPerEntryFlags) / 8 + 2, 0);
+
+    lldb::addr_t prev_file_addr = 0;
+    uint32_t prev_line = 0;
+    for (uint32_t idx = 0; idx < m_num_entries; ++idx)
     {
-        entry_collection::iterator prev_pos = pos - 1;
-        assert(prev_pos->is_terminal_entry);
+        const Entry &entry = entries[idx];
+        if (idx % kEntriesPerBlock == 0)
+        {
+            EntryBlock block = { entry.file_addr, static_cast<uint32_t>(m_entry_data.size()) };
+            m_entry_blocks.push_back (block);
+            prev_file_addr = entry.file_addr;
+            prev_line = 0;
+        }
+
+        // Sequences from discarded code can overlap, so addresses are
+        // signed deltas too.
+        AppendSLEB128 (m_entry_data, static_cast<int64_t>(entry.file_addr - prev_file_addr));
+        AppendSLEB128 (m_entry_data, static_cast<int64_t>(entry.line) - prev_line);
+        AppendULEB128 (m_entry_data, entry.column);
+        AppendULEB128 (m_entry_data, entry.file_idx);
+        prev_file_addr = entry.file_addr;
+        prev_line = entry.line;
+
+        const uint32_t flags = (entry.is_start_of_statement   ? 1u << 0 : 0) |
+                               (entry.is_start_of_basic_block ? 1u << 1 : 0) |
+                               (entry.is_prologue_end         ? 1u << 2 : 0) |
+                               (entry.is_epilogue_begin       ? 1u << 3 : 0) |
+                               (entry.is_terminal_entry       ? 1u << 4 : 0);
+        const size_t bit = idx * kBitsPerEntryFlags;
+        m_entry_flags[bit / 8] |= flags << (bit % 8);
+        m_entry_flags[bit / 8 + 1] |= flags >> (8 - bit % 8);
+    }
+    m_entry_data.shrink_to_fit();
+}
+
+LineTable::EntryReader::EntryReader (const LineTable &line_table, uint32_t idx) :
+    m_line_table (line_table),
+    m_idx (idx),
+    m_data_offset (0),
+    m_entry ()
+{
+    if (IsValid())
+    {
+        const uint32_t block_idx = idx / kEntriesPerBlock;
+        m_idx = block_idx * kEntriesPerBlock;
+        m_data_offset = m_line_table.m_entry_blocks[block_idx].data_offset;
+        DecodeEntry();
+        while (m_idx < idx)
+            Next();
     }
-#endif
-    m_entries.insert(pos, seq->m_entries.begin(), seq->m_entries.end());
+}
+
+void
+LineTable::EntryReader::Next ()
+{
+    ++m_idx;
+    if (IsValid())
+        DecodeEntry();
+}
+
+void
+LineTable::EntryReader::DecodeEntry ()
+{
+    lldb::addr_t prev_file_addr = m_entry.file_addr;
+    uint32_t prev_line = m_entry.line;
+    if (m_idx % kEntriesPerBlock == 0)
+    {
+        prev_file_addr = m_line_table.m_entry_blocks[m_idx / kEntriesPerBlock].file_addr;
+        prev_line = 0;
+    }
+
+    const uint8_t *data = m_line_table.m_entry_data.data();
+    m_entry.file_addr = prev_file_addr + DecodeSLEB128 (data, m_data_offset);
+    m_entry.line = prev_line + DecodeSLEB128 (data, m_data_offset);
+    m_entry.column = DecodeULEB128 (data, m_data_offset);
+    m_entry.file_idx = DecodeULEB128 (data, m_data_offset);
+
+    const size_t bit = m_idx * kBitsPerEntryFlags;
+    const uint8_t *flag_bytes = &m_line_table.m_entry_flags[bit / 8];
+    const uint32_t flags = (flag_bytes[0] | flag_bytes[1] << 8) >> (bit % 8);
+    m_entry.is_start_of_statement = (flags & (1u << 0)) != 0;
+    m_entry.is_start_of_basic_block = (flags & (1u << 1)) != 0;
+    m_entry.is_prologue_end = (flags & (1u << 2)) != 0;
+    m_entry.is_epilogue_begin = (flags & (1u << 3)) != 0;
+    m_entry.is_terminal_entry = (flags & (1u << 4)) != 0;
 }
 
 //----------------------------------------------------------------------
@@ -175,13 +357,14 @@ LineTable::Entry::LessThanBinaryPredicate::operator() (const LineTable::Entry& a
 uint32_t
 LineTable::GetSize() const
 {
-    return m_entries.size();
+    return m_num_entries + m_num_pending_entries;
 }
 
 bool
 LineTable::GetLineEntryAtIndex(uint32_t idx, LineEntry& line_entry)
 {
-    if (idx < m_entries.size())
+    FinalizeEntries();
+    if (idx < m_num_entries)
     {
         ConvertEntryAtIndexToLineEntry (idx, line_entry);
         return true;
@@ -190,6 +373,26 @@ LineTable::GetLineEntryAtIndex(uint32_t idx, LineEntry& line_entry)
     return false;
 }
 
+uint32_t
+LineTable::FindFirstEntryIndexAtOrAfter (lldb::addr_t file_addr)
+{
+    // Find the last block that starts below the address; the entry can
+    // only be in that block or be the first entry of the next one.
+    entry_block_collection::const_iterator block_pos = std::lower_bound (m_entry_blocks.begin(),
+                                                                         m_entry_blocks.end(),
+                                                                         file_addr,
+                                                                         EntryBlock::FileAddressLessThan);
+    if (block_pos == m_entry_blocks.begin())
+        return 0;
+
+    const uint32_t block_idx = std::distance<entry_block_collection::const_iterator> (m_entry_blocks.begin(), block_pos) - 1;
+    const uint32_t end_idx = std::min<uint32_t> ((block_idx + 1) * kEntriesPerBlock, m_num_entries);
+    EntryReader reader (*this, block_idx * kEntriesPerBlock);
+    while (reader.GetIndex() < end_idx && reader.GetEntry().file_addr < file_addr)
+        reader.Next();
+    return reader.GetIndex();
+}
+
 bool
 LineTable::FindLineEntryByAddress (const Address &so_addr, LineEntry& line_entry, uint32_t *index_ptr)
 {
@@ -200,63 +403,41 @@ LineTable::FindLineEntryByAddress (const Address &so_addr, LineEntry& line_entry
 
     if (so_addr.GetModule().get() == m_comp_unit->GetModule().get())
     {
-        Entry search_entry;
-        search_entry.file_addr = so_addr.GetFileAddress();
-        if (search_entry.file_addr != LLDB_INVALID_ADDRESS)
+        const lldb::addr_t file_addr = so_addr.GetFileAddress();
+        if (file_addr != LLDB_INVALID_ADDRESS)
         {
-            entry_collection::const_iterator begin_pos = m_entries.begin();
-            entry_collection::const_iterator end_pos = m_entries.end();
-            entry_collection::const_iterator pos = lower_bound(begin_pos, end_pos, search_entry, Entry::EntryAddressLessThan);
-            if (pos != end_pos)
+            FinalizeEntries();
+            uint32_t match_idx = FindFirstEntryIndexAtOrAfter (file_addr);
+            if (match_idx < m_num_entries && match_idx > 0)
             {
-                if (pos != begin_pos)
+                EntryReader reader (*this, match_idx);
+                if (reader.GetEntry().file_addr != file_addr)
+                    --match_idx;
+                else if (reader.GetEntry().is_terminal_entry)
                 {
-                    if (pos->file_addr != search_entry.file_addr)
-                        --pos;
-                    else if (pos->file_addr == search_entry.file_addr)
-                    {
-                        // If this is a termination entry, it should't match since
-                        // entries with the "is_terminal_entry" member set to true 
-                        // are termination entries that define the range for the 
-                        // previous entry.
-                        if (pos->is_terminal_entry)
-                        {
-                            // The matching entry is a terminal entry, so we skip
-                            // ahead to the next entry to see if there is another
-                            // entry following this one whose section/offset matches.
-                            ++pos;
-                            if (pos != end_pos)
-                            {
-                                if (pos->file_addr != search_entry.file_addr)
-                                    pos = end_pos;
-                            }
-                        }
-                        
-                        if (pos != end_pos)
-                        {
-                            // While in the same section/offset backup to find the first
-                            // line entry that matches the address in case there are 
-                            // multiple
-                            while (pos != begin_pos)
-                            {
-                                entry_collection::const_iterator prev_pos = pos - 1;
-                                if (prev_pos->file_addr == search_entry.file_addr &&
-                                    prev_pos->is_terminal_entry == false)
-                                    --pos;
-                                else
-                                    break;
-                            }
-                        }
-                    }
-
+                    // If this is a termination entry, it should't match since
+                    // entries with the "is_terminal_entry" member set to true
+                    // are termination entries that define the range for the
+                    // previous entry.  Skip ahead to the next entry to see if
+                    // there is another entry following this one whose
+                    // section/offset matches.
+                    ++match_idx;
+                    reader.Next();
+                    if (reader.IsValid() && reader.GetEntry().file_addr != file_addr)
+                        match_idx = m_num_entries;
                 }
-                
-                // Make sure we have a valid match and that the match isn't a terminating
-                // entry for a previous line...
-                if (pos != end_pos && pos->is_terminal_entry == false)
+            }
+
+            // Make sure we have a valid match and that the match isn't a terminating
+            // entry for a previous line...
+            if (match_idx < m_num_entries)
+            {
+                EntryReader reader (*this, match_idx);
+                const Entry entry = reader.GetEntry();
+                if (entry.is_terminal_entry == false)
                 {
-                    uint32_t match_idx = std::distance (begin_pos, pos);
-                    success = ConvertEntryAtIndexToLineEntry(match_idx, line_entry);
+                    reader.Next();
+                    success = ConvertEntryToLineEntry (entry, reader.IsValid() ? &reader.GetEntry() : nullptr, line_entry);
                     if (index_ptr != nullptr && success)
                         *index_ptr = match_idx;
                 }
@@ -270,27 +451,98 @@ LineTable::FindLineEntryByAddress (const Address &so_addr, LineEntry& line_entry
 bool
 LineTable::ConvertEntryAtIndexToLineEntry (uint32_t idx, LineEntry &line_entry)
 {
-    if (idx < m_entries.size())
+    FinalizeEntries();
+    if (idx < m_num_entries)
     {
-        const Entry& entry = m_entries[idx];
-        ModuleSP module_sp (m_comp_unit->GetModule());
-        if (module_sp && module_sp->ResolveFileAddress(entry.file_addr, line_entry.range.GetBaseAddress()))
+        EntryReader reader (*this, idx);
+        const Entry entry = reader.GetEntry();
+        reader.Next();
+        return ConvertEntryToLineEntry (entry, reader.IsValid() ? &reader.GetEntry() : nullptr, line_entry);
+    }
+    return false;
+}
+
+bool
+LineTable::ConvertEntryToLineEntry (const Entry &entry, const Entry *next_entry, LineEntry &line_entry)
+{
+    ModuleSP module_sp (m_comp_unit->GetModule());
+    if (module_sp && module_sp->ResolveFileAddress(entry.file_addr, line_entry.range.GetBaseAddress()))
+    {
+        if (!entry.is_terminal_entry && next_entry != nullptr)
+            line_entry.range.SetByteSize(next_entry->file_addr - entry.file_addr);
+        else
+            line_entry.range.SetByteSize(0);
+
+        line_entry.file = m_comp_unit->GetSupportFiles().GetFileSpecAtIndex (entry.file_idx);
+        line_entry.line = entry.line;
+        line_entry.column = entry.column;
+        line_entry.is_start_of_statement = entry.is_start_of_statement;
+        line_entry.is_start_of_basic_block = entry.is_start_of_basic_block;
+        line_entry.is_prologue_end = entry.is_prologue_end;
+        line_entry.is_epilogue_begin = entry.is_epilogue_begin;
+        line_entry.is_terminal_entry = entry.is_terminal_entry;
+        return true;
+    }
+    return false;
+}
+
+void
+LineTable::BuildFileLineIndex ()
+{
+    m_file_line_index.clear();
+
+    FinalizeEntries();
+    for (EntryReader reader (*this); reader.IsValid(); reader.Next())
+    {
+        // Skip line table rows that terminate the previous row (is_terminal_entry is non-zero)
+        const Entry &entry = reader.GetEntry();
+        if (entry.is_terminal_entry)
+            continue;
+
+        if (entry.file_idx >= m_file_line_index.size())
+            m_file_line_index.resize (entry.file_idx + 1);
+        LineIndexEntry index_entry = { entry.line, reader.GetIndex() };
+        m_file_line_index[entry.file_idx].push_back (index_entry);
+    }
+
+    for (auto &file_entries : m_file_line_index)
+        std::sort (file_entries.begin(), file_entries.end(), LineIndexEntry::LessThan);
+}
+
+bool
+LineTable::FindInFileLineIndex (uint32_t start_idx,
+                                uint32_t file_idx,
+                                uint32_t line,
+                                bool exact,
+                                LineIndexEntry &match)
+{
+    if (m_file_line_index.empty())
+        BuildFileLineIndex ();
+
+    if (file_idx >= m_file_line_index.size())
+        return false;
+
+    // Exact match always wins.  Otherwise find the closest line > the desired
+    // line.  Within a line, the first entry at or after start_idx wins.
+    // FIXME: Maybe want to find the line closest before and the line closest after and
+    // if they're not in the same function, don't return a match.
+    const std::vector<LineIndexEntry> &file_entries = m_file_line_index[file_idx];
+    LineIndexEntry key = { line, start_idx };
+    auto pos = std::lower_bound (file_entries.begin(), file_entries.end(), key, LineIndexEntry::LessThan);
+    while (pos != file_entries.end())
+    {
+        if (exact && pos->line != line)
+            return false;
+
+        if (pos->entry_idx >= start_idx)
         {
-            if (!entry.is_terminal_entry && idx + 1 < m_entries.size())
-                line_entry.range.SetByteSize(m_entries[idx+1].file_addr - entry.file_addr);
-            else
-                line_entry.range.SetByteSize(0);
-
-            line_entry.file = m_comp_unit->GetSupportFiles().GetFileSpecAtIndex (entry.file_idx);
-            line_entry.line = entry.line;
-            line_entry.column = entry.column;
-            line_entry.is_start_of_statement = entry.is_start_of_statement;
-            line_entry.is_start_of_basic_block = entry.is_start_of_basic_block;
-            line_entry.is_prologue_end = entry.is_prologue_end;
-            line_entry.is_epilogue_begin = entry.is_epilogue_begin;
-            line_entry.is_terminal_entry = entry.is_terminal_entry;
+            match = *pos;
             return true;
         }
+
+        // All entries for this line come before start_idx, try the next line.
+        key.line = pos->line;
+        pos = std::lower_bound (pos, file_entries.end(), key, LineIndexEntry::LessThan);
     }
     return false;
 }
@@ -305,50 +557,26 @@ LineTable::FindLineEntryIndexByFileIndex
     LineEntry* line_entry_ptr
 )
 {
-
-    const size_t count = m_entries.size();
-    std::vector<uint32_t>::const_iterator begin_pos = file_indexes.begin();
-    std::vector<uint32_t>::const_iterator end_pos = file_indexes.end();
-    size_t best_match = UINT32_MAX;
-
-    for (size_t idx = start_idx; idx < count; ++idx)
+    // Take the best match across all the files: an exact line match over
+    // a later line, and the earliest entry among equally good matches.
+    bool found = false;
+    LineIndexEntry best_match = { UINT32_MAX, UINT32_MAX };
+    for (uint32_t file_idx : file_indexes)
     {
-        // Skip line table rows that terminate the previous row (is_terminal_entry is non-zero)
-        if (m_entries[idx].is_terminal_entry)
-            continue;
-
-        if (find (begin_pos, end_pos, m_entries[idx].file_idx) == end_pos)
-            continue;
-
-        // Exact match always wins.  Otherwise try to find the closest line > the desired
-        // line.
-        // FIXME: Maybe want to find the line closest before and the line closest after and
-        // if they're not in the same function, don't return a match.
-
-        if (m_entries[idx].line < line)
-        {
-            continue;
-        }
-        else if (m_entries[idx].line == line)
+        LineIndexEntry match;
+        if (FindInFileLineIndex (start_idx, file_idx, line, exact, match) &&
+            (!found || LineIndexEntry::LessThan (match, best_match)))
         {
-            if (line_entry_ptr)
-                ConvertEntryAtIndexToLineEntry (idx, *line_entry_ptr);
-            return idx;
-        }
-        else if (!exact)
-        {
-            if (best_match == UINT32_MAX)
-                best_match = idx;
-            else if (m_entries[idx].line < m_entries[best_match].line)
-                best_match = idx;
+            best_match = match;
+            found = true;
         }
     }
 
-    if (best_match != UINT32_MAX)
+    if (found)
     {
         if (line_entry_ptr)
-            ConvertEntryAtIndexToLineEntry (best_match, *line_entry_ptr);
-        return best_match;
+            ConvertEntryAtIndexToLineEntry (best_match.entry_idx, *line_entry_ptr);
+        return best_match.entry_idx;
     }
     return UINT32_MAX;
 }
@@ -356,47 +584,12 @@ LineTable::FindLineEntryIndexByFileIndex
 uint32_t
 LineTable::FindLineEntryIndexByFileIndex (uint32_t start_idx, uint32_t file_idx, uint32_t line, bool exact, LineEntry* line_entry_ptr)
 {
-    const size_t count = m_entries.size();
-    size_t best_match = UINT32_MAX;
-
-    for (size_t idx = start_idx; idx < count; ++idx)
-    {
-        // Skip line table rows that terminate the previous row (is_terminal_entry is non-zero)
-        if (m_entries[idx].is_terminal_entry)
-            continue;
-
-        if (m_entries[idx].file_idx != file_idx)
-            continue;
-
-        // Exact match always wins.  Otherwise try to find the closest line > the desired
-        // line.
-        // FIXME: Maybe want to find the line closest before and the line closest after and
-        // if they're not in the same function, don't return a match.
-
-        if (m_entries[idx].line < line)
-        {
-            continue;
-        }
-        else if (m_entries[idx].line == line)
-        {
-            if (line_entry_ptr)
-                ConvertEntryAtIndexToLineEntry (idx, *line_entry_ptr);
-            return idx;
-        }
-        else if (!exact)
-        {
-            if (best_match == UINT32_MAX)
-                best_match = idx;
-            else if (m_entries[idx].line < m_entries[best_match].line)
-                best_match = idx;
-        }
-    }
-
-    if (best_match != UINT32_MAX)
+    LineIndexEntry match;
+    if (FindInFileLineIndex (start_idx, file_idx, line, exact, match))
     {
         if (line_entry_ptr)
-            ConvertEntryAtIndexToLineEntry (best_match, *line_entry_ptr);
-        return best_match;
+            ConvertEntryAtIndexToLineEntry (match.entry_idx, *line_entry_ptr);
+        return match.entry_idx;
     }
     return UINT32_MAX;
 }
@@ -411,20 +604,23 @@ LineTable::FineLineEntriesForFileIndex (uint32_t file_idx,
         sc_list.Clear();
 
     size_t num_added = 0;
-    const size_t count = m_entries.size();
-    if (count > 0)
+    FinalizeEntries();
+    if (m_num_entries > 0)
     {
         SymbolContext sc (m_comp_unit);
 
-        for (size_t idx = 0; idx < count; ++idx)
+        for (EntryReader reader (*this); reader.IsValid(); )
         {
+            const Entry entry = reader.GetEntry();
+            reader.Next();
+
             // Skip line table rows that terminate the previous row (is_terminal_entry is non-zero)
-            if (m_entries[idx].is_terminal_entry)
+            if (entry.is_terminal_entry)
                 continue;
             
-            if (m_entries[idx].file_idx == file_idx)
+            if (entry.file_idx == file_idx)
             {
-                if (ConvertEntryAtIndexToLineEntry (idx, sc.line_entry))
+                if (ConvertEntryToLineEntry (entry, reader.IsValid() ? &reader.GetEntry() : nullptr, sc.line_entry))
                 {
                     ++num_added;
                     sc_list.Append(sc);
@@ -439,12 +635,14 @@ LineTable::FineLineEntriesForFileIndex (uint32_t file_idx,
 void
 LineTable::Dump (Stream *s, Target *target, Address::DumpStyle style, Address::DumpStyle fallback_style, bool show_line_ranges)
 {
-    const size_t count = m_entries.size();
+    FinalizeEntries();
     LineEntry line_entry;
     FileSpec prev_file;
-    for (size_t idx = 0; idx < count; ++idx)
+    for (EntryReader reader (*this); reader.IsValid(); )
     {
-        ConvertEntryAtIndexToLineEntry (idx, line_entry);
+        const Entry entry = reader.GetEntry();
+        reader.Next();
+        ConvertEntryToLineEntry (entry, reader.IsValid() ? &reader.GetEntry() : nullptr, line_entry);
         line_entry.Dump (s, target, prev_file != line_entry.file, style, fallback_style, show_line_ranges);
         s->EOL();
         prev_file = line_entry.file;
@@ -455,11 +653,13 @@ LineTable::Dump (Stream *s, Target *target, Address::DumpStyle style, Address::D
 void
 LineTable::GetDescription (Stream *s, Target *target, DescriptionLevel level)
 {
-    const size_t count = m_entries.size();
+    FinalizeEntries();
     LineEntry line_entry;
-    for (size_t idx = 0; idx < count; ++idx)
+    for (EntryReader reader (*this); reader.IsValid(); )
     {
-        ConvertEntryAtIndexToLineEntry (idx, line_entry);
+        const Entry entry = reader.GetEntry();
+        reader.Next();
+        ConvertEntryToLineEntry (entry, reader.IsValid() ? &reader.GetEntry() : nullptr, line_entry);
         line_entry.GetDescription (s, level, m_comp_unit, target, true);
         s->EOL();
     }
@@ -472,12 +672,11 @@ LineTable::GetContiguousFileAddressRanges (FileAddressRanges &file_ranges, bool
         file_ranges.Clear();
     const size_t initial_count = file_ranges.GetSize();
     
-    const size_t count = m_entries.size();
-    LineEntry line_entry;
+    FinalizeEntries();
     FileAddressRanges::Entry range (LLDB_INVALID_ADDRESS, 0);
-    for (size_t idx = 0; idx < count; ++idx)
+    for (EntryReader reader (*this); reader.IsValid(); reader.Next())
     {
-        const Entry& entry = m_entries[idx];
+        const Entry& entry = reader.GetEntry();
 
         if (entry.is_terminal_entry)
         {
@@ -501,16 +700,15 @@ LineTable::LinkLineTable (const FileRangeMap &file_range_map)
 {
     std::unique_ptr<LineTable> line_table_ap (new LineTable (m_comp_unit));
     LineSequenceImpl sequence;
-    const size_t count = m_entries.size();
-    LineEntry line_entry;
+    FinalizeEntries();
     const FileRangeMap::Entry *file_range_entry = nullptr;
     const FileRangeMap::Entry *prev_file_range_entry = nullptr;
     lldb::addr_t prev_file_addr = LLDB_INVALID_ADDRESS;
     bool prev_entry_was_linked = false;
     bool range_changed = false;
-    for (size_t idx = 0; idx < count; ++idx)
+    for (EntryReader reader (*this); reader.IsValid(); reader.Next())
     {
-        const Entry& entry = m_entries[idx];
+        const Entry& entry = reader.GetEntry();
         
         const bool end_sequence = entry.is_terminal_entry;
         const lldb::addr_t lookup_file_addr = entry.file_addr - (end_sequence ? 1 : 0);
@@ -586,7 +784,7 @@ LineTable::LinkLineTable (const FileRangeMap &file_range_map)
         prev_file_addr = entry.file_addr;
         range_changed = false;
     }
-    if (line_table_ap->m_entries.empty())
+    if (line_table_ap->GetSize() == 0)
         return nullptr;
     return line_table_ap.release();
 }
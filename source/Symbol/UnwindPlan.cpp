@@ -9,6 +9,8 @@
 
 #include "lldb/Symbol/UnwindPlan.h"
 
+#include <algorithm>
+
 #include "lldb/Core/ConstString.h"
 #include "lldb/Core/Log.h"
 #include "lldb/Target/Process.h"
@@ -217,13 +219,37 @@ UnwindPlan::Row::Row() :
 {
 }
 
+static bool
+RegisterNumberLessThan (const std::pair<uint32_t, UnwindPlan::Row::RegisterLocation> &entry, uint32_t reg_num)
+{
+    return entry.first < reg_num;
+}
+
+UnwindPlan::Row::RegisterLocation *
+UnwindPlan::Row::FindRegisterLocation (uint32_t reg_num)
+{
+    collection::iterator pos = std::lower_bound (m_register_locations.begin(), m_register_locations.end(), reg_num, RegisterNumberLessThan);
+    if (pos != m_register_locations.end() && pos->first == reg_num)
+        return &pos->second;
+    return nullptr;
+}
+
+const UnwindPlan::Row::RegisterLocation *
+UnwindPlan::Row::FindRegisterLocation (uint32_t reg_num) const
+{
+    collection::const_iterator pos = std::lower_bound (m_register_locations.begin(), m_register_locations.end(), reg_num, RegisterNumberLessThan);
+    if (pos != m_register_locations.end() && pos->first == reg_num)
+        return &pos->second;
+    return nullptr;
+}
+
 bool
 UnwindPlan::Row::GetRegisterInfo (uint32_t reg_num, UnwindPlan::Row::RegisterLocation& register_location) const
 {
-    collection::const_iterator pos = m_register_locations.find(reg_num);
-    if (pos != m_register_locations.end())
+    const RegisterLocation *reg_loc = FindRegisterLocation (reg_num);
+    if (reg_loc)
     {
-        register_location = pos->second;
+        register_location = *reg_loc;
         return true;
     }
     return false;
@@ -232,8 +258,8 @@ UnwindPlan::Row::GetRegisterInfo (uint32_t reg_num, UnwindPlan::Row::RegisterLoc
 void
 UnwindPlan::Row::RemoveRegisterInfo (uint32_t reg_num)
 {
-    collection::const_iterator pos = m_register_locations.find(reg_num);
-    if (pos != m_register_locations.end())
+    collection::iterator pos = std::lower_bound (m_register_locations.begin(), m_register_locations.end(), reg_num, RegisterNumberLessThan);
+    if (pos != m_register_locations.end() && pos->first == reg_num)
     {
         m_register_locations.erase(pos);
     }
@@ -242,58 +268,60 @@ UnwindPlan::Row::RemoveRegisterInfo (uint32_t reg_num)
 void
 UnwindPlan::Row::SetRegisterInfo (uint32_t reg_num, const UnwindPlan::Row::RegisterLocation register_location)
 {
-    m_register_locations[reg_num] = register_location;
+    collection::iterator pos = std::lower_bound (m_register_locations.begin(), m_register_locations.end(), reg_num, RegisterNumberLessThan);
+    if (pos != m_register_locations.end() && pos->first == reg_num)
+        pos->second = register_location;
+    else
+        m_register_locations.insert (pos, RegisterLocationEntry (reg_num, register_location));
 }
 
 bool
 UnwindPlan::Row::SetRegisterLocationToAtCFAPlusOffset (uint32_t reg_num, int32_t offset, bool can_replace)
 {
-    if (!can_replace && m_register_locations.find(reg_num) != m_register_locations.end())
+    if (!can_replace && FindRegisterLocation (reg_num) != nullptr)
         return false;
     RegisterLocation reg_loc;
     reg_loc.SetAtCFAPlusOffset(offset);
-    m_register_locations[reg_num] = reg_loc;
+    SetRegisterInfo (reg_num, reg_loc);
     return true;
 }
 
 bool
 UnwindPlan::Row::SetRegisterLocationToIsCFAPlusOffset (uint32_t reg_num, int32_t offset, bool can_replace)
 {
-    if (!can_replace && m_register_locations.find(reg_num) != m_register_locations.end())
+    if (!can_replace && FindRegisterLocation (reg_num) != nullptr)
         return false;
     RegisterLocation reg_loc;
     reg_loc.SetIsCFAPlusOffset(offset);
-    m_register_locations[reg_num] = reg_loc;
+    SetRegisterInfo (reg_num, reg_loc);
     return true;
 }
 
 bool
 UnwindPlan::Row::SetRegisterLocationToUndefined (uint32_t reg_num, bool can_replace, bool can_replace_only_if_unspecified)
 {
-    collection::iterator pos = m_register_locations.find(reg_num);
-    collection::iterator end = m_register_locations.end();
-    
-    if (pos != end)
+    const RegisterLocation *existing = FindRegisterLocation (reg_num);
+    if (existing)
     {
         if (!can_replace)
             return false;
-        if (can_replace_only_if_unspecified && !pos->second.IsUnspecified())
+        if (can_replace_only_if_unspecified && !existing->IsUnspecified())
             return false;
     }
     RegisterLocation reg_loc;
     reg_loc.SetUndefined();
-    m_register_locations[reg_num] = reg_loc;
+    SetRegisterInfo (reg_num, reg_loc);
     return true;
 }
 
 bool
 UnwindPlan::Row::SetRegisterLocationToUnspecified (uint32_t reg_num, bool can_replace)
 {
-    if (!can_replace && m_register_locations.find(reg_num) != m_register_locations.end())
+    if (!can_replace && FindRegisterLocation (reg_num) != nullptr)
         return false;
     RegisterLocation reg_loc;
     reg_loc.SetUnspecified();
-    m_register_locations[reg_num] = reg_loc;
+    SetRegisterInfo (reg_num, reg_loc);
     return true;
 }
 
@@ -302,22 +330,22 @@ UnwindPlan::Row::SetRegisterLocationToRegister (uint32_t reg_num,
                                                 uint32_t other_reg_num,
                                                 bool can_replace)
 {
-    if (!can_replace && m_register_locations.find(reg_num) != m_register_locations.end())
+    if (!can_replace && FindRegisterLocation (reg_num) != nullptr)
         return false;
     RegisterLocation reg_loc;
     reg_loc.SetInRegister(other_reg_num);
-    m_register_locations[reg_num] = reg_loc;
+    SetRegisterInfo (reg_num, reg_loc);
     return true;
 }
 
 bool
 UnwindPlan::Row::SetRegisterLocationToSame (uint32_t reg_num, bool must_replace)
 {
-    if (must_replace && m_register_locations.find(reg_num) == m_register_locations.end())
+    if (must_replace && FindRegisterLocation (reg_num) == nullptr)
         return false;
     RegisterLocation reg_loc;
     reg_loc.SetSame();
-    m_register_locations[reg_num] = reg_loc;
+    SetRegisterInfo (reg_num, reg_loc);
     return true;
 }
 
@@ -337,16 +365,17 @@ UnwindPlan::AppendRow (const UnwindPlan::RowSP &row_sp)
         m_row_list.back() = row_sp;
 }
 
+static bool
+OffsetLessThanRow (lldb::addr_t offset, const UnwindPlan::RowSP &row_sp)
+{
+    return offset < row_sp->GetOffset();
+}
+
 void
 UnwindPlan::InsertRow (const UnwindPlan::RowSP &row_sp)
 {
-    collection::iterator it = m_row_list.begin();
-    while (it != m_row_list.end()) {
-        RowSP row = *it;
-        if (row->GetOffset() > row_sp->GetOffset())
-            break;
-        it++;
-    }
+    // Rows are kept sorted by offset; equal offsets stay in insertion order.
+    collection::iterator it = std::upper_bound (m_row_list.begin(), m_row_list.end(), row_sp->GetOffset(), OffsetLessThanRow);
     m_row_list.insert(it, row_sp);
 }
 
@@ -360,14 +389,10 @@ UnwindPlan::GetRowForFunctionOffset (int offset) const
             row = m_row_list.back();
         else
         {
-            collection::const_iterator pos, end = m_row_list.end();
-            for (pos = m_row_list.begin(); pos != end; ++pos)
-            {
-                if ((*pos)->GetOffset() <= static_cast<lldb::offset_t>(offset))
-                    row = *pos;
-                else
-                    break;
-            }
+            // The last row that starts at or before offset.
+            collection::const_iterator pos = std::upper_bound (m_row_list.begin(), m_row_list.end(), static_cast<lldb::addr_t>(offset), OffsetLessThanRow);
+            if (pos != m_row_list.begin())
+                row = *(pos - 1);
         }
     }
     return row;
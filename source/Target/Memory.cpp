@@ -11,16 +11,29 @@
 // C Includes
 #include <inttypes.h>
 // C++ Includes
+#include <algorithm>
 // Other libraries and framework includes
 // Project includes
+#include "lldb/Core/Address.h"
 #include "lldb/Core/DataBufferHeap.h"
+#include "lldb/Core/Section.h"
 #include "lldb/Core/State.h"
 #include "lldb/Core/Log.h"
+#include "lldb/Core/Stream.h"
 #include "lldb/Target/Process.h"
+#include "lldb/Target/SectionLoadList.h"
+#include "lldb/Target/Target.h"
 
 using namespace lldb;
 using namespace lldb_private;
 
+// Batched prefetches never read past the page an address lives in, so a
+// string that sits right before an unmapped page doesn't fail the read.
+static const addr_t k_prefetch_page_size = 4096;
+
+// Upper bound on a single coalesced read.
+static const addr_t k_max_prefetch_run_size = 64 * 1024;
+
 //----------------------------------------------------------------------
 // MemoryCache constructor
 //----------------------------------------------------------------------
@@ -29,8 +42,16 @@ MemoryCache::MemoryCache(Process &process) :
     m_cache_line_byte_size (process.GetMemoryCacheLineSize()),
     m_mutex (Mutex::eMutexTypeRecursive),
     m_cache (),
-    m_invalid_ranges ()
+    m_read_only_cache (),
+    m_invalid_ranges (),
+    m_slabs (),
+    m_slab_bytes_used (0),
+    m_free_lines (),
+    m_next_sequential_line_addr (LLDB_INVALID_ADDRESS),
+    m_prefetch_lines (1),
+    m_stats ()
 {
+    InvalidateL1 ();
 }
 
 //----------------------------------------------------------------------
@@ -45,11 +66,46 @@ MemoryCache::Clear(bool clear_invalid_ranges)
 {
     Mutex::Locker locker (m_mutex);
     m_cache.clear();
+    m_read_only_cache.clear();
+    m_free_lines.clear();
+    m_slabs.clear();
+    m_slab_bytes_used = 0;
+    InvalidateL1 ();
+    m_next_sequential_line_addr = LLDB_INVALID_ADDRESS;
+    m_prefetch_lines = 1;
     if (clear_invalid_ranges)
         m_invalid_ranges.Clear();
     m_cache_line_byte_size = m_process.GetMemoryCacheLineSize();
 }
 
+void
+MemoryCache::ClearVolatile ()
+{
+    Mutex::Locker locker (m_mutex);
+    // The slabs are carved up in lines of the old size, so a change to the
+    // line size setting means starting over.
+    if (m_cache_line_byte_size != m_process.GetMemoryCacheLineSize())
+    {
+        Clear ();
+        return;
+    }
+    ReleaseLines (m_cache);
+    // Lines kept from before live reads were forced may be stale by now.
+    if (!m_read_only_cache.empty() && m_process.GetForceLiveMemoryReads())
+        ReleaseLines (m_read_only_cache);
+    InvalidateL1 ();
+    m_next_sequential_line_addr = LLDB_INVALID_ADDRESS;
+    m_prefetch_lines = 1;
+}
+
+void
+MemoryCache::ClearReadOnly ()
+{
+    Mutex::Locker locker (m_mutex);
+    ReleaseLines (m_read_only_cache);
+    InvalidateL1 ();
+}
+
 void
 MemoryCache::Flush (addr_t addr, size_t size)
 {
@@ -57,7 +113,7 @@ MemoryCache::Flush (addr_t addr, size_t size)
         return;
 
     Mutex::Locker locker (m_mutex);
-    if (m_cache.empty())
+    if (m_cache.empty() && m_read_only_cache.empty())
         return;
 
     const uint32_t cache_line_byte_size = m_cache_line_byte_size;
@@ -79,7 +135,17 @@ MemoryCache::Flush (addr_t addr, size_t size)
     {
         BlockMap::iterator pos = m_cache.find (curr_addr);
         if (pos != m_cache.end())
+        {
+            m_free_lines.push_back (pos->second.bytes);
             m_cache.erase(pos);
+        }
+        pos = m_read_only_cache.find (curr_addr);
+        if (pos != m_read_only_cache.end())
+        {
+            m_free_lines.push_back (pos->second.bytes);
+            m_read_only_cache.erase(pos);
+        }
+        InvalidateL1 (curr_addr);
     }
 }
 
@@ -131,93 +197,417 @@ MemoryCache::Read (addr_t addr,
     // it in the cache.
     if (dst && dst_len > m_cache_line_byte_size)
     {
-        return m_process.ReadMemoryFromInferior (addr, dst, dst_len, error);
+        const size_t bytes_read = m_process.ReadMemoryFromInferior (addr, dst, dst_len, error);
+        Mutex::Locker locker (m_mutex);
+        ++m_stats.uncached_reads;
+        ++m_stats.inferior_reads;
+        m_stats.bytes_transferred += bytes_read;
+        return bytes_read;
     }
 
     if (dst && bytes_left > 0)
     {
         const uint32_t cache_line_byte_size = m_cache_line_byte_size;
         uint8_t *dst_buf = (uint8_t *)dst;
-        addr_t curr_addr = addr - (addr % cache_line_byte_size);
-        addr_t cache_offset = addr - curr_addr;
+        addr_t curr_addr = addr;
         Mutex::Locker locker (m_mutex);
         
         while (bytes_left > 0)
         {
-            if (m_invalid_ranges.FindEntryThatContains(curr_addr))
+            const addr_t line_addr = curr_addr - (curr_addr % cache_line_byte_size);
+            if (m_invalid_ranges.FindEntryThatContains(line_addr))
             {
-                error.SetErrorStringWithFormat("memory read failed for 0x%" PRIx64, curr_addr);
+                error.SetErrorStringWithFormat("memory read failed for 0x%" PRIx64, line_addr);
                 return dst_len - bytes_left;
             }
 
-            BlockMap::const_iterator pos = m_cache.find (curr_addr);
-            BlockMap::const_iterator end = m_cache.end ();
-            
-            if (pos != end)
+            const CacheLine *line = FindLine (line_addr);
+            if (line == NULL)
             {
-                size_t curr_read_size = cache_line_byte_size - cache_offset;
-                if (curr_read_size > bytes_left)
-                    curr_read_size = bytes_left;
-                
-                memcpy (dst_buf + dst_len - bytes_left, pos->second->GetBytes() + cache_offset, curr_read_size);
-                
-                bytes_left -= curr_read_size;
-                curr_addr += curr_read_size + cache_offset;
-                cache_offset = 0;
-                
-                if (bytes_left > 0)
-                {
-                    // Get sequential cache page hits
-                    for (++pos; (pos != end) && (bytes_left > 0); ++pos)
-                    {
-                        assert ((curr_addr % cache_line_byte_size) == 0);
-                        
-                        if (pos->first != curr_addr)
-                            break;
-                        
-                        curr_read_size = pos->second->GetByteSize();
-                        if (curr_read_size > bytes_left)
-                            curr_read_size = bytes_left;
-                        
-                        memcpy (dst_buf + dst_len - bytes_left, pos->second->GetBytes(), curr_read_size);
-                        
-                        bytes_left -= curr_read_size;
-                        curr_addr += curr_read_size;
-                        
-                        // We have a cache page that succeeded to read some bytes
-                        // but not an entire page. If this happens, we must cap
-                        // off how much data we are able to read...
-                        if (pos->second->GetByteSize() != cache_line_byte_size)
-                            return dst_len - bytes_left;
-                    }
-                }
-            }
-            
-            // We need to read from the process
-            
-            if (bytes_left > 0)
-            {
-                assert ((curr_addr % cache_line_byte_size) == 0);
-                std::unique_ptr<DataBufferHeap> data_buffer_heap_ap(new DataBufferHeap (cache_line_byte_size, 0));
-                size_t process_bytes_read = m_process.ReadMemoryFromInferior (curr_addr, 
-                                                                              data_buffer_heap_ap->GetBytes(), 
-                                                                              data_buffer_heap_ap->GetByteSize(), 
-                                                                              error);
-                if (process_bytes_read == 0)
+                ++m_stats.misses;
+                line = ReadLines (line_addr, error);
+                if (line == NULL)
                     return dst_len - bytes_left;
-                
-                if (process_bytes_read != cache_line_byte_size)
-                    data_buffer_heap_ap->SetByteSize (process_bytes_read);
-                m_cache[curr_addr] = DataBufferSP (data_buffer_heap_ap.release());
-                // We have read data and put it into the cache, continue through the
-                // loop again to get the data out of the cache...
             }
+
+            const size_t line_offset = curr_addr - line_addr;
+            if (line_offset >= line->byte_size)
+                return dst_len - bytes_left;
+
+            size_t curr_read_size = line->byte_size - line_offset;
+            if (curr_read_size > bytes_left)
+                curr_read_size = bytes_left;
+
+            memcpy (dst_buf + dst_len - bytes_left, line->bytes + line_offset, curr_read_size);
+
+            bytes_left -= curr_read_size;
+            curr_addr += curr_read_size;
+
+            // We have a cache line that succeeded to read some bytes but
+            // not an entire line. If this happens, we must cap off how
+            // much data we are able to read...
+            if (line->byte_size != cache_line_byte_size)
+                return dst_len - bytes_left;
         }
     }
     
     return dst_len - bytes_left;
 }
 
+void
+MemoryCache::Prefetch (addr_t addr, size_t size)
+{
+    if (size == 0)
+        return;
+
+    const addr_t cache_line_byte_size = m_cache_line_byte_size;
+    addr_t end_addr = addr + size;
+    if (end_addr < addr)
+        end_addr = LLDB_INVALID_ADDRESS;
+
+    std::vector<addr_t> line_addrs;
+    for (addr_t line_addr = addr - (addr % cache_line_byte_size);
+         line_addr < end_addr && line_addr + cache_line_byte_size > line_addr;
+         line_addr += cache_line_byte_size)
+        line_addrs.push_back (line_addr);
+
+    Mutex::Locker locker (m_mutex);
+    FillLines (line_addrs);
+}
+
+void
+MemoryCache::Prefetch (const std::vector<addr_t> &addrs, size_t size)
+{
+    if (size == 0)
+        return;
+
+    const addr_t cache_line_byte_size = m_cache_line_byte_size;
+    std::vector<addr_t> line_addrs;
+    for (addr_t addr : addrs)
+    {
+        if (addr == 0 || addr == LLDB_INVALID_ADDRESS)
+            continue;
+        const addr_t page_end_addr = addr - (addr % k_prefetch_page_size) + k_prefetch_page_size;
+        addr_t end_addr = addr + size;
+        if (page_end_addr > addr && end_addr > page_end_addr)
+            end_addr = page_end_addr;
+        if (end_addr < addr)
+            end_addr = LLDB_INVALID_ADDRESS;
+        for (addr_t line_addr = addr - (addr % cache_line_byte_size);
+             line_addr < end_addr && line_addr + cache_line_byte_size > line_addr;
+             line_addr += cache_line_byte_size)
+            line_addrs.push_back (line_addr);
+    }
+    std::sort (line_addrs.begin(), line_addrs.end());
+    line_addrs.erase (std::unique (line_addrs.begin(), line_addrs.end()), line_addrs.end());
+
+    Mutex::Locker locker (m_mutex);
+    FillLines (line_addrs);
+}
+
+MemoryCache::Stats
+MemoryCache::GetStats () const
+{
+    Mutex::Locker locker (m_mutex);
+    return m_stats;
+}
+
+void
+MemoryCache::ResetStats ()
+{
+    Mutex::Locker locker (m_mutex);
+    m_stats = Stats();
+}
+
+void
+MemoryCache::DumpStats (Stream &s) const
+{
+    Mutex::Locker locker (m_mutex);
+    const uint64_t hits = m_stats.l1_hits + m_stats.l2_hits;
+    const uint64_t lookups = hits + m_stats.misses;
+    s.Printf ("Line size:         %u bytes\n", m_cache_line_byte_size);
+    s.Printf ("Cached lines:      %" PRIu64 " (%" PRIu64 " from read-only sections)\n",
+              (uint64_t)(m_cache.size() + m_read_only_cache.size()),
+              (uint64_t)m_read_only_cache.size());
+    s.Printf ("Hits:              %" PRIu64 " (L1 %" PRIu64 ", L2 %" PRIu64 ")\n",
+              hits,
+              m_stats.l1_hits,
+              m_stats.l2_hits);
+    s.Printf ("Misses:            %" PRIu64 "\n", m_stats.misses);
+    if (lookups > 0)
+        s.Printf ("Hit rate:          %.1f%%\n", 100.0 * hits / lookups);
+    s.Printf ("Lines read ahead:  %" PRIu64 "\n", m_stats.prefetched_lines);
+    s.Printf ("Uncached reads:    %" PRIu64 "\n", m_stats.uncached_reads);
+    s.Printf ("Process reads:     %" PRIu64 " (%" PRIu64 " bytes)\n",
+              m_stats.inferior_reads,
+              m_stats.bytes_transferred);
+}
+
+//----------------------------------------------------------------------
+// Look "line_addr" up in the L1 table, then in the line maps. A line
+// found in the maps replaces whatever its L1 slot held before.
+//
+// The caller must hold m_mutex.
+//----------------------------------------------------------------------
+const MemoryCache::CacheLine *
+MemoryCache::FindLine (addr_t line_addr)
+{
+    L1Entry &entry = m_l1[(line_addr / m_cache_line_byte_size) & (k_num_l1_entries - 1)];
+    if (entry.line && entry.line_addr == line_addr)
+    {
+        ++m_stats.l1_hits;
+        return entry.line;
+    }
+
+    const CacheLine *line = NULL;
+    BlockMap::const_iterator pos = m_cache.find (line_addr);
+    if (pos != m_cache.end())
+        line = &pos->second;
+    else
+    {
+        pos = m_read_only_cache.find (line_addr);
+        if (pos != m_read_only_cache.end())
+            line = &pos->second;
+    }
+
+    if (line)
+    {
+        ++m_stats.l2_hits;
+        entry.line_addr = line_addr;
+        entry.line = line;
+    }
+    return line;
+}
+
+bool
+MemoryCache::LineIsCached (addr_t line_addr) const
+{
+    return m_cache.find (line_addr) != m_cache.end() ||
+           m_read_only_cache.find (line_addr) != m_read_only_cache.end();
+}
+
+static bool
+IsInReadOnlySection (const SectionLoadList &section_load_list, addr_t load_addr)
+{
+    Address so_addr;
+    if (!section_load_list.ResolveLoadAddress (load_addr, so_addr))
+        return false;
+
+    SectionSP section_sp (so_addr.GetSection());
+    if (!section_sp)
+        return false;
+
+    const uint32_t permissions = section_sp->GetPermissions();
+    return (permissions & ePermissionsReadable) != 0 && (permissions & ePermissionsWritable) == 0;
+}
+
+//----------------------------------------------------------------------
+// Only complete lines in loaded sections that are mapped readable but
+// not writable can outlive a resume, and only while the user hasn't
+// asked for live reads (self-modifying code). Small sections often share a line
+// with their neighbours, so it's enough for the first and last byte of
+// the line to be read-only: writable segments start on a page boundary
+// and can't sit in the middle of a line whose ends aren't writable.
+//----------------------------------------------------------------------
+bool
+MemoryCache::IsReadOnlyLine (addr_t line_addr)
+{
+    if (m_process.GetForceLiveMemoryReads())
+        return false;
+    const SectionLoadList &section_load_list = m_process.GetTarget().GetSectionLoadList();
+    return IsInReadOnlySection (section_load_list, line_addr) &&
+           IsInReadOnlySection (section_load_list, line_addr + m_cache_line_byte_size - 1);
+}
+
+uint8_t *
+MemoryCache::AllocateLine ()
+{
+    if (!m_free_lines.empty())
+    {
+        uint8_t *bytes = m_free_lines.back();
+        m_free_lines.pop_back();
+        return bytes;
+    }
+
+    const size_t slab_byte_size = k_lines_per_slab * m_cache_line_byte_size;
+    if (m_slabs.empty() || m_slab_bytes_used + m_cache_line_byte_size > slab_byte_size)
+    {
+        m_slabs.emplace_back (new uint8_t[slab_byte_size]);
+        m_slab_bytes_used = 0;
+    }
+    uint8_t *bytes = m_slabs.back().get() + m_slab_bytes_used;
+    m_slab_bytes_used += m_cache_line_byte_size;
+    return bytes;
+}
+
+void
+MemoryCache::ReleaseLines (BlockMap &lines)
+{
+    for (const auto &pos : lines)
+        m_free_lines.push_back (pos.second.bytes);
+    lines.clear();
+}
+
+void
+MemoryCache::InvalidateL1 (addr_t line_addr)
+{
+    L1Entry &entry = m_l1[(line_addr / m_cache_line_byte_size) & (k_num_l1_entries - 1)];
+    if (entry.line_addr == line_addr)
+        entry.line = NULL;
+}
+
+void
+MemoryCache::InvalidateL1 ()
+{
+    for (size_t idx = 0; idx < k_num_l1_entries; ++idx)
+    {
+        m_l1[idx].line_addr = LLDB_INVALID_ADDRESS;
+        m_l1[idx].line = NULL;
+    }
+}
+
+//----------------------------------------------------------------------
+// Copy "byte_size" bytes of a freshly read line into the cache. Short
+// lines always go in the volatile map so the next stop gives them
+// another try.
+//
+// The caller must hold m_mutex.
+//----------------------------------------------------------------------
+const MemoryCache::CacheLine *
+MemoryCache::InsertLine (addr_t line_addr, const uint8_t *bytes, uint32_t byte_size)
+{
+    BlockMap &lines = (byte_size == m_cache_line_byte_size && IsReadOnlyLine (line_addr)) ? m_read_only_cache : m_cache;
+    std::pair<BlockMap::iterator, bool> result = lines.insert (BlockMap::value_type (line_addr, CacheLine()));
+    CacheLine &line = result.first->second;
+    if (result.second)
+    {
+        line.bytes = AllocateLine ();
+        line.byte_size = byte_size;
+        memcpy (line.bytes, bytes, byte_size);
+    }
+    return &line;
+}
+
+size_t
+MemoryCache::ReadFromInferior (addr_t addr, void *dst, size_t dst_len, Error &error)
+{
+    const size_t bytes_read = m_process.ReadMemoryFromInferior (addr, dst, dst_len, error);
+    ++m_stats.inferior_reads;
+    m_stats.bytes_transferred += bytes_read;
+    return bytes_read;
+}
+
+//----------------------------------------------------------------------
+// Read the missing line at "line_addr". A miss on the line right after
+// the lines the previous miss read means we are walking memory in order,
+// so read twice as far ahead as last time; any other miss starts over
+// at a single line. Read-ahead stops at the first line that is already
+// cached or invalid, and if it fails to produce even the first line we
+// fall back to reading just that line so the caller gets the same data
+// and error it would have without read-ahead.
+//
+// The caller must hold m_mutex.
+//----------------------------------------------------------------------
+const MemoryCache::CacheLine *
+MemoryCache::ReadLines (addr_t line_addr, Error &error)
+{
+    const uint32_t cache_line_byte_size = m_cache_line_byte_size;
+
+    if (line_addr == m_next_sequential_line_addr)
+        m_prefetch_lines = std::min<uint32_t> (m_prefetch_lines * 2, k_max_prefetch_lines);
+    else
+        m_prefetch_lines = 1;
+
+    uint32_t num_lines = 1;
+    while (num_lines < m_prefetch_lines)
+    {
+        const addr_t next_line_addr = line_addr + num_lines * cache_line_byte_size;
+        if (next_line_addr < line_addr || LineIsCached (next_line_addr) || m_invalid_ranges.FindEntryThatContains (next_line_addr))
+            break;
+        ++num_lines;
+    }
+
+    if (num_lines > 1)
+    {
+        DataBufferHeap data (num_lines * cache_line_byte_size, 0);
+        Error prefetch_error;
+        const size_t bytes_read = ReadFromInferior (line_addr, data.GetBytes(), data.GetByteSize(), prefetch_error);
+        const size_t lines_read = bytes_read / cache_line_byte_size;
+        if (lines_read > 0)
+        {
+            const CacheLine *first_line = InsertLine (line_addr, data.GetBytes(), cache_line_byte_size);
+            for (size_t idx = 1; idx < lines_read; ++idx)
+                InsertLine (line_addr + idx * cache_line_byte_size,
+                            data.GetBytes() + idx * cache_line_byte_size,
+                            cache_line_byte_size);
+            m_stats.prefetched_lines += lines_read - 1;
+            m_next_sequential_line_addr = line_addr + lines_read * cache_line_byte_size;
+            return first_line;
+        }
+        m_prefetch_lines = 1;
+    }
+
+    DataBufferHeap data (cache_line_byte_size, 0);
+    const size_t bytes_read = ReadFromInferior (line_addr, data.GetBytes(), data.GetByteSize(), error);
+    if (bytes_read == 0)
+        return NULL;
+    m_next_sequential_line_addr = line_addr + cache_line_byte_size;
+    return InsertLine (line_addr, data.GetBytes(), bytes_read);
+}
+
+//----------------------------------------------------------------------
+// Read the missing lines in "line_addrs" (sorted, unique and cache line
+// aligned) into the cache. Runs of missing lines are read in one go as
+// long as each next line either directly follows the run or sits in the
+// same page as its end, so the gap bytes we read along the way are known
+// to be mapped. Only complete lines are cached; whatever a short read
+// left out is read again, and its error reported, by Read ().
+//
+// The caller must hold m_mutex.
+//----------------------------------------------------------------------
+void
+MemoryCache::FillLines (const std::vector<addr_t> &line_addrs)
+{
+    const addr_t cache_line_byte_size = m_cache_line_byte_size;
+    const size_t num_lines = line_addrs.size();
+    size_t idx = 0;
+    while (idx < num_lines)
+    {
+        const addr_t run_start = line_addrs[idx++];
+        if (LineIsCached (run_start) || m_invalid_ranges.FindEntryThatContains (run_start))
+            continue;
+
+        addr_t run_end = run_start + cache_line_byte_size;
+        while (idx < num_lines)
+        {
+            const addr_t next_line_addr = line_addrs[idx];
+            if (LineIsCached (next_line_addr) || m_invalid_ranges.FindEntryThatContains (next_line_addr))
+                break;
+            if (next_line_addr != run_end &&
+                (next_line_addr / k_prefetch_page_size) != ((run_end - 1) / k_prefetch_page_size))
+                break;
+            if (next_line_addr + cache_line_byte_size - run_start > k_max_prefetch_run_size)
+                break;
+            run_end = next_line_addr + cache_line_byte_size;
+            ++idx;
+        }
+
+        DataBufferHeap run_data (run_end - run_start, 0);
+        Error error;
+        const size_t bytes_read = ReadFromInferior (run_start,
+                                                    run_data.GetBytes(),
+                                                    run_data.GetByteSize(),
+                                                    error);
+        for (size_t offset = 0; offset + cache_line_byte_size <= bytes_read; offset += cache_line_byte_size)
+        {
+            if (!LineIsCached (run_start + offset))
+            {
+                InsertLine (run_start + offset, run_data.GetBytes() + offset, cache_line_byte_size);
+                ++m_stats.prefetched_lines;
+            }
+        }
+    }
+}
 
 
 AllocatedBlock::AllocatedBlock (lldb::addr_t addr, 
@@ -17,6 +17,7 @@
 #include "lldb/Core/Log.h"
 #include "lldb/Core/Module.h"
 #include "lldb/Core/PluginManager.h"
+#include "lldb/Core/Section.h"
 #include "lldb/Core/State.h"
 #include "lldb/Core/StreamFile.h"
 #include "lldb/Expression/ClangUserExpression.h"
@@ -29,6 +30,7 @@
 #include "lldb/Host/ThreadLauncher.h"
 #include "lldb/Interpreter/CommandInterpreter.h"
 #include "lldb/Interpreter/OptionValueProperties.h"
+#include "lldb/Symbol/ObjectFile.h"
 #include "lldb/Symbol/Symbol.h"
 #include "lldb/Target/ABI.h"
 #include "lldb/Target/DynamicLoader.h"
@@ -43,6 +45,7 @@
 #include "lldb/Target/ObjCLanguageRuntime.h"
 #include "lldb/Target/Platform.h"
 #include "lldb/Target/RegisterContext.h"
+#include "lldb/Target/SectionLoadList.h"
 #include "lldb/Target/StopInfo.h"
 #include "lldb/Target/SystemRuntime.h"
 #include "lldb/Target/Target.h"
@@ -116,6 +119,8 @@ g_properties[] =
     { "stop-on-sharedlibrary-events" , OptionValue::eTypeBoolean, true, false, NULL, NULL, "If true, stop when a shared library is loaded or unloaded." },
     { "detach-keeps-stopped" , OptionValue::eTypeBoolean, true, false, NULL, NULL, "If true, detach will attempt to keep the process stopped." },
     { "memory-cache-line-size" , OptionValue::eTypeUInt64, false, 512, NULL, NULL, "The memory cache line size" },
+    { "force-live-memory-reads" , OptionValue::eTypeBoolean, false, false, NULL, NULL, "If true, always read memory from the live process. Otherwise reads from read-only sections of modules whose files match the loaded image are served from the object files, "
+                                                                                       "and cached lines from those sections are kept across resumes. Turn this on when debugging JIT or self-modifying code." },
     {  NULL                  , OptionValue::eTypeInvalid, false, 0, NULL, NULL, NULL  }
 };
 
@@ -127,7 +132,8 @@ enum {
     ePropertyPythonOSPluginPath,
     ePropertyStopOnSharedLibraryEvents,
     ePropertyDetachKeepsStopped,
-    ePropertyMemCacheLineSize
+    ePropertyMemCacheLineSize,
+    ePropertyForceLiveMemoryReads
 };
 
 ProcessProperties::ProcessProperties (lldb_private::Process *process) :
@@ -177,6 +183,13 @@ ProcessProperties::GetMemoryCacheLineSize() const
     return m_collection_sp->GetPropertyAtIndexAsUInt64 (NULL, idx, g_properties[idx].default_uint_value);
 }
 
+bool
+ProcessProperties::GetForceLiveMemoryReads() const
+{
+    const uint32_t idx = ePropertyForceLiveMemoryReads;
+    return m_collection_sp->GetPropertyAtIndexAsBoolean (NULL, idx, g_properties[idx].default_uint_value != 0);
+}
+
 Args
 ProcessProperties::GetExtraStartupCommands () const
 {
@@ -742,6 +755,8 @@ Process::Process(Target &target, Listener &listener, const UnixSignalsSP &unix_s
     m_iohandler_sync (false),
     m_memory_cache (*this),
     m_allocated_memory_cache (*this),
+    m_file_sections_mutex (Mutex::eMutexTypeNormal),
+    m_file_sections_match_memory (),
     m_should_detach (false),
     m_next_event_action_ap(),
     m_public_run_lock (),
@@ -871,6 +886,7 @@ Process::Finalize()
     m_notifications.swap(empty_notifications);
     m_image_tokens.clear();
     m_memory_cache.Clear();
+    ClearFileSections();
     m_allocated_memory_cache.Clear();
     m_language_runtimes.clear();
     m_instrumentation_runtimes.clear();
@@ -1797,7 +1813,7 @@ Process::SetPrivateState (StateType new_state)
             m_thread_list.DidStop();
 
             m_mod_id.BumpStopID();
-            m_memory_cache.Clear();
+            m_memory_cache.ClearVolatile();
             if (log)
                 log->Printf("Process::SetPrivateState (%s) stop_id = %u", StateAsCString(new_state), m_mod_id.GetStopID());
         }
@@ -2281,6 +2297,16 @@ Process::RemoveOwnerFromBreakpointSite (lldb::user_id_t owner_id, lldb::user_id_
 }
 
 
+void
+Process::FlushBreakpointSiteMemory (addr_t bp_addr, size_t size)
+{
+    // Read-only cache lines live across resumes, so a trap inserted or
+    // removed behind the cache's back would otherwise be seen for good.
+#if defined (ENABLE_MEMORY_CACHING)
+    m_memory_cache.Flush (bp_addr, size);
+#endif
+}
+
 size_t
 Process::RemoveBreakpointOpcodesFromBuffer (addr_t bp_addr, size_t size, uint8_t *buf) const
 {
@@ -2363,7 +2389,9 @@ Process::EnableSoftwareBreakpoint (BreakpointSite *bp_site)
         if (DoReadMemory(bp_addr, bp_site->GetSavedOpcodeBytes(), bp_opcode_size, error) == bp_opcode_size)
         {
             // Write a software breakpoint in place of the original opcode
-            if (DoWriteMemory(bp_addr, bp_opcode_bytes, bp_opcode_size, error) == bp_opcode_size)
+            const size_t bytes_written = DoWriteMemory(bp_addr, bp_opcode_bytes, bp_opcode_size, error);
+            FlushBreakpointSiteMemory (bp_addr, bp_opcode_size);
+            if (bytes_written == bp_opcode_size)
             {
                 uint8_t verify_bp_opcode_bytes[64];
                 if (DoReadMemory(bp_addr, verify_bp_opcode_bytes, bp_opcode_size, error) == bp_opcode_size)
@@ -2433,7 +2461,9 @@ Process::DisableSoftwareBreakpoint (BreakpointSite *bp_site)
                     break_op_found = true;
                     // We found a valid breakpoint opcode at this address, now restore
                     // the saved opcode.
-                    if (DoWriteMemory (bp_addr, bp_site->GetSavedOpcodeBytes(), break_op_size, error) == break_op_size)
+                    const size_t bytes_written = DoWriteMemory (bp_addr, bp_site->GetSavedOpcodeBytes(), break_op_size, error);
+                    FlushBreakpointSiteMemory (bp_addr, break_op_size);
+                    if (bytes_written == break_op_size)
                     {
                         verify = true;
                     }
@@ -2500,6 +2530,16 @@ size_t
 Process::ReadMemory (addr_t addr, void *buf, size_t size, Error &error)
 {
     error.Clear();
+
+    // Bytes in read-only sections are the same in the process as in the
+    // object file it was loaded from, so don't pay for a round trip.
+    if (buf && size && !GetForceLiveMemoryReads())
+    {
+        const size_t file_bytes_read = ReadMemoryFromObjectFile (addr, buf, size);
+        if (file_bytes_read == size)
+            return file_bytes_read;
+    }
+
     if (!GetDisableMemoryCache())
     {        
 #if defined (VERIFY_MEMORY_READS)
@@ -2592,19 +2632,33 @@ Process::ReadStringFromMemory (addr_t addr, char *dst, size_t max_bytes, Error &
             if (bytes_read == 0)
                 break;
 
-            // Search for a null terminator of correct size and alignment in bytes_read
-            size_t aligned_start = total_bytes_read - total_bytes_read % type_width;
-            for (size_t i = aligned_start; i + type_width <= total_bytes_read + bytes_read; i += type_width)
-                if (::strncmp(&dst[i], terminator, type_width) == 0)
+            // Search for a null terminator of correct size and alignment in bytes_read.
+            // Let memchr find the zero bytes and only check the alignment and the rest
+            // of the character at the candidates it turns up.
+            const size_t scan_end = total_bytes_read + bytes_read;
+            size_t i = total_bytes_read - total_bytes_read % type_width;
+            while (i + type_width <= scan_end)
+            {
+                const char *zero = (const char *)::memchr (&dst[i], '\0', scan_end - i);
+                if (zero == NULL)
+                    break;
+                i = zero - dst;
+                i -= i % type_width;
+                if (i + type_width > scan_end)
+                    break;
+                if (::memcmp (&dst[i], terminator, type_width) == 0)
                 {
                     error.Clear();
                     return i;
                 }
+                i += type_width;
+            }
 
             total_bytes_read += bytes_read;
             curr_dst += bytes_read;
             curr_addr += bytes_read;
             bytes_left -= bytes_read;
+            PrefetchStringTail (curr_addr, bytes_left);
         }
     }
     else
@@ -2644,16 +2698,22 @@ Process::ReadCStringFromMemory (addr_t addr, char *dst, size_t dst_max_len, Erro
                 dst[total_cstr_len] = '\0';
                 break;
             }
-            const size_t len = strlen(curr_dst);
+            const char *terminator = (const char *)::memchr (curr_dst, '\0', bytes_read);
+            if (terminator)
+            {
+                total_cstr_len += terminator - curr_dst;
+                break;
+            }
 
-            total_cstr_len += len;
+            total_cstr_len += bytes_read;
 
-            if (len < bytes_to_read)
+            if (bytes_read < bytes_to_read)
                 break;
 
             curr_dst += bytes_read;
             curr_addr += bytes_read;
             bytes_left -= bytes_read;
+            PrefetchStringTail (curr_addr, bytes_left);
         }
     }
     else
@@ -2666,6 +2726,237 @@ Process::ReadCStringFromMemory (addr_t addr, char *dst, size_t dst_max_len, Erro
     return total_cstr_len;
 }
 
+//----------------------------------------------------------------------
+// A string that didn't end in the cache line we just read tends to go
+// on for a while, so rather than paying one round trip per cache line
+// fetch whatever is left of it in the current page with a single read.
+// We stop at the page boundary so a string that ends right before an
+// unmapped page doesn't make the whole read fail.
+//----------------------------------------------------------------------
+void
+Process::PrefetchStringTail (addr_t addr, size_t max_bytes)
+{
+    static const addr_t k_page_size = 4096;
+
+    if (max_bytes == 0 || GetDisableMemoryCache())
+        return;
+    const addr_t page_bytes_left = k_page_size - (addr % k_page_size);
+    m_memory_cache.Prefetch (addr, std::min<addr_t>(max_bytes, page_bytes_left));
+}
+
+//----------------------------------------------------------------------
+// Read [addr, addr + size) from the object file of the module it was
+// loaded from. This only happens when the whole range is backed by file
+// data of a single section that isn't writable, the module has a UUID
+// to identify its file by, the file was found to be the one the process
+// loaded and nothing wrote to the section since. Returns zero if the
+// read has to go to the process instead.
+//----------------------------------------------------------------------
+size_t
+Process::ReadMemoryFromObjectFile (addr_t addr, void *buf, size_t size)
+{
+    Address so_addr;
+    if (!GetTarget().GetSectionLoadList().ResolveLoadAddress (addr, so_addr))
+        return 0;
+
+    SectionSP section_sp (so_addr.GetSection());
+    if (!section_sp || section_sp->IsEncrypted() || section_sp->GetTargetByteSize() != 1)
+        return 0;
+
+    const uint32_t permissions = section_sp->GetPermissions();
+    if ((permissions & ePermissionsReadable) == 0 || (permissions & ePermissionsWritable) != 0)
+        return 0;
+
+    const addr_t section_offset = so_addr.GetOffset();
+    if (section_offset + size > section_sp->GetFileSize())
+        return 0;
+
+    // Object files that were read out of the process memory read their
+    // section data back from the process.
+    ObjectFile *objfile = section_sp->GetObjectFile();
+    if (objfile == NULL || objfile->IsInMemory())
+        return 0;
+
+    ModuleSP module_sp (section_sp->GetModule());
+    if (!module_sp || !module_sp->GetUUID().IsValid())
+        return 0;
+
+    if (!FileSectionMatchesMemory (section_sp, addr - section_offset))
+        return 0;
+
+    return objfile->ReadSectionData (section_sp.get(), section_offset, buf, size);
+}
+
+//----------------------------------------------------------------------
+// Decide whether "section_sp" can be read from its object file the first
+// time the section is used, and remember the verdict until the module is
+// unloaded or the section is written to. The file must be the one the
+// process loaded, not just one with the same name, so a small piece of
+// the image that identifies it is compared with the process:
+//  - the GNU build ID note, for ELF images that have one;
+//  - otherwise the start of the section holding the image header, which
+//    for Mach-O images covers the load commands and so the LC_UUID;
+//  - otherwise the start of the section itself.
+// Only a bounded number of bytes is ever read from the process.
+//----------------------------------------------------------------------
+bool
+Process::FileSectionMatchesMemory (const SectionSP &section_sp, addr_t load_addr)
+{
+    static const size_t k_max_identity_size = 4096;
+
+    {
+        Mutex::Locker locker (m_file_sections_mutex);
+        std::map<const Section *, bool>::const_iterator pos = m_file_sections_match_memory.find (section_sp.get());
+        if (pos != m_file_sections_match_memory.end())
+            return pos->second;
+    }
+
+    static ConstString g_build_id_name (".note.gnu.build-id");
+    ModuleSP module_sp (section_sp->GetModule());
+    SectionList *section_list = module_sp ? module_sp->GetSectionList() : NULL;
+
+    SectionSP identity_sp;
+    addr_t identity_offset = 0;
+    addr_t identity_load_addr = LLDB_INVALID_ADDRESS;
+    if (section_list)
+        identity_sp = section_list->FindSectionByName (g_build_id_name);
+    if (identity_sp)
+        identity_load_addr = identity_sp->GetLoadBaseAddress (&GetTarget());
+
+    if (identity_load_addr == LLDB_INVALID_ADDRESS)
+    {
+        Address header_addr (section_sp->GetObjectFile()->GetHeaderAddress());
+        identity_sp = header_addr.GetSection();
+        if (identity_sp)
+        {
+            identity_offset = header_addr.GetOffset();
+            identity_load_addr = header_addr.GetLoadAddress (&GetTarget());
+        }
+    }
+
+    if (identity_load_addr == LLDB_INVALID_ADDRESS || identity_offset >= identity_sp->GetFileSize())
+    {
+        identity_sp = section_sp;
+        identity_offset = 0;
+        identity_load_addr = load_addr;
+    }
+
+    // If the process can't be read right now, don't record anything and
+    // try again next time.
+    bool matches = false;
+    const size_t identity_size = std::min<addr_t> (k_max_identity_size, identity_sp->GetFileSize() - identity_offset);
+    if (!FileSectionBytesMatchMemory (identity_sp, identity_offset, identity_load_addr, identity_size, matches))
+        return false;
+
+    Log *log (lldb_private::GetLogIfAllCategoriesSet (LIBLLDB_LOG_PROCESS));
+    if (log && !matches)
+        log->Printf ("Process::%s section %s at 0x%" PRIx64 " differs from its object file, reading it from the process",
+                     __FUNCTION__,
+                     section_sp->GetName().AsCString("<unknown>"),
+                     load_addr);
+
+    Mutex::Locker locker (m_file_sections_mutex);
+    // A write may have happened while we were comparing; it wins.
+    std::map<const Section *, bool>::const_iterator pos = m_file_sections_match_memory.find (section_sp.get());
+    if (pos != m_file_sections_match_memory.end())
+        return pos->second;
+    m_file_sections_match_memory[section_sp.get()] = matches;
+    return matches;
+}
+
+//----------------------------------------------------------------------
+// Compare "size" bytes of the file data of "section_sp", starting at
+// "offset", with the process memory at "load_addr". Bytes under any
+// breakpoint site are left out: the process may hold a trap there, put
+// in by us or by a remote stub, that the file doesn't have. Returns
+// false if either side couldn't be read, otherwise sets "matches".
+//----------------------------------------------------------------------
+bool
+Process::FileSectionBytesMatchMemory (const SectionSP &section_sp, addr_t offset, addr_t load_addr, size_t size, bool &matches)
+{
+    if (size == 0)
+        return false;
+
+    std::vector<uint8_t> file_bytes (size);
+    std::vector<uint8_t> live_bytes (size);
+    if (section_sp->GetObjectFile()->ReadSectionData (section_sp.get(), offset, &file_bytes[0], size) != size)
+        return false;
+    Error error;
+    if (ReadMemoryFromInferior (load_addr, &live_bytes[0], size, error) != size)
+        return false;
+
+    BreakpointSiteList bp_sites_in_range;
+    if (m_breakpoint_site_list.FindInRange (load_addr, load_addr + size, bp_sites_in_range))
+    {
+        bp_sites_in_range.ForEach([load_addr, size, &file_bytes, &live_bytes](BreakpointSite *bp_site) -> void {
+            addr_t intersect_addr;
+            size_t intersect_size;
+            size_t opcode_offset;
+            if (bp_site->IntersectsRange(load_addr, size, &intersect_addr, &intersect_size, &opcode_offset))
+            {
+                const size_t buf_offset = intersect_addr - load_addr;
+                ::memcpy(&live_bytes[buf_offset], &file_bytes[buf_offset], intersect_size);
+            }
+        });
+    }
+
+    matches = ::memcmp (&file_bytes[0], &live_bytes[0], size) == 0;
+    return true;
+}
+
+//----------------------------------------------------------------------
+// After a write to [addr, addr + size), never serve any section the
+// write overlapped out of its object file again.
+//----------------------------------------------------------------------
+void
+Process::FileSectionsWritten (addr_t addr, size_t size)
+{
+    std::vector<SectionSP> sections;
+    if (GetTarget().GetSectionLoadList().FindSectionsInRange (addr, size, sections) == 0)
+        return;
+
+    const addr_t end_addr = addr + size;
+    Mutex::Locker locker (m_file_sections_mutex);
+    while (!sections.empty())
+    {
+        SectionSP section_sp (sections.back());
+        sections.pop_back();
+        m_file_sections_match_memory[section_sp.get()] = false;
+
+        const SectionList &children = section_sp->GetChildren();
+        for (size_t i = 0; i < children.GetSize(); ++i)
+        {
+            SectionSP child_sp (children.GetSectionAtIndex (i));
+            const addr_t child_addr = child_sp->GetLoadBaseAddress (&GetTarget());
+            if (child_addr != LLDB_INVALID_ADDRESS && child_addr < end_addr && addr < child_addr + child_sp->GetByteSize())
+                sections.push_back (child_sp);
+        }
+    }
+}
+
+void
+Process::ClearFileSections ()
+{
+    Mutex::Locker locker (m_file_sections_mutex);
+    m_file_sections_match_memory.clear();
+}
+
+void
+Process::PrefetchMemory (const std::vector<addr_t> &addrs, size_t byte_size)
+{
+    if (addrs.empty() || byte_size == 0 || GetDisableMemoryCache())
+        return;
+    m_memory_cache.Prefetch (addrs, byte_size);
+}
+
+void
+Process::PrefetchMemory (addr_t addr, size_t byte_size)
+{
+    if (addr == LLDB_INVALID_ADDRESS || byte_size == 0 || GetDisableMemoryCache())
+        return;
+    m_memory_cache.Prefetch (addr, byte_size);
+}
+
 size_t
 Process::ReadMemoryFromInferior (addr_t addr, void *buf, size_t size, Error &error)
 {
@@ -2759,6 +3050,9 @@ Process::WriteMemory (addr_t addr, const void *buf, size_t size, Error &error)
 
     m_mod_id.BumpMemoryID();
 
+    // The object file no longer has what the process has for these bytes.
+    FileSectionsWritten (addr, size);
+
     // We need to write any data that would go where any current software traps
     // (enabled software breakpoints) any software traps (breakpoints) that we
     // may have placed in our tasks memory.
@@ -6378,6 +6672,7 @@ Process::DidExec ()
     m_instrumentation_runtimes.clear();
     m_thread_list.DiscardThreadPlans();
     m_memory_cache.Clear(true);
+    ClearFileSections();
     m_stop_info_override_callback = NULL;
     DoDidExec();
     CompleteAttach ();
@@ -6447,6 +6742,13 @@ Process::ModulesDidLoad (ModuleList &module_list)
 
 }
 
+void
+Process::ModulesDidUnload (ModuleList &module_list)
+{
+    m_memory_cache.ClearReadOnly();
+    ClearFileSections();
+}
+
 ThreadCollectionSP
 Process::GetHistoryThreads(lldb::addr_t addr)
 {
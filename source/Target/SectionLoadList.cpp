@@ -274,6 +274,24 @@ SectionLoadList::ResolveLoadAddress (addr_t load_addr, Address &so_addr) const
     return false;
 }
 
+size_t
+SectionLoadList::FindSectionsInRange (addr_t addr, addr_t size, std::vector<SectionSP> &sections) const
+{
+    const size_t initial_size = sections.size();
+    const addr_t end_addr = addr + size;
+    Mutex::Locker locker(m_mutex);
+    addr_to_sect_collection::const_iterator pos = m_addr_to_sect.upper_bound (addr);
+    // The section that starts closest before "addr" may extend into the range.
+    if (pos != m_addr_to_sect.begin())
+        --pos;
+    for (; pos != m_addr_to_sect.end() && pos->first < end_addr; ++pos)
+    {
+        if (pos->first + pos->second->GetByteSize() > addr)
+            sections.push_back (pos->second);
+    }
+    return sections.size() - initial_size;
+}
+
 void
 SectionLoadList::Dump (Stream &s, Target *target)
 {
@@ -1290,6 +1290,8 @@ Target::ModulesDidUnload (ModuleList &module_list, bool delete_locations)
     if (m_valid && module_list.GetSize())
     {
         UnloadModuleSections (module_list);
+        if (m_process_sp)
+            m_process_sp->ModulesDidUnload (module_list);
         m_breakpoint_list.UpdateBreakpoints (module_list, false, delete_locations);
         BroadcastEvent (eBroadcastBitModulesUnloaded, new TargetEventData (this->shared_from_this(), module_list));
     }
@@ -667,7 +667,7 @@ Thread::SetupForResume ()
         {
             const addr_t thread_pc = reg_ctx_sp->GetPC();
             BreakpointSiteSP bp_site_sp = GetProcess()->GetBreakpointSiteList().FindByAddress(thread_pc);
-            if (bp_site_sp)
+            if (bp_site_sp && !GetProcess()->StepsOverBreakpointSiteOnResume(bp_site_sp.get()))
             {
                 // Note, don't assume there's a ThreadPlanStepOverBreakpoint, the target may not require anything
                 // special to step over a breakpoint.
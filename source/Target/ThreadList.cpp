@@ -9,10 +9,16 @@
 #include <stdlib.h>
 
 #include <algorithm>
+#include <atomic>
 
 #include "lldb/Core/Log.h"
 #include "lldb/Core/State.h"
+#include "lldb/Core/Timer.h"
+#include "lldb/Host/HostInfo.h"
+#include "lldb/Host/HostThread.h"
+#include "lldb/Host/ThreadLauncher.h"
 #include "lldb/Target/RegisterContext.h"
+#include "lldb/Target/StackFrame.h"
 #include "lldb/Target/ThreadList.h"
 #include "lldb/Target/Thread.h"
 #include "lldb/Target/ThreadPlan.h"
@@ -495,6 +501,89 @@ ThreadList::DiscardThreadPlans ()
 
 }
 
+namespace
+{
+    struct FetchStackFramesInfo
+    {
+        FetchStackFramesInfo (const ThreadList::collection &threads, uint32_t end_frame_idx) :
+            m_threads (threads),
+            m_end_frame_idx (end_frame_idx),
+            m_next_thread_idx (0)
+        {
+        }
+
+        const ThreadList::collection &m_threads;
+        const uint32_t m_end_frame_idx;
+        std::atomic<size_t> m_next_thread_idx;
+    };
+
+    lldb::thread_result_t
+    FetchStackFramesThread (lldb::thread_arg_t arg)
+    {
+        FetchStackFramesInfo *info = static_cast<FetchStackFramesInfo *>(arg);
+        const size_t num_threads = info->m_threads.size();
+        for (size_t idx = info->m_next_thread_idx++; idx < num_threads; idx = info->m_next_thread_idx++)
+        {
+            Thread *thread = info->m_threads[idx].get();
+            for (uint32_t frame_idx = 0; frame_idx < info->m_end_frame_idx; ++frame_idx)
+            {
+                StackFrameSP frame_sp (thread->GetStackFrameAtIndex (frame_idx));
+                if (!frame_sp)
+                    break;
+                frame_sp->GetSymbolContext (eSymbolContextEverything);
+            }
+        }
+        return NULL;
+    }
+}
+
+void
+ThreadList::FetchStackFrames (const collection &threads, uint32_t end_frame_idx, uint32_t num_workers)
+{
+    Timer scoped_timer (__PRETTY_FUNCTION__, "%s (%" PRIu64 " threads)", __PRETTY_FUNCTION__, (uint64_t)threads.size());
+
+    if (num_workers == 0)
+        num_workers = HostInfo::GetNumberCPUS();
+    if (num_workers > threads.size())
+        num_workers = threads.size();
+
+    FetchStackFramesInfo info (threads, end_frame_idx);
+
+    // The calling thread is one of the workers.  The others only speed
+    // things up, so carry on with fewer if some can't be started.
+    std::vector<HostThread> workers;
+    for (uint32_t i = 1; i < num_workers; ++i)
+    {
+        HostThread worker = ThreadLauncher::LaunchThread ("lldb.target.unwind-worker",
+                                                          FetchStackFramesThread,
+                                                          &info,
+                                                          NULL,
+                                                          8*1024*1024); // Symbol parsing can recurse deeply
+        if (worker.IsJoinable())
+            workers.push_back (worker);
+    }
+
+    FetchStackFramesThread (&info);
+
+    for (HostThread &worker : workers)
+        worker.Join (NULL);
+}
+
+void
+ThreadList::FetchStackFrames (uint32_t end_frame_idx, uint32_t num_workers)
+{
+    // Work on a copy so the list's mutex isn't held while the workers
+    // run; they may need it themselves.
+    collection threads;
+    {
+        Mutex::Locker locker(GetMutex());
+        m_process->UpdateThreadListIfNeeded();
+        threads = m_threads;
+    }
+
+    FetchStackFrames (threads, end_frame_idx, num_workers);
+}
+
 bool
 ThreadList::WillResume ()
 {
@@ -342,13 +342,37 @@ StringExtractor::GetHexBytes (void *dst_void, size_t dst_len, uint8_t fail_fill_
 {
     uint8_t *dst = (uint8_t*)dst_void;
     size_t bytes_extracted = 0;
-    while (bytes_extracted < dst_len && GetBytesLeft ())
+    size_t bytes_left = GetBytesLeft ();
+    if (bytes_left > 0)
     {
-        dst[bytes_extracted] = GetHexU8 (fail_fill_value);
-        if (IsGood())
-            ++bytes_extracted;
+        // Decode straight out of the packet buffer instead of going
+        // through GetHexU8() for every byte, this is the hot path for
+        // memory and register reads.
+        const char *src = m_packet.data() + m_index;
+        bool success = true;
+        while (bytes_extracted < dst_len && bytes_left > 0)
+        {
+            if (bytes_left < 2)
+            {
+                success = false;
+                break;
+            }
+            const int hi_nibble = xdigit_to_sint(src[0]);
+            const int lo_nibble = xdigit_to_sint(src[1]);
+            if (hi_nibble == -1 || lo_nibble == -1)
+            {
+                success = false;
+                break;
+            }
+            dst[bytes_extracted++] = (uint8_t)((hi_nibble << 4) + lo_nibble);
+            src += 2;
+            bytes_left -= 2;
+        }
+
+        if (success)
+            m_index += bytes_extracted * 2;
         else
-            break;
+            m_index = UINT64_MAX;
     }
 
     for (size_t i = bytes_extracted; i < dst_len; ++i)
@@ -84,6 +84,7 @@ StringExtractorGDBRemote::GetServerPacketType () const
         switch (packet_cstr[1])
         {
         case 'E':
+            if (PACKET_STARTS_WITH ("QEnableCompression:"))     return eServerPacketType_QEnableCompression;
             if (PACKET_STARTS_WITH ("QEnvironment:"))           return eServerPacketType_QEnvironment;
             if (PACKET_STARTS_WITH ("QEnvironmentHexEncoded:")) return eServerPacketType_QEnvironmentHexEncoded;
             break;
@@ -109,6 +110,10 @@ StringExtractorGDBRemote::GetServerPacketType () const
             if (PACKET_MATCHES("QListThreadsInStopReply"))        return eServerPacketType_QListThreadsInStopReply;
             break;
 
+        case 'N':
+            if (PACKET_STARTS_WITH ("QNonStop:"))                 return eServerPacketType_QNonStop;
+            break;
+
         case 'R':
             if (PACKET_STARTS_WITH ("QRestoreRegisterState:"))    return eServerPacketType_QRestoreRegisterState;
             break;
@@ -229,6 +234,7 @@ StringExtractorGDBRemote::GetServerPacketType () const
               if (PACKET_STARTS_WITH ("vAttachName;"))          return eServerPacketType_vAttachName;
               if (PACKET_STARTS_WITH("vCont;"))                 return eServerPacketType_vCont;
               if (PACKET_MATCHES ("vCont?"))                    return eServerPacketType_vCont_actions;
+              if (PACKET_MATCHES ("vStopped"))                  return eServerPacketType_vStopped;
             }
             break;
       case '_':
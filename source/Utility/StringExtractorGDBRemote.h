@@ -84,8 +84,10 @@ public:
         eServerPacketType_vFile_symlink,
         eServerPacketType_vFile_unlink,
       // debug server packages
+        eServerPacketType_QEnableCompression,
         eServerPacketType_QEnvironmentHexEncoded,
         eServerPacketType_QListThreadsInStopReply,
+        eServerPacketType_QNonStop,
         eServerPacketType_QRestoreRegisterState,
         eServerPacketType_QSaveRegisterState,
         eServerPacketType_QSetLogging,
@@ -122,6 +124,7 @@ public:
         eServerPacketType_vAttachName,
         eServerPacketType_vCont,
         eServerPacketType_vCont_actions, // vCont?
+        eServerPacketType_vStopped,
 
         eServerPacketType_stop_reason, // '?'
 
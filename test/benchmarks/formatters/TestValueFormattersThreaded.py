@@ -0,0 +1,85 @@
+"""Benchmark formatting SBValues from several threads at once.
+
+SBValue calls take the target's API mutex, so the threads take turns and
+this can't show how the format cache scales.  It measures what an SB API
+client formatting values from several threads sees, and catches contention
+that makes that slower than formatting from a single thread.  The format
+cache and category lookups are exercised from several threads directly by
+unittests/DataFormatters.
+"""
+
+import os, sys
+import threading
+import unittest2
+import lldb
+from lldbbench import *
+import lldbutil
+
+class ValueFormattersThreadedBench(BenchBase):
+
+    mydir = TestBase.compute_mydir(__file__)
+
+    # Number of SB API threads formatting values concurrently.
+    thread_counts = [1, 2, 4, 8]
+
+    def setUp(self):
+        BenchBase.setUp(self)
+        self.count = lldb.bmIterationCount
+        if self.count <= 0:
+            self.count = 20
+
+    @benchmarks_test
+    @dwarf_test
+    def test_threaded_formatting_with_dwarf(self):
+        """Measure formatting the locals of a frame from several threads at once."""
+        self.buildDwarf()
+        exe = os.path.join(os.getcwd(), "a.out")
+        target = self.dbg.CreateTarget(exe)
+        self.assertTrue(target, VALID_TARGET)
+
+        breakpoint = target.BreakpointCreateBySourceRegex("// break here", lldb.SBFileSpec("main.cpp"))
+        self.assertTrue(breakpoint.GetNumLocations() > 0, VALID_BREAKPOINT)
+
+        process = target.LaunchSimple(None, None, self.get_process_working_directory())
+        self.assertTrue(process, PROCESS_IS_VALID)
+        threads = lldbutil.get_threads_stopped_at_breakpoint(process, breakpoint)
+        self.assertTrue(len(threads) == 1)
+        frame = threads[0].GetFrameAtIndex(0)
+
+        # Warm up the format cache so every run only measures lookups.
+        self.format_values(frame)
+
+        print
+        for num_threads in self.thread_counts:
+            stopwatch = Stopwatch()
+            for i in range(self.count):
+                workers = [threading.Thread(target=self.format_values, args=(frame,)) for t in range(num_threads)]
+                with stopwatch:
+                    for worker in workers:
+                        worker.start()
+                    for worker in workers:
+                        worker.join()
+            # Each thread does the same amount of work and the SB API lets
+            # only one of them in at a time, so expect the time per round to
+            # grow about linearly with the number of threads.
+            print "%d threads: %s" % (num_threads, stopwatch)
+
+        process.Kill()
+
+    def format_values(self, frame):
+        """Walk the locals of 'frame' asking for the values and summaries of everything."""
+        def walk(value, depth):
+            value.GetValue()
+            value.GetSummary()
+            if depth == 0:
+                return
+            for child in value:
+                walk(child, depth - 1)
+        for value in frame.GetVariables(False, True, False, True):
+            walk(value, 3)
+
+if __name__ == '__main__':
+    import atexit
+    lldb.SBDebugger.Initialize()
+    atexit.register(lambda: lldb.SBDebugger.Terminate())
+    unittest2.main()
@@ -0,0 +1,43 @@
+//===-- main.cpp ------------------------------------------------*- C++ -*-===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+
+// A frame full of values of a handful of types, so that formatting them
+// is dominated by formatter lookups that hit the format cache.
+
+#include <string>
+#include <vector>
+
+struct Point
+{
+    int x;
+    int y;
+};
+
+struct Record
+{
+    std::string name;
+    Point origin;
+    Point extent;
+    double weight;
+    const char *tag;
+};
+
+int
+main (int argc, char const *argv[])
+{
+    std::vector<Record> records;
+    for (int i = 0; i < 64; ++i)
+    {
+        Record r = { "record " + std::to_string (i), { i, -i }, { 2 * i, 3 * i }, i / 4.0, "tag" };
+        records.push_back (r);
+    }
+    Record first = records.front ();
+    Record last = records.back ();
+    return records.size () + first.origin.x + last.extent.y; // break here
+}
@@ -0,0 +1,61 @@
+"""Benchmark stop/resume latency against the number of inferior threads."""
+
+import os, sys
+import unittest2
+import lldb
+from lldbbench import *
+import lldbutil
+
+class ThreadStopLatencyBench(BenchBase):
+
+    mydir = TestBase.compute_mydir(__file__)
+
+    # Thread counts to measure, from a lightly to a heavily threaded inferior.
+    thread_counts = [1, 100, 1000, 5000]
+
+    def setUp(self):
+        BenchBase.setUp(self)
+        self.count = lldb.bmIterationCount
+        if self.count <= 0:
+            self.count = 50
+
+    @benchmarks_test
+    @unittest2.skipUnless(sys.platform.startswith("linux"), "requires Linux")
+    @dwarf_test
+    def test_stop_latency_with_dwarf(self):
+        """Measure continue-to-breakpoint time as the number of threads grows."""
+        self.buildDwarf()
+        print
+        for num_threads in self.thread_counts:
+            stopwatch = self.run_to_breakpoint_repeatedly(num_threads, self.count)
+            print "%5d threads: %s" % (num_threads, stopwatch)
+
+    def run_to_breakpoint_repeatedly(self, num_threads, count):
+        exe = os.path.join(os.getcwd(), "a.out")
+        target = self.dbg.CreateTarget(exe)
+        self.assertTrue(target, VALID_TARGET)
+
+        breakpoint = target.BreakpointCreateBySourceRegex("// break here", lldb.SBFileSpec("main.cpp"))
+        self.assertTrue(breakpoint.GetNumLocations() > 0, VALID_BREAKPOINT)
+
+        # One extra breakpoint hit for the first stop, which isn't timed.
+        process = target.LaunchSimple([str(num_threads), str(count + 1)], None, self.get_process_working_directory())
+        self.assertTrue(process, PROCESS_IS_VALID)
+        self.assertTrue(len(lldbutil.get_threads_stopped_at_breakpoint(process, breakpoint)) == 1)
+
+        # Each continue resumes every thread and stops all of them again.
+        stopwatch = Stopwatch()
+        for i in range(count):
+            with stopwatch:
+                process.Continue()
+            self.assertEqual(process.GetState(), lldb.eStateStopped)
+
+        process.Kill()
+        self.dbg.DeleteTarget(target)
+        return stopwatch
+
+if __name__ == '__main__':
+    import atexit
+    lldb.SBDebugger.Initialize()
+    atexit.register(lambda: lldb.SBDebugger.Terminate())
+    unittest2.main()
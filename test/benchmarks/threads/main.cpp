@@ -0,0 +1,70 @@
+//===-- main.cpp ------------------------------------------------*- C++ -*-===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+
+// Starts the number of threads given on the command line and keeps them
+// running, then hits a breakpoint in the main thread over and over so that
+// every stop and resume has to deal with all of them.
+
+#include <pthread.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include <atomic>
+#include <vector>
+
+std::atomic_int g_started (0);
+std::atomic_bool g_done (false);
+int g_iteration = 0;
+
+void *
+thread_func (void *)
+{
+    ++g_started;
+    while (!g_done)
+        usleep (1000);
+    return nullptr;
+}
+
+void
+stop_here ()
+{
+    ++g_iteration; // break here
+}
+
+int
+main (int argc, char const *argv[])
+{
+    const int num_threads = argc > 1 ? atoi (argv[1]) : 100;
+    const int num_iterations = argc > 2 ? atoi (argv[2]) : 100;
+
+    // Keep the stacks small so thousands of threads fit comfortably.
+    pthread_attr_t attr;
+    pthread_attr_init (&attr);
+    pthread_attr_setstacksize (&attr, 64 * 1024);
+
+    std::vector<pthread_t> threads;
+    for (int i = 0; i < num_threads; ++i)
+    {
+        pthread_t thread;
+        if (pthread_create (&thread, &attr, thread_func, nullptr) != 0)
+            break;
+        threads.push_back (thread);
+    }
+    pthread_attr_destroy (&attr);
+
+    while (g_started < static_cast<int> (threads.size ()))
+        usleep (1000);
+
+    for (int i = 0; i < num_iterations; ++i)
+        stop_here ();
+
+    g_done = true;
+    for (pthread_t thread : threads)
+        pthread_join (thread, nullptr);
+    return 0;
+}
@@ -0,0 +1,60 @@
+"""Benchmark unwinding a deep stack through many functions with eh_frame CFI."""
+
+import os, sys
+import unittest2
+import lldb
+from lldbbench import *
+import lldbutil
+
+class UnwindBench(BenchBase):
+
+    mydir = TestBase.compute_mydir(__file__)
+
+    def setUp(self):
+        BenchBase.setUp(self)
+        self.count = lldb.bmIterationCount
+        if self.count <= 0:
+            self.count = 10
+
+    @benchmarks_test
+    @dwarf_test
+    def test_unwind_with_dwarf(self):
+        """Measure the first complete backtrace through ~2000 eh_frame described frames."""
+        self.buildDwarf()
+        stopwatch = Stopwatch()
+        for i in range(self.count):
+            num_frames = self.unwind_once(stopwatch)
+        print
+        print "unwinding %d frames: %s" % (num_frames, stopwatch)
+
+    def unwind_once(self, stopwatch):
+        exe = os.path.join(os.getcwd(), "a.out")
+        target = self.dbg.CreateTarget(exe)
+        self.assertTrue(target, VALID_TARGET)
+
+        breakpoint = target.BreakpointCreateBySourceRegex("// break here", lldb.SBFileSpec("main.c"))
+        self.assertTrue(breakpoint.GetNumLocations() > 0, VALID_BREAKPOINT)
+
+        process = target.LaunchSimple(None, None, self.get_process_working_directory())
+        self.assertTrue(process, PROCESS_IS_VALID)
+        threads = lldbutil.get_threads_stopped_at_breakpoint(process, breakpoint)
+        self.assertTrue(len(threads) == 1)
+        thread = threads[0]
+
+        # Walking the stack parses the FDEs of all 64 functions into
+        # UnwindPlans and looks up a row for each of the frames.
+        with stopwatch:
+            num_frames = thread.GetNumFrames()
+        self.assertTrue(num_frames > 2000)
+
+        process.Kill()
+        self.dbg.DeleteTarget(target)
+        # Drop the module so the next iteration starts without any unwind info.
+        lldb.SBDebugger.MemoryPressureDetected()
+        return num_frames
+
+if __name__ == '__main__':
+    import atexit
+    lldb.SBDebugger.Initialize()
+    atexit.register(lambda: lldb.SBDebugger.Terminate())
+    unittest2.main()
@@ -0,0 +1,45 @@
+// Many distinct functions, each with its own FDE that saves several
+// callee-saved registers, so unwinding through them builds and searches
+// a lot of UnwindPlan rows.
+
+volatile int g_sink;
+
+int stop_here (int depth)
+{
+    return g_sink + depth; // break here
+}
+
+#define DEFINE_FRAME(name, next)                                        \
+    int name (int depth)                                                \
+    {                                                                   \
+        int a = g_sink, b = a * 3, c = b ^ depth, d = c + a, e = d * b; \
+        int result = depth > 0 ? next (depth - 1) : stop_here (depth);  \
+        return result + a + b + c + d + e;                              \
+    }
+
+#define DEFINE_FRAMES_8(prefix, next)               \
+    DEFINE_FRAME(prefix##7, next)                   \
+    DEFINE_FRAME(prefix##6, prefix##7)              \
+    DEFINE_FRAME(prefix##5, prefix##6)              \
+    DEFINE_FRAME(prefix##4, prefix##5)              \
+    DEFINE_FRAME(prefix##3, prefix##4)              \
+    DEFINE_FRAME(prefix##2, prefix##3)              \
+    DEFINE_FRAME(prefix##1, prefix##2)              \
+    DEFINE_FRAME(prefix##0, prefix##1)
+
+int frame_h0 (int depth);
+
+DEFINE_FRAMES_8(frame_a, frame_h0)
+DEFINE_FRAMES_8(frame_b, frame_a0)
+DEFINE_FRAMES_8(frame_c, frame_b0)
+DEFINE_FRAMES_8(frame_d, frame_c0)
+DEFINE_FRAMES_8(frame_e, frame_d0)
+DEFINE_FRAMES_8(frame_f, frame_e0)
+DEFINE_FRAMES_8(frame_g, frame_f0)
+DEFINE_FRAMES_8(frame_h, frame_g0)
+
+int main (int argc, char const *argv[])
+{
+    // 64 distinct functions, recursed through 32 times.
+    return frame_h0 (2047);
+}
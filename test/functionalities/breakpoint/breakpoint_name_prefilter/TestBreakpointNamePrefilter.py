@@ -0,0 +1,67 @@
+"""
+Test that breakpoints get their locations when a module is added to the
+target, whether they are looked up by name or search every module.
+"""
+
+import os, time
+import unittest2
+import lldb
+from lldbtest import *
+import lldbutil
+
+class BreakpointNamePrefilterTestCase(TestBase):
+
+    mydir = TestBase.compute_mydir(__file__)
+
+    @unittest2.skipUnless(sys.platform.startswith("darwin"), "requires Darwin")
+    @dsym_test
+    def test_with_dsym(self):
+        """Test breakpoints resolving in a module added after they were set."""
+        self.buildDsym()
+        self.name_prefilter_test()
+
+    @dwarf_test
+    def test_with_dwarf(self):
+        """Test breakpoints resolving in a module added after they were set."""
+        self.buildDwarf()
+        self.name_prefilter_test()
+
+    def name_prefilter_test(self):
+        """Test breakpoints resolving in a module added after they were set."""
+        # Start out with a target that has no modules, so every breakpoint
+        # below gets its locations when the executable is added.
+        target = self.dbg.CreateTarget("")
+        self.assertTrue(target, VALID_TARGET)
+        self.assertTrue(target.GetNumModules() == 0)
+
+        foo_bp = target.BreakpointCreateByName("foo_function")
+        missing_bp = target.BreakpointCreateByName("no_such_function")
+        regex_bp = target.BreakpointCreateByRegex("^ba[rz]_function$")
+        self.assertTrue(foo_bp.IsValid() and missing_bp.IsValid() and regex_bp.IsValid(), VALID_BREAKPOINT)
+
+        # A breakpoint with several names, only one of which exists.
+        self.runCmd("breakpoint set -n no_such_function -n bar_function")
+        names_bp = target.GetBreakpointAtIndex(target.GetNumBreakpoints() - 1)
+        self.assertTrue(names_bp.IsValid(), VALID_BREAKPOINT)
+
+        for bp in [foo_bp, missing_bp, regex_bp, names_bp]:
+            self.assertTrue(bp.GetNumLocations() == 0)
+
+        exe = os.path.join(os.getcwd(), "a.out")
+        module = target.AddModule(exe, None, None)
+        self.assertTrue(module.IsValid())
+
+        # Name lookups only get the modules that define one of their names,
+        # the regex breakpoint searches every module.
+        self.assertTrue(foo_bp.GetNumLocations() == 1, "foo_function resolved")
+        self.assertTrue(missing_bp.GetNumLocations() == 0, "no_such_function stays unresolved")
+        self.assertTrue(names_bp.GetNumLocations() == 1, "bar_function resolved through its second name")
+        self.assertTrue(regex_bp.GetNumLocations() == 2, "regex breakpoint found bar_function and baz_function")
+
+        self.assertTrue(foo_bp.GetLocationAtIndex(0).GetAddress().GetFunction().GetName() == "foo_function")
+
+if __name__ == '__main__':
+    import atexit
+    lldb.SBDebugger.Initialize()
+    atexit.register(lambda: lldb.SBDebugger.Terminate())
+    unittest2.main()
@@ -0,0 +1,26 @@
+#include <stdio.h>
+
+int
+foo_function (int value)
+{
+    return value + 1;
+}
+
+int
+bar_function (int value)
+{
+    return value * 2;
+}
+
+int
+baz_function (int value)
+{
+    return value - 3;
+}
+
+int
+main (int argc, char const *argv[])
+{
+    printf ("%d\n", foo_function (argc) + bar_function (argc) + baz_function (argc));
+    return 0;
+}
@@ -0,0 +1,39 @@
+//===-- main.cpp ------------------------------------------------*- C++ -*-===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+
+// Array children are made a page at a time; check elements on both sides
+// of page boundaries, in and out of order.
+
+struct Pair
+{
+    int first;
+    short second;
+};
+
+int main (int argc, char const *argv[])
+{
+    int numbers[1000];
+    Pair pairs[600];
+    for (int i = 0; i < 1000; i++)
+        numbers[i] = i * 3;
+    for (int i = 0; i < 600; i++)
+    {
+        pairs[i].first = i;
+        pairs[i].second = -i;
+    }
+    return 0; //% self.expect("frame variable numbers[999] numbers[255] numbers[256] numbers[0]", substrs = ['[999] = 2997', '[255] = 765', '[256] = 768', '[0] = 0'])
+     //% self.expect("frame variable pairs[513]", substrs = ['first = 513', 'second = -513'])
+     //% numbers = self.frame().FindVariable('numbers')
+     //% self.assertTrue(numbers.GetNumChildren() == 1000)
+     //% self.assertTrue(all(numbers.GetChildAtIndex(i).GetValueAsSigned() == i * 3 for i in range(1000)))
+     //% self.assertTrue(numbers.GetChildAtIndex(700).GetName() == '[700]')
+     //% self.assertTrue(numbers.GetChildAtIndex(700).GetLoadAddress() == numbers.GetLoadAddress() + 700 * 4)
+     //% pairs = self.frame().FindVariable('pairs')
+     //% self.assertTrue(pairs.GetChildAtIndex(599).GetChildMemberWithName('second').GetValueAsSigned() == -599)
+}
@@ -0,0 +1,98 @@
+"""
+Test Python synthetic children providers that hand out their children a range at a time.
+"""
+
+import os, time
+import unittest2
+import lldb
+from lldbtest import *
+import lldbutil
+
+class PythonSynthRangeDataFormatterTestCase(TestBase):
+
+    mydir = TestBase.compute_mydir(__file__)
+
+    @unittest2.skipUnless(sys.platform.startswith("darwin"), "requires Darwin")
+    @dsym_test
+    def test_with_dsym_and_run_command(self):
+        """Test a synthetic children provider implementing get_children_in_range."""
+        self.buildDsym()
+        self.data_formatter_commands()
+
+    @dwarf_test
+    def test_with_dwarf_and_run_command(self):
+        """Test a synthetic children provider implementing get_children_in_range."""
+        self.buildDwarf()
+        self.data_formatter_commands()
+
+    def setUp(self):
+        # Call super's setUp().
+        TestBase.setUp(self)
+        # Find the line number to break at.
+        self.line = line_number('main.cpp', '// Set break point at this line.')
+
+    def data_formatter_commands(self):
+        """Test a synthetic children provider implementing get_children_in_range."""
+        self.runCmd("file a.out", CURRENT_EXECUTABLE_SET)
+
+        lldbutil.run_break_set_by_file_and_line (self, "main.cpp", self.line, num_expected_locations=1, loc_exact=True)
+
+        self.runCmd("run", RUN_SUCCEEDED)
+
+        # The stop reason of the thread should be breakpoint.
+        self.expect("thread list", STOPPED_DUE_TO_BREAKPOINT,
+            substrs = ['stopped',
+                       'stop reason = breakpoint'])
+
+        # This is the function to remove the custom formats in order to have a
+        # clean slate for the next test case.
+        def cleanup():
+            self.runCmd('type synth clear', check=False)
+            self.runCmd('settings clear target.max-children-count', check=False)
+
+        # Execute the cleanup function during test case tear down.
+        self.addTearDownHook(cleanup)
+
+        self.runCmd("command script import rangesynth.py")
+        self.runCmd("type synth add -l rangesynth.ContainerSynthProvider Container")
+        self.runCmd("settings set target.max-children-count 300")
+
+        self.expect("frame variable container",
+            substrs = ['[0] = 0',
+                       '[1] = 3',
+                       '[63] = 189',
+                       '[64] = 192',
+                       '[299] = 897'])
+
+        # 300 children come in a handful of pages, and get_child_at_index was never needed.
+        range_calls = int(self.script_result("rangesynth.g_children_in_range_calls"))
+        self.assertTrue(range_calls > 0 and range_calls <= 5, "children fetched in %d calls" % range_calls)
+        self.assertTrue(self.script_result("rangesynth.g_child_at_index_calls") == "0")
+
+        # A provider that returns None for one page only falls back to
+        # get_child_at_index for that page, and every page is asked for once.
+        self.runCmd("type synth clear")
+        self.runCmd("type synth add -l rangesynth.PartialContainerSynthProvider Container")
+
+        self.expect("frame variable container",
+            substrs = ['[0] = 0',
+                       '[63] = 189',
+                       '[64] = 192',
+                       '[299] = 897'])
+
+        self.assertTrue(self.script_result("rangesynth.g_partial_range_starts") == "[0, 64, 128, 192, 256]")
+        self.assertTrue(self.script_result("rangesynth.g_partial_child_at_index_calls") == "64")
+
+    def script_result(self, expr):
+        command_interpreter = self.dbg.GetCommandInterpreter()
+        self.assertTrue(command_interpreter, VALID_COMMAND_INTERPRETER)
+        result = lldb.SBCommandReturnObject()
+        command_interpreter.HandleCommand("script " + expr, result)
+        self.assertTrue(result.Succeeded(), "script " + expr + " runs successfully")
+        return result.GetOutput().strip()
+
+if __name__ == '__main__':
+    import atexit
+    lldb.SBDebugger.Initialize()
+    atexit.register(lambda: lldb.SBDebugger.Terminate())
+    unittest2.main()
@@ -0,0 +1,24 @@
+//===-- main.cpp ------------------------------------------------*- C++ -*-===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+
+struct Container
+{
+    int *m_data;
+    int m_size;
+};
+
+int main (int argc, char const *argv[])
+{
+    int storage[300];
+    for (int i = 0; i < 300; i++)
+        storage[i] = i * 3;
+
+    Container container = { storage, 300 };
+    return container.m_size; // Set break point at this line.
+}
@@ -0,0 +1,55 @@
+import lldb
+
+g_child_at_index_calls = 0
+g_children_in_range_calls = 0
+
+class ContainerSynthProvider:
+    def __init__(self, valobj, dict):
+        self.valobj = valobj
+
+    def update(self):
+        self.data = self.valobj.GetChildMemberWithName('m_data')
+        self.size = self.valobj.GetChildMemberWithName('m_size').GetValueAsUnsigned(0)
+        self.int_type = self.data.GetType().GetPointeeType()
+        self.int_size = self.int_type.GetByteSize()
+
+    def num_children(self):
+        return self.size
+
+    def get_child_index(self, name):
+        try:
+            return int(name.lstrip('[').rstrip(']'))
+        except:
+            return -1
+
+    def get_child_at_index(self, index):
+        global g_child_at_index_calls
+        g_child_at_index_calls += 1
+        offset = index * self.int_size
+        return self.data.CreateChildAtOffset('[' + str(index) + ']', offset, self.int_type)
+
+    def get_children_in_range(self, start, count):
+        global g_children_in_range_calls
+        g_children_in_range_calls += 1
+        base = self.data.GetValueAsUnsigned(0)
+        end = min(start + count, self.size)
+        return [('[' + str(i) + ']', base + i * self.int_size, self.int_type) for i in range(start, end)]
+
+g_partial_child_at_index_calls = 0
+g_partial_range_starts = []
+
+class PartialContainerSynthProvider(ContainerSynthProvider):
+    """Hands over every page in one go but the first one."""
+    def get_child_at_index(self, index):
+        global g_partial_child_at_index_calls
+        g_partial_child_at_index_calls += 1
+        offset = index * self.int_size
+        return self.data.CreateChildAtOffset('[' + str(index) + ']', offset, self.int_type)
+
+    def get_children_in_range(self, start, count):
+        g_partial_range_starts.append(start)
+        if start == 0:
+            return None
+        base = self.data.GetValueAsUnsigned(0)
+        end = min(start + count, self.size)
+        return [('[' + str(i) + ']', base + i * self.int_size, self.int_type) for i in range(start, end)]
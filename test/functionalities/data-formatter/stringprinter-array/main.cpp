@@ -0,0 +1,30 @@
+//===-- main.cpp ------------------------------------------------*- C++ -*-===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+
+#include <stdio.h>
+#include <string.h>
+
+static char storage[64][16];
+static char long_string[3001];
+
+int main (int argc, char const *argv[])
+{
+    const char *strings[64];
+    for (int i = 0; i < 64; i++)
+    {
+        snprintf(storage[i], sizeof(storage[i]), "string %d", i);
+        strings[i] = storage[i];
+    }
+    memset(long_string, 'x', sizeof(long_string) - 1);
+    const char *long_cstr = long_string;
+    return 0; //% self.addTearDownHook(lambda x: x.runCmd("settings clear target.max-string-summary-length"))
+     //% self.expect("frame variable strings", substrs = ['[0] = 0x', '"string 0"', '[31] = 0x', '"string 31"', '[63] = 0x', '"string 63"'])
+     //% self.runCmd("settings set target.max-string-summary-length 4096")
+     //% self.assertTrue(self.frame().FindVariable('long_cstr').GetSummary() == '"' + 'x' * 3000 + '"')
+}
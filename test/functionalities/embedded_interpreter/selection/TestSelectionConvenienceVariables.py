@@ -0,0 +1,86 @@
+"""
+Test that lldb.thread and lldb.frame follow "thread select" and "frame select"
+without the process stopping again.
+"""
+
+import os, time
+import unittest2
+import lldb
+from lldbtest import *
+import lldbutil
+
+class SelectionConvenienceVariablesTestCase(TestBase):
+
+    mydir = TestBase.compute_mydir(__file__)
+
+    @unittest2.skipUnless(sys.platform.startswith("darwin"), "requires Darwin")
+    @dsym_test
+    def test_with_dsym(self):
+        """Test lldb.thread and lldb.frame after changing the selection."""
+        self.buildDsym()
+        self.selection_test()
+
+    @dwarf_test
+    def test_with_dwarf(self):
+        """Test lldb.thread and lldb.frame after changing the selection."""
+        self.buildDwarf()
+        self.selection_test()
+
+    def setUp(self):
+        # Call super's setUp().
+        TestBase.setUp(self)
+        # Find the line number to break inside inner().
+        self.line = line_number('main.c', '// Set break point at this line.')
+
+    def expect_selection(self, thread_index_id, frame_id, function_name):
+        """Check what lldb.thread and lldb.frame refer to."""
+        self.expect('script print "thread=%d" % lldb.thread.GetIndexID()',
+            substrs = ["thread=%d" % thread_index_id])
+        self.expect('script print "frame=%d" % lldb.frame.GetFrameID()',
+            substrs = ["frame=%d" % frame_id])
+        if function_name:
+            self.expect('script print "function=%s" % lldb.frame.GetFunctionName()',
+                substrs = ["function=%s" % function_name])
+
+    def selection_test(self):
+        """Test lldb.thread and lldb.frame after changing the selection."""
+        exe = os.path.join(os.getcwd(), "a.out")
+        self.runCmd("file " + exe, CURRENT_EXECUTABLE_SET)
+
+        lldbutil.run_break_set_by_file_and_line (self, "main.c", self.line, num_expected_locations=1)
+
+        self.runCmd("run", RUN_SUCCEEDED)
+
+        self.expect("thread list", STOPPED_DUE_TO_BREAKPOINT,
+            substrs = ["stop reason = breakpoint 1."])
+
+        process = self.dbg.GetSelectedTarget().GetProcess()
+        stop_id = process.GetStopID()
+        stopped_thread = process.GetSelectedThread()
+        self.assertTrue(stopped_thread.IsValid())
+        other_thread = None
+        for thread in process:
+            if thread.GetThreadID() != stopped_thread.GetThreadID():
+                other_thread = thread
+        self.assertTrue(other_thread, "Found the main thread.")
+
+        # Look at the globals once, so they are cached for this stop.
+        self.expect_selection(stopped_thread.GetIndexID(), 0, "inner")
+
+        self.runCmd("frame select 1")
+        self.expect_selection(stopped_thread.GetIndexID(), 1, "outer")
+
+        self.runCmd("thread select %d" % other_thread.GetIndexID())
+        self.expect_selection(other_thread.GetIndexID(), other_thread.GetSelectedFrame().GetFrameID(), None)
+
+        # Back to the thread that hit the breakpoint, which kept frame 1 selected.
+        self.runCmd("thread select %d" % stopped_thread.GetIndexID())
+        self.expect_selection(stopped_thread.GetIndexID(), 1, "outer")
+
+        self.assertTrue(process.GetStopID() == stop_id, "The process didn't stop again.")
+
+if __name__ == '__main__':
+    import atexit
+    lldb.SBDebugger.Initialize()
+    atexit.register(lambda: lldb.SBDebugger.Terminate())
+    unittest2.main()
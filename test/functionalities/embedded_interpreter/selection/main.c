@@ -0,0 +1,31 @@
+#include <pthread.h>
+
+int g_value;
+
+void
+inner (int value)
+{
+    g_value = value; // Set break point at this line.
+}
+
+void
+outer (int value)
+{
+    inner (value + 1);
+}
+
+void *
+thread_func (void *input)
+{
+    outer ((int)(long)input);
+    return NULL;
+}
+
+int
+main ()
+{
+    pthread_t thread;
+    pthread_create (&thread, NULL, thread_func, (void *)1);
+    pthread_join (thread, NULL);
+    return 0;
+}
@@ -0,0 +1,144 @@
+"""
+Test the 'memory cache-stats' command, that cached lines from read-only
+sections survive a resume, and that breakpoint traps do not linger in them.
+"""
+
+import os, time
+import unittest2
+import lldb
+from lldbtest import *
+import lldbutil
+
+class MemoryCacheStatsTestCase(TestBase):
+
+    mydir = TestBase.compute_mydir(__file__)
+
+    @unittest2.skipUnless(sys.platform.startswith("darwin"), "requires Darwin")
+    @dsym_test
+    def test_memory_cache_stats_with_dsym(self):
+        """Test the 'memory cache-stats' command."""
+        self.buildDsym()
+        self.memory_cache_stats()
+
+    @dwarf_test
+    def test_memory_cache_stats_with_dwarf(self):
+        """Test the 'memory cache-stats' command."""
+        self.buildDwarf()
+        self.memory_cache_stats()
+
+    @unittest2.skipUnless(sys.platform.startswith("darwin"), "requires Darwin")
+    @dsym_test
+    def test_read_code_after_deleting_breakpoint_with_dsym(self):
+        """Test that code read after deleting a breakpoint has no trap in it."""
+        self.buildDsym()
+        self.read_code_after_deleting_breakpoint()
+
+    @dwarf_test
+    def test_read_code_after_deleting_breakpoint_with_dwarf(self):
+        """Test that code read after deleting a breakpoint has no trap in it."""
+        self.buildDwarf()
+        self.read_code_after_deleting_breakpoint()
+
+    def setUp(self):
+        # Call super's setUp().
+        TestBase.setUp(self)
+        # Find the line number to break inside main().
+        self.line = line_number('main.c', '// Set break point at this line.')
+
+    def memory_cache_stats(self):
+        """Test the 'memory cache-stats' command."""
+        exe = os.path.join(os.getcwd(), "a.out")
+        self.runCmd("file " + exe, CURRENT_EXECUTABLE_SET)
+
+        lldbutil.run_break_set_by_file_and_line (self, "main.c", self.line, num_expected_locations=1, loc_exact=True)
+
+        self.runCmd("run", RUN_SUCCEEDED)
+
+        # The stop reason of the thread should be breakpoint.
+        self.expect("thread list", STOPPED_DUE_TO_BREAKPOINT,
+            substrs = ['stopped', 'stop reason = breakpoint'])
+
+        target = self.dbg.GetSelectedTarget()
+        process = target.GetProcess()
+        functions = target.FindFunctions("bump")
+        self.assertTrue(functions.GetSize() == 1, "found bump()")
+        bump_addr = functions.GetContextAtIndex(0).GetFunction().GetStartAddress().GetLoadAddress(target)
+        self.assertTrue(bump_addr != lldb.LLDB_INVALID_ADDRESS)
+
+        # The code of bump() is served from the object file, without going
+        # through the cache.
+        self.runCmd("memory cache-stats --reset")
+        error = lldb.SBError()
+        code = process.ReadMemory(bump_addr, 16, error)
+        self.assertTrue(error.Success(), "read the code of bump()")
+        self.expect("memory cache-stats",
+            substrs = ['Hits:              0', 'Misses:            0'])
+
+        # Once the section has been written to (with the same bytes, so the
+        # program keeps working) it has to be read from the process, and the
+        # code of bump() is pulled into the cache.
+        self.assertTrue(process.WriteMemory(bump_addr, code, error) == len(code))
+        self.assertTrue(error.Success(), "wrote the code of bump() back")
+        self.runCmd("memory cache-stats --reset")
+        self.assertTrue(process.ReadMemory(bump_addr, 16, error) == code)
+        self.assertTrue(error.Success(), "read the code of bump() from the process")
+        self.expect("memory cache-stats", matching=False,
+            substrs = ['Misses:            0'])
+        self.expect("memory cache-stats",
+            substrs = ['Hits:', 'Misses:', 'Process reads:'])
+
+        # Resume the process; the code of bump() lives in a read-only section,
+        # so reading it again must not go back to the process.
+        self.runCmd("next")
+        self.runCmd("memory cache-stats --reset")
+        self.expect("memory cache-stats",
+            substrs = ['Hits:              0', 'Misses:            0'])
+        self.assertTrue(process.ReadMemory(bump_addr, 16, error) == code)
+        self.assertTrue(error.Success(), "read the code of bump() again")
+        self.expect("memory cache-stats",
+            substrs = ['Misses:            0'])
+
+    def read_code_after_deleting_breakpoint(self):
+        """Test that code read after deleting a breakpoint has no trap in it."""
+        exe = os.path.join(os.getcwd(), "a.out")
+        self.runCmd("file " + exe, CURRENT_EXECUTABLE_SET)
+
+        lldbutil.run_break_set_by_file_and_line (self, "main.c", self.line, num_expected_locations=1, loc_exact=True)
+
+        self.runCmd("run", RUN_SUCCEEDED)
+
+        target = self.dbg.GetSelectedTarget()
+        process = target.GetProcess()
+        functions = target.FindFunctions("bump")
+        self.assertTrue(functions.GetSize() == 1, "found bump()")
+        bump_addr = functions.GetContextAtIndex(0).GetFunction().GetStartAddress().GetLoadAddress(target)
+        self.assertTrue(bump_addr != lldb.LLDB_INVALID_ADDRESS)
+
+        # Write the code of bump() back so that it is read from the process,
+        # through the cache, rather than from the object file.
+        error = lldb.SBError()
+        code = process.ReadMemory(bump_addr, 16, error)
+        self.assertTrue(error.Success(), "read the code of bump()")
+        self.assertTrue(process.WriteMemory(bump_addr, code, error) == len(code))
+        self.assertTrue(error.Success(), "wrote the code of bump() back")
+
+        # Pull the code of bump() into the cache while a trap sits in it.
+        breakpoint = target.BreakpointCreateByAddress(bump_addr)
+        self.assertTrue(breakpoint.IsValid() and breakpoint.GetNumLocations() == 1, VALID_BREAKPOINT)
+        process.ReadMemory(bump_addr, 16, error)
+        self.assertTrue(error.Success(), "read the code of bump() with a breakpoint in it")
+
+        # Once the breakpoint is gone, the trap must not come back from the
+        # cache, before or after a resume.
+        self.assertTrue(target.BreakpointDelete(breakpoint.GetID()))
+        self.assertTrue(process.ReadMemory(bump_addr, 16, error) == code)
+        self.assertTrue(error.Success(), "read the code of bump() after deleting the breakpoint")
+        self.runCmd("next")
+        self.assertTrue(process.ReadMemory(bump_addr, 16, error) == code)
+        self.assertTrue(error.Success(), "read the code of bump() after a resume")
+
+if __name__ == '__main__':
+    import atexit
+    lldb.SBDebugger.Initialize()
+    atexit.register(lambda: lldb.SBDebugger.Terminate())
+    unittest2.main()
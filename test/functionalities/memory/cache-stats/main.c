@@ -0,0 +1,25 @@
+//===-- main.c --------------------------------------------------*- C++ -*-===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+
+int g_counter = 0;
+
+void
+bump (void)
+{
+    g_counter++;
+}
+
+int
+main (int argc, char const *argv[])
+{
+    bump (); // Set break point at this line.
+    bump ();
+    bump ();
+    return g_counter;
+}
@@ -0,0 +1,132 @@
+"""
+Test that reads from read-only sections are served from the object file,
+and that target.process.force-live-memory-reads sends them to the process.
+"""
+
+import os, time
+import unittest2
+import lldb
+from lldbtest import *
+import lldbutil
+
+class FileBackedMemoryTestCase(TestBase):
+
+    mydir = TestBase.compute_mydir(__file__)
+
+    @unittest2.skipUnless(sys.platform.startswith("darwin"), "requires Darwin")
+    @dsym_test
+    def test_file_backed_memory_with_dsym(self):
+        """Test reading read-only sections from the object file."""
+        self.buildDsym()
+        self.file_backed_memory()
+
+    @dwarf_test
+    def test_file_backed_memory_with_dwarf(self):
+        """Test reading read-only sections from the object file."""
+        self.buildDwarf()
+        self.file_backed_memory()
+
+    @unittest2.skipUnless(sys.platform.startswith("darwin"), "requires Darwin")
+    @dsym_test
+    def test_file_backed_memory_under_breakpoint_with_dsym(self):
+        """Test that a breakpoint in a read-only section doesn't stop it being read from the object file."""
+        self.buildDsym()
+        self.file_backed_memory_under_breakpoint()
+
+    @dwarf_test
+    def test_file_backed_memory_under_breakpoint_with_dwarf(self):
+        """Test that a breakpoint in a read-only section doesn't stop it being read from the object file."""
+        self.buildDwarf()
+        self.file_backed_memory_under_breakpoint()
+
+    def setUp(self):
+        # Call super's setUp().
+        TestBase.setUp(self)
+        # Find the line number to break inside main().
+        self.line = line_number('main.c', '// Set break point at this line.')
+
+    def file_backed_memory(self):
+        """Test reading read-only sections from the object file."""
+        exe = os.path.join(os.getcwd(), "a.out")
+        self.runCmd("file " + exe, CURRENT_EXECUTABLE_SET)
+
+        lldbutil.run_break_set_by_file_and_line (self, "main.c", self.line, num_expected_locations=1, loc_exact=True)
+
+        self.runCmd("run", RUN_SUCCEEDED)
+
+        # The stop reason of the thread should be breakpoint.
+        self.expect("thread list", STOPPED_DUE_TO_BREAKPOINT,
+            substrs = ['stopped', 'stop reason = breakpoint'])
+
+        def cleanup():
+            self.runCmd('settings clear target.process.force-live-memory-reads', check=False)
+
+        # Execute the cleanup function during test case tear down.
+        self.addTearDownHook(cleanup)
+
+        target = self.dbg.GetSelectedTarget()
+        process = target.GetProcess()
+        functions = target.FindFunctions("bump")
+        self.assertTrue(functions.GetSize() == 1, "found bump()")
+        bump_addr = functions.GetContextAtIndex(0).GetFunction().GetStartAddress().GetLoadAddress(target)
+        self.assertTrue(bump_addr != lldb.LLDB_INVALID_ADDRESS)
+
+        # Let the first read check the section against the process, then
+        # make sure the next one doesn't touch the process at all.
+        error = lldb.SBError()
+        file_code = process.ReadMemory(bump_addr, 16, error)
+        self.assertTrue(error.Success(), "read the code of bump()")
+        self.runCmd("memory cache-stats --reset")
+        self.assertTrue(process.ReadMemory(bump_addr, 16, error) == file_code)
+        self.expect("memory cache-stats",
+            substrs = ['Hits:              0', 'Misses:            0', 'Process reads:     0'])
+
+        # Forcing live reads must give the same bytes, read from the process.
+        self.runCmd("settings set target.process.force-live-memory-reads true")
+        self.runCmd("memory cache-stats --reset")
+        live_code = process.ReadMemory(bump_addr, 16, error)
+        self.assertTrue(error.Success(), "read the code of bump() from the process")
+        self.assertTrue(live_code == file_code)
+        self.expect("memory cache-stats", matching=False,
+            substrs = ['Process reads:     0'])
+
+    def file_backed_memory_under_breakpoint(self):
+        """Test that a breakpoint in a read-only section doesn't stop it being read from the object file."""
+        exe = os.path.join(os.getcwd(), "a.out")
+        self.runCmd("file " + exe, CURRENT_EXECUTABLE_SET)
+
+        lldbutil.run_break_set_by_file_and_line (self, "main.c", self.line, num_expected_locations=1, loc_exact=True)
+
+        self.runCmd("run", RUN_SUCCEEDED)
+
+        target = self.dbg.GetSelectedTarget()
+        process = target.GetProcess()
+        functions = target.FindFunctions("bump")
+        self.assertTrue(functions.GetSize() == 1, "found bump()")
+        bump_start = functions.GetContextAtIndex(0).GetFunction().GetStartAddress()
+        bump_addr = bump_start.GetLoadAddress(target)
+        section_addr = bump_start.GetSection().GetLoadAddress(target)
+        self.assertTrue(bump_addr != lldb.LLDB_INVALID_ADDRESS)
+        self.assertTrue(section_addr != lldb.LLDB_INVALID_ADDRESS)
+
+        # Put traps at the start of the code section and in bump() before
+        # anything has been read from the section.  Whether we or the stub
+        # wrote them, they must not make the section look like a different
+        # image than the one in the file.
+        for addr in [section_addr, bump_addr]:
+            breakpoint = target.BreakpointCreateByAddress(addr)
+            self.assertTrue(breakpoint.IsValid() and breakpoint.GetNumLocations() == 1, VALID_BREAKPOINT)
+
+        error = lldb.SBError()
+        file_code = process.ReadMemory(bump_addr, 16, error)
+        self.assertTrue(error.Success(), "read the code of bump()")
+        self.runCmd("memory cache-stats --reset")
+        self.assertTrue(process.ReadMemory(bump_addr, 16, error) == file_code)
+        self.expect("memory cache-stats",
+            substrs = ['Process reads:     0'])
+
+if __name__ == '__main__':
+    import atexit
+    lldb.SBDebugger.Initialize()
+    atexit.register(lambda: lldb.SBDebugger.Terminate())
+    unittest2.main()
@@ -26,6 +26,19 @@ class MemoryReadTestCase(TestBase):
         self.buildDwarf()
         self.memory_read_command()
 
+    @unittest2.skipUnless(sys.platform.startswith("darwin"), "requires Darwin")
+    @dsym_test
+    def test_large_memory_read_with_dsym(self):
+        """Test reading more memory than fits in one memory packet."""
+        self.buildDsym()
+        self.large_memory_read()
+
+    @dwarf_test
+    def test_large_memory_read_with_dwarf(self):
+        """Test reading more memory than fits in one memory packet."""
+        self.buildDwarf()
+        self.large_memory_read()
+
     def setUp(self):
         # Call super's setUp().
         TestBase.setUp(self)
@@ -98,6 +111,33 @@ class MemoryReadTestCase(TestBase):
         self.expect("memory read --format 'float' --count 1 --size 20 `&my_double`",
             substrs = ['unsupported byte size (20) for float format'])
 
+    def large_memory_read(self):
+        """Read a 1MB buffer in one call and check every byte."""
+        exe = os.path.join(os.getcwd(), "a.out")
+        target = self.dbg.CreateTarget(exe)
+        self.assertTrue(target, VALID_TARGET)
+
+        lldbutil.run_break_set_by_file_and_line (self, "main.cpp", self.line, num_expected_locations=1, loc_exact=True)
+        process = target.LaunchSimple(None, None, self.get_process_working_directory())
+        self.assertTrue(process, PROCESS_IS_VALID)
+        self.assertTrue(process.GetState() == lldb.eStateStopped)
+
+        buffer_var = target.FindFirstGlobalVariable("g_large_buffer")
+        self.assertTrue(buffer_var.IsValid())
+        size = buffer_var.GetByteSize()
+        self.assertTrue(size == 1024 * 1024)
+
+        # The read is split into several memory packets, which go out
+        # pipelined when the server runs without acks.
+        error = lldb.SBError()
+        data = process.ReadMemory(buffer_var.GetLoadAddress(), size, error)
+        self.assertTrue(error.Success(), error.GetCString())
+        self.assertTrue(len(data) == size)
+        for i in range(size):
+            expected = (i * 7 + (i >> 8)) & 0xff
+            if ord(data[i]) != expected:
+                self.fail("byte %u of g_large_buffer is 0x%x, expected 0x%x" % (i, ord(data[i]), expected))
+
 
 if __name__ == '__main__':
     import atexit
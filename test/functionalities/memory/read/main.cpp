@@ -8,11 +8,17 @@
 //===----------------------------------------------------------------------===//
 #include <stdio.h>
 
+// Larger than any single memory packet a debug server accepts.
+static unsigned char g_large_buffer[1024 * 1024];
+
 int main (int argc, char const *argv[])
 {
+    for (size_t i = 0; i < sizeof(g_large_buffer); ++i)
+        g_large_buffer[i] = (unsigned char)(i * 7 + (i >> 8));
     char my_string[] = {'a', 'b', 'c', 'd', 'e', 'f', 'g', 0};
     double my_double = 1234.5678;
     printf("my_string=%s\n", my_string); // Set break point at this line.
     printf("my_double=%g\n", my_double);
+    printf("g_large_buffer[1]=%u\n", g_large_buffer[1]);
     return 0;
 }
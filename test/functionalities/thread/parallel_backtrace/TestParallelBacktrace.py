@@ -0,0 +1,76 @@
+"""
+Test that unwinding all threads in parallel gives the same backtraces, in the same order.
+"""
+
+import os, time
+import unittest2
+import lldb
+from lldbtest import *
+import lldbutil
+
+class ParallelBacktraceTestCase(TestBase):
+
+    mydir = TestBase.compute_mydir(__file__)
+
+    @unittest2.skipUnless(sys.platform.startswith("darwin"), "requires Darwin")
+    @dsym_test
+    def test_with_dsym(self):
+        """Test thread backtrace all --parallel."""
+        self.buildDsym()
+        self.parallel_backtrace_test()
+
+    @dwarf_test
+    def test_with_dwarf(self):
+        """Test thread backtrace all --parallel."""
+        self.buildDwarf()
+        self.parallel_backtrace_test()
+
+    def setUp(self):
+        # Call super's setUp().
+        TestBase.setUp(self)
+        # Find the line number to break inside stop_here().
+        self.line = line_number('main.c', '// Set break point at this line.')
+
+    def backtrace_output(self, options):
+        self.runCmd("thread backtrace all " + options)
+        return self.res.GetOutput()
+
+    def parallel_backtrace_test(self):
+        """Test thread backtrace all --parallel."""
+        exe = os.path.join(os.getcwd(), "a.out")
+        self.runCmd("file " + exe, CURRENT_EXECUTABLE_SET)
+
+        lldbutil.run_break_set_by_file_and_line (self, "main.c", self.line, num_expected_locations=1)
+
+        self.runCmd("run", RUN_SUCCEEDED)
+
+        self.expect("thread list", STOPPED_DUE_TO_BREAKPOINT,
+            substrs = ["stop reason = breakpoint 1."])
+
+        process = self.dbg.GetSelectedTarget().GetProcess()
+        self.assertTrue(process.GetNumThreads() == 17, 'Number of expected threads and actual threads do not match.')
+
+        # Unwinding caches the frames until the process resumes, so take the
+        # serial backtrace at the first stop and the parallel one at the
+        # second, each from scratch.
+        serial = self.backtrace_output("")
+
+        self.runCmd("continue")
+        self.expect("thread list", STOPPED_DUE_TO_BREAKPOINT,
+            substrs = ["stop reason = breakpoint 1."])
+        self.assertTrue(process.GetNumThreads() == 17, 'Number of expected threads and actual threads do not match.')
+
+        parallel = self.backtrace_output("--parallel 4")
+        self.assertTrue(parallel == serial, 'Parallel and serial backtraces differ.')
+        self.assertTrue(parallel.count("recurse") == sum(range(1, 17)), 'Missing recurse frames.')
+
+        # Same through the API, with a frame limit.
+        self.assertTrue(process.FetchThreadStackFrames(5, 0))
+        for thread in process:
+            self.assertTrue(thread.GetNumFrames() > 0)
+
+if __name__ == '__main__':
+    import atexit
+    lldb.SBDebugger.Initialize()
+    atexit.register(lambda: lldb.SBDebugger.Terminate())
+    unittest2.main()
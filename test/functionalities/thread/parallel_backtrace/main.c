@@ -0,0 +1,55 @@
+#include <pthread.h>
+
+#define NUM_THREADS 16
+
+pthread_barrier_t barrier;
+
+int
+recurse (int depth)
+{
+    if (depth == 0)
+    {
+        pthread_barrier_wait (&barrier);
+        pthread_barrier_wait (&barrier);
+        return 0;
+    }
+    return recurse (depth - 1) + 1;
+}
+
+void
+stop_here ()
+{
+    return; // Set break point at this line.
+}
+
+void *
+thread_func (void *input)
+{
+    recurse ((int)(long)input);
+    return NULL;
+}
+
+int main ()
+{
+    pthread_t threads[NUM_THREADS];
+    int i;
+
+    pthread_barrier_init (&barrier, NULL, NUM_THREADS + 1);
+
+    for (i = 0; i < NUM_THREADS; i++)
+        pthread_create (&threads[i], NULL, thread_func, (void *)(long)i);
+
+    pthread_barrier_wait (&barrier);
+
+    // Stop twice with every other thread parked in the second barrier, so
+    // both stops have the same backtraces.
+    for (i = 0; i < 2; i++)
+        stop_here ();
+
+    pthread_barrier_wait (&barrier);
+
+    for (i = 0; i < NUM_THREADS; i++)
+        pthread_join (threads[i], NULL);
+
+    return 0;
+}
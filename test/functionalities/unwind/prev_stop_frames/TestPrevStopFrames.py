@@ -0,0 +1,79 @@
+"""
+Test that backtraces stay correct when the unwinder carries frames over from one stop to the next.
+"""
+
+import os, time
+import unittest2
+import lldb
+from lldbtest import *
+import lldbutil
+
+class PrevStopFramesTestCase(TestBase):
+
+    mydir = TestBase.compute_mydir(__file__)
+
+    @unittest2.skipUnless(sys.platform.startswith("darwin"), "requires Darwin")
+    @dsym_test
+    def test_with_dsym (self):
+        """Test backtraces of a deep stack across several stops."""
+        self.buildDsym()
+        self.prev_stop_frames_tests()
+
+    @dwarf_test
+    def test_with_dwarf (self):
+        """Test backtraces of a deep stack across several stops."""
+        self.buildDwarf()
+        self.prev_stop_frames_tests()
+
+    def setUp(self):
+        # Call super's setUp().
+        TestBase.setUp(self)
+        self.line = line_number('main.c', '// Set break point at this line.')
+
+    def check_backtrace (self, thread, first_func, limit):
+        # stop_here, then limit + 1 recurse_a/recurse_b frames alternating down to depth 0, then main.
+        self.assertTrue(thread.GetNumFrames() >= limit + 3, "Not enough frames: %d" % thread.GetNumFrames())
+        self.assertTrue(thread.GetFrameAtIndex(0).GetFunctionName() == "stop_here")
+        other_func = "recurse_b" if first_func == "recurse_a" else "recurse_a"
+        for i in range(1, limit + 2):
+            frame = thread.GetFrameAtIndex(i)
+            depth = limit + 1 - i
+            expected_func = first_func if depth % 2 == 0 else other_func
+            self.assertTrue(frame.GetFunctionName() == expected_func,
+                            "Frame %d is %s, expected %s" % (i, frame.GetFunctionName(), expected_func))
+            self.assertTrue(frame.FindVariable("depth").GetValueAsSigned() == depth,
+                            "Frame %d has the wrong depth" % (i))
+        self.assertTrue(thread.GetFrameAtIndex(limit + 2).GetFunctionName() == "main")
+
+    def prev_stop_frames_tests (self):
+        exe = os.path.join(os.getcwd(), "a.out")
+        target = self.dbg.CreateTarget(exe)
+        self.assertTrue(target, VALID_TARGET)
+
+        breakpoint = target.BreakpointCreateByLocation("main.c", self.line)
+        self.assertTrue(breakpoint, VALID_BREAKPOINT)
+
+        process = target.LaunchSimple (None, None, self.get_process_working_directory())
+        self.assertTrue(process, PROCESS_IS_VALID)
+
+        expected_stacks = [ ("recurse_a", 200), ("recurse_a", 200), ("recurse_a", 200),
+                            ("recurse_a", 201), ("recurse_b", 200) ]
+        for (first_func, limit) in expected_stacks:
+            thread = lldbutil.get_one_thread_stopped_at_breakpoint(process, breakpoint)
+            self.assertTrue(thread, "Stopped at the breakpoint")
+            self.check_backtrace(thread, first_func, limit)
+
+            # Step within stop_here; everything above frame 0 stays the same.
+            thread.StepInstruction(False)
+            self.assertTrue(process.GetState() == lldb.eStateStopped)
+            self.check_backtrace(thread, first_func, limit)
+
+            process.Continue()
+
+        self.assertTrue(process.GetState() == lldb.eStateExited, "Process exited")
+
+if __name__ == '__main__':
+    import atexit
+    lldb.SBDebugger.Initialize()
+    atexit.register(lambda: lldb.SBDebugger.Terminate())
+    unittest2.main()
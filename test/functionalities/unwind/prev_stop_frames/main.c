@@ -0,0 +1,43 @@
+#include <stdio.h>
+
+int g_sink = 0;
+
+int __attribute__((noinline))
+stop_here (int depth)
+{
+    g_sink += depth; // Set break point at this line.
+    return g_sink;
+}
+
+int recurse_b (int depth, int limit);
+
+int __attribute__((noinline))
+recurse_a (int depth, int limit)
+{
+    if (depth == limit)
+        return stop_here (depth);
+    return recurse_b (depth + 1, limit) + 1;
+}
+
+int __attribute__((noinline))
+recurse_b (int depth, int limit)
+{
+    if (depth == limit)
+        return stop_here (depth);
+    return recurse_a (depth + 1, limit) + 1;
+}
+
+int
+main (int argc, char const *argv[])
+{
+    int i;
+    // The same stack three times in a row.
+    for (i = 0; i < 3; i++)
+        recurse_a (0, 200);
+    // One frame deeper, so the frames above main are all different.
+    recurse_a (0, 201);
+    // Same depth, but every frame is in the other function.
+    recurse_b (0, 200);
+    printf ("%d\n", g_sink);
+    return 0;
+}
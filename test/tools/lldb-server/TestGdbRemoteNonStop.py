@@ -0,0 +1,126 @@
+import time
+import unittest2
+
+import gdbremote_testcase
+from lldbtest import *
+
+class TestGdbRemoteNonStop(gdbremote_testcase.GdbRemoteTestCaseBase):
+    """Test the QNonStop/vStopped/%Stop support in lldb-server."""
+
+    def qSupported_reports_non_stop(self):
+        server = self.connect_to_debug_monitor()
+        self.assertIsNotNone(server)
+
+        self.add_no_ack_remote_stream()
+        self.add_qSupported_packets()
+
+        context = self.expect_gdbremote_sequence()
+        self.assertIsNotNone(context)
+
+        supported_dict = self.parse_qSupported_response(context)
+        self.assertEquals(supported_dict.get("QNonStop"), "+")
+
+    @llgs_test
+    def test_qSupported_reports_non_stop_llgs(self):
+        self.init_llgs_test()
+        self.qSupported_reports_non_stop()
+
+    def QNonStop_rejects_unknown_mode(self):
+        server = self.connect_to_debug_monitor()
+        self.assertIsNotNone(server)
+
+        self.add_no_ack_remote_stream()
+        self.test_sequence.add_log_lines(
+            ["read packet: $QNonStop:2#00",
+             {"direction":"send", "regex":r"^\$E([0-9a-fA-F]{2})#[0-9a-fA-F]{2}$"},
+            ], True)
+
+        context = self.expect_gdbremote_sequence()
+        self.assertIsNotNone(context)
+
+    @llgs_test
+    def test_QNonStop_rejects_unknown_mode_llgs(self):
+        self.init_llgs_test()
+        self.QNonStop_rejects_unknown_mode()
+
+    def vStopped_is_unsupported_in_all_stop_mode(self):
+        procs = self.prep_debug_monitor_and_inferior()
+        self.test_sequence.add_log_lines(
+            ["read packet: $vStopped#00",
+             "send packet: $#00",
+            ], True)
+
+        context = self.expect_gdbremote_sequence()
+        self.assertIsNotNone(context)
+
+    @llgs_test
+    @dwarf_test
+    def test_vStopped_is_unsupported_in_all_stop_mode_llgs_dwarf(self):
+        self.init_llgs_test()
+        self.buildDwarf()
+        self.set_inferior_startup_launch()
+        self.vStopped_is_unsupported_in_all_stop_mode()
+
+    def stopping_one_thread_leaves_others_running(self):
+        procs = self.prep_debug_monitor_and_inferior(inferior_args=["thread:new", "thread:new", "sleep:10"])
+
+        # Switch to non-stop mode while only the main thread exists and is
+        # stopped at the launch stop.
+        self.test_sequence.add_log_lines(
+            ["read packet: $QNonStop:1#00",
+             "send packet: $OK#00",
+             "read packet: $?#00",
+             {"direction":"send", "regex":r"^\$T([0-9a-fA-F]{2})thread:([0-9a-fA-F]+);", "capture":{2:"main_thread_id"}},
+             "read packet: $vStopped#00",
+             "send packet: $OK#00",
+             # Resuming answers right away in non-stop mode.
+             "read packet: $vCont;c#00",
+             "send packet: $OK#00",
+            ], True)
+
+        context = self.expect_gdbremote_sequence()
+        self.assertIsNotNone(context)
+        main_thread_id = int(context.get("main_thread_id"), 16)
+
+        # Give the inferior time to start its other threads.
+        time.sleep(1)
+
+        # Stop just the main thread; its stop is announced by a notification.
+        self.reset_test_sequence()
+        self.test_sequence.add_log_lines(
+            ["read packet: $vCont;t:{:x}#00".format(main_thread_id),
+             "send packet: $OK#00",
+             {"direction":"send", "regex":r"^%Stop:T([0-9a-fA-F]{2})thread:([0-9a-fA-F]+);", "capture":{2:"notified_thread_id"}},
+             "read packet: $vStopped#00",
+             "send packet: $OK#00",
+            ], True)
+
+        context = self.expect_gdbremote_sequence()
+        self.assertIsNotNone(context)
+        self.assertEquals(int(context.get("notified_thread_id"), 16), main_thread_id)
+
+        # The other threads kept running: the main thread is the only one
+        # "?" reports as stopped.
+        self.reset_test_sequence()
+        self.test_sequence.add_log_lines(
+            ["read packet: $?#00",
+             {"direction":"send", "regex":r"^\$T([0-9a-fA-F]{2})thread:([0-9a-fA-F]+);", "capture":{2:"stopped_thread_id"}},
+             "read packet: $vStopped#00",
+             "send packet: $OK#00",
+            ], True)
+
+        context = self.expect_gdbremote_sequence()
+        self.assertIsNotNone(context)
+        self.assertEquals(int(context.get("stopped_thread_id"), 16), main_thread_id)
+
+    @llgs_test
+    @dwarf_test
+    def test_stopping_one_thread_leaves_others_running_llgs_dwarf(self):
+        self.init_llgs_test()
+        self.buildDwarf()
+        self.set_inferior_startup_launch()
+        self.stopping_one_thread_leaves_others_running()
+
+
+if __name__ == '__main__':
+    unittest2.main()
@@ -0,0 +1,148 @@
+import re
+import signal
+import unittest2
+
+import gdbremote_testcase
+from lldbgdbserverutils import *
+from lldbtest import *
+
+class TestGdbRemoteRegisterCache(gdbremote_testcase.GdbRemoteTestCaseBase):
+    """Test that register reads served from lldb-server's per-stop register cache stay accurate."""
+
+    def stop_inferior_and_gather_registers(self):
+        inferior_args = ["message:main entered", "sleep:5"]
+        procs = self.prep_debug_monitor_and_inferior(inferior_args=inferior_args)
+
+        self.add_process_info_collection_packets()
+        self.add_register_info_collection_packets()
+        self.test_sequence.add_log_lines([
+            # Start the inferior...
+            "read packet: $c#63",
+            # ... match output....
+            { "type":"output_match", "regex":r"^message:main entered\r\n$" },
+            ], True)
+        # ... then interrupt.
+        self.add_interrupt_packets()
+
+        context = self.expect_gdbremote_sequence()
+        self.assertIsNotNone(context)
+
+        # Gather process info.
+        process_info = self.parse_process_info_response(context)
+        endian = process_info.get("endian")
+        self.assertIsNotNone(endian)
+
+        # Gather register info.
+        reg_infos = self.parse_register_info_packets(context)
+        self.assertIsNotNone(reg_infos)
+        self.add_lldb_register_index(reg_infos)
+
+        return (endian, reg_infos)
+
+    def write_register_value(self, reg_info, endian, value):
+        self.reset_test_sequence()
+        self.test_sequence.add_log_lines([
+            "read packet: $P{:x}={}#00".format(reg_info["lldb_register_index"], pack_register_hex(endian, value, byte_size=int(reg_info["bitsize"]) / 8)),
+            "send packet: $OK#00",
+            ], True)
+        context = self.expect_gdbremote_sequence()
+        self.assertIsNotNone(context)
+
+    def gpr_writes_are_visible_to_later_reads(self):
+        (endian, reg_infos) = self.stop_inferior_and_gather_registers()
+
+        gpr_reg_infos = [reg_info for reg_info in reg_infos if self.is_bit_flippable_register(reg_info)]
+        self.assertTrue(len(gpr_reg_infos) > 0)
+
+        # Reading every register fills the cache for this stop.
+        initial_reg_values = self.read_register_values(gpr_reg_infos, endian)
+
+        # Each write is read back right away, and each read refills the cache.
+        (successful_writes, failed_writes) = self.flip_all_bits_in_each_register_value(gpr_reg_infos, endian)
+        self.assertTrue(successful_writes > 0)
+
+        # None of the values the writes replaced may come back from the cache.
+        flipped_reg_values = self.read_register_values(gpr_reg_infos, endian)
+        changed_regs = [reg_index for reg_index in initial_reg_values if flipped_reg_values[reg_index] != initial_reg_values[reg_index]]
+        self.assertTrue(len(changed_regs) >= successful_writes)
+
+    @llgs_test
+    @dwarf_test
+    def test_gpr_writes_are_visible_to_later_reads_llgs_dwarf(self):
+        self.init_llgs_test()
+        self.buildDwarf()
+        self.set_inferior_startup_launch()
+        self.gpr_writes_are_visible_to_later_reads()
+
+    def fpr_write_preserves_other_fprs(self):
+        (endian, reg_infos) = self.stop_inferior_and_gather_registers()
+
+        xmm_reg_infos = { reg_info["name"]:reg_info for reg_info in reg_infos if reg_info["name"] in ["xmm0", "xmm1"] }
+        self.assertEquals(len(xmm_reg_infos), 2)
+        xmm0_info = xmm_reg_infos["xmm0"]
+        xmm1_info = xmm_reg_infos["xmm1"]
+
+        initial_reg_values = self.read_register_values([xmm0_info, xmm1_info], endian)
+
+        # Writing one register rewrites the whole floating point set, which must
+        # start from the thread's current contents.
+        new_xmm0_value = initial_reg_values[xmm0_info["lldb_register_index"]] ^ int("ff" * (int(xmm0_info["bitsize"]) / 8), 16)
+        self.write_register_value(xmm0_info, endian, new_xmm0_value)
+
+        final_reg_values = self.read_register_values([xmm0_info, xmm1_info], endian)
+        self.assertEquals(final_reg_values[xmm0_info["lldb_register_index"]], new_xmm0_value)
+        self.assertEquals(final_reg_values[xmm1_info["lldb_register_index"]], initial_reg_values[xmm1_info["lldb_register_index"]])
+
+    @llgs_test
+    @dwarf_test
+    def test_fpr_write_preserves_other_fprs_llgs_dwarf(self):
+        self.init_llgs_test()
+        if not re.match("x86_64", self.getArchitecture()):
+            self.skipTest("xmm registers are only checked on x86_64")
+        self.buildDwarf()
+        self.set_inferior_startup_launch()
+        self.fpr_write_preserves_other_fprs()
+
+    def pc_read_after_step_is_not_stale(self):
+        (endian, reg_infos) = self.stop_inferior_and_gather_registers()
+
+        (pc_lldb_reg_index, pc_reg_info) = self.find_pc_reg_info(reg_infos)
+        self.assertIsNotNone(pc_reg_info)
+
+        # Gather thread info.
+        self.reset_test_sequence()
+        self.add_threadinfo_collection_packets()
+        context = self.expect_gdbremote_sequence()
+        self.assertIsNotNone(context)
+        threads = self.parse_threadinfo_packets(context)
+        self.assertIsNotNone(threads)
+        thread_id = threads[0]
+
+        initial_pc = self.read_register_values([pc_reg_info], endian)[pc_reg_info["lldb_register_index"]]
+
+        # Resuming the thread must drop whatever was cached for the previous stop.
+        self.reset_test_sequence()
+        self.test_sequence.add_log_lines([
+            "read packet: $Hc{0:x}#00".format(thread_id),
+            "send packet: $OK#00",
+            "read packet: $s#00",
+            { "direction":"send", "regex":r"^\$T([0-9a-fA-F]{2})", "capture":{1:"stop_signo"} },
+            ], True)
+        context = self.expect_gdbremote_sequence()
+        self.assertIsNotNone(context)
+        self.assertEquals(int(context.get("stop_signo"), 16), signal.SIGTRAP)
+
+        stepped_pc = self.read_register_values([pc_reg_info], endian)[pc_reg_info["lldb_register_index"]]
+        self.assertNotEqual(stepped_pc, initial_pc)
+
+    @llgs_test
+    @dwarf_test
+    def test_pc_read_after_step_is_not_stale_llgs_dwarf(self):
+        self.init_llgs_test()
+        self.buildDwarf()
+        self.set_inferior_startup_launch()
+        self.pc_read_after_step_is_not_stale()
+
+
+if __name__ == '__main__':
+    unittest2.main()
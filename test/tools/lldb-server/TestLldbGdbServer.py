@@ -1280,6 +1280,77 @@ class LldbGdbServerTestCase(gdbremote_testcase.GdbRemoteTestCaseBase):
         self.set_inferior_startup_launch()
         self.software_breakpoint_set_and_remove_work()
 
+    def resume_with_signal_over_breakpoint_delivers_signal_once(self):
+        # Start up the inferior.
+        procs = self.prep_debug_monitor_and_inferior(
+            inferior_args=["get-code-address-hex:hello", "sleep:1", "call-function:hello"])
+
+        # Run until the code address of hello is printed, then stop.
+        self.test_sequence.add_log_lines(
+            [# Start running after initial stop.
+             "read packet: $c#63",
+             # Match output line that prints the memory address of the function call entry point.
+             { "type":"output_match", "regex":r"^code address: 0x([0-9a-fA-F]+)\r\n$", "capture":{ 1:"function_address"} },
+             # Now stop the inferior.
+             "read packet: {}".format(chr(03)),
+             # And wait for the stop notification.
+             {"direction":"send", "regex":r"^\$T([0-9a-fA-F]{2})thread:([0-9a-fA-F]+);", "capture":{1:"stop_signo", 2:"stop_thread_id"} }],
+            True)
+
+        context = self.expect_gdbremote_sequence()
+        self.assertIsNotNone(context)
+        self.assertIsNotNone(context.get("function_address"))
+        function_address = int(context.get("function_address"), 16)
+
+        # Set a breakpoint on hello and run to it.
+        BREAKPOINT_KIND = 1
+        self.reset_test_sequence()
+        self.add_set_breakpoint_packets(function_address, do_continue=True, breakpoint_kind=BREAKPOINT_KIND)
+
+        context = self.expect_gdbremote_sequence()
+        self.assertIsNotNone(context)
+        self.assertEquals(int(context.get("stop_signo"), 16), signal.SIGTRAP)
+        thread_id = int(context.get("stop_thread_id"), 16)
+
+        # Resume the thread sitting on the breakpoint with SIGUSR1.  The stub
+        # steps it over the breakpoint with the signal, the handler runs, and
+        # the thread comes back to the breakpoint when the handler returns.
+        self.reset_test_sequence()
+        self.test_sequence.add_log_lines(
+            ["read packet: $vCont;C{0:02x}:{1:x}#00".format(signal.SIGUSR1, thread_id),
+             { "type":"output_match", "regex":r"received SIGUSR1 on thread id: [0-9a-fA-F]+\r\n", "regex_mode":"search" },
+             {"direction":"send", "regex":r"^\$T([0-9a-fA-F]{2})thread:([0-9a-fA-F]+);", "capture":{1:"stop_signo", 2:"stop_thread_id"} }],
+            True)
+
+        context = self.expect_gdbremote_sequence()
+        self.assertIsNotNone(context)
+        self.assertEquals(int(context.get("stop_signo"), 16), signal.SIGTRAP)
+        output = context["O_content"]
+
+        # Remove the breakpoint and run to completion.
+        self.reset_test_sequence()
+        self.add_remove_breakpoint_packets(function_address, breakpoint_kind=BREAKPOINT_KIND)
+        self.test_sequence.add_log_lines(
+            ["read packet: $c#63",
+             { "type":"output_match", "regex":r"hello, world\r\n", "regex_mode":"search" },
+             {"direction":"send", "regex":r"^\$W00(.*)#[0-9a-fA-F]{2}$" }],
+            True)
+
+        context = self.expect_gdbremote_sequence()
+        self.assertIsNotNone(context)
+        output += context["O_content"]
+
+        # The signal must have been delivered exactly once.
+        self.assertEquals(output.count("received SIGUSR1"), 1)
+
+    @llgs_test
+    @dwarf_test
+    def test_resume_with_signal_over_breakpoint_delivers_signal_once_llgs_dwarf(self):
+        self.init_llgs_test()
+        self.buildDwarf()
+        self.set_inferior_startup_launch()
+        self.resume_with_signal_over_breakpoint_delivers_signal_once()
+
     def qSupported_returns_known_stub_features(self):
         # Start up the stub and start/prep the inferior.
         procs = self.prep_debug_monitor_and_inferior()
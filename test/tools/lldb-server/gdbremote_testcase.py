@@ -687,6 +687,9 @@ class GdbRemoteTestCaseBase(TestBase):
         "qXfer:auxv:read",
         "qXfer:libraries:read",
         "qXfer:libraries-svr4:read",
+        "SupportedCompressions",
+        "BreakpointStepOver",
+        "QNonStop",
     ]
 
     def parse_qSupported_response(self, context):
@@ -32,7 +32,8 @@ class SocketPacketPump(object):
     content into the two queues.
     """
 
-    _GDB_REMOTE_PACKET_REGEX = re.compile(r'^\$([^\#]*)#[0-9a-fA-F]{2}')
+    # Packets start with '$', asynchronous notifications with '%'.
+    _GDB_REMOTE_PACKET_REGEX = re.compile(r'^[\$%]([^\#]*)#[0-9a-fA-F]{2}')
 
     def __init__(self, pump_socket, logger=None):
         if not pump_socket:
@@ -492,6 +492,16 @@ main_gdbserver (int argc, char *argv[])
     signal (SIGHUP, signal_handler);
 #endif
 
+#if defined(__linux__)
+    // NativeProcessLinux collects inferior state changes through a signalfd,
+    // which only sees SIGCHLD if no thread can take delivery of it.  Block it
+    // before any other thread is started so every thread inherits the mask.
+    sigset_t sigchld_set;
+    sigemptyset (&sigchld_set);
+    sigaddset (&sigchld_set, SIGCHLD);
+    pthread_sigmask (SIG_BLOCK, &sigchld_set, nullptr);
+#endif
+
     const char *progname = argv[0];
     const char *subcommand = argv[1];
     argc--;
@@ -0,0 +1,171 @@
+//===-- FormatterThreadingTest.cpp ------------------------------*- C++ -*-===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+
+#include "gtest/gtest.h"
+
+#include <atomic>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "lldb/Core/ConstString.h"
+#include "lldb/Core/DataExtractor.h"
+#include "lldb/Core/ValueObjectConstResult.h"
+#include "lldb/DataFormatters/FormatCache.h"
+#include "lldb/DataFormatters/TypeCategory.h"
+#include "lldb/DataFormatters/TypeCategoryMap.h"
+#include "lldb/DataFormatters/TypeSummary.h"
+#include "lldb/Symbol/ClangASTContext.h"
+
+using namespace lldb_private;
+
+namespace
+{
+    const size_t kNumReaders = 8;
+    const size_t kNumIterations = 20000;
+
+    lldb::TypeSummaryImplSP
+    MakeSummary (const char *format)
+    {
+        return lldb::TypeSummaryImplSP (new StringSummaryFormat (TypeSummaryImpl::Flags (), format));
+    }
+}
+
+//----------------------------------------------------------------------
+// Readers look types up while writers fill the cache in and clear it.
+// A hit must always hand back the summary that was stored for that type.
+//----------------------------------------------------------------------
+TEST (FormatterThreadingTest, FormatCacheLookupsRaceWithUpdates)
+{
+    const size_t num_types = 64;
+    std::vector<ConstString> types;
+    std::vector<lldb::TypeSummaryImplSP> summaries;
+    for (size_t i = 0; i < num_types; ++i)
+    {
+        types.push_back (ConstString (("type_" + std::to_string (i)).c_str ()));
+        summaries.push_back (MakeSummary (("summary_" + std::to_string (i)).c_str ()));
+    }
+
+    FormatCache cache;
+    std::atomic<bool> done (false);
+    std::atomic<size_t> mismatches (0);
+
+    std::vector<std::thread> threads;
+    for (size_t t = 0; t < kNumReaders; ++t)
+    {
+        threads.push_back (std::thread ([&, t] () {
+            for (size_t i = 0; i < kNumIterations; ++i)
+            {
+                const size_t idx = (i + t) % num_types;
+                lldb::TypeSummaryImplSP summary_sp;
+                if (cache.GetSummary (types[idx], summary_sp))
+                {
+                    if (summary_sp != summaries[idx])
+                        ++mismatches;
+                }
+                else
+                {
+                    // Readers that miss fill the entry in, as FormatManager does.
+                    cache.SetSummary (types[idx], summaries[idx]);
+                }
+            }
+        }));
+    }
+    std::thread clearer ([&] () {
+        while (!done)
+        {
+            cache.Clear ();
+            std::this_thread::yield ();
+        }
+    });
+
+    for (std::thread &thread : threads)
+        thread.join ();
+    done = true;
+    clearer.join ();
+
+    EXPECT_EQ (0u, mismatches);
+#ifdef LLDB_CONFIGURATION_DEBUG
+    // The counters are only kept in debug builds.
+    EXPECT_EQ (kNumReaders * kNumIterations, cache.GetCacheHits () + cache.GetCacheMisses ());
+#endif
+
+    // Once the writers are gone, everything that was stored is found.
+    cache.Clear ();
+    for (size_t i = 0; i < num_types; ++i)
+        cache.SetSummary (types[i], summaries[i]);
+    for (size_t i = 0; i < num_types; ++i)
+    {
+        lldb::TypeSummaryImplSP summary_sp;
+        ASSERT_TRUE (cache.GetSummary (types[i], summary_sp));
+        EXPECT_EQ (summaries[i], summary_sp);
+    }
+}
+
+//----------------------------------------------------------------------
+// Readers format an int while another thread keeps enabling and
+// disabling the only category that has a summary for it.  Every lookup
+// must see the category either enabled or disabled, never a half
+// updated list.
+//----------------------------------------------------------------------
+TEST (FormatterThreadingTest, CategoryLookupsRaceWithEnableAndDisable)
+{
+    ClangASTContext ast ("x86_64-unknown-linux-gnu");
+    ClangASTType int_type (ast.GetBasicType (lldb::eBasicTypeInt));
+    ASSERT_TRUE (int_type.IsValid ());
+
+    const int value = 42;
+    DataExtractor data (&value, sizeof (value), lldb::eByteOrderLittle, 8);
+    lldb::ValueObjectSP valobj_sp (ValueObjectConstResult::Create (nullptr, int_type, ConstString ("value"), data));
+    ASSERT_TRUE (valobj_sp.get () != nullptr);
+
+    TypeCategoryMap categories (nullptr);
+    ConstString category_name ("threading");
+    lldb::TypeCategoryImplSP category_sp (new TypeCategoryImpl (nullptr, category_name));
+    lldb::TypeSummaryImplSP summary_sp (MakeSummary ("answer"));
+    category_sp->GetTypeSummariesContainer ()->Add (ConstString ("int"), summary_sp);
+    categories.Add (category_name, category_sp);
+
+    std::atomic<bool> done (false);
+    std::atomic<size_t> mismatches (0);
+
+    std::thread toggler ([&] () {
+        while (!done)
+        {
+            categories.Enable (category_name, TypeCategoryMap::Default);
+            std::this_thread::yield ();
+            categories.Disable (category_name);
+        }
+    });
+
+    std::vector<std::thread> threads;
+    for (size_t t = 0; t < kNumReaders; ++t)
+    {
+        threads.push_back (std::thread ([&] () {
+            for (size_t i = 0; i < kNumIterations / 10; ++i)
+            {
+                lldb::TypeSummaryImplSP current_sp (categories.GetSummaryFormat (*valobj_sp, lldb::eNoDynamicValues));
+                if (current_sp && current_sp != summary_sp)
+                    ++mismatches;
+            }
+        }));
+    }
+
+    for (std::thread &thread : threads)
+        thread.join ();
+    done = true;
+    toggler.join ();
+
+    EXPECT_EQ (0u, mismatches);
+
+    // The toggler always leaves the category disabled.
+    EXPECT_TRUE (categories.GetSummaryFormat (*valobj_sp, lldb::eNoDynamicValues).get () == nullptr);
+    ASSERT_TRUE (categories.Enable (category_name, TypeCategoryMap::Default));
+    EXPECT_EQ (summary_sp, categories.GetSummaryFormat (*valobj_sp, lldb::eNoDynamicValues));
+}
@@ -0,0 +1,141 @@
+//===-- ClangPredefinesCacheTest.cpp ----------------------------*- C++ -*-===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+
+#include "gtest/gtest.h"
+
+#include <string>
+
+#include "clang/Basic/LangOptions.h"
+#include "clang/Basic/ObjCRuntime.h"
+#include "clang/Basic/TargetOptions.h"
+
+#include "lldb/Expression/ClangPredefinesCache.h"
+
+using namespace lldb_private;
+
+namespace
+{
+    // The options ClangExpressionParser sets up for a C++ expression on
+    // x86_64 Linux.
+    class ClangPredefinesCacheTest : public testing::Test
+    {
+    protected:
+        void
+        SetUp () override
+        {
+            m_target_opts = clang::TargetOptions ();
+            m_lang_opts = clang::LangOptions ();
+            m_target_opts.Triple = "x86_64-unknown-linux-gnu";
+            m_target_opts.CPU = "x86-64";
+            m_lang_opts.CPlusPlus = true;
+            m_lang_opts.CPlusPlus11 = true;
+            m_lang_opts.DebuggerSupport = true;
+            m_key = GetKey ();
+        }
+
+        std::string
+        GetKey () const
+        {
+            return ClangPredefinesCache::GetKey (m_target_opts, m_lang_opts);
+        }
+
+        clang::TargetOptions m_target_opts;
+        clang::LangOptions m_lang_opts;
+        std::string m_key;
+    };
+}
+
+TEST_F (ClangPredefinesCacheTest, SameOptionsSameKey)
+{
+    clang::TargetOptions target_opts (m_target_opts);
+    clang::LangOptions lang_opts (m_lang_opts);
+    EXPECT_EQ (m_key, ClangPredefinesCache::GetKey (target_opts, lang_opts));
+}
+
+TEST_F (ClangPredefinesCacheTest, TargetOptionsChangeKey)
+{
+    m_target_opts.Triple = "i386-unknown-linux-gnu";
+    EXPECT_NE (m_key, GetKey ());
+    SetUp ();
+
+    m_target_opts.CPU = "haswell";
+    EXPECT_NE (m_key, GetKey ());
+    SetUp ();
+
+    m_target_opts.ABI = "aapcs";
+    EXPECT_NE (m_key, GetKey ());
+    SetUp ();
+
+    m_target_opts.FPMath = "sse";
+    EXPECT_NE (m_key, GetKey ());
+    SetUp ();
+
+    m_target_opts.Features.push_back ("+avx2");
+    EXPECT_NE (m_key, GetKey ());
+    SetUp ();
+
+    m_target_opts.FeaturesAsWritten.push_back ("+avx2");
+    EXPECT_NE (m_key, GetKey ());
+}
+
+TEST_F (ClangPredefinesCacheTest, LanguageOptionsChangeKey)
+{
+    m_lang_opts.CPlusPlus11 = false;
+    EXPECT_NE (m_key, GetKey ());
+    SetUp ();
+
+    m_lang_opts.ObjC1 = true;
+    m_lang_opts.ObjC2 = true;
+    EXPECT_NE (m_key, GetKey ());
+    SetUp ();
+
+    m_lang_opts.DebuggerCastResultToId = true;
+    EXPECT_NE (m_key, GetKey ());
+    SetUp ();
+
+    // __OPTIMIZE__ and the stack protector macros come from options that
+    // ClangExpressionParser does not set itself.
+    m_lang_opts.Optimize = true;
+    EXPECT_NE (m_key, GetKey ());
+    SetUp ();
+
+    m_lang_opts.setStackProtector (clang::LangOptions::SSPOn);
+    EXPECT_NE (m_key, GetKey ());
+    SetUp ();
+
+    m_lang_opts.ObjCRuntime.set (clang::ObjCRuntime::GNUstep, clang::VersionTuple (1, 7));
+    EXPECT_NE (m_key, GetKey ());
+}
+
+TEST_F (ClangPredefinesCacheTest, LookupIsPerKey)
+{
+    ClangPredefinesCache cache;
+    std::string predefines;
+    EXPECT_FALSE (cache.GetPredefines (m_key, predefines));
+
+    cache.SetPredefines (m_key, "#define __x86_64__ 1\n");
+    ASSERT_TRUE (cache.GetPredefines (m_key, predefines));
+    EXPECT_EQ ("#define __x86_64__ 1\n", predefines);
+
+    // Switching the target misses and leaves the old buffer alone.
+    m_target_opts.Triple = "i386-unknown-linux-gnu";
+    const std::string i386_key (GetKey ());
+    EXPECT_FALSE (cache.GetPredefines (i386_key, predefines));
+
+    cache.SetPredefines (i386_key, "#define __i386__ 1\n");
+    ASSERT_TRUE (cache.GetPredefines (i386_key, predefines));
+    EXPECT_EQ ("#define __i386__ 1\n", predefines);
+    ASSERT_TRUE (cache.GetPredefines (m_key, predefines));
+    EXPECT_EQ ("#define __x86_64__ 1\n", predefines);
+
+    // So does switching the language.
+    SetUp ();
+    m_lang_opts.ObjC1 = true;
+    EXPECT_FALSE (cache.GetPredefines (GetKey (), predefines));
+}
@@ -0,0 +1,157 @@
+#include "gtest/gtest.h"
+
+#include "Plugins/Process/Linux/DisplacedStepping.h"
+
+using namespace lldb_private;
+
+namespace
+{
+    const lldb::addr_t ORIG_ADDR = 0x400000;
+    const lldb::addr_t SLOT_ADDR = 0x400800;
+
+    bool
+    RelocateX86_64 (DisplacedInstruction &insn, const std::vector<uint8_t> &bytes)
+    {
+        return insn.Relocate (llvm::Triple::x86_64, bytes.data (), bytes.size (), ORIG_ADDR, SLOT_ADDR);
+    }
+
+    bool
+    RelocateARM64 (DisplacedInstruction &insn, uint32_t opcode)
+    {
+        const uint8_t bytes[4] = {
+            static_cast<uint8_t> (opcode),
+            static_cast<uint8_t> (opcode >> 8),
+            static_cast<uint8_t> (opcode >> 16),
+            static_cast<uint8_t> (opcode >> 24)
+        };
+        return insn.Relocate (llvm::Triple::aarch64, bytes, sizeof (bytes), ORIG_ADDR, SLOT_ADDR);
+    }
+}
+
+TEST(DisplacedSteppingTest, X86_64InstructionLengths)
+{
+    struct
+    {
+        std::vector<uint8_t> bytes;
+        size_t length;
+    } cases[] = {
+        { { 0x55, 0xcc, 0xcc }, 1 },                                            // push %rbp
+        { { 0x48, 0x89, 0xe5, 0xcc }, 3 },                                      // mov %rsp,%rbp
+        { { 0x48, 0x83, 0xec, 0x20, 0xcc }, 4 },                                // sub $0x20,%rsp
+        { { 0x8b, 0x44, 0x24, 0x08, 0xcc }, 4 },                                // mov 0x8(%rsp),%eax
+        { { 0x48, 0xb8, 1, 2, 3, 4, 5, 6, 7, 8, 0xcc }, 10 },                   // movabs $imm64,%rax
+        { { 0x66, 0x0f, 0x1f, 0x44, 0x00, 0x00, 0xcc }, 6 },                    // nopw 0x0(%rax,%rax,1)
+        { { 0xf3, 0x0f, 0x1e, 0xfa, 0xcc }, 4 },                                // endbr64
+        { { 0xc5, 0xf8, 0x77, 0xcc }, 3 },                                      // vzeroupper
+        { { 0x66, 0x0f, 0x3a, 0x0f, 0xc1, 0x08, 0xcc }, 6 },                    // palignr $8,%xmm1,%xmm0
+        { { 0xf7, 0xc7, 1, 0, 0, 0, 0xcc }, 6 },                                // test $1,%edi
+        { { 0xc7, 0x04, 0x25, 0, 0, 0, 0, 1, 0, 0, 0 }, 11 },                   // movl $1,0x0
+    };
+
+    for (const auto &c : cases)
+    {
+        DisplacedInstruction insn;
+        ASSERT_TRUE (RelocateX86_64 (insn, c.bytes));
+        ASSERT_EQ (c.length, insn.GetSize ());
+        ASSERT_FALSE (insn.IsCall ());
+        ASSERT_EQ (0, memcmp (insn.GetBytes (), c.bytes.data (), c.length));
+        ASSERT_EQ (ORIG_ADDR + c.length, insn.FixupPC (SLOT_ADDR + c.length));
+    }
+}
+
+TEST(DisplacedSteppingTest, X86_64RipRelativeOperandIsRewritten)
+{
+    // lea 0x10(%rip),%rax
+    DisplacedInstruction insn;
+    ASSERT_TRUE (RelocateX86_64 (insn, { 0x48, 0x8d, 0x05, 0x10, 0x00, 0x00, 0x00 }));
+    ASSERT_EQ (7u, insn.GetSize ());
+
+    const uint8_t *bytes = insn.GetBytes ();
+    const int32_t disp = bytes[3] | bytes[4] << 8 | bytes[5] << 16 | bytes[6] << 24;
+    ASSERT_EQ (ORIG_ADDR + 7 + 0x10, SLOT_ADDR + 7 + disp);
+}
+
+TEST(DisplacedSteppingTest, X86_64RipRelativeOperandOutOfRange)
+{
+    DisplacedInstruction insn;
+    ASSERT_FALSE (insn.Relocate (llvm::Triple::x86_64,
+                                 std::vector<uint8_t> ({ 0x48, 0x8d, 0x05, 0xff, 0xff, 0xff, 0x7f }).data (), 7,
+                                 0x7f0000000000, 0x400000));
+}
+
+TEST(DisplacedSteppingTest, X86_64Branches)
+{
+    DisplacedInstruction insn;
+
+    // call rel32: pc and return address both move back to the original code.
+    ASSERT_TRUE (RelocateX86_64 (insn, { 0xe8, 0x00, 0x01, 0x00, 0x00 }));
+    ASSERT_TRUE (insn.IsCall ());
+    ASSERT_EQ (SLOT_ADDR + 5, insn.GetSlotReturnAddress ());
+    ASSERT_EQ (ORIG_ADDR + 5, insn.GetReturnAddress ());
+    ASSERT_EQ (ORIG_ADDR + 5 + 0x100, insn.FixupPC (SLOT_ADDR + 5 + 0x100));
+
+    // jne rel8
+    ASSERT_TRUE (RelocateX86_64 (insn, { 0x75, 0xf0 }));
+    ASSERT_FALSE (insn.IsCall ());
+    ASSERT_EQ (ORIG_ADDR + 2 - 0x10, insn.FixupPC (SLOT_ADDR + 2 - 0x10));
+
+    // ret: the target is absolute unless the instruction never ran.
+    ASSERT_TRUE (RelocateX86_64 (insn, { 0xc3 }));
+    ASSERT_EQ (0x7fff1234u, insn.FixupPC (0x7fff1234));
+    ASSERT_EQ (ORIG_ADDR, insn.FixupPC (SLOT_ADDR));
+
+    // call *%rax
+    ASSERT_TRUE (RelocateX86_64 (insn, { 0xff, 0xd0 }));
+    ASSERT_TRUE (insn.IsCall ());
+    ASSERT_EQ (0x7fff1234u, insn.FixupPC (0x7fff1234));
+}
+
+TEST(DisplacedSteppingTest, X86_64Unsupported)
+{
+    DisplacedInstruction insn;
+    ASSERT_FALSE (RelocateX86_64 (insn, { 0x0f, 0x05 }));           // syscall
+    ASSERT_FALSE (RelocateX86_64 (insn, { 0xcd, 0x80 }));           // int $0x80
+    ASSERT_FALSE (RelocateX86_64 (insn, { 0xcc }));                 // int3
+    ASSERT_FALSE (RelocateX86_64 (insn, { 0xf4 }));                 // hlt
+    ASSERT_FALSE (RelocateX86_64 (insn, { 0x48, 0x8b }));           // truncated
+    ASSERT_FALSE (RelocateX86_64 (insn, { 0xf3, 0xa4 }));           // rep movsb
+    ASSERT_FALSE (RelocateX86_64 (insn, { 0xf3, 0x48, 0xab }));     // rep stosq
+    ASSERT_FALSE (RelocateX86_64 (insn, { 0xf2, 0xae }));           // repne scasb
+    ASSERT_FALSE (RelocateX86_64 (insn, { 0xf3, 0xa6 }));           // repe cmpsb
+    ASSERT_FALSE (insn.Relocate (llvm::Triple::x86, std::vector<uint8_t> ({ 0x90 }).data (), 1, ORIG_ADDR, SLOT_ADDR));
+}
+
+TEST(DisplacedSteppingTest, ARM64Instructions)
+{
+    DisplacedInstruction insn;
+
+    // add x0, x0, #1
+    ASSERT_TRUE (RelocateARM64 (insn, 0x91000400));
+    ASSERT_EQ (4u, insn.GetSize ());
+    ASSERT_FALSE (insn.IsCall ());
+    ASSERT_EQ (ORIG_ADDR + 4, insn.FixupPC (SLOT_ADDR + 4));
+
+    // bl #0x100
+    ASSERT_TRUE (RelocateARM64 (insn, 0x94000040));
+    ASSERT_TRUE (insn.IsCall ());
+    ASSERT_EQ (ORIG_ADDR + 0x100, insn.FixupPC (SLOT_ADDR + 0x100));
+    ASSERT_EQ (ORIG_ADDR + 4, insn.GetReturnAddress ());
+
+    // b.ne #-8
+    ASSERT_TRUE (RelocateARM64 (insn, 0x54ffffc1));
+    ASSERT_EQ (ORIG_ADDR - 8, insn.FixupPC (SLOT_ADDR - 8));
+
+    // ret
+    ASSERT_TRUE (RelocateARM64 (insn, 0xd65f03c0));
+    ASSERT_FALSE (insn.IsCall ());
+    ASSERT_EQ (0x1000u, insn.FixupPC (0x1000));
+
+    // blr x8
+    ASSERT_TRUE (RelocateARM64 (insn, 0xd63f0100));
+    ASSERT_TRUE (insn.IsCall ());
+
+    ASSERT_FALSE (RelocateARM64 (insn, 0x90000000));    // adrp x0, #0
+    ASSERT_FALSE (RelocateARM64 (insn, 0x58000040));    // ldr x0, #8
+    ASSERT_FALSE (RelocateARM64 (insn, 0xd4000001));    // svc #0
+    ASSERT_FALSE (RelocateARM64 (insn, 0xd4200000));    // brk #0
+}
@@ -813,3 +813,88 @@ TEST_F (ThreadStateCoordinatorTest, CallAfterRunningThreadsStopRequestsStopTwoOt
     ASSERT_EQ (true, DidFireDeferredNotification ());
     ASSERT_EQ (TRIGGERING_TID, GetDeferredNotificationTID ());
 }
+
+TEST_F (ThreadStateCoordinatorTest, ProcessPendingEventsDrainsQueueWithoutBlocking)
+{
+    int queued_count = 0;
+    m_coordinator.SetEventQueuedFunction ([&queued_count] () { ++queued_count; });
+
+    // Nothing queued yet: returns immediately.
+    ASSERT_EQ (ThreadStateCoordinator::eventLoopResultContinue, m_coordinator.ProcessPendingEvents ());
+
+    m_coordinator.NotifyThreadCreate (TRIGGERING_TID, true, GetErrorFunction ());
+    m_coordinator.NotifyThreadCreate (PENDING_STOP_TID, false, GetErrorFunction ());
+    CallAfterRunningThreadsStop (TRIGGERING_TID);
+    ASSERT_EQ (3, queued_count);
+
+    // All three events are processed in one call.
+    ASSERT_EQ (ThreadStateCoordinator::eventLoopResultContinue, m_coordinator.ProcessPendingEvents ());
+    ASSERT_EQ (false, HasError ());
+    ASSERT_EQ (true, DidRequestStopForTid (PENDING_STOP_TID));
+    ASSERT_EQ (false, DidFireDeferredNotification ());
+
+    NotifyThreadStop (PENDING_STOP_TID);
+    ASSERT_EQ (4, queued_count);
+    ASSERT_EQ (ThreadStateCoordinator::eventLoopResultContinue, m_coordinator.ProcessPendingEvents ());
+    ASSERT_EQ (true, DidFireDeferredNotification ());
+    ASSERT_EQ (TRIGGERING_TID, GetDeferredNotificationTID ());
+
+    // A stop request ends processing.
+    m_coordinator.StopCoordinator ();
+    ASSERT_EQ (ThreadStateCoordinator::eventLoopResultStop, m_coordinator.ProcessPendingEvents ());
+}
+
+TEST_F (ThreadStateCoordinatorTest, CallAfterRunningThreadsStopWaitsOnManyThreadsThroughDeaths)
+{
+    const lldb::tid_t FIRST_TID = 10000;
+    const size_t THREAD_COUNT = 1000;
+
+    SetupKnownStoppedThread (TRIGGERING_TID);
+    for (size_t i = 0; i < THREAD_COUNT; ++i)
+        NotifyThreadCreate (FIRST_TID + i, false);
+    ASSERT_EQ (ThreadStateCoordinator::eventLoopResultContinue, m_coordinator.ProcessPendingEvents ());
+
+    CallAfterRunningThreadsStop (TRIGGERING_TID);
+    ASSERT_PROCESS_NEXT_EVENT_SUCCEEDS ();
+    ASSERT_EQ (THREAD_COUNT, GetRequestedStopCount ());
+
+    // Every tenth thread dies instead of stopping, which moves other threads
+    // around in the coordinator's thread array.
+    for (size_t i = 0; i < THREAD_COUNT; ++i)
+    {
+        if (i % 10 == 0)
+            NotifyThreadDeath (FIRST_TID + i);
+        else
+            NotifyThreadStop (FIRST_TID + i);
+        ASSERT_PROCESS_NEXT_EVENT_SUCCEEDS ();
+        ASSERT_EQ (i + 1 == THREAD_COUNT, DidFireDeferredNotification ());
+    }
+    ASSERT_EQ (TRIGGERING_TID, GetDeferredNotificationTID ());
+
+    // The dead threads are gone, the rest are known and stopped.
+    NotifyThreadStop (FIRST_TID);
+    ASSERT_PROCESS_NEXT_EVENT_FAILS ();
+}
+
+TEST_F (ThreadStateCoordinatorTest, ReplacedPendingNotificationNoLongerWaitsOnItsThreads)
+{
+    SetupKnownStoppedThread (TRIGGERING_TID);
+    SetupKnownRunningThread (PENDING_STOP_TID);
+    SetupKnownRunningThread (PENDING_STOP_TID_02);
+
+    // The first notification waits on PENDING_STOP_TID only.
+    CallAfterThreadsStop (TRIGGERING_TID, ThreadStateCoordinator::ThreadIDSet { PENDING_STOP_TID });
+    ASSERT_PROCESS_NEXT_EVENT_SUCCEEDS ();
+
+    // The second one replaces it and waits on PENDING_STOP_TID_02 only.
+    CallAfterThreadsStop (TRIGGERING_TID, ThreadStateCoordinator::ThreadIDSet { PENDING_STOP_TID_02 });
+    ASSERT_PROCESS_NEXT_EVENT_SUCCEEDS ();
+
+    NotifyThreadStop (PENDING_STOP_TID);
+    ASSERT_PROCESS_NEXT_EVENT_SUCCEEDS ();
+    ASSERT_EQ (false, DidFireDeferredNotification ());
+
+    NotifyThreadStop (PENDING_STOP_TID_02);
+    ASSERT_PROCESS_NEXT_EVENT_SUCCEEDS ();
+    ASSERT_EQ (true, DidFireDeferredNotification ());
+}
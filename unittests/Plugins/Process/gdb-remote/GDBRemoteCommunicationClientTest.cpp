@@ -0,0 +1,107 @@
+#if !defined(_WIN32)
+
+#include "gtest/gtest.h"
+
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "lldb/Host/ConnectionFileDescriptor.h"
+#include "Plugins/Process/gdb-remote/GDBRemoteCommunicationClient.h"
+
+using namespace lldb_private;
+
+namespace
+{
+    class TestClient : public GDBRemoteCommunicationClient
+    {
+    public:
+        TestClient ()
+        {
+            // Pipelining is only done without acks.
+            m_send_acks = false;
+        }
+    };
+
+    void
+    WritePacket (int fd, const std::string &payload)
+    {
+        uint8_t checksum = 0;
+        for (char ch : payload)
+            checksum += ch;
+        char checksum_str[3];
+        ::snprintf (checksum_str, sizeof (checksum_str), "%2.2x", checksum);
+        const std::string frame = "$" + payload + "#" + checksum_str;
+        ASSERT_EQ ((ssize_t)frame.size (), ::write (fd, frame.data (), frame.size ()));
+    }
+
+    // Acts as the remote end: waits until "count" packets have arrived
+    // before answering any of them, then replies "R<request>" to each in
+    // order. A client that waits for each reply before sending the next
+    // request never gets an answer.
+    void
+    ServePackets (int fd, size_t count, std::vector<std::string> *received)
+    {
+        std::string buffer;
+        while (received->size () < count)
+        {
+            char bytes[512];
+            const ssize_t bytes_read = ::read (fd, bytes, sizeof (bytes));
+            if (bytes_read <= 0)
+                return;
+            buffer.append (bytes, bytes_read);
+            for (;;)
+            {
+                const size_t start_pos = buffer.find ('$');
+                const size_t hash_pos = buffer.find ('#', start_pos);
+                if (start_pos == std::string::npos || hash_pos == std::string::npos || hash_pos + 2 >= buffer.size ())
+                    break;
+                received->push_back (buffer.substr (start_pos + 1, hash_pos - start_pos - 1));
+                buffer.erase (0, hash_pos + 3);
+            }
+        }
+        for (const std::string &request : *received)
+            WritePacket (fd, "R" + request);
+    }
+}
+
+TEST (GDBRemoteCommunicationClientTest, SendPacketsAndWaitForResponses)
+{
+    int fds[2];
+    ASSERT_EQ (0, ::socketpair (AF_UNIX, SOCK_STREAM, 0, fds));
+
+    TestClient client;
+    client.SetConnection (new ConnectionFileDescriptor (fds[0], true));
+
+    std::vector<std::string> payloads;
+    for (int i = 0; i < 40; ++i)
+        payloads.push_back ("p" + std::to_string (i) + ";thread:1;");
+
+    std::vector<std::string> received;
+    std::thread server (ServePackets, fds[1], payloads.size (), &received);
+
+    std::vector<StringExtractorGDBRemote> responses;
+    const GDBRemoteCommunication::PacketResult result = client.SendPacketsAndWaitForResponses (payloads, responses);
+    server.join ();
+    ::close (fds[1]);
+
+    ASSERT_EQ (GDBRemoteCommunication::PacketResult::Success, result);
+    ASSERT_EQ (payloads, received);
+    ASSERT_EQ (payloads.size (), responses.size ());
+    for (size_t i = 0; i < payloads.size (); ++i)
+        ASSERT_EQ ("R" + payloads[i], responses[i].GetStringRef ());
+}
+
+TEST (GDBRemoteCommunicationClientTest, SendPacketsAndWaitForResponsesEmptyBatch)
+{
+    TestClient client;
+    std::vector<StringExtractorGDBRemote> responses (3);
+    ASSERT_EQ (GDBRemoteCommunication::PacketResult::Success,
+               client.SendPacketsAndWaitForResponses (std::vector<std::string> (), responses));
+    ASSERT_TRUE (responses.empty ());
+}
+
+#endif
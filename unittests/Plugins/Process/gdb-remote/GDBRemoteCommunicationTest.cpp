@@ -0,0 +1,123 @@
+#include "gtest/gtest.h"
+
+#include <string>
+
+#include "Plugins/Process/gdb-remote/GDBRemoteCommunication.h"
+#include "Utility/StringExtractorGDBRemote.h"
+
+using namespace lldb_private;
+
+namespace
+{
+    typedef GDBRemoteCommunication::CompressionType CompressionType;
+
+    class TestCommunication : public GDBRemoteCommunication
+    {
+    public:
+        TestCommunication () :
+            GDBRemoteCommunication ("gdb-remote.test", "gdb-remote.test.listener")
+        {
+            // Compression is only ever enabled once acks are off.
+            m_send_acks = false;
+        }
+
+        bool
+        GetThreadSuffixSupported () override
+        {
+            return false;
+        }
+
+        // Encodes payload the way SendPacket would and runs the framed
+        // result through the receive path.
+        bool
+        RoundTrip (const std::string &payload, std::string &encoded, StringExtractorGDBRemote &packet)
+        {
+            EncodeCompressedPayload (payload.data (), payload.size (), encoded);
+            return Receive (encoded, packet);
+        }
+
+        bool
+        Receive (const std::string &content, StringExtractorGDBRemote &packet)
+        {
+            char checksum[3];
+            ::snprintf (checksum, sizeof (checksum), "%2.2x", (uint8_t)CalculcateChecksum (content.data (), content.size ()));
+            const std::string frame = "$" + content + "#" + checksum;
+            return CheckForPacket ((const uint8_t *)frame.data (), frame.size (), packet);
+        }
+    };
+}
+
+TEST (GDBRemoteCommunicationTest, UncompressedPackets)
+{
+    TestCommunication comm;
+    comm.SetSendCompression (CompressionType::ZlibDeflate, 64);
+    comm.SetReceiveCompression (CompressionType::ZlibDeflate);
+
+    // Payloads below the threshold go out as-is behind an 'N'.
+    std::string encoded;
+    StringExtractorGDBRemote packet;
+    ASSERT_TRUE (comm.RoundTrip ("OK", encoded, packet));
+    ASSERT_EQ ("NOK", encoded);
+    ASSERT_EQ ("OK", packet.GetStringRef ());
+
+    ASSERT_TRUE (comm.Receive ("N", packet));
+    ASSERT_EQ ("", packet.GetStringRef ());
+
+    // Once compression is on, a packet without an encoding prefix is bad.
+    ASSERT_FALSE (comm.Receive ("OK", packet));
+}
+
+TEST (GDBRemoteCommunicationTest, CompressedPackets)
+{
+    if (!GDBRemoteCommunication::IsCompressionTypeSupported (CompressionType::ZlibDeflate))
+        return;
+
+    TestCommunication comm;
+    comm.SetSendCompression (CompressionType::ZlibDeflate, 64);
+    comm.SetReceiveCompression (CompressionType::ZlibDeflate);
+
+    // A memory read reply: long and very repetitive.
+    std::string payload;
+    for (int i = 0; i < 1024; ++i)
+        payload += "00ff10ef";
+
+    std::string encoded;
+    StringExtractorGDBRemote packet;
+    ASSERT_TRUE (comm.RoundTrip (payload, encoded, packet));
+    ASSERT_EQ ('C', encoded[0]);
+    ASSERT_EQ (0u, encoded.find ("C8192:"));
+    ASSERT_LT (encoded.size (), payload.size ());
+    ASSERT_EQ (payload, packet.GetStringRef ());
+
+    // Packets that don't shrink are sent uncompressed.  Pseudo-random bytes
+    // with the high bit set have about seven bits of entropy each and never
+    // need escaping, so deflate can only make them larger (256 bytes come
+    // out as 265 with any compression level).
+    std::string noise;
+    uint32_t seed = 12345;
+    for (int i = 0; i < 256; ++i)
+    {
+        seed = seed * 1103515245 + 12345;
+        noise.push_back ((char)(0x80 | ((seed >> 16) & 0x7f)));
+    }
+    ASSERT_TRUE (comm.RoundTrip (noise, encoded, packet));
+    ASSERT_EQ ("N" + noise, encoded);
+    ASSERT_EQ (noise, packet.GetStringRef ());
+}
+
+TEST (GDBRemoteCommunicationTest, CorruptCompressedPackets)
+{
+    TestCommunication comm;
+    comm.SetReceiveCompression (CompressionType::ZlibDeflate);
+
+    StringExtractorGDBRemote packet;
+
+    // Missing size separator, bad size, and a size past the limit, which
+    // must be turned down before anything is allocated for it.
+    ASSERT_FALSE (comm.Receive ("C1234", packet));
+    ASSERT_FALSE (comm.Receive ("Cxyz:abc", packet));
+    ASSERT_FALSE (comm.Receive ("C99999999999:abc", packet));
+
+    // A size that doesn't match what the data inflates to.
+    ASSERT_FALSE (comm.Receive ("C10:abc", packet));
+}
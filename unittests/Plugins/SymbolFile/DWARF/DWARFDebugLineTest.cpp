@@ -0,0 +1,79 @@
+#include "gtest/gtest.h"
+
+#include "Plugins/SymbolFile/DWARF/DWARFDebugLine.h"
+
+namespace
+{
+    // Builds an index from (low_pc, high_pc) pairs, using each sequence's
+    // position in the list as its offset.
+    void
+    BuildSequenceIndex (DWARFDebugLine::SequenceIndex &sequence_index, const std::vector<std::pair<dw_addr_t, dw_addr_t>> &ranges)
+    {
+        for (size_t i = 0; i < ranges.size (); ++i)
+        {
+            DWARFDebugLine::Sequence sequence = { ranges[i].first, ranges[i].second, static_cast<dw_offset_t> (i) };
+            sequence_index.sequences.push_back (sequence);
+        }
+        sequence_index.Finalize ();
+    }
+
+    dw_offset_t
+    FindSequenceOffset (const DWARFDebugLine::SequenceIndex &sequence_index, dw_addr_t address)
+    {
+        const DWARFDebugLine::Sequence *sequence = sequence_index.FindSequenceContainingAddress (address);
+        return sequence ? sequence->offset : DW_INVALID_OFFSET;
+    }
+}
+
+TEST (DWARFDebugLineTest, FindSequenceContainingAddressDisjoint)
+{
+    DWARFDebugLine::SequenceIndex sequence_index;
+    // Added out of order, Finalize sorts them.
+    BuildSequenceIndex (sequence_index, { { 0x2000, 0x2100 }, { 0x1000, 0x1100 }, { 0x3000, 0x3010 } });
+
+    ASSERT_EQ (DW_INVALID_OFFSET, FindSequenceOffset (sequence_index, 0x0fff));
+    ASSERT_EQ (1u, FindSequenceOffset (sequence_index, 0x1000));
+    ASSERT_EQ (1u, FindSequenceOffset (sequence_index, 0x10ff));
+    ASSERT_EQ (DW_INVALID_OFFSET, FindSequenceOffset (sequence_index, 0x1100));
+    ASSERT_EQ (0u, FindSequenceOffset (sequence_index, 0x2080));
+    ASSERT_EQ (2u, FindSequenceOffset (sequence_index, 0x3000));
+    ASSERT_EQ (DW_INVALID_OFFSET, FindSequenceOffset (sequence_index, 0x3010));
+}
+
+TEST (DWARFDebugLineTest, FindSequenceContainingAddressOverlapping)
+{
+    DWARFDebugLine::SequenceIndex sequence_index;
+    // Sequence 0 encloses sequences 1 and 2, as happens when a function is
+    // emitted in the middle of another one's address range.
+    BuildSequenceIndex (sequence_index, { { 0x1000, 0x2000 }, { 0x1100, 0x1200 }, { 0x1800, 0x1810 },
+                                          { 0x3000, 0x3100 } });
+
+    // Inside an inner sequence, the innermost one wins.
+    ASSERT_EQ (1u, FindSequenceOffset (sequence_index, 0x1100));
+    ASSERT_EQ (2u, FindSequenceOffset (sequence_index, 0x180f));
+
+    // Past the last inner sequence that starts before the address, only
+    // the enclosing one covers it.
+    ASSERT_EQ (0u, FindSequenceOffset (sequence_index, 0x1000));
+    ASSERT_EQ (0u, FindSequenceOffset (sequence_index, 0x1200));
+    ASSERT_EQ (0u, FindSequenceOffset (sequence_index, 0x1810));
+    ASSERT_EQ (0u, FindSequenceOffset (sequence_index, 0x1fff));
+
+    // Nothing reaches the gap or the end.
+    ASSERT_EQ (DW_INVALID_OFFSET, FindSequenceOffset (sequence_index, 0x2000));
+    ASSERT_EQ (DW_INVALID_OFFSET, FindSequenceOffset (sequence_index, 0x2fff));
+    ASSERT_EQ (DW_INVALID_OFFSET, FindSequenceOffset (sequence_index, 0x3100));
+}
+
+TEST (DWARFDebugLineTest, FindSequenceContainingAddressEmpty)
+{
+    DWARFDebugLine::SequenceIndex sequence_index;
+    BuildSequenceIndex (sequence_index, { });
+    ASSERT_EQ (DW_INVALID_OFFSET, FindSequenceOffset (sequence_index, 0));
+
+    // Empty sequences never contain anything, but don't hide the sequence
+    // before them.
+    BuildSequenceIndex (sequence_index, { { 0x1000, 0x1100 }, { 0x1010, 0x1010 } });
+    ASSERT_EQ (0u, FindSequenceOffset (sequence_index, 0x1010));
+    ASSERT_EQ (0u, FindSequenceOffset (sequence_index, 0x1020));
+}
@@ -0,0 +1,295 @@
+#include "gtest/gtest.h"
+
+#include <algorithm>
+#include <vector>
+
+#include "lldb/Core/AddressRange.h"
+#include "lldb/Core/ArchSpec.h"
+#include "lldb/Core/Module.h"
+#include "lldb/Core/Section.h"
+#include "lldb/Core/dwarf.h"
+#include "lldb/Symbol/DWARFCallFrameInfo.h"
+#include "lldb/Symbol/ObjectFile.h"
+
+using namespace lldb_private;
+
+namespace
+{
+    // File addresses of the sections of the test image.
+    const lldb::addr_t kTextAddr = 0x0;
+    const lldb::addr_t kTextSize = 0x10000;
+    const lldb::addr_t kEHFrameAddr = 0x20000;
+    const lldb::addr_t kEHFrameHdrAddr = 0x21000;
+
+    struct Function
+    {
+        lldb::addr_t base;
+        lldb::addr_t size;
+    };
+
+    // Functions in the order their FDEs appear in .eh_frame, which is not
+    // address order.  There is a gap between 0x1100 and 0x1200.
+    const Function g_functions[] = {
+        { 0x1200, 0x10 },
+        { 0x1000, 0x40 },
+        { 0x1300, 0x100 },
+        { 0x1040, 0xc0 },
+    };
+    const size_t g_num_functions = sizeof (g_functions) / sizeof (g_functions[0]);
+
+    void
+    AppendUnsigned (std::vector<uint8_t> &bytes, uint64_t value, size_t byte_size)
+    {
+        for (size_t i = 0; i < byte_size; ++i)
+            bytes.push_back ((uint8_t)(value >> (8 * i)));
+    }
+
+    void
+    PatchU32 (std::vector<uint8_t> &bytes, size_t offset, uint32_t value)
+    {
+        for (size_t i = 0; i < 4; ++i)
+            bytes[offset + i] = (uint8_t)(value >> (8 * i));
+    }
+
+    // Pads an entry started at "start" with DW_CFA_nop and fills in its
+    // length.
+    void
+    FinishEntry (std::vector<uint8_t> &bytes, size_t start)
+    {
+        while ((bytes.size () - start) % 4 != 0)
+            bytes.push_back (0);
+        PatchU32 (bytes, start, bytes.size () - start - 4);
+    }
+
+    // Builds an .eh_frame with two CIEs, the second one only used by the
+    // last FDE, and returns the offset of each FDE.
+    std::vector<size_t>
+    BuildEHFrame (std::vector<uint8_t> &eh_frame)
+    {
+        std::vector<size_t> fde_offsets;
+        size_t cie_offset = 0;
+        for (size_t i = 0; i < g_num_functions; ++i)
+        {
+            if (i == 0 || i + 1 == g_num_functions)
+            {
+                // CIE: version 1, "zR", code align 1, data align -8,
+                // return address in r16, FDE pointers pcrel|sdata4, and
+                // CFA = r7 + 8 with r16 at CFA - 8.
+                cie_offset = eh_frame.size ();
+                AppendUnsigned (eh_frame, 0, 4);
+                AppendUnsigned (eh_frame, 0, 4);
+                const uint8_t cie_body[] = { 1, 'z', 'R', 0, 1, 0x78, 16, 1, DW_EH_PE_pcrel | DW_EH_PE_sdata4,
+                                             0x0c, 7, 8, 0x90, 1 };
+                eh_frame.insert (eh_frame.end (), cie_body, cie_body + sizeof (cie_body));
+                FinishEntry (eh_frame, cie_offset);
+            }
+
+            const size_t fde_offset = eh_frame.size ();
+            fde_offsets.push_back (fde_offset);
+            AppendUnsigned (eh_frame, 0, 4);
+            AppendUnsigned (eh_frame, fde_offset + 4 - cie_offset, 4);
+            AppendUnsigned (eh_frame, g_functions[i].base - (kEHFrameAddr + eh_frame.size ()), 4);
+            AppendUnsigned (eh_frame, g_functions[i].size, 4);
+            eh_frame.push_back (0);
+            FinishEntry (eh_frame, fde_offset);
+        }
+        return fde_offsets;
+    }
+
+    size_t
+    GetFieldSize (uint8_t encoding)
+    {
+        switch (encoding & DW_EH_PE_MASK_ENCODING)
+        {
+            case DW_EH_PE_udata2:
+            case DW_EH_PE_sdata2:   return 2;
+            case DW_EH_PE_udata4:
+            case DW_EH_PE_sdata4:   return 4;
+            default:                return 8;
+        }
+    }
+
+    // Builds an .eh_frame_hdr whose search table, encoded with
+    // "table_enc", holds the first "num_entries" functions in address
+    // order.  The count field claims "fde_count" entries.
+    void
+    BuildEHFrameHdr (std::vector<uint8_t> &hdr, const std::vector<size_t> &fde_offsets,
+                     uint8_t table_enc, size_t num_entries, uint32_t fde_count)
+    {
+        hdr.push_back (1);
+        hdr.push_back (DW_EH_PE_pcrel | DW_EH_PE_sdata4);
+        hdr.push_back (DW_EH_PE_udata4);
+        hdr.push_back (table_enc);
+        AppendUnsigned (hdr, kEHFrameAddr - (kEHFrameHdrAddr + hdr.size ()), 4);
+        AppendUnsigned (hdr, fde_count, 4);
+
+        std::vector<std::pair<lldb::addr_t, lldb::addr_t>> table;
+        for (size_t i = 0; i < g_num_functions; ++i)
+            table.push_back (std::make_pair (g_functions[i].base, kEHFrameAddr + fde_offsets[i]));
+        std::sort (table.begin (), table.end ());
+        table.resize (num_entries);
+
+        const size_t field_size = GetFieldSize (table_enc);
+        for (const auto &entry : table)
+        {
+            const lldb::addr_t values[] = { entry.first, entry.second };
+            for (lldb::addr_t value : values)
+            {
+                lldb::addr_t base = 0;
+                if ((table_enc & 0x70) == DW_EH_PE_pcrel)
+                    base = kEHFrameHdrAddr + hdr.size ();
+                else if ((table_enc & 0x70) == DW_EH_PE_datarel)
+                    base = kEHFrameHdrAddr;
+                AppendUnsigned (hdr, value - base, field_size);
+            }
+        }
+    }
+
+    class CFITestImage : public ObjectFileJITDelegate
+    {
+    public:
+        CFITestImage (uint8_t table_enc, size_t num_entries, uint32_t fde_count)
+        {
+            const std::vector<size_t> fde_offsets = BuildEHFrame (m_eh_frame);
+            BuildEHFrameHdr (m_eh_frame_hdr, fde_offsets, table_enc, num_entries, fde_count);
+        }
+
+        lldb::ByteOrder
+        GetByteOrder () const override
+        {
+            return lldb::eByteOrderLittle;
+        }
+
+        uint32_t
+        GetAddressByteSize () const override
+        {
+            return 8;
+        }
+
+        void
+        PopulateSymtab (ObjectFile *obj_file, Symtab &symtab) override
+        {
+        }
+
+        void
+        PopulateSectionList (ObjectFile *obj_file, SectionList &section_list) override
+        {
+            // JIT sections hold the host address of their contents in place
+            // of a file offset.
+            lldb::ModuleSP module_sp (obj_file->GetModule ());
+            section_list.AddSection (lldb::SectionSP (new Section (module_sp, obj_file, 1, ConstString (".text"), lldb::eSectionTypeCode,
+                                                                   kTextAddr, kTextSize, 0, 0, 0, 0)));
+            section_list.AddSection (lldb::SectionSP (new Section (module_sp, obj_file, 2, ConstString (".eh_frame"), lldb::eSectionTypeEHFrame,
+                                                                   kEHFrameAddr, m_eh_frame.size (), (uintptr_t)&m_eh_frame[0], m_eh_frame.size (), 0, 0)));
+            section_list.AddSection (lldb::SectionSP (new Section (module_sp, obj_file, 3, ConstString (".eh_frame_hdr"), lldb::eSectionTypeOther,
+                                                                   kEHFrameHdrAddr, m_eh_frame_hdr.size (), (uintptr_t)&m_eh_frame_hdr[0], m_eh_frame_hdr.size (), 0, 0)));
+        }
+
+        bool
+        GetArchitecture (ArchSpec &arch) override
+        {
+            arch.SetTriple ("x86_64-pc-linux");
+            return true;
+        }
+
+    private:
+        std::vector<uint8_t> m_eh_frame;
+        std::vector<uint8_t> m_eh_frame_hdr;
+    };
+
+    // Looks every interesting address up through .eh_frame_hdr and through
+    // the full scan of .eh_frame.  Addresses in functions that were left
+    // out of the search table must not be found through it.
+    void
+    CheckLookups (uint8_t table_enc, size_t num_entries, uint32_t fde_count, bool use_table)
+    {
+        std::shared_ptr<CFITestImage> image_sp (new CFITestImage (table_enc, num_entries, fde_count));
+        lldb::ModuleSP module_sp (Module::CreateJITModule (image_sp));
+        ASSERT_TRUE (module_sp.get () != nullptr);
+        ObjectFile *objfile = module_sp->GetObjectFile ();
+        ASSERT_TRUE (objfile != nullptr);
+        lldb::SectionSP eh_frame_sp (module_sp->GetSectionList ()->FindSectionByName (ConstString (".eh_frame")));
+        ASSERT_TRUE (eh_frame_sp.get () != nullptr);
+
+        DWARFCallFrameInfo hdr_cfi (*objfile, eh_frame_sp, lldb::eRegisterKindGCC, true);
+        DWARFCallFrameInfo scan_cfi (*objfile, eh_frame_sp, lldb::eRegisterKindGCC, true);
+        DWARFCallFrameInfo::FunctionAddressAndSizeVector functions;
+        scan_cfi.GetFunctionAddressAndSizeVector (functions);
+        ASSERT_EQ (g_num_functions, functions.GetSize ());
+
+        std::vector<Function> table_functions (g_functions, g_functions + g_num_functions);
+        std::sort (table_functions.begin (), table_functions.end (),
+                   [](const Function &lhs, const Function &rhs) { return lhs.base < rhs.base; });
+        if (use_table)
+            table_functions.resize (num_entries);
+
+        const lldb::addr_t probes[] = { 0x0, 0xfff, 0x1000, 0x103f, 0x1040, 0x10ff, 0x1100, 0x11ff,
+                                        0x1200, 0x120f, 0x1210, 0x12ff, 0x1300, 0x13ff, 0x1400, 0xffff };
+        for (lldb::addr_t file_addr : probes)
+        {
+            Address so_addr;
+            ASSERT_TRUE (module_sp->ResolveFileAddress (file_addr, so_addr));
+
+            AddressRange scan_range;
+            const bool scan_found = scan_cfi.GetAddressRange (so_addr, scan_range);
+            AddressRange hdr_range;
+            const bool hdr_found = hdr_cfi.GetAddressRange (so_addr, hdr_range);
+
+            const Function *expected = nullptr;
+            for (const Function &function : table_functions)
+            {
+                if (function.base <= file_addr && file_addr < function.base + function.size)
+                    expected = &function;
+            }
+
+            ASSERT_EQ (expected != nullptr, hdr_found) << "file address 0x" << std::hex << file_addr;
+            if (hdr_found)
+            {
+                ASSERT_TRUE (scan_found);
+                ASSERT_EQ (scan_range.GetBaseAddress ().GetFileAddress (), hdr_range.GetBaseAddress ().GetFileAddress ());
+                ASSERT_EQ (scan_range.GetByteSize (), hdr_range.GetByteSize ());
+                ASSERT_EQ (expected->base, hdr_range.GetBaseAddress ().GetFileAddress ());
+                ASSERT_EQ (expected->size, hdr_range.GetByteSize ());
+            }
+        }
+
+        // Scanning the section after CIEs were parsed for lookups through
+        // the table must leave those CIEs in place.
+        DWARFCallFrameInfo::FunctionAddressAndSizeVector hdr_functions;
+        hdr_cfi.GetFunctionAddressAndSizeVector (hdr_functions);
+        ASSERT_EQ (g_num_functions, hdr_functions.GetSize ());
+        for (size_t i = 0; i < g_num_functions; ++i)
+        {
+            Address so_addr;
+            ASSERT_TRUE (module_sp->ResolveFileAddress (g_functions[i].base, so_addr));
+            AddressRange range;
+            ASSERT_TRUE (hdr_cfi.GetAddressRange (so_addr, range));
+            ASSERT_EQ (g_functions[i].base, range.GetBaseAddress ().GetFileAddress ());
+        }
+    }
+}
+
+TEST (DWARFCallFrameInfoTest, EHFrameHdrMatchesScan)
+{
+    // The encodings linkers use, and absolute ones.
+    CheckLookups (DW_EH_PE_datarel | DW_EH_PE_sdata4, g_num_functions, g_num_functions, true);
+    CheckLookups (DW_EH_PE_pcrel | DW_EH_PE_sdata4, g_num_functions, g_num_functions, true);
+    CheckLookups (DW_EH_PE_absptr | DW_EH_PE_udata8, g_num_functions, g_num_functions, true);
+    CheckLookups (DW_EH_PE_absptr, g_num_functions, g_num_functions, true);
+}
+
+TEST (DWARFCallFrameInfoTest, EHFrameHdrIsAuthoritative)
+{
+    // A function left out of the table is not looked for in .eh_frame.
+    CheckLookups (DW_EH_PE_datarel | DW_EH_PE_sdata4, g_num_functions - 1, g_num_functions - 1, true);
+}
+
+TEST (DWARFCallFrameInfoTest, UnusableEHFrameHdrFallsBackToScan)
+{
+    // Variable size entries can't be binary searched.
+    CheckLookups (DW_EH_PE_datarel | DW_EH_PE_uleb128, g_num_functions, g_num_functions, false);
+    // Entries relative to the function or text can't be decoded.
+    CheckLookups (DW_EH_PE_textrel | DW_EH_PE_sdata4, g_num_functions, g_num_functions, false);
+    // A count running past the end of the section.
+    CheckLookups (DW_EH_PE_datarel | DW_EH_PE_sdata4, g_num_functions, g_num_functions + 1, false);
+}
@@ -0,0 +1,145 @@
+#include "gtest/gtest.h"
+
+#include <memory>
+
+#include "lldb/Core/Module.h"
+#include "lldb/Core/Section.h"
+#include "lldb/Symbol/CompileUnit.h"
+#include "lldb/Symbol/LineTable.h"
+
+using namespace lldb_private;
+
+namespace
+{
+    // Appends a sequence whose entries are given as (file address, line,
+    // file index) triples; the last one terminates the sequence.
+    void
+    InsertSequence (LineTable &line_table, const std::vector<std::vector<uint32_t>> &rows)
+    {
+        std::unique_ptr<LineSequence> sequence (line_table.CreateLineSequenceContainer ());
+        for (size_t i = 0; i < rows.size (); ++i)
+        {
+            const bool is_terminal_entry = (i + 1 == rows.size ());
+            line_table.AppendLineEntryToSequence (sequence.get (), rows[i][0], rows[i][1], 0, rows[i][2],
+                                                  true, false, false, false, is_terminal_entry);
+        }
+        line_table.InsertSequence (sequence.get ());
+    }
+}
+
+TEST (LineTableTest, FindLineEntryIndexByFileIndex)
+{
+    LineTable line_table (nullptr);
+
+    // Entry indexes:   0               1               2               3 (terminal)
+    InsertSequence (line_table, { { 0x1000, 10, 1 }, { 0x1004, 12, 2 }, { 0x1008, 10, 1 }, { 0x100c, 10, 1 } });
+    //                  4               5               6 (terminal)
+    InsertSequence (line_table, { { 0x2000, 20, 1 }, { 0x2004, 15, 1 }, { 0x2008, 0, 1 } });
+
+    // Exact matches come back in entry order.
+    ASSERT_EQ (0u, line_table.FindLineEntryIndexByFileIndex (0, 1, 10, true, nullptr));
+    ASSERT_EQ (2u, line_table.FindLineEntryIndexByFileIndex (1, 1, 10, true, nullptr));
+    ASSERT_EQ (UINT32_MAX, line_table.FindLineEntryIndexByFileIndex (3, 1, 10, true, nullptr));
+    ASSERT_EQ (UINT32_MAX, line_table.FindLineEntryIndexByFileIndex (0, 1, 11, true, nullptr));
+
+    // Otherwise the closest following line wins, whatever its position.
+    ASSERT_EQ (5u, line_table.FindLineEntryIndexByFileIndex (0, 1, 11, false, nullptr));
+    ASSERT_EQ (4u, line_table.FindLineEntryIndexByFileIndex (0, 1, 16, false, nullptr));
+    ASSERT_EQ (UINT32_MAX, line_table.FindLineEntryIndexByFileIndex (0, 1, 21, false, nullptr));
+
+    // Terminal entries and unknown files never match.
+    ASSERT_EQ (UINT32_MAX, line_table.FindLineEntryIndexByFileIndex (0, 1, 0, true, nullptr));
+    ASSERT_EQ (UINT32_MAX, line_table.FindLineEntryIndexByFileIndex (0, 7, 10, false, nullptr));
+
+    // Several files at once.
+    const std::vector<uint32_t> file_indexes = { 1, 2 };
+    ASSERT_EQ (1u, line_table.FindLineEntryIndexByFileIndex (0, file_indexes, 12, true, nullptr));
+    ASSERT_EQ (1u, line_table.FindLineEntryIndexByFileIndex (0, file_indexes, 11, false, nullptr));
+    ASSERT_EQ (5u, line_table.FindLineEntryIndexByFileIndex (0, file_indexes, 13, false, nullptr));
+
+    // Adding a sequence makes its entries visible to lookups.
+    //                  7               8 (terminal)
+    InsertSequence (line_table, { { 0x3000, 11, 1 }, { 0x3004, 0, 1 } });
+    ASSERT_EQ (7u, line_table.FindLineEntryIndexByFileIndex (0, 1, 11, true, nullptr));
+}
+
+TEST (LineTableTest, SequencesInsertedOutOfOrder)
+{
+    LineTable line_table (nullptr);
+
+    // Enough sequences to span several encoded blocks, inserted from the
+    // highest address down.  Sequence n covers [0x1000 * n, 0x1000 * n + 0x20)
+    // with lines 100 * n and 100 * n + 1.
+    const uint32_t num_sequences = 100;
+    for (uint32_t n = num_sequences; n > 0; --n)
+        InsertSequence (line_table, { { 0x1000 * n, 100 * n, 1 }, { 0x1000 * n + 0x10, 100 * n + 1, 1 },
+                                      { 0x1000 * n + 0x20, 0, 1 } });
+    ASSERT_EQ (3 * num_sequences, line_table.GetSize ());
+
+    // Entries come back in address order.
+    for (uint32_t n = 1; n <= num_sequences; ++n)
+    {
+        ASSERT_EQ (3 * (n - 1), line_table.FindLineEntryIndexByFileIndex (0, 1, 100 * n, true, nullptr));
+        ASSERT_EQ (3 * (n - 1) + 1, line_table.FindLineEntryIndexByFileIndex (0, 1, 100 * n + 1, true, nullptr));
+    }
+}
+
+TEST (LineTableTest, FindLineEntryByAddress)
+{
+    // A module with one code section covering every address below, so line
+    // table file addresses resolve to section offsets.
+    lldb::ModuleSP module_sp (new Module (FileSpec (), ArchSpec ()));
+    lldb::SectionSP text_sp (new Section (module_sp, nullptr, 1, ConstString (".text"), lldb::eSectionTypeCode,
+                                          0, 0x10000, 0, 0x10000, 0, 0));
+    module_sp->GetUnifiedSectionList ()->AddSection (text_sp);
+    CompileUnit comp_unit (module_sp, nullptr, "main.c", 0, lldb::eLanguageTypeC);
+    LineTable line_table (&comp_unit);
+
+    // Entry indexes:   0               1               2 (terminal)
+    InsertSequence (line_table, { { 0x1000, 10, 1 }, { 0x1010, 12, 1 }, { 0x1020, 0, 1 } });
+    // The next sequence starts where the previous one ends.
+    //                  3               4 (terminal)
+    InsertSequence (line_table, { { 0x1020, 30, 1 }, { 0x1030, 0, 1 } });
+    // After a gap, and far enough away to need a multi-byte address delta.
+    //                  5               6               7 (terminal)
+    InsertSequence (line_table, { { 0x8000, 50, 1 }, { 0x8004, 40, 1 }, { 0x8100, 0, 1 } });
+
+    struct
+    {
+        lldb::addr_t file_addr;
+        uint32_t index;
+        uint32_t line;
+        lldb::addr_t range_start;
+        lldb::addr_t range_size;
+    } expected[] = {
+        { 0x1000, 0, 10, 0x1000, 0x10 },
+        { 0x100f, 0, 10, 0x1000, 0x10 },
+        { 0x1010, 1, 12, 0x1010, 0x10 },
+        { 0x1020, 3, 30, 0x1020, 0x10 },
+        { 0x102c, 3, 30, 0x1020, 0x10 },
+        { 0x8000, 5, 50, 0x8000, 0x4 },
+        { 0x8004, 6, 40, 0x8004, 0xfc },
+        { 0x80ff, 6, 40, 0x8004, 0xfc },
+    };
+    for (const auto &e : expected)
+    {
+        LineEntry line_entry;
+        uint32_t index = UINT32_MAX;
+        ASSERT_TRUE (line_table.FindLineEntryByAddress (Address (text_sp, e.file_addr), line_entry, &index));
+        ASSERT_EQ (e.index, index);
+        ASSERT_EQ (e.line, line_entry.line);
+        ASSERT_EQ (e.range_start, line_entry.range.GetBaseAddress ().GetFileAddress ());
+        ASSERT_EQ (e.range_size, line_entry.range.GetByteSize ());
+    }
+
+    // Addresses at a terminal entry that no sequence continues, in the gap
+    // between sequences, at the final terminal entry and past the end.
+    const lldb::addr_t misses[] = { 0x1030, 0x4000, 0x8100, 0x9000 };
+    for (lldb::addr_t file_addr : misses)
+    {
+        LineEntry line_entry;
+        uint32_t index = 0;
+        ASSERT_FALSE (line_table.FindLineEntryByAddress (Address (text_sp, file_addr), line_entry, &index));
+        ASSERT_EQ (UINT32_MAX, index);
+    }
+}
@@ -0,0 +1,72 @@
+#include "gtest/gtest.h"
+
+#include "lldb/Symbol/UnwindPlan.h"
+
+using namespace lldb_private;
+
+namespace
+{
+    UnwindPlan::RowSP
+    MakeRow (lldb::addr_t offset, int32_t cfa_offset)
+    {
+        UnwindPlan::RowSP row_sp (new UnwindPlan::Row);
+        row_sp->SetOffset (offset);
+        row_sp->GetCFAValue ().SetIsRegisterPlusOffset (7, cfa_offset);
+        return row_sp;
+    }
+}
+
+TEST (UnwindPlanTest, RowRegisterLocations)
+{
+    UnwindPlan::Row row;
+    UnwindPlan::Row::RegisterLocation reg_loc;
+
+    // Registers are added out of order and must still be found.
+    ASSERT_TRUE (row.SetRegisterLocationToAtCFAPlusOffset (16, -8, true));
+    ASSERT_TRUE (row.SetRegisterLocationToAtCFAPlusOffset (6, -16, true));
+    ASSERT_TRUE (row.SetRegisterLocationToAtCFAPlusOffset (3, -24, true));
+    for (uint32_t reg_num = 0; reg_num < 32; ++reg_num)
+        row.SetRegisterLocationToSame (reg_num + 100, false);
+
+    ASSERT_TRUE (row.GetRegisterInfo (6, reg_loc));
+    ASSERT_TRUE (reg_loc.IsAtCFAPlusOffset ());
+    ASSERT_EQ (-16, reg_loc.GetOffset ());
+    ASSERT_FALSE (row.GetRegisterInfo (7, reg_loc));
+    ASSERT_TRUE (row.GetRegisterInfo (131, reg_loc));
+    ASSERT_TRUE (reg_loc.IsSame ());
+
+    // can_replace and must_replace are honored.
+    ASSERT_FALSE (row.SetRegisterLocationToAtCFAPlusOffset (6, -32, false));
+    ASSERT_FALSE (row.SetRegisterLocationToSame (7, true));
+    ASSERT_TRUE (row.SetRegisterLocationToIsCFAPlusOffset (6, 0, true));
+    ASSERT_TRUE (row.GetRegisterInfo (6, reg_loc));
+    ASSERT_TRUE (reg_loc.IsCFAPlusOffset ());
+
+    // Copies are independent of the original.
+    UnwindPlan::Row copy (row);
+    ASSERT_TRUE (copy == row);
+    copy.RemoveRegisterInfo (16);
+    ASSERT_FALSE (copy.GetRegisterInfo (16, reg_loc));
+    ASSERT_TRUE (row.GetRegisterInfo (16, reg_loc));
+    ASSERT_FALSE (copy == row);
+}
+
+TEST (UnwindPlanTest, GetRowForFunctionOffset)
+{
+    UnwindPlan plan (lldb::eRegisterKindDWARF);
+    ASSERT_FALSE (plan.GetRowForFunctionOffset (0));
+
+    plan.AppendRow (MakeRow (0, 8));
+    plan.AppendRow (MakeRow (1, 16));
+    plan.AppendRow (MakeRow (4, 24));
+    plan.InsertRow (MakeRow (2, 32));
+    plan.InsertRow (MakeRow (10, 40));
+
+    ASSERT_EQ (5, plan.GetRowCount ());
+    ASSERT_EQ (8, plan.GetRowForFunctionOffset (0)->GetCFAValue ().GetOffset ());
+    ASSERT_EQ (16, plan.GetRowForFunctionOffset (1)->GetCFAValue ().GetOffset ());
+    ASSERT_EQ (32, plan.GetRowForFunctionOffset (3)->GetCFAValue ().GetOffset ());
+    ASSERT_EQ (24, plan.GetRowForFunctionOffset (9)->GetCFAValue ().GetOffset ());
+    ASSERT_EQ (40, plan.GetRowForFunctionOffset (1000)->GetCFAValue ().GetOffset ());
+    ASSERT_EQ (40, plan.GetRowForFunctionOffset (-1)->GetCFAValue ().GetOffset ());
+}
@@ -404,3 +404,21 @@ TEST_F (StringExtractorTest, GetHexBytesAvail_Partial)
 }
 
 
+
+TEST_F (StringExtractorTest, GetHexBytes_OddLength)
+{
+    const char kHexEncodedBytes[] = "abcde";
+    StringExtractor ex(kHexEncodedBytes);
+
+    uint8_t dst[4];
+    ASSERT_EQ(2u, ex.GetHexBytes (dst, sizeof(dst), 0xde));
+    EXPECT_EQ(0xab,dst[0]);
+    EXPECT_EQ(0xcd,dst[1]);
+    // the dangling nibble doesn't decode, the rest is filled with 0xde
+    EXPECT_EQ(0xde,dst[2]);
+    EXPECT_EQ(0xde,dst[3]);
+
+    ASSERT_EQ(false, ex.IsGood());
+    ASSERT_EQ(UINT64_MAX, ex.GetFilePos());
+    ASSERT_EQ(0u, ex.GetBytesLeft());
+}